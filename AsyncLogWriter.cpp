@@ -0,0 +1,138 @@
+
+#include "AsyncLogWriter.h"
+
+using namespace std;
+
+
+AsyncLogWriter::AsyncLogWriter(LineWriter line_writer, FlushHandler flush_handler,
+	size_t queue_capacity, LogBackPressure back_pressure) :
+		writeLine(line_writer),
+		flush(flush_handler),
+		capacity(queue_capacity > 0 ? queue_capacity : 1),
+		backPressure(back_pressure) {
+
+	writerThread = thread(&AsyncLogWriter::Run, this);
+}
+
+AsyncLogWriter::~AsyncLogWriter() {
+	{
+		lock_guard<mutex> lock(queueMutex);
+		stopRequested = true;
+	}
+	queueNotEmpty.notify_all();
+	queueNotFull.notify_all();
+	if (writerThread.joinable())
+		writerThread.join();
+}
+
+
+void AsyncLogWriter::Push(const string& line, bool encrypt) {
+	unique_lock<mutex> lock(queueMutex);
+
+	if (queuedLineCount >= capacity) {
+		// The writer thread can't wait on itself (e.g., an error reported
+		// while writing a line), so it always drops instead of blocking.
+		bool calledFromWriterThread = this_thread::get_id() == writerThread.get_id();
+
+		if (backPressure == LogBackPressure::BLOCK and !calledFromWriterThread) {
+			queueNotFull.wait(lock, [this] { return queuedLineCount < capacity or stopRequested; });
+		}
+		else if (backPressure == LogBackPressure::DROP_OLDEST and !calledFromWriterThread) {
+			// Flush markers are rare, so the oldest line is at or near the front
+			for (auto it = queue.begin(); it != queue.end(); ++it) {
+				if (!it->flushMarker) {
+					if (recycledLines.size() < 2 * capacity)
+						recycledLines.push_back(move(it->text));
+					queue.erase(it);
+					queuedLineCount--;
+					droppedLines++;
+					break;
+				}
+			}
+		}
+		else {
+			droppedLines++;
+			return;
+		}
+	}
+
+	PendingLine pending;
+	if (!recycledLines.empty()) {
+		pending.text.swap(recycledLines.back());
+		recycledLines.pop_back();
+	}
+	pending.text.assign(line);
+	pending.encrypt = encrypt;
+	queue.push_back(move(pending));
+	queuedLineCount++;
+	lock.unlock();
+	queueNotEmpty.notify_one();
+}
+
+
+void AsyncLogWriter::Drain() {
+	if (this_thread::get_id() == writerThread.get_id()) {
+		flush();
+		return;
+	}
+
+	unique_lock<mutex> lock(queueMutex);
+	unsigned long long ticket = ++flushesRequested;
+	queue.push_back({ "", false, true });
+	queueNotEmpty.notify_one();
+	flushCompleted.wait(lock, [this, ticket] { return flushesCompleted >= ticket or stopRequested; });
+}
+
+
+unsigned long long AsyncLogWriter::GetDroppedLineCount() const {
+	return droppedLines;
+}
+
+thread::id AsyncLogWriter::GetWriterThreadID() const {
+	return writerThread.get_id();
+}
+
+
+void AsyncLogWriter::Run() {
+	deque<PendingLine> batch;
+
+	while (true) {
+		{
+			unique_lock<mutex> lock(queueMutex);
+			queueNotEmpty.wait(lock, [this] { return !queue.empty() or stopRequested; });
+			if (queue.empty() and stopRequested)
+				break;
+
+			// Take the whole queue at once so producers only wait for the
+			// swap, never for encryption or file I/O.
+			batch.swap(queue);
+			queuedLineCount = 0;
+		}
+		queueNotFull.notify_all();
+
+		for (PendingLine& pending : batch) {
+			if (pending.flushMarker) {
+				flush();
+				{
+					lock_guard<mutex> lock(queueMutex);
+					flushesCompleted++;
+				}
+				flushCompleted.notify_all();
+			}
+			else {
+				writeLine(pending.text, pending.encrypt);
+			}
+		}
+
+		// Hand the line buffers back to Push(..) for reuse. At most one full
+		// queue and one full batch of lines exist at a time.
+		{
+			lock_guard<mutex> lock(queueMutex);
+			for (PendingLine& pending : batch) {
+				if (!pending.flushMarker and recycledLines.size() < 2 * capacity)
+					recycledLines.push_back(move(pending.text));
+			}
+		}
+		batch.clear();
+	}
+}
@@ -0,0 +1,95 @@
+/**
+* Async Log Writer - Moves log file output (encryption and file I/O) off the
+*	thread that commits log lines.
+*
+* - Lines are pushed into a bounded FIFO queue and written in order by a
+*	single dedicated writer thread, so lines from one logger are never
+*	reordered.
+* - When the queue is full, the back-pressure policy decides what happens:
+*		- BLOCK: The caller waits until the writer thread frees up space.
+*		- DROP_OLDEST: The oldest queued line is discarded to make room.
+*		- DROP_NEWEST: The line being pushed is discarded.
+*	Discarded lines are counted (see GetDroppedLineCount()).
+* - Drain() blocks until every line pushed so far has been written and
+*	the flush handler has run on the writer thread.
+* - Line strings are recycled once written, so pushing a line only copies
+*	it into an existing buffer once the queue has warmed up.
+*
+* Used by LoggerBase - see LoggerBase::EnableAsyncOutput(..).
+*
+* @file AsyncLogWriter.h
+* @created October 2026
+* @version 1.0
+*/
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+enum class LogBackPressure {
+	BLOCK,
+	DROP_OLDEST,
+	DROP_NEWEST,
+};
+
+
+class AsyncLogWriter {
+
+public:
+	// Called on the writer thread for each queued line, in push order.
+	using LineWriter = std::function<void(const std::string& line, bool encrypt)>;
+	// Called on the writer thread whenever Drain() is requested.
+	using FlushHandler = std::function<void()>;
+
+	AsyncLogWriter(LineWriter line_writer, FlushHandler flush_handler,
+		size_t queue_capacity, LogBackPressure back_pressure);
+	// Writes out all queued lines before stopping the writer thread.
+	~AsyncLogWriter();
+
+	void Push(const std::string& line, bool encrypt);
+	void Drain();
+
+	unsigned long long GetDroppedLineCount() const;
+
+	// So errors reported while writing can be recognized
+	std::thread::id GetWriterThreadID() const;
+
+
+private:
+	struct PendingLine {
+		std::string text;
+		bool encrypt = false;
+		bool flushMarker = false;
+	};
+
+	LineWriter writeLine;
+	FlushHandler flush;
+	const size_t capacity;
+	const LogBackPressure backPressure;
+
+	// A deque, so DROP_OLDEST drops from the front in constant time
+	std::deque<PendingLine> queue;
+	std::vector<std::string> recycledLines;
+	size_t queuedLineCount = 0; // Flush markers don't count against capacity
+	std::mutex queueMutex;
+	std::condition_variable queueNotEmpty;
+	std::condition_variable queueNotFull;
+	std::condition_variable flushCompleted;
+	unsigned long long flushesRequested = 0;
+	unsigned long long flushesCompleted = 0;
+	bool stopRequested = false;
+
+	std::atomic<unsigned long long> droppedLines{ 0 };
+
+	std::thread writerThread;
+
+	void Run();
+
+};
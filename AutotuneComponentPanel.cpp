@@ -257,69 +257,19 @@ void AutotuneComponentPanel::OnClearButtonClicked(wxCommandEvent& evt) {
 
 
 void AutotuneComponentPanel::RefreshAll() {
+	AutotuneProgressSnapshot snapshot;
 
 	////////////////////////////////////////////////////////////////////////
 	// Autotune-Diagnostics
 
-	// If Autotune Diagnostics is enabled and running, perform updates here:
 	if (diagnostics) {
 
-		if (diagnostics->IsRunning()) {
+		if (diagnosticsProgress.Take(snapshot))
+			ApplyDiagnosticsProgress(snapshot);
 
+		if (diagnostics->IsRunning()) {
 			retuneButton->Disable();
 			runDiagnosticsButton->Disable();
-
-			gauge->SetValue(diagnosticData->progressPercentage);
-
-			// Detect error
-			if (diagnosticData->isError) {
-				DisplayMessage(diagnosticData->status, TEXT_COLOR_RED);
-				return;
-			}
-
-			// Detect when Diagnostics starts, and if so, apply the starting values
-			if (!detectedDiagnosticsStart) {
-				if (diagnosticData->stage == ATD_Stage::GO_TO_LOW) {
-					detectedDiagnosticsStart = true;
-					ApplyDiagnosticStartingValues();
-				}
-				return;
-			}
-
-
-			if (!detectedMainDiagnosticsStage) {
-
-				// Detect when Autotune stops, either by finishing or by being cancelled
-				if (!diagnosticData->isRunning) {
-					SetValuesIfDiagnosticsStopped();
-					return;
-				}
-
-				// Detect when main tuning stage starts
-				if (diagnosticData->stage == ATD_Stage::FORWARD_RUN) {
-					detectedMainDiagnosticsStage = true;
-					return;
-				}
-
-				return;
-			}
-
-			if (!detectedDiagnosticsStopped) {
-
-				// Detect when Autotune stops, either by finishing or by being cancelled
-				if (!diagnosticData->isRunning) {
-					SetValuesIfDiagnosticsStopped();
-					return;
-				}
-
-				// If detected main tuning stage, but has not stopped yet, Autotune is in the main tuning stage
-				// If in main tuning stage, increment the gauge (stopping at 80%)
-				if (diagnosticData->stage == ATD_Stage::FORWARD_RUN or diagnosticData->stage == ATD_Stage::BACKWARD_RUN) {
-					ApplyDiagnosticValues(); // Plot the (value, power) coordinates
-				}
-			}
-
-
 			return;
 		}
 		else {
@@ -332,67 +282,12 @@ void AutotuneComponentPanel::RefreshAll() {
 	////////////////////////////////////////////////////////////////////////
 	// Autotune-Power 
 
+	if (powerProgress.Take(snapshot))
+		ApplyPowerProgress(snapshot);
 
 	if (autotunePower->IsRunning()) {
-
 		retuneButton->Disable();
 		runDiagnosticsButton->Disable();
-		
-
-		gauge->SetValue(data->progressPercentage);
-
-		// Detect error
-		if (data->isError) {
-			DisplayMessage(data->status, TEXT_COLOR_RED);
-			return;
-		}
-
-		if (data->attemptingRetune) {
-			ClearAll();
-			DisplayMessage(data->status, TEXT_COLOR_RED);
-		}
-
-		// Detect when Autotune starts, and if so, apply the starting values
-		if (!detectedStart) {
-			if (data->stage == AutotunePowerStage::FIND_LOWER_BOUND) {
-				detectedStart = true;
-				ApplyStartingValues();
-			}
-			return;
-		}
-
-
-		if (!detectedMainTuningStage) {
-
-			// Detect when Autotune stops, either by finishing or by being cancelled
-			if (!data->isRunning) {
-				SetValuesIfAutotuneStopped();
-				return;
-			}
-
-			// Detect when main tuning stage starts
-			if (data->stage == AutotunePowerStage::MAIN_TUNING_STAGE) {
-				detectedMainTuningStage = true;
-				return;
-			}
-
-			return;
-		}
-
-		if (!detectedStopped) {
-
-			// Detect when Autotune stops, either by finishing or by being cancelled
-			if (!data->isRunning) {
-				SetValuesIfAutotuneStopped();
-				return;
-			}
-
-			// If detected main tuning stage, but has not stopped yet, Autotune is in the main tuning stage
-			// If in main tuning stage, increment the gauge (stopping at 80%)
-			if (data->stage == AutotunePowerStage::MAIN_TUNING_STAGE) {
-				ApplyCurrentValues(); // Plot the (value, power) coordinates
-			}
-		}
 	}
 	else {
 		retuneButton->Enable();
@@ -402,14 +297,16 @@ void AutotuneComponentPanel::RefreshAll() {
 
 
 void AutotuneComponentPanel::ClearAll() {
-	detectedStart = false;
-	detectedDiagnosticsStart = false;
-	detectedMainTuningStage = false;
-	detectedMainDiagnosticsStage = false;
-	detectedStopped = false;
-	detectedDiagnosticsStopped = false;
+	// The step thread starts over with its next update
+	powerProgress.Restart();
+	diagnosticsProgress.Restart();
+	appliedPower = AppliedProgress();
+	appliedDiagnostics = AppliedProgress();
 
+	ClearDisplay();
+}
 
+void AutotuneComponentPanel::ClearDisplay() {
 	// Removed this to test new clear button - to clear canvas, you now have to press the Clear button
 	//ClearCanvas();
 
@@ -426,106 +323,228 @@ void AutotuneComponentPanel::ClearCanvas() {
 	canvas->Refresh();
 }
 
-void AutotuneComponentPanel::ApplyStartingValues() {
-	ApplyPowerStartingValues();
-	if (data->type == MOTOR_STR)
-		ApplyMotorStartingValues();
-	else
-		ApplyTemperatureStartingValues();
-}
 
-void AutotuneComponentPanel::ApplyPowerStartingValues() {
-	canvas->SetStartY(data->startPower);
-	startPowerValue->SetLabelText(to_wx_string(data->startPower, 2) + " W");
-	UpdatePanel();
-}
+//-----------------------------------------------------------------------------
+// Publish progress (step thread)
 
-void AutotuneComponentPanel::ApplyMotorStartingValues() {
-	canvas->SetStartX(data->startIndex);
-	startValue->SetLabelText(to_wx_string(data->startIndex));
-	UpdatePanel();
+// Only the step thread changes data while Autotune-Power runs, so it's read
+//	here, right after each step, and not by RefreshAll().
+void AutotuneComponentPanel::PublishPowerProgress() {
+	AutotuneProgressSnapshot& state = powerProgress.BeginUpdate();
+
+	// A retune attempt starts the curve over
+	if (data->attemptingRetune and !state.retuning)
+		powerProgress.StartOver();
+
+	bool isMotor = data->type == MOTOR_STR;
+	state.retuning = data->attemptingRetune;
+	state.running = data->isRunning;
+	state.finished = data->finished;
+	state.error = data->isError;
+	state.progressPercentage = data->progressPercentage;
+	state.status = data->status;
+
+	if (state.error) {
+		// Nothing else to show
+	}
+	else if (!state.started) {
+		if (data->stage == AutotunePowerStage::FIND_LOWER_BOUND) {
+			state.started = true;
+			state.startPower = data->startPower;
+			state.startX = isMotor ? data->startIndex : data->startTemp;
+		}
+	}
+	else if (!state.stopped) {
+		// Stopped, either by finishing or by being cancelled
+		if (!data->isRunning) {
+			state.stopped = true;
+			state.finalPower = data->currentPower;
+			state.finalX = isMotor ? data->finalIndex : data->finalTemp;
+		}
+		else if (data->stage == AutotunePowerStage::MAIN_TUNING_STAGE) {
+			if (isMotor)
+				powerProgress.AddPoint(data->currentIndex, data->currentPower);
+			else {
+				// Only add a point if this step's set temperature is different from last step's.
+				// This avoids the power curve getting a jagged shape.
+				if (data->currentTemp != lastPowerTemp)
+					powerProgress.AddPoint(data->currentTemp, data->currentPower);
+				lastPowerTemp = data->currentTemp;
+			}
+		}
+	}
+
+	powerProgress.Publish();
 }
 
-void AutotuneComponentPanel::ApplyTemperatureStartingValues() {
-	canvas->SetStartX(data->startTemp);
-	startValue->SetLabelText(to_wx_string(data->startTemp, 2));
-	UpdatePanel();
+// Same as PublishPowerProgress(), for Autotune-Diagnostics
+void AutotuneComponentPanel::PublishDiagnosticsProgress() {
+	AutotuneProgressSnapshot& state = diagnosticsProgress.BeginUpdate();
+
+	bool isMotor = diagnosticData->type == MOTOR_STR;
+	state.running = diagnosticData->isRunning;
+	state.finished = diagnosticData->finished;
+	state.error = diagnosticData->isError;
+	state.progressPercentage = diagnosticData->progressPercentage;
+	state.status = diagnosticData->status;
+
+	if (state.error) {
+		// Nothing else to show
+	}
+	else if (!state.started) {
+		if (diagnosticData->stage == ATD_Stage::GO_TO_LOW) {
+			state.started = true;
+			state.startPower = diagnosticData->startPower;
+			state.startX = isMotor ? diagnosticData->startIndex : diagnosticData->startTemp;
+		}
+	}
+	else if (!state.stopped) {
+		// Stopped, either by finishing or by being cancelled
+		if (!diagnosticData->isRunning) {
+			state.stopped = true;
+			state.fittedMaxPower = { diagnosticData->fittedMaxPower_forward, diagnosticData->fittedMaxPower_backward, diagnosticData->fittedMaxPower_difference };
+			state.fittedMaxLoc = { diagnosticData->fittedMaxLoc_forward, diagnosticData->fittedMaxLoc_backward, diagnosticData->fittedMaxLoc_difference };
+		}
+		else if (diagnosticData->stage == ATD_Stage::FORWARD_RUN or diagnosticData->stage == ATD_Stage::BACKWARD_RUN) {
+			if (isMotor)
+				diagnosticsProgress.AddPoint(diagnosticData->currentIndex, diagnosticData->currentPower);
+			else {
+				// Only add a point if this step's set temperature is different from last step's.
+				// This avoids the power curve getting a jagged shape.
+				if (diagnosticData->currentTemp != lastDiagnosticsTemp)
+					diagnosticsProgress.AddPoint(diagnosticData->currentTemp, diagnosticData->currentPower);
+				lastDiagnosticsTemp = diagnosticData->currentTemp;
+			}
+		}
+	}
+
+	diagnosticsProgress.Publish();
 }
 
 
-void AutotuneComponentPanel::ApplyCurrentValues() {
-	if (data->type == MOTOR_STR)
-		canvas->AddPoint(data->currentIndex, data->currentPower);
-	else {
+//-----------------------------------------------------------------------------
+// Apply progress snapshots (UI thread)
+
+void AutotuneComponentPanel::ApplyPowerProgress(const AutotuneProgressSnapshot& snapshot) {
+	// New run or retune attempt
+	if (snapshot.attempt != appliedPower.attempt) {
+		appliedPower = AppliedProgress();
+		appliedPower.attempt = snapshot.attempt;
+		ClearDisplay();
+	}
+
+	gauge->SetValue(snapshot.progressPercentage);
 
-		// Check if this step's set temperature is the same as last step.
-		// Only update if this step's set temp is different from last step's.
-		// This avoids the power curve getting a jagged shape.
-		static float lastTemp = 0;
-		bool tempChangedSinceLastStep = (data->currentTemp != lastTemp);
+	if (snapshot.error) {
+		DisplayMessage(snapshot.status, TEXT_COLOR_RED);
+		return;
+	}
+	if (snapshot.retuning)
+		DisplayMessage(snapshot.status, TEXT_COLOR_RED);
+
+	if (snapshot.started and !appliedPower.started) {
+		appliedPower.started = true;
+		ApplyStartingValues(snapshot);
+	}
 
-		if (tempChangedSinceLastStep)
-			canvas->AddPoint(data->currentTemp, data->currentPower);
+	// Plot the (value, power) coordinates measured since the last snapshot
+	for (const AutotunePoint& point : snapshot.newPoints)
+		canvas->AddPoint(point.x, point.power);
 
-		lastTemp = data->currentTemp;
+	if (snapshot.stopped and !appliedPower.stopped) {
+		appliedPower.stopped = true;
+		SetValuesIfAutotuneStopped(snapshot);
 	}
 }
 
+void AutotuneComponentPanel::ApplyDiagnosticsProgress(const AutotuneProgressSnapshot& snapshot) {
+	// New run
+	if (snapshot.attempt != appliedDiagnostics.attempt) {
+		appliedDiagnostics = AppliedProgress();
+		appliedDiagnostics.attempt = snapshot.attempt;
+		ClearDisplay();
+	}
 
-void AutotuneComponentPanel::ApplyDiagnosticValues() {
-	if (diagnosticData->type == MOTOR_STR)
-		canvas->AddDiagnosticPoint(diagnosticData->currentIndex, diagnosticData->currentPower);
-	else {
+	gauge->SetValue(snapshot.progressPercentage);
+
+	if (snapshot.error) {
+		DisplayMessage(snapshot.status, TEXT_COLOR_RED);
+		return;
+	}
 
-		// Check if this step's set temperature is the same as last step.
-		// Only update if this step's set temp is different from last step's.
-		// This avoids the power curve getting a jagged shape.
-		static float lastDTemp = 0;
-		bool tempChangedSinceLastStep = (diagnosticData->currentTemp != lastDTemp);
+	if (snapshot.started and !appliedDiagnostics.started) {
+		appliedDiagnostics.started = true;
+		ApplyDiagnosticStartingValues(snapshot);
+	}
 
-		if (tempChangedSinceLastStep)
-			canvas->AddDiagnosticPoint(diagnosticData->currentTemp, diagnosticData->currentPower);
+	for (const AutotunePoint& point : snapshot.newPoints)
+		canvas->AddDiagnosticPoint(point.x, point.power);
 
-		lastDTemp = diagnosticData->currentTemp;
+	if (snapshot.stopped and !appliedDiagnostics.stopped) {
+		appliedDiagnostics.stopped = true;
+		SetValuesIfDiagnosticsStopped(snapshot);
 	}
 }
 
-
-void AutotuneComponentPanel::ApplyDiagnosticStartingValues() {
-	canvas->SetStartY(diagnosticData->startPower);
+void AutotuneComponentPanel::ApplyStartingValues(const AutotuneProgressSnapshot& snapshot) {
+	ApplyPowerStartingValues(snapshot);
 	if (data->type == MOTOR_STR)
-		canvas->SetStartX(diagnosticData->startIndex);
+		ApplyMotorStartingValues(snapshot);
 	else
-		canvas->SetStartX(diagnosticData->startTemp);
+		ApplyTemperatureStartingValues(snapshot);
+}
+
+void AutotuneComponentPanel::ApplyPowerStartingValues(const AutotuneProgressSnapshot& snapshot) {
+	canvas->SetStartY(snapshot.startPower);
+	startPowerValue->SetLabelText(to_wx_string(snapshot.startPower, 2) + " W");
+	UpdatePanel();
+}
+
+void AutotuneComponentPanel::ApplyMotorStartingValues(const AutotuneProgressSnapshot& snapshot) {
+	canvas->SetStartX(snapshot.startX);
+	startValue->SetLabelText(to_wx_string(int(snapshot.startX)));
+	UpdatePanel();
+}
+
+void AutotuneComponentPanel::ApplyTemperatureStartingValues(const AutotuneProgressSnapshot& snapshot) {
+	canvas->SetStartX(snapshot.startX);
+	startValue->SetLabelText(to_wx_string(snapshot.startX, 2));
+	UpdatePanel();
+}
+
+
+void AutotuneComponentPanel::ApplyDiagnosticStartingValues(const AutotuneProgressSnapshot& snapshot) {
+	canvas->SetStartY(snapshot.startPower);
+	canvas->SetStartX(snapshot.startX);
 	UpdatePanel();
 }
 
 
-void AutotuneComponentPanel::ApplyFinalValues() {
-	ApplyPowerFinalValues();
+void AutotuneComponentPanel::ApplyFinalValues(const AutotuneProgressSnapshot& snapshot) {
+	ApplyPowerFinalValues(snapshot);
 	if (data->type == MOTOR_STR)
-		ApplyMotorFinalValues();
+		ApplyMotorFinalValues(snapshot);
 	else
-		ApplyTemperatureFinalValues();
+		ApplyTemperatureFinalValues(snapshot);
 }
 
-void AutotuneComponentPanel::ApplyPowerFinalValues() {
-	canvas->SetFinishY(data->currentPower);
-	finalPowerValue->SetLabelText(to_wx_string(data->currentPower, 2) + " W");
+void AutotuneComponentPanel::ApplyPowerFinalValues(const AutotuneProgressSnapshot& snapshot) {
+	canvas->SetFinishY(snapshot.finalPower);
+	finalPowerValue->SetLabelText(to_wx_string(snapshot.finalPower, 2) + " W");
 	UpdatePanel();
 }
 
-void AutotuneComponentPanel::ApplyTemperatureFinalValues() {
-	canvas->SetFinishX(data->finalTemp);
-	finalValue->SetLabelText(to_wx_string(data->finalTemp, 2));
+void AutotuneComponentPanel::ApplyTemperatureFinalValues(const AutotuneProgressSnapshot& snapshot) {
+	canvas->SetFinishX(snapshot.finalX);
+	finalValue->SetLabelText(to_wx_string(snapshot.finalX, 2));
 	UpdatePanel();
 }
 
 
 
-void AutotuneComponentPanel::ApplyMotorFinalValues() {
-	canvas->SetFinishX(data->finalIndex);
-	finalValue->SetLabelText(to_wx_string(data->finalIndex));
+void AutotuneComponentPanel::ApplyMotorFinalValues(const AutotuneProgressSnapshot& snapshot) {
+	canvas->SetFinishX(snapshot.finalX);
+	finalValue->SetLabelText(to_wx_string(int(snapshot.finalX)));
 	UpdatePanel();
 }
 
@@ -577,37 +596,35 @@ void AutotuneComponentPanel::SetParameterLabels() {
 }
 
 
-void AutotuneComponentPanel::SetValuesIfAutotuneStopped() {
-	detectedStopped = true;
-	if (data->finished) {
+void AutotuneComponentPanel::SetValuesIfAutotuneStopped(const AutotuneProgressSnapshot& snapshot) {
+	if (snapshot.finished) {
 		DisplayMessage(_(DONE_STR), TEXT_COLOR_GREEN);
-		ApplyFinalValues();
+		ApplyFinalValues(snapshot);
 	}
 	else {
-		DisplayMessage(data->status, TEXT_COLOR_RED);
+		DisplayMessage(snapshot.status, TEXT_COLOR_RED);
 	}
 }
 
-void AutotuneComponentPanel::SetValuesIfDiagnosticsStopped() {
-	detectedDiagnosticsStopped = true;
-	if (diagnosticData->finished) {
+void AutotuneComponentPanel::SetValuesIfDiagnosticsStopped(const AutotuneProgressSnapshot& snapshot) {
+	if (snapshot.finished) {
 		DisplayMessage(_(DONE_STR), TEXT_COLOR_GREEN);
 
 		int locDecimalPlaces = 2;
 		if (diagnosticData->type == MOTOR_STR)
 			locDecimalPlaces = 0;
 
-		diagosticsForwardMaxPower->SetLabelText(to_wx_string(diagnosticData->fittedMaxPower_forward, 2));
-		diagosticsBackwardMaxPower->SetLabelText(to_wx_string(diagnosticData->fittedMaxPower_backward, 2));
-		diagosticsDifferenceMaxPower->SetLabelText(to_wx_string(diagnosticData->fittedMaxPower_difference, 3));
-		diagosticsForwardMaxLoc->SetLabelText(to_wx_string(diagnosticData->fittedMaxLoc_forward, locDecimalPlaces));
-		diagosticsBackwardMaxLoc->SetLabelText(to_wx_string(diagnosticData->fittedMaxLoc_backward, locDecimalPlaces));
-		diagosticsDifferenceMaxLoc->SetLabelText(to_wx_string(diagnosticData->fittedMaxLoc_difference, locDecimalPlaces));
+		diagosticsForwardMaxPower->SetLabelText(to_wx_string(snapshot.fittedMaxPower[0], 2));
+		diagosticsBackwardMaxPower->SetLabelText(to_wx_string(snapshot.fittedMaxPower[1], 2));
+		diagosticsDifferenceMaxPower->SetLabelText(to_wx_string(snapshot.fittedMaxPower[2], 3));
+		diagosticsForwardMaxLoc->SetLabelText(to_wx_string(snapshot.fittedMaxLoc[0], locDecimalPlaces));
+		diagosticsBackwardMaxLoc->SetLabelText(to_wx_string(snapshot.fittedMaxLoc[1], locDecimalPlaces));
+		diagosticsDifferenceMaxLoc->SetLabelText(to_wx_string(snapshot.fittedMaxLoc[2], locDecimalPlaces));
 
 		DiagnosticsResultsPanel->Show();
 		UpdatePanel();
 	}
 	else {
-		DisplayMessage(diagnosticData->status, TEXT_COLOR_RED);
+		DisplayMessage(snapshot.status, TEXT_COLOR_RED);
 	}
 }
@@ -6,6 +6,8 @@
 * @author James Butcher
 * @created  June - July, 2022
 * @version 1.1  2/29/24 - Added Autotune Diagnostics Feature.
+* @version 1.2  10/17/26 - Progress comes from snapshots the step thread publishes
+*	after each step (see AutotuneProgressChannel.h) instead of reading the live data.
 */
 
 #pragma once
@@ -15,6 +17,7 @@
 #include <wx/gbsizer.h>
 
 #include "AutotunePlotCanvas.h"
+#include "AutotuneProgressChannel.h"
 #include "LaserControlProcedures/AutotunePower/AutotunePowerManager.h"
 #include "LaserControlProcedures/AutotunePower/PowerTuneData.h"
 #include "LaserControlProcedures/AutotuneDiagnostics/ATD_Data.h"
@@ -45,6 +48,10 @@ public:
     void RefreshAll();
     void ClearAll();
 
+    // Step thread: publish this component's progress right after each step
+    void PublishPowerProgress();
+    void PublishDiagnosticsProgress();
+
 
 private:
     std::shared_ptr<MainLaserControllerInterface> lc;
@@ -77,39 +84,50 @@ private:
     wxStaticText* diagosticsBackwardMaxLoc;
     wxStaticText* diagosticsDifferenceMaxLoc;
 
-    // Flags to signal changes in state
-    bool detectedStart = false;
-    bool detectedDiagnosticsStart = false;
-    bool detectedMainTuningStage = false;
-    bool detectedMainDiagnosticsStage = false;
-    bool detectedStopped = false;
-    bool detectedDiagnosticsStopped = false;
+    // Progress published by the step thread
+    AutotuneProgressChannel powerProgress;
+    AutotuneProgressChannel diagnosticsProgress;
+    // Step thread: last temperature plotted
+    float lastPowerTemp = 0;
+    float lastDiagnosticsTemp = 0;
+
+    // What the panel shows of the current attempt
+    struct AppliedProgress {
+        unsigned long long attempt = 0;
+        bool started = false;
+        bool stopped = false;
+    };
+    AppliedProgress appliedPower;
+    AppliedProgress appliedDiagnostics;
 
     void Init();
 
     void OnClearButtonClicked(wxCommandEvent& evt);
 
+    // Apply progress snapshots
+    void ApplyPowerProgress(const AutotuneProgressSnapshot& snapshot);
+    void ApplyDiagnosticsProgress(const AutotuneProgressSnapshot& snapshot);
+
     // Apply data to plot canvas
-    void ApplyStartingValues();
-    void ApplyPowerStartingValues();
-    void ApplyMotorStartingValues();
-    void ApplyTemperatureStartingValues();
-    void ApplyCurrentValues();
-    void ApplyFinalValues();
-    void ApplyPowerFinalValues();
-    void ApplyMotorFinalValues();
-    void ApplyTemperatureFinalValues();
+    void ApplyStartingValues(const AutotuneProgressSnapshot& snapshot);
+    void ApplyPowerStartingValues(const AutotuneProgressSnapshot& snapshot);
+    void ApplyMotorStartingValues(const AutotuneProgressSnapshot& snapshot);
+    void ApplyTemperatureStartingValues(const AutotuneProgressSnapshot& snapshot);
+    void ApplyFinalValues(const AutotuneProgressSnapshot& snapshot);
+    void ApplyPowerFinalValues(const AutotuneProgressSnapshot& snapshot);
+    void ApplyMotorFinalValues(const AutotuneProgressSnapshot& snapshot);
+    void ApplyTemperatureFinalValues(const AutotuneProgressSnapshot& snapshot);
 
     // Apply diagnostic data to plot canvas
-    void ApplyDiagnosticValues();
-    void ApplyDiagnosticStartingValues();
-    void SetValuesIfDiagnosticsStopped();
+    void ApplyDiagnosticStartingValues(const AutotuneProgressSnapshot& snapshot);
+    void SetValuesIfDiagnosticsStopped(const AutotuneProgressSnapshot& snapshot);
 
     // Helper functions
     void DisplayMessage(wxString newMessage, wxColor fontColor);
     void UpdatePanel();
     void SetParameterLabels();
-    void SetValuesIfAutotuneStopped();
+    void SetValuesIfAutotuneStopped(const AutotuneProgressSnapshot& snapshot);
+    void ClearDisplay();
     void ClearCanvas();
 
 };
@@ -1,5 +1,6 @@
 #include "AutotuneDiagnosticsPanel.h"
 #include "../CommonFunctions_GUI.h"
+#include "Logging/UserActionJournal.h"
 
 using namespace std;
 
@@ -36,22 +37,6 @@ const wxString SAVE_FULL_LOG_STR = _("Save Full Log");
 const wxString SAVE_STATISTICS_LOG_STR = _("Save Statistics");
 
 
-// Handles continuously stepping the Autotune Diagnostics procedure
-void StepAutotuneDiagnosticsThread(shared_ptr<AutotuneDiagnostics> diagnostics, vector<AutotuneComponentPanel*> autotuneComponentPanels) {
-	while (true) {
-		if (diagnostics->IsRunning()) {
-			diagnostics->Step();
-			if (!IsInAccessMode(GuiAccessMode::END_USER))
-				wxLogStatus(to_wx_string(diagnostics->GetStepSummary()));
-			for (auto component : autotuneComponentPanels)
-				component->RefreshAll();
-		}
-		else
-			break;
-	}
-}
-
-
 AutotuneDiagnosticsPanel::AutotuneDiagnosticsPanel(
 	shared_ptr<MainLaserControllerInterface> _lc,
 	shared_ptr<AutotuneDiagnostics> _diagnostics,
@@ -66,6 +51,8 @@ AutotuneDiagnosticsPanel::AutotuneDiagnosticsPanel(
 	this->SetAutoLayout(false);
 	this->SetBackgroundColour(FOREGROUND_PANEL_COLOR);
 
+	progressTimer.Bind(wxEVT_TIMER, &AutotuneDiagnosticsPanel::OnProgressTimer, this, progressTimer.GetId());
+
 	sizer = new wxBoxSizer(wxVERTICAL);
 
 	title = new FeatureTitle(this, DIAGNOSTICS_STR, DIAGNOSTICS_TOOLTIP);
@@ -263,16 +250,28 @@ void AutotuneDiagnosticsPanel::StartDiagnostics() {
 }
 
 
+// Steps the Autotune Diagnostics procedure on the executor's worker thread, with
+//	each component publishing its progress after each step. Component panels and
+//	the step summary are refreshed by OnProgressTimer(..).
 void AutotuneDiagnosticsPanel::StartDiagnosticsStepThread() {
-	if (diagnosticsThread != nullptr) {
-		diagnosticsThread->join();
-	}
-	diagnosticsThread = make_shared<std::thread>(StepAutotuneDiagnosticsThread, diagnostics, autotuneComponentPanels);
+	shared_ptr<AutotuneDiagnostics> procedure = diagnostics;
+	vector<AutotuneComponentPanel*> components = autotuneComponentPanels;
+	stepExecutor.Start({
+		[procedure] { return procedure->IsRunning(); },
+		[procedure, components] {
+			procedure->Step();
+			for (auto component : components)
+				component->PublishDiagnosticsProgress();
+		},
+		[procedure] { return procedure->GetStepSummary(); },
+		[procedure] { procedure->Cancel(); }
+	});
+	progressTimer.Start(PROGRESS_FRAME_INTERVAL_MS);
 }
 
 
 void AutotuneDiagnosticsPanel::CancelDiagnostics() {
-	diagnostics->Cancel();
+	stepExecutor.Cancel();
 	runningMessage->Set(_("Canceled"));
 	runningMessage->StopCycling();
 	saveFullLogButton->Show();
@@ -286,7 +285,7 @@ void AutotuneDiagnosticsPanel::CancelDiagnostics() {
 // Callbacks
 
 void AutotuneDiagnosticsPanel::OnMainButtonClicked(wxCommandEvent& evt) {
-	STAGE_ACTION("Main Autotune-Diagnostics button clicked")
+	JOURNALED_STAGE_ACTION("Main Autotune-Diagnostics button clicked")
 		if (diagnostics->IsRunning())
 			CancelDiagnostics();
 		else {
@@ -295,20 +294,20 @@ void AutotuneDiagnosticsPanel::OnMainButtonClicked(wxCommandEvent& evt) {
 			confirmAutotuneDialog.SetOKLabel(_("Yes"));
 			if (confirmAutotuneDialog.ShowModal() == wxID_OK) {
 				RunFullDiagnostics();
-				STAGE_ACTION_ARGUMENTS("Confirmed");
+				JOURNALED_STAGE_ACTION_ARGUMENTS("Confirmed");
 			}
 			else {
-				STAGE_ACTION_ARGUMENTS("Cancelled");
+				JOURNALED_STAGE_ACTION_ARGUMENTS("Cancelled");
 			}
 		}
-	LOG_ACTION()
+	JOURNALED_LOG_ACTION()
 }
 
 
 // Assumes the individual component panel already reset the 
 // Autotune Diagnostics Manager and added only itself for the next run
 void AutotuneDiagnosticsPanel::OnRetuneButtonClicked(wxCommandEvent& evt) {
-	STAGE_ACTION_("Autotune-Diagnostics Retune button clicked", to_string(evt.GetId() - 1))
+	JOURNALED_STAGE_ACTION_("Autotune-Diagnostics Retune button clicked", to_string(evt.GetId() - 1))
 	AutotuneComponentPanel* panel = mapIdToPlotPanel.at(evt.GetId() - 1);
 	panel->ClearAll();
 	diagnostics->Reset();
@@ -319,19 +318,33 @@ void AutotuneDiagnosticsPanel::OnRetuneButtonClicked(wxCommandEvent& evt) {
 
 	StartDiagnostics();
 
-	LOG_ACTION()
+	JOURNALED_LOG_ACTION()
 }
 
 
 AutotuneDiagnosticsPanel::~AutotuneDiagnosticsPanel() {
-	if (diagnosticsThread) {
-		diagnosticsThread->join();
-	}
+	progressTimer.Stop();
+	stepExecutor.Join();
+}
+
+
+void AutotuneDiagnosticsPanel::OnProgressTimer(wxTimerEvent& evt) {
+	ProcedureProgress progress;
+	if (!stepExecutor.TakeProgress(progress))
+		return;
+
+	if (!IsInAccessMode(GuiAccessMode::END_USER))
+		wxLogStatus(to_wx_string(progress.stepSummary));
+	for (auto component : autotuneComponentPanels)
+		component->RefreshAll();
+
+	if (!progress.running)
+		progressTimer.Stop();
 }
 
 
 void AutotuneDiagnosticsPanel::OnSaveFullLogButtonClicked(wxCommandEvent& evt) {
-	STAGE_ACTION("Save Autotune-Diagnostics Full Log button clicked")
+	JOURNALED_STAGE_ACTION("Save Autotune-Diagnostics Full Log button clicked")
 		wxString defaultPath = diagnostics->GetDefaultLogPath_Full();
 	wxString defaultFilename = diagnostics->GetDefaultLogFilename_Full();
 
@@ -339,7 +352,7 @@ void AutotuneDiagnosticsPanel::OnSaveFullLogButtonClicked(wxCommandEvent& evt) {
 
 	if (saveMemoryFileDialog.ShowModal() == wxID_OK) {
 		string path = string(saveMemoryFileDialog.GetPath());
-		STAGE_ACTION_ARGUMENTS(path)
+		JOURNALED_STAGE_ACTION_ARGUMENTS(path)
 
 			// If in higher access mode, save log unencrypted
 			if (GetGUIAccessMode() == GuiAccessMode::SERVICE or GetGUIAccessMode() == GuiAccessMode::FACTORY)
@@ -355,12 +368,12 @@ void AutotuneDiagnosticsPanel::OnSaveFullLogButtonClicked(wxCommandEvent& evt) {
 	else {
 		wxLogStatus(_("Save log file cancelled."));
 	}
-	LOG_ACTION()
+	JOURNALED_LOG_ACTION()
 }
 
 
 void AutotuneDiagnosticsPanel::OnSaveStatisticsLogButtonClicked(wxCommandEvent& evt) {
-	STAGE_ACTION("Save Autotune-Diagnostics Statistics Log button clicked")
+	JOURNALED_STAGE_ACTION("Save Autotune-Diagnostics Statistics Log button clicked")
 		wxString defaultPath = diagnostics->GetDefaultLogPath_Statistics();
 	wxString defaultFilename = diagnostics->GetDefaultLogFilename_Statistics();
 
@@ -368,7 +381,7 @@ void AutotuneDiagnosticsPanel::OnSaveStatisticsLogButtonClicked(wxCommandEvent&
 
 	if (saveMemoryFileDialog.ShowModal() == wxID_OK) {
 		string path = string(saveMemoryFileDialog.GetPath());
-		STAGE_ACTION_ARGUMENTS(path)
+		JOURNALED_STAGE_ACTION_ARGUMENTS(path)
 
 			// If in higher access mode, save log unencrypted
 			if (GetGUIAccessMode() == GuiAccessMode::SERVICE or GetGUIAccessMode() == GuiAccessMode::FACTORY)
@@ -384,7 +397,7 @@ void AutotuneDiagnosticsPanel::OnSaveStatisticsLogButtonClicked(wxCommandEvent&
 	else {
 		wxLogStatus(_("Save log file cancelled."));
 	}
-	LOG_ACTION()
+	JOURNALED_LOG_ACTION()
 }
 
 
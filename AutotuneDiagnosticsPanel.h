@@ -16,8 +16,6 @@
 
 #pragma once
 
-#include <thread>
-
 #include <wx/collpane.h>
 #include <wx/gbsizer.h>
 #include <wx/spinctrl.h>
@@ -29,6 +27,7 @@
 #include "../CommonGUIComponents/DynamicStatusMessage.h"
 #include "../CommonGUIComponents/FeatureTitle.h"
 #include "../CommonGUIComponents/PowerMonitorReadout.h"
+#include "ProcedureExecutor.h"
 
 
 class AutotuneDiagnosticsPanel : public wxPanel {
@@ -56,7 +55,8 @@ private:
     std::shared_ptr<MainLaserControllerInterface> lc;
     std::shared_ptr<AutotuneDiagnostics> diagnostics;
 
-    std::shared_ptr<std::thread> diagnosticsThread = nullptr;
+    ProcedureExecutor stepExecutor;
+    wxTimer progressTimer;
     bool faultDialogShown = false;
 
     wxBoxSizer* sizer;
@@ -83,6 +83,7 @@ private:
     void StartDiagnosticsStepThread();
     void RunFullDiagnostics();
     void CancelDiagnostics();
+    void OnProgressTimer(wxTimerEvent& evt);
 
     // Callbacks
     void OnMainButtonClicked(wxCommandEvent& evt);
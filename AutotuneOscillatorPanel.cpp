@@ -1,5 +1,6 @@
 #include "AutotuneOscillatorPanel.h"
 #include "../CommonFunctions_GUI.h"
+#include "Logging/UserActionJournal.h"
 
 using namespace std;
 
@@ -14,20 +15,6 @@ static wxString START_INDEX_STR = _("Start Index");
 static wxString FINAL_INDEX_STR = _("Final Index");
 
 
-// Handles continuously stepping the Autotune Oscillator procedure
-void StepAutotuneOscillatorThread(shared_ptr<AutotuneOscillatorManager> autotuneOscillator) {
-	while (true) {
-		if (autotuneOscillator->IsRunning()) {
-			autotuneOscillator->Step();
-			if (!IsInAccessMode(GuiAccessMode::END_USER))
-				wxLogStatus(to_wx_string(autotuneOscillator->GetStepSummary()));
-		}
-		else
-			break;
-	}
-}
-
-
 AutotuneOscillatorPanel::AutotuneOscillatorPanel(
 	shared_ptr<MainLaserControllerInterface> _lc,
 	shared_ptr<AutotunePowerManager> autotune_power, 
@@ -41,6 +28,8 @@ AutotuneOscillatorPanel::AutotuneOscillatorPanel(
 
 	this->SetBackgroundColour(FOREGROUND_PANEL_COLOR);
 
+	progressTimer.Bind(wxEVT_TIMER, &AutotuneOscillatorPanel::OnProgressTimer, this, progressTimer.GetId());
+
 	wxBoxSizer* AutotuneOscillatorSizer = new wxBoxSizer(wxVERTICAL);
 
 	// Title
@@ -159,9 +148,8 @@ AutotuneOscillatorPanel::AutotuneOscillatorPanel(
 }
 
 AutotuneOscillatorPanel::~AutotuneOscillatorPanel() {
-	if (autotuneOscillatorThread) {
-		autotuneOscillatorThread->join();
-	}
+	progressTimer.Stop();
+	stepExecutor.Join();
 }
 
 
@@ -194,7 +182,7 @@ void AutotuneOscillatorPanel::RefreshAutotuneProcedure() {
 		DisplayResults();
 		ResetWidgetsWhenAutotuneStops();
 	}
-	// No step block necessary here - the autotuneOscillatorThread takes care of stepping the procedure while running
+	// No step block necessary here - the stepExecutor takes care of stepping the procedure while running
 }
 
 
@@ -264,51 +252,70 @@ void AutotuneOscillatorPanel::Start(bool fullRun) {
 	}
 }
 
+// Steps the Autotune Oscillator procedure on the executor's worker thread.
+//	The step summary is shown by OnProgressTimer(..).
 void AutotuneOscillatorPanel::StartAutotuneStepThread() {
-	if (autotuneOscillatorThread != nullptr) {
-		autotuneOscillatorThread->join();
-	}
-	autotuneOscillatorThread = make_shared<std::thread>(StepAutotuneOscillatorThread, autotuneOscillator);
+	shared_ptr<AutotuneOscillatorManager> autotune = autotuneOscillator;
+	stepExecutor.Start({
+		[autotune] { return autotune->IsRunning(); },
+		[autotune] { autotune->Step(); },
+		[autotune] { return autotune->GetStepSummary(); },
+		[autotune] { autotune->Cancel(); }
+	});
+	progressTimer.Start(PROGRESS_FRAME_INTERVAL_MS);
 }
 
 
 void AutotuneOscillatorPanel::Cancel() {
-	autotuneOscillator->Cancel();
+	stepExecutor.Cancel();
 	runningMessage->Set(_("Canceled"));
 	ResetWidgetsWhenAutotuneStops();
 }
 
 
+void AutotuneOscillatorPanel::OnProgressTimer(wxTimerEvent& evt) {
+	ProcedureProgress progress;
+	if (!stepExecutor.TakeProgress(progress))
+		return;
+
+	if (!IsInAccessMode(GuiAccessMode::END_USER))
+		wxLogStatus(to_wx_string(progress.stepSummary));
+
+	if (!progress.running)
+		progressTimer.Stop();
+}
+
+
 
 //-----------------------------------------------------------------------------
 // Callbacks
 
 void AutotuneOscillatorPanel::OnStartSeedOnlyClicked(wxCommandEvent& evt) {
-	STAGE_ACTION_("Start Autotune-Oscillator button clicked", "Seed Only")
+	JOURNALED_STAGE_ACTION_("Start Autotune-Oscillator button clicked", "Seed Only")
 	Start(false);
-	LOG_ACTION()
+	JOURNALED_LOG_ACTION()
 }
 
 void AutotuneOscillatorPanel::OnStartFullRunClicked(wxCommandEvent& evt) {
-	STAGE_ACTION_("Start Autotune-Oscillator button clicked", "Full Run")
+	JOURNALED_STAGE_ACTION_("Start Autotune-Oscillator button clicked", "Full Run")
 	Start(true);
-	LOG_ACTION()
+	JOURNALED_LOG_ACTION()
 }
 
 void AutotuneOscillatorPanel::OnCancelFullRunClicked(wxCommandEvent& evt) {
-	STAGE_ACTION_("Cancel Autotune-Oscillator button clicked", "Full Run")
+	JOURNALED_STAGE_ACTION_("Cancel Autotune-Oscillator button clicked", "Full Run")
 	Cancel();
-	LOG_ACTION()
+	JOURNALED_LOG_ACTION()
 }
 
 void AutotuneOscillatorPanel::OnCancelSeedOnlyClicked(wxCommandEvent& evt) {
-	STAGE_ACTION_("Cancel Autotune-Oscillator button clicked", "Seed Only")
+	JOURNALED_STAGE_ACTION_("Cancel Autotune-Oscillator button clicked", "Seed Only")
 	Cancel();
-	LOG_ACTION()
+	JOURNALED_LOG_ACTION()
 }
 
 void AutotuneOscillatorPanel::OnSaveLogButtonClicked(wxCommandEvent& evt) {
-	STAGE_ACTION("Save Autotune-Oscillator Log button clicked")
+	JOURNALED_STAGE_ACTION("Save Autotune-Oscillator Log button clicked")
 	wxString defaultPath = autotuneOscillator->GetDefaultLogPath();
 	wxString defaultFilename = autotuneOscillator->GetDefaultLogFilename();
 
@@ -316,7 +323,7 @@ void AutotuneOscillatorPanel::OnSaveLogButtonClicked(wxCommandEvent& evt) {
 
 	if (saveMemoryFileDialog.ShowModal() == wxID_OK) {
 		string path = string(saveMemoryFileDialog.GetPath());
-		STAGE_ACTION_ARGUMENTS(path)
+		JOURNALED_STAGE_ACTION_ARGUMENTS(path)
 
 		// If in higher access mode, save log unencrypted
 		if (GetGUIAccessMode() == GuiAccessMode::SERVICE or GetGUIAccessMode() == GuiAccessMode::FACTORY)
@@ -332,7 +339,7 @@ void AutotuneOscillatorPanel::OnSaveLogButtonClicked(wxCommandEvent& evt) {
 	else {
 		wxLogStatus(_("Save log file cancelled."));
 	}
-	LOG_ACTION()
+	JOURNALED_LOG_ACTION()
 }
 
 
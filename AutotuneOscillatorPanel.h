@@ -1,7 +1,5 @@
 #pragma once
 
-#include <thread>
-
 #include <wx/collpane.h>
 #include <wx/gbsizer.h>
 #include <wx/spinctrl.h>
@@ -11,6 +9,7 @@
 #include "../CommonGUIComponents/FeatureTitle.h"
 #include "LaserControlProcedures/AutotunePower/AutotunePowerManager.h"
 #include "LaserControlProcedures/AutotuneOscillator/AutotuneOscillatorManager.h"
+#include "ProcedureExecutor.h"
 
 
 class AutotuneOscillatorPanel : public wxPanel {
@@ -20,7 +19,8 @@ private:
     std::shared_ptr<AutotunePowerManager> autotunePower;
     std::shared_ptr<AutotuneOscillatorManager> autotuneOscillator;
 
-    std::shared_ptr<std::thread> autotuneOscillatorThread = nullptr;
+    ProcedureExecutor stepExecutor;
+    wxTimer progressTimer;
 
     FeatureTitle* title;
     wxButton* startSeedOnlyButton;
@@ -50,6 +50,7 @@ private:
     void Start(bool fullRun);
     void StartAutotuneStepThread();
     void Cancel();
+    void OnProgressTimer(wxTimerEvent& evt);
 
     // Callbacks
     void OnStartFullRunClicked(wxCommandEvent& evt);
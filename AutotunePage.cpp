@@ -1,6 +1,7 @@
 #include "AutotunePage.h"
 #include "AutotuneComponentPanel.h"
 #include "../CommonFunctions_GUI.h"
+#include "Logging/UserActionJournal.h"
 #include "../AccessCodeDialog.h"
 
 using namespace std;
@@ -91,11 +92,11 @@ void AutotunePage::InitAutotuneDiagnostics() {
 
 
 void AutotunePage::OnGetAutotuneSettingsAccessKeyButtonClicked(wxCommandEvent& evt) {
-	STAGE_ACTION("Generate Autotune Settings access key")
+	JOURNALED_STAGE_ACTION("Generate Autotune Settings access key")
 	wxString code = GenerateOfflinePartialKey(AccessCodeType::AUTOTUNE_SETTINGS);
 	AccessCodeDialog accessCodeDialog(this, code, _(AUTOTUNE_SETTINGS_ACCESS_KEY_MESSAGE_STR));
 	accessCodeDialog.ShowModal();
-	LOG_ACTION()
+	JOURNALED_LOG_ACTION()
 }
 
 
@@ -1,6 +1,9 @@
+#include <filesystem>
+
 #include "AutotunePowerPanel.h"
 #include "Security/AccessByMACAddress.h"
 #include "../CommonFunctions_GUI.h"
+#include "Logging/UserActionJournal.h"
 #include "../CommonGUIComponents/PowerMonitorReadout.h"
 #include "../../CommonUtilities/ConfigurationManager.h"
 
@@ -17,6 +20,11 @@ const wxString AUTOTUNE_POWER_TOOLTIP = _(
 	"  and may need to be run more than once."
 );
 
+// Configuration entry (per serial number) listing which components interact - see AutotuneScheduler.h.
+//	Without it, all components are tuned one after another. With it, the lanes' managers share lc, which
+//	is safe only because they never use it at the same time - see "Sharing lc" in AutotuneScheduler.h.
+const wxString AUTOTUNE_COUPLING_TABLE_KEY = "AutotuneCouplingTable";
+
 const wxString AUTOTUNE_RUNNING_MESSAGE_STR = _("Calibrating");
 const wxString AUTOTUNE_ERROR_STR = _("Calibration Error");
 const wxString CONFIRM_AUTOTUNE_STR = _("Confirm Calibrate Power");
@@ -56,22 +64,6 @@ const wxString TEMPERATURE_RANGE_TOOLTIP = _("Set temperature range from startin
 
 
 
-// Handles continuously stepping the Autotune Power procedure
-void StepAutotunePowerThread(shared_ptr<AutotunePowerManager> autotunePower, vector<AutotuneComponentPanel*> autotuneComponentPanels) {
-	while (true) {
-		if (autotunePower->IsRunning()) {
-			autotunePower->Step();
-			if (!IsInAccessMode(GuiAccessMode::END_USER))
-				wxLogStatus(to_wx_string(autotunePower->GetStepSummary()));
-			for (auto component : autotuneComponentPanels)
-				component->RefreshAll();
-		}
-		else
-			break;
-	}
-}
-
-
 AutotunePowerPanel::AutotunePowerPanel(
 	shared_ptr<MainLaserControllerInterface> laser_controller,
 	shared_ptr<AutotunePowerManager> autotune_power, 
@@ -86,6 +78,8 @@ AutotunePowerPanel::AutotunePowerPanel(
 	this->SetAutoLayout(false);
 	this->SetBackgroundColour(FOREGROUND_PANEL_COLOR);
 
+	progressTimer.Bind(wxEVT_TIMER, &AutotunePowerPanel::OnProgressTimer, this, progressTimer.GetId());
+
 	sizer = new wxBoxSizer(wxVERTICAL);
 
 	title = new FeatureTitle(this, AUTOTUNE_POWER_STR, AUTOTUNE_POWER_TOOLTIP);
@@ -329,12 +323,12 @@ void AutotunePowerPanel::RefreshAll() {
 }
 
 void AutotunePowerPanel::RefreshMainButtonState() {
-	SetTextBasedOnCondition(mainButton, autotunePower->IsRunning(), _(CANCEL_TEXT), _(START_TEXT));
-	SetBGColorBasedOnCondition(mainButton, autotunePower->IsRunning(), TEXT_COLOR_RED, BUTTON_COLOR_INACTIVE);
+	SetTextBasedOnCondition(mainButton, IsAutotuneRunning(), _(CANCEL_TEXT), _(START_TEXT));
+	SetBGColorBasedOnCondition(mainButton, IsAutotuneRunning(), TEXT_COLOR_RED, BUTTON_COLOR_INACTIVE);
 }
 
 void AutotunePowerPanel::RefreshPowerMonitorReadouts() {
-	if (autotunePower->IsRunning()) {
+	if (IsAutotuneRunning()) {
 		// Don't refresh anything while autotune is running - it takes care of refreshes on its own
 	}
 	else
@@ -348,7 +342,7 @@ void AutotunePowerPanel::RefreshPowerMonitorReadouts() {
 void AutotunePowerPanel::RefreshAutotuneControlEnabled() {
 	// Refresh main autotune power button enable state
 
-	if (autotunePower->IsRunning()) {
+	if (IsAutotuneRunning()) {
 		// Can always cancel Autotune at any time
 		RefreshWidgetEnableBasedOnCondition(mainButton, true);
 	}
@@ -388,9 +382,11 @@ void AutotunePowerPanel::RefreshAutotuneProcedure() {
 
 	if (startAutotuneTriggered) {
 
-		if (autotunePower->IsFinished()) {
+		if (autotunePower->IsFinished() and LanesFinished()) {
 
 			wxLogStatus(to_wx_string(autotunePower->GetSummary()));
+			for (auto manager : laneManagers)
+				wxLogStatus(to_wx_string(manager->GetSummary()));
 			runningMessage->Set(_("Finished."));
 			runningMessage->StopCycling();
 			
@@ -404,7 +400,10 @@ void AutotunePowerPanel::RefreshAutotuneProcedure() {
 
 			RefreshPanels();
 		}
-		else if (autotunePower->IsError()) {
+		else if (shared_ptr<AutotunePowerManager> failedManager = GetFailedManager()) {
+
+			// Stop the other lanes of a parallel run
+			stepExecutor.Cancel();
 
 			if (lc->HasHardFault() or lc->HasSoftFault()) {
 				// Only show the dialog once
@@ -415,7 +414,7 @@ void AutotunePowerPanel::RefreshAutotuneProcedure() {
 				}
 			}
 			else
-				runningMessage->Set(_("ERROR - ") + autotunePower->GetErrorMessage());
+				runningMessage->Set(_("ERROR - ") + failedManager->GetErrorMessage());
 
 			runningMessage->StopCycling();
 
@@ -429,8 +428,8 @@ void AutotunePowerPanel::RefreshAutotuneProcedure() {
 
 			RefreshPanels();
 		}
-		else if (autotunePower->IsRunning()) {
-			runningMessage->Set(_(AUTOTUNE_RUNNING_MESSAGE_STR) + " - " + to_wx_string(autotunePower->GetProgressPercentage()) + "%");
+		else if (IsAutotuneRunning()) {
+			runningMessage->Set(_(AUTOTUNE_RUNNING_MESSAGE_STR) + " - " + to_wx_string(GetProgressPercentage()) + "%");
 		}
 	}
 }
@@ -449,20 +448,58 @@ void AutotunePowerPanel::RefreshPanels() {
 
 void AutotunePowerPanel::RunFullAutotune() {
 	autotunePower->Reset();
+	laneManagers.clear();
 
 	for (auto panel : autotuneComponentPanels)
 		panel->ClearAll();
 
-	for (auto data : autotunePowerTuneData) {
-		if (data->type == "Motor")
-			autotunePower->AddMotorComponent(data);
-		else
-			autotunePower->AddTemperatureComponent(data);
+	// Components that don't interact are tuned at the same time, by one manager per lane.
+	//	autotunePower tunes the first lane.
+	vector<vector<size_t>> lanes = PlanLanes();
+	for (size_t i = 0; i < lanes.size(); i++) {
+		shared_ptr<AutotunePowerManager> manager = autotunePower;
+		if (i > 0) {
+			manager = make_shared<AutotunePowerManager>(lc);
+			laneManagers.push_back(manager);
+		}
+		for (size_t component : lanes[i]) {
+			shared_ptr<PowerTuneData> data = autotunePowerTuneData[component];
+			if (data->type == "Motor")
+				manager->AddMotorComponent(data);
+			else
+				manager->AddTemperatureComponent(data);
+		}
 	}
 	StartAutotune();
 }
 
 
+// Lanes of autotunePowerTuneData indices. One lane if no coupling table is configured.
+vector<vector<size_t>> AutotunePowerPanel::PlanLanes() {
+	vector<AutotuneSchedulerComponent> components;
+	for (auto data : autotunePowerTuneData)
+		components.push_back({ data->pmId, data->type + " " + to_string(data->componentId) });
+
+	AutotuneCouplingTable coupling;
+	wxString couplingTableKey = AUTOTUNE_COUPLING_TABLE_KEY + "_" + lc->GetSerialNumber();
+	bool parallel = ConfigurationManager::GetInstance().Exists(couplingTableKey);
+	if (parallel) {
+		wxString couplingTable = ConfigurationManager::GetInstance().Get(couplingTableKey);
+		parallel = AutotuneCouplingTable::Parse(couplingTable.ToStdString(), coupling);
+		if (!parallel)
+			wxLogStatus(_("Invalid Autotune coupling table - tuning components one after another"));
+	}
+
+	if (!parallel) {
+		vector<size_t> allComponents;
+		for (size_t i = 0; i < components.size(); i++)
+			allComponents.push_back(i);
+		return { allComponents };
+	}
+	return PlanAutotuneLanes(components, coupling);
+}
+
+
 void AutotunePowerPanel::StartAutotune() {
 
 	autotunePower->Start();
@@ -481,6 +518,8 @@ void AutotunePowerPanel::StartAutotune() {
 			if (cantStartDialog.ShowModal() == wxID_YES) {
 				autotunePower->EnableStartOverride();
 				autotunePower->Start();
+				for (auto manager : laneManagers)
+					manager->EnableStartOverride();
 			}
 			else {
 				runningMessage->Set(_("ERROR"));
@@ -497,6 +536,9 @@ void AutotunePowerPanel::StartAutotune() {
 		}
 
 	}
+	for (auto manager : laneManagers)
+		manager->Start();
+
 	runningMessage->Show();
 	runningMessage->Set(_(AUTOTUNE_RUNNING_MESSAGE_STR));
 	runningMessage->StartCycling();
@@ -516,16 +558,76 @@ void AutotunePowerPanel::StartAutotune() {
 }
 
 
+// Steps the Autotune Power procedure of each lane on the executor's worker thread,
+//	in turns, with each component publishing its progress after each round.
+//	Component panels and the step summary are refreshed by OnProgressTimer(..).
 void AutotunePowerPanel::StartAutotuneStepThread() {
-	if (autotunePowerThread != nullptr) {
-		autotunePowerThread->join();
+	vector<ProcedureExecutor::Procedure> laneProcedures;
+	vector<shared_ptr<AutotunePowerManager>> managers = { autotunePower };
+	managers.insert(managers.end(), laneManagers.begin(), laneManagers.end());
+	for (shared_ptr<AutotunePowerManager> autotune : managers) {
+		laneProcedures.push_back({
+			[autotune] { return autotune->IsRunning(); },
+			[autotune] { autotune->Step(); },
+			[autotune] { return autotune->GetStepSummary(); },
+			[autotune] { autotune->Cancel(); }
+		});
 	}
-	autotunePowerThread = make_shared<std::thread>(StepAutotunePowerThread, autotunePower, autotuneComponentPanels);
+
+	shared_ptr<AutotuneLaneStepper> stepper = make_shared<AutotuneLaneStepper>(laneProcedures);
+	laneStepper = stepper;
+	vector<AutotuneComponentPanel*> components = autotuneComponentPanels;
+	stepExecutor.Start({
+		[stepper] { return stepper->IsRunning(); },
+		[stepper, components] {
+			stepper->Step();
+			for (auto component : components)
+				component->PublishPowerProgress();
+		},
+		[stepper] { return stepper->GetStepSummary(); },
+		[stepper] { stepper->Cancel(); }
+	});
+	progressTimer.Start(PROGRESS_FRAME_INTERVAL_MS);
+}
+
+
+bool AutotunePowerPanel::IsAutotuneRunning() {
+	if (autotunePower->IsRunning())
+		return true;
+	for (auto manager : laneManagers)
+		if (manager->IsRunning())
+			return true;
+	return false;
+}
+
+bool AutotunePowerPanel::LanesFinished() {
+	for (auto manager : laneManagers)
+		if (!manager->IsFinished())
+			return false;
+	return true;
+}
+
+// The manager of the first lane that stopped with an error, if any
+shared_ptr<AutotunePowerManager> AutotunePowerPanel::GetFailedManager() {
+	if (autotunePower->IsError())
+		return autotunePower;
+	for (auto manager : laneManagers)
+		if (manager->IsError())
+			return manager;
+	return nullptr;
+}
+
+// Mean progress of all lanes
+int AutotunePowerPanel::GetProgressPercentage() {
+	int progressSum = autotunePower->GetProgressPercentage();
+	for (auto manager : laneManagers)
+		progressSum += manager->GetProgressPercentage();
+	return progressSum / int(laneManagers.size() + 1);
 }
 
 
 void AutotunePowerPanel::CancelAutotune() {
-	autotunePower->Cancel();
+	stepExecutor.Cancel();
 	runningMessage->Set(_("Canceled"));
 	runningMessage->StopCycling();
 	saveLogButton->Show();
@@ -552,37 +654,37 @@ void AutotunePowerPanel::SetTemperaturePrecisionTooltip() {
 }
 
 void AutotunePowerPanel::SetDropThreshold() {
-	STAGE_ACTION("Set Autotune Power Drop Threshold");
+	JOURNALED_STAGE_ACTION("Set Autotune Power Drop Threshold");
 	int newThreshold = dropThresholdSpinCtrl->GetValue();
-	STAGE_ACTION_ARGUMENTS(to_string(newThreshold));
+	JOURNALED_STAGE_ACTION_ARGUMENTS(to_string(newThreshold));
 	lc->SetAutotunePowerDropThreshold(newThreshold);
 	newThreshold = lc->GetAutotunePowerDropThreshold();
 	dropThresholdSpinCtrl->SetValue(newThreshold);
 	wxLogStatus("---New Power Drop Threshold Set: " + to_wx_string(newThreshold) + _(" percent"));
-	LOG_ACTION();
+	JOURNALED_LOG_ACTION();
 }
 
 void AutotunePowerPanel::SetMotorRange() {
-	STAGE_ACTION("Set Autotune Motor Range");
+	JOURNALED_STAGE_ACTION("Set Autotune Motor Range");
 	int newRange = motorRangeSpinCtrl->GetValue();
-	STAGE_ACTION_ARGUMENTS(to_string(newRange));
+	JOURNALED_STAGE_ACTION_ARGUMENTS(to_string(newRange));
 	lc->SetAutotuneMotorRange(newRange);
 	newRange = lc->GetAutotuneMotorRange();
 	motorRangeSpinCtrl->SetValue(newRange);
 	wxLogStatus("---New Motor Range Set: " + to_wx_string(newRange));
-	LOG_ACTION();
+	JOURNALED_LOG_ACTION();
 }
 
 void AutotunePowerPanel::SetTemperatureRange(float newRange) {
-	STAGE_ACTION("Set Autotune Temperature Range");
+	JOURNALED_STAGE_ACTION("Set Autotune Temperature Range");
 	if (newRange < 0.0f)
 		newRange = temperatureRangeSpinCtrlDouble->GetValue();
-	STAGE_ACTION_ARGUMENTS(to_string_with_precision(newRange, 1));
+	JOURNALED_STAGE_ACTION_ARGUMENTS(to_string_with_precision(newRange, 1));
 	lc->SetAutotuneTemperatureRange(newRange);
 	newRange = lc->GetAutotuneTemperatureRange();
 	temperatureRangeSpinCtrlDouble->SetValue(newRange);
 	wxLogStatus("---New Temperature Range Set: " + to_wx_string(newRange, 1));
-	LOG_ACTION();
+	JOURNALED_LOG_ACTION();
 }
 
 
@@ -591,8 +693,8 @@ void AutotunePowerPanel::SetTemperatureRange(float newRange) {
 // Callbacks
 
 void AutotunePowerPanel::OnMainButtonClicked(wxCommandEvent& evt) {
-	STAGE_ACTION("Main Autotune-Power button clicked")
-	if (autotunePower->IsRunning())
+	JOURNALED_STAGE_ACTION("Main Autotune-Power button clicked")
+	if (IsAutotuneRunning())
 		CancelAutotune();
 	else {
 		wxString msg = _(CONFIRM_AUTOTUNE_MESSAGE);
@@ -600,23 +702,24 @@ void AutotunePowerPanel::OnMainButtonClicked(wxCommandEvent& evt) {
 		confirmAutotuneDialog.SetOKLabel(_("Yes"));
 		if (confirmAutotuneDialog.ShowModal() == wxID_OK) {
 			RunFullAutotune();
-			STAGE_ACTION_ARGUMENTS("Confirmed");
+			JOURNALED_STAGE_ACTION_ARGUMENTS("Confirmed");
 		}
 		else {
-			STAGE_ACTION_ARGUMENTS("Cancelled");
+			JOURNALED_STAGE_ACTION_ARGUMENTS("Cancelled");
 		}
 	}
-	LOG_ACTION()
+	JOURNALED_LOG_ACTION()
 }
 
 
 // Assumes the individual component panel already reset the 
 // Autotune Power Manager and added only itself for the next run
 void AutotunePowerPanel::OnRetuneButtonClicked(wxCommandEvent& evt) {
-	STAGE_ACTION_("Autotune-Power Retune button clicked", to_string(evt.GetId()))
+	JOURNALED_STAGE_ACTION_("Autotune-Power Retune button clicked", to_string(evt.GetId()))
 	AutotuneComponentPanel* panel = mapIdToPlotPanel.at(evt.GetId());
 	panel->ClearAll();
 	autotunePower->Reset();
+	laneManagers.clear();
 	if (panel->data->type == MOTOR_STR)
 		autotunePower->AddMotorComponent(panel->data);
 	else
@@ -624,19 +727,37 @@ void AutotunePowerPanel::OnRetuneButtonClicked(wxCommandEvent& evt) {
 
 	StartAutotune();
 
-	LOG_ACTION()
+	JOURNALED_LOG_ACTION()
 }
 
 
 AutotunePowerPanel::~AutotunePowerPanel() {
-	if (autotunePowerThread) {
-		autotunePowerThread->join();
+	progressTimer.Stop();
+	stepExecutor.Join();
+}
+
+
+void AutotunePowerPanel::OnProgressTimer(wxTimerEvent& evt) {
+	ProcedureProgress progress;
+	if (!stepExecutor.TakeProgress(progress))
+		return;
+
+	if (!IsInAccessMode(GuiAccessMode::END_USER))
+		wxLogStatus(to_wx_string(progress.stepSummary));
+	for (auto component : autotuneComponentPanels)
+		component->RefreshAll();
+
+	if (!progress.running) {
+		progressTimer.Stop();
+		// The last snapshot comes after the last step, so the lane timing is complete
+		if (laneStepper and laneStepper->GetLaneCount() > 1)
+			wxLogStatus(to_wx_string(laneStepper->GetTimingReport()));
 	}
 }
 
 
 void AutotunePowerPanel::OnSaveLogButtonClicked(wxCommandEvent& evt) {
-	STAGE_ACTION("Save Autotune-Power Log button clicked")
+	JOURNALED_STAGE_ACTION("Save Autotune-Power Log button clicked")
 	wxString defaultPath = autotunePower->GetDefaultLogPath();
 	wxString defaultFilename = autotunePower->GetDefaultLogFilename();
 
@@ -644,53 +765,68 @@ void AutotunePowerPanel::OnSaveLogButtonClicked(wxCommandEvent& evt) {
 
 	if (saveMemoryFileDialog.ShowModal() == wxID_OK) {
 		string path = string(saveMemoryFileDialog.GetPath());
-		STAGE_ACTION_ARGUMENTS(path)
+		JOURNALED_STAGE_ACTION_ARGUMENTS(path)
+
+		// Each lane of a parallel run has its own log, saved next to the first
+		//	lane's with its lane number, e.g. "Autotune_Lane2.log"
+		vector<shared_ptr<AutotunePowerManager>> managers = { autotunePower };
+		managers.insert(managers.end(), laneManagers.begin(), laneManagers.end());
+		bool saved = true;
+		for (size_t i = 0; i < managers.size(); i++) {
+			string lanePath = path;
+			if (i > 0) {
+				filesystem::path firstLanePath(path);
+				lanePath = (firstLanePath.parent_path() / (firstLanePath.stem().string() + "_Lane" + to_string(i + 1) +
+					firstLanePath.extension().string())).string();
+			}
 
-		// If in higher access mode, save log unencrypted
-		if (GetGUIAccessMode() == GuiAccessMode::SERVICE or GetGUIAccessMode() == GuiAccessMode::FACTORY)
-			autotunePower->SaveLog(path);
-		else
-			autotunePower->SaveLogEncrypted(path);
+			// If in higher access mode, save log unencrypted
+			if (GetGUIAccessMode() == GuiAccessMode::SERVICE or GetGUIAccessMode() == GuiAccessMode::FACTORY)
+				managers[i]->SaveLog(lanePath);
+			else
+				managers[i]->SaveLogEncrypted(lanePath);
+			saved = saved and managers[i]->SaveLogSuccessful();
+		}
 
-		if (autotunePower->SaveLogSuccessful())
-			wxLogStatus(_("Save successful."));
+		if (saved)
+			wxLogStatus(managers.size() > 1 ? _("Save successful - one log per lane.") : _("Save successful."));
 		else
 			wxLogStatus(_("Save failed."));
 	}
 	else {
 		wxLogStatus(_("Save log file cancelled."));
 	}
-	LOG_ACTION()
+	JOURNALED_LOG_ACTION()
 }
 
 void AutotunePowerPanel::OnSettingsCollapse(wxCollapsiblePaneEvent& evt) {
-	STAGE_ACTION("Autotune-Power settings collapse button clicked")
+	JOURNALED_STAGE_ACTION("Autotune-Power settings collapse button clicked")
 	RefreshPanels();
-	LOG_ACTION()
+	JOURNALED_LOG_ACTION()
 }
 
 void AutotunePowerPanel::OnSpeedSliderMoved(wxCommandEvent& evt) {
-	STAGE_ACTION("Autotune-Power speed slider moved")
+	JOURNALED_STAGE_ACTION("Autotune-Power speed slider moved")
 	int newSpeedLevel = speedSlider->GetValue();
-	STAGE_ACTION_ARGUMENTS(to_string(newSpeedLevel))
+	JOURNALED_STAGE_ACTION_ARGUMENTS(to_string(newSpeedLevel))
 	lc->SetAutotuneSpeedLevel(newSpeedLevel);
-	LOG_ACTION()
+	JOURNALED_LOG_ACTION()
 }
 
 void AutotunePowerPanel::OnPrecisionSliderMoved_Motor(wxCommandEvent& evt) {
-	STAGE_ACTION("Autotune-Power motor precision slider moved")
+	JOURNALED_STAGE_ACTION("Autotune-Power motor precision slider moved")
 	int newPrecisionLevel = precisionSlider_Motor->GetValue();
-	STAGE_ACTION_ARGUMENTS(to_string(newPrecisionLevel))
+	JOURNALED_STAGE_ACTION_ARGUMENTS(to_string(newPrecisionLevel))
 	lc->SetAutotuneMotorPrecisionLevel(newPrecisionLevel);
-	LOG_ACTION()
+	JOURNALED_LOG_ACTION()
 }
 
 void AutotunePowerPanel::OnPrecisionSliderMoved_Temperature(wxCommandEvent& evt) {
-	STAGE_ACTION("Autotune-Power temperature precision slider moved")
+	JOURNALED_STAGE_ACTION("Autotune-Power temperature precision slider moved")
 	int newPrecisionLevel = precisionSlider_Temperature->GetValue();
-	STAGE_ACTION_ARGUMENTS(to_string(newPrecisionLevel))
+	JOURNALED_STAGE_ACTION_ARGUMENTS(to_string(newPrecisionLevel))
 	lc->SetAutotuneTemperaturePrecisionLevel(newPrecisionLevel);
-	LOG_ACTION()
+	JOURNALED_LOG_ACTION()
 }
 
 void AutotunePowerPanel::SetDropThresholdWithText(wxCommandEvent& evt) {
@@ -19,8 +19,6 @@
 
 #pragma once
 
-#include <thread>
-
 #include <wx/collpane.h>
 #include <wx/gbsizer.h>
 #include <wx/spinctrl.h>
@@ -30,6 +28,8 @@
 #include "../CommonGUIComponents/DynamicStatusMessage.h"
 #include "../CommonGUIComponents/FeatureTitle.h"
 #include "../CommonGUIComponents/PowerMonitorReadout.h"
+#include "AutotuneScheduler.h"
+#include "ProcedureExecutor.h"
 #include "LaserControlProcedures/AutotunePower/AutotunePowerManager.h"
 #include "LaserControlProcedures/AutotuneOscillator/AutotuneOscillatorManager.h"
 
@@ -63,7 +63,11 @@ private:
     std::shared_ptr<AutotunePowerManager> autotunePower;
     std::shared_ptr<AutotuneOscillatorManager> autotuneOscillator;
 
-    std::shared_ptr<std::thread> autotunePowerThread = nullptr;
+    ProcedureExecutor stepExecutor;
+    wxTimer progressTimer;
+    // Managers of the other lanes of a parallel run (autotunePower tunes the first)
+    std::vector<std::shared_ptr<AutotunePowerManager>> laneManagers;
+    std::shared_ptr<AutotuneLaneStepper> laneStepper;
     bool faultDuringAutotuneDialogShown = false;
 
     wxBoxSizer* sizer;
@@ -134,6 +138,14 @@ private:
     void StartAutotuneStepThread();
     void RunFullAutotune();
     void CancelAutotune();
+    void OnProgressTimer(wxTimerEvent& evt);
+
+    // Parallel lanes
+    std::vector<std::vector<size_t>> PlanLanes();
+    bool IsAutotuneRunning();
+    bool LanesFinished();
+    std::shared_ptr<AutotunePowerManager> GetFailedManager();
+    int GetProgressPercentage();
 
     // Helper functions
     void SetMotorPrecisionTooltip();
@@ -0,0 +1,70 @@
+#include <memory>
+
+#include "AutotuneProgressChannel.h"
+
+using namespace std;
+
+
+AutotuneProgressChannel::~AutotuneProgressChannel() {
+	delete latest.exchange(nullptr);
+}
+
+
+//-------------------------------------------------------------------------
+// Step thread
+
+AutotuneProgressSnapshot& AutotuneProgressChannel::BeginUpdate() {
+	if (restartRequested.exchange(false, memory_order_acquire))
+		StartOver();
+	working.newPoints.clear();
+	return working;
+}
+
+void AutotuneProgressChannel::StartOver() {
+	unsigned long long attempt = working.attempt + 1;
+	unsigned long long version = working.version;
+	working = AutotuneProgressSnapshot();
+	working.attempt = attempt;
+	working.version = version;
+	publishedPointCount = 0;
+}
+
+void AutotuneProgressChannel::AddPoint(double x, double power) {
+	working.newPoints.push_back({ x, power });
+}
+
+void AutotuneProgressChannel::Publish() {
+	working.version++;
+	auto snapshot = make_unique<AutotuneProgressSnapshot>(working);
+	snapshot->pointOffset = publishedPointCount;
+	publishedPointCount += working.newPoints.size();
+
+	// Take back the snapshot the UI didn't take yet, and carry its points
+	// over. Only this thread puts snapshots into the slot, so it stays
+	// empty until the store below.
+	unique_ptr<AutotuneProgressSnapshot> untaken(latest.exchange(nullptr, memory_order_acquire));
+	if (untaken and untaken->attempt == snapshot->attempt) {
+		untaken->newPoints.insert(untaken->newPoints.end(), snapshot->newPoints.begin(), snapshot->newPoints.end());
+		snapshot->newPoints.swap(untaken->newPoints);
+		snapshot->pointOffset = untaken->pointOffset;
+	}
+
+	latest.store(snapshot.release(), memory_order_release);
+}
+
+
+//-------------------------------------------------------------------------
+// UI thread
+
+bool AutotuneProgressChannel::Take(AutotuneProgressSnapshot& snapshot) {
+	unique_ptr<AutotuneProgressSnapshot> taken(latest.exchange(nullptr, memory_order_acquire));
+	if (!taken)
+		return false;
+	snapshot = move(*taken);
+	return true;
+}
+
+void AutotuneProgressChannel::Restart() {
+	restartRequested.store(true, memory_order_release);
+	delete latest.exchange(nullptr, memory_order_acquire);
+}
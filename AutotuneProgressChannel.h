@@ -0,0 +1,122 @@
+/**
+* Autotune Progress Channel - Hands the progress of one component's autotune
+*	run (Autotune-Power or Autotune-Diagnostics) from the step thread to the
+*	UI thread as immutable snapshots.
+*
+* - The step thread is the only one that changes a component's tuning data,
+*	so it copies what the panel shows into the channel's working state
+*	after each step and publishes it. The UI thread never reads the live
+*	tuning data while a run is stepping.
+* - Each published snapshot is a new object, swapped into a single slot.
+*	The UI takes the latest one - a snapshot it didn't take in time is
+*	replaced, never queued - but the points measured since the last
+*	snapshot taken are carried over into its replacement, so the panel
+*	gets every point exactly once and only appends the new ones.
+* - A run, or a retune attempt within a run, is an attempt. Points and
+*	start values of an earlier attempt no longer apply when the attempt
+*	number changes.
+*
+* Example usage:
+*
+*	// Step thread, after Step()
+*	AutotuneProgressSnapshot& state = channel.BeginUpdate();
+*	state.progressPercentage = data->progressPercentage;
+*	channel.AddPoint(data->currentIndex, data->currentPower);
+*	channel.Publish();
+*
+*	// UI thread
+*	AutotuneProgressSnapshot snapshot;
+*	if (channel.Take(snapshot))
+*		for (const AutotunePoint& point : snapshot.newPoints)
+*			canvas->AddPoint(point.x, point.power);
+*
+* @file AutotuneProgressChannel.h
+* @created October 2026
+* @version 1.0
+*/
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <string>
+#include <vector>
+
+
+// A measured (setting, power) point of a tuning curve
+struct AutotunePoint {
+	double x;
+	double power;
+};
+
+
+// What a component's autotune looked like after a step
+struct AutotuneProgressSnapshot {
+	// Increases with each published snapshot
+	unsigned long long version = 0;
+	// Increases when the run starts over (see AutotuneProgressChannel::StartOver())
+	unsigned long long attempt = 0;
+
+	bool running = false;
+	bool finished = false;
+	bool error = false;
+	bool retuning = false;
+	int progressPercentage = 0;
+	std::string status;
+
+	// Start values are set
+	bool started = false;
+	double startX = 0;
+	double startPower = 0;
+	// The run stopped. Final values are set if it finished.
+	bool stopped = false;
+	double finalX = 0;
+	double finalPower = 0;
+
+	// Diagnostics results (forward, backward, difference), once finished
+	std::array<double, 3> fittedMaxPower{};
+	std::array<double, 3> fittedMaxLoc{};
+
+	// Points of this attempt measured since the previous snapshot taken
+	std::vector<AutotunePoint> newPoints;
+	// How many points of this attempt came before newPoints
+	size_t pointOffset = 0;
+};
+
+
+class AutotuneProgressChannel {
+
+public:
+	AutotuneProgressChannel() = default;
+	~AutotuneProgressChannel();
+	AutotuneProgressChannel(const AutotuneProgressChannel&) = delete;
+	AutotuneProgressChannel& operator=(const AutotuneProgressChannel&) = delete;
+
+	// Step thread. The working state to fill in for the next snapshot. It
+	//   keeps its values between updates, except newPoints, which starts
+	//   empty. Starts over if the UI asked for it with Restart().
+	AutotuneProgressSnapshot& BeginUpdate();
+	// Step thread. Start a new attempt: the working state is reset.
+	void StartOver();
+	// Step thread. A point measured in this update.
+	void AddPoint(double x, double power);
+	// Step thread. Publish the working state as the latest snapshot.
+	void Publish();
+
+	// UI thread. Take the latest snapshot, if one was published since the
+	//   last call.
+	bool Take(AutotuneProgressSnapshot& snapshot);
+	// UI thread. Drop the snapshot not taken yet, and have the step thread
+	//   start over with its next update. Call before a new run starts.
+	void Restart();
+
+
+private:
+	// Step thread only
+	AutotuneProgressSnapshot working;
+	size_t publishedPointCount = 0;
+
+	std::atomic<bool> restartRequested{ false };
+	// Newest snapshot not taken yet, owned by the channel
+	std::atomic<AutotuneProgressSnapshot*> latest{ nullptr };
+
+};
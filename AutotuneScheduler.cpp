@@ -0,0 +1,211 @@
+#include <algorithm>
+#include <cstdio>
+#include <map>
+#include <numeric>
+
+#include "AutotuneScheduler.h"
+
+using namespace std;
+
+
+static string Trim(const string& text) {
+	size_t start = text.find_first_not_of(" \t");
+	if (start == string::npos)
+		return "";
+	size_t end = text.find_last_not_of(" \t");
+	return text.substr(start, end - start + 1);
+}
+
+static string GetPowerMonitorKey(int pm_id) {
+	return "PM " + to_string(pm_id);
+}
+
+static double ToSeconds(chrono::steady_clock::duration duration) {
+	return chrono::duration<double>(duration).count();
+}
+
+
+//-------------------------------------------------------------------------
+// AutotuneCouplingTable
+
+bool AutotuneCouplingTable::Parse(const string& text, AutotuneCouplingTable& table) {
+	table.couplings.clear();
+
+	size_t start = 0;
+	while (start <= text.size()) {
+		size_t end = text.find(';', start);
+		if (end == string::npos)
+			end = text.size();
+		string pair = Trim(text.substr(start, end - start));
+		start = end + 1;
+		if (pair.empty())
+			continue;
+
+		size_t dash = pair.find('-');
+		if (dash == string::npos)
+			return false;
+		string keyA = Trim(pair.substr(0, dash));
+		string keyB = Trim(pair.substr(dash + 1));
+		if (keyA.empty() or keyB.empty() or keyB.find('-') != string::npos)
+			return false;
+		table.AddCoupling(keyA, keyB);
+	}
+	return true;
+}
+
+void AutotuneCouplingTable::AddCoupling(const string& key_a, const string& key_b) {
+	couplings.insert(minmax(key_a, key_b));
+}
+
+bool AutotuneCouplingTable::AreCoupled(const AutotuneSchedulerComponent& a, const AutotuneSchedulerComponent& b) const {
+	if (a.pmId == b.pmId)
+		return true;
+
+	string pmKeyA = GetPowerMonitorKey(a.pmId);
+	string pmKeyB = GetPowerMonitorKey(b.pmId);
+	return HasCoupling(a.key, b.key) or HasCoupling(a.key, pmKeyB) or
+		HasCoupling(pmKeyA, b.key) or HasCoupling(pmKeyA, pmKeyB);
+}
+
+bool AutotuneCouplingTable::HasCoupling(const string& key_a, const string& key_b) const {
+	return couplings.count(minmax(key_a, key_b)) > 0;
+}
+
+
+//-------------------------------------------------------------------------
+
+vector<vector<size_t>> PlanAutotuneLanes(const vector<AutotuneSchedulerComponent>& components,
+	const AutotuneCouplingTable& coupling) {
+
+	// Components coupled directly or through others end up with the same root
+	vector<size_t> roots(components.size());
+	iota(roots.begin(), roots.end(), 0);
+	auto findRoot = [&](size_t component) {
+		while (roots[component] != component)
+			component = roots[component] = roots[roots[component]];
+		return component;
+	};
+	for (size_t i = 0; i < components.size(); i++)
+		for (size_t j = i + 1; j < components.size(); j++)
+			if (coupling.AreCoupled(components[i], components[j]))
+				roots[max(findRoot(i), findRoot(j))] = min(findRoot(i), findRoot(j));
+
+	vector<vector<size_t>> lanes;
+	map<size_t, size_t> laneOfRoot;
+	for (size_t i = 0; i < components.size(); i++) {
+		size_t root = findRoot(i);
+		auto lane = laneOfRoot.find(root);
+		if (lane == laneOfRoot.end()) {
+			lane = laneOfRoot.emplace(root, lanes.size()).first;
+			lanes.emplace_back();
+		}
+		lanes[lane->second].push_back(i);
+	}
+	return lanes;
+}
+
+
+//-------------------------------------------------------------------------
+// AutotuneLaneStepper
+
+AutotuneLaneStepper::AutotuneLaneStepper(const vector<ProcedureExecutor::Procedure>& lane_procedures) {
+	for (const ProcedureExecutor::Procedure& procedure : lane_procedures) {
+		Lane lane;
+		lane.procedure = procedure;
+		lanes.push_back(lane);
+	}
+}
+
+bool AutotuneLaneStepper::IsRunning() {
+	Begin();
+	UpdateRunningLanes();
+	return any_of(lanes.begin(), lanes.end(), [](const Lane& lane) { return lane.running; });
+}
+
+void AutotuneLaneStepper::Step() {
+	Begin();
+	UpdateRunningLanes();
+	stepSummary.clear();
+
+	for (size_t i = 0; i < lanes.size(); i++) {
+		Lane& lane = lanes[i];
+		if (!lane.running)
+			continue;
+
+		auto stepStartTime = chrono::steady_clock::now();
+		lane.procedure.step();
+		auto stepTime = chrono::steady_clock::now() - stepStartTime;
+		for (size_t j = 0; j < lanes.size(); j++)
+			if (j != i and lanes[j].running)
+				lanes[j].otherLanesStepTime += stepTime;
+
+		if (lane.procedure.getStepSummary) {
+			if (!stepSummary.empty())
+				stepSummary += "; ";
+			if (lanes.size() > 1)
+				stepSummary += "Lane " + to_string(i + 1) + ": ";
+			stepSummary += lane.procedure.getStepSummary();
+		}
+	}
+}
+
+string AutotuneLaneStepper::GetStepSummary() const {
+	return stepSummary;
+}
+
+// Called from the UI thread - only uses what doesn't change while stepping
+void AutotuneLaneStepper::Cancel() {
+	for (const Lane& lane : lanes)
+		if (lane.procedure.cancel)
+			lane.procedure.cancel();
+}
+
+size_t AutotuneLaneStepper::GetLaneCount() const {
+	return lanes.size();
+}
+
+chrono::steady_clock::duration AutotuneLaneStepper::GetWallTime() const {
+	if (!started)
+		return chrono::steady_clock::duration::zero();
+	return endTime - startTime;
+}
+
+chrono::steady_clock::duration AutotuneLaneStepper::GetSequentialTime() const {
+	chrono::steady_clock::duration sequentialTime{ 0 };
+	for (const Lane& lane : lanes)
+		sequentialTime += max(lane.elapsed - lane.otherLanesStepTime, chrono::steady_clock::duration::zero());
+	return sequentialTime;
+}
+
+string AutotuneLaneStepper::GetTimingReport() const {
+	double wallSeconds = ToSeconds(GetWallTime());
+	char report[160];
+	if (lanes.size() <= 1)
+		snprintf(report, sizeof(report), "1 lane: %.1f s", wallSeconds);
+	else {
+		double sequentialSeconds = ToSeconds(GetSequentialTime());
+		snprintf(report, sizeof(report), "%zu lanes in parallel: %.1f s (about %.1f s one after another, %.1f s saved)",
+			lanes.size(), wallSeconds, sequentialSeconds, max(sequentialSeconds - wallSeconds, 0.0));
+	}
+	return report;
+}
+
+void AutotuneLaneStepper::Begin() {
+	if (started)
+		return;
+	started = true;
+	startTime = chrono::steady_clock::now();
+	endTime = startTime;
+}
+
+// Record when lanes stop
+void AutotuneLaneStepper::UpdateRunningLanes() {
+	auto now = chrono::steady_clock::now();
+	for (Lane& lane : lanes) {
+		if (lane.running and !lane.procedure.isRunning()) {
+			lane.running = false;
+			lane.elapsed = now - startTime;
+			endTime = now;
+		}
+	}
+}
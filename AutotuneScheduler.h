@@ -0,0 +1,143 @@
+/**
+* Autotune Scheduler - Tunes components that don't interact at the same time.
+*
+* - Components that read the same power monitor always interact. Others
+*	interact only if the coupling table says so, by power monitor
+*	("PM 1 - PM 2") or by component ("Temperature 3 - Motor 1").
+* - PlanAutotuneLanes(..) splits the components into lanes: components
+*	that interact, directly or through others, share a lane and are tuned
+*	one after another in their original order. Different lanes are tuned
+*	at the same time, each by its own procedure (e.g. AutotunePowerManager).
+* - AutotuneLaneStepper steps the lanes on one thread, one step of each
+*	running lane per round, so the commands of different lanes are sent in
+*	turns and never overlap on the serial link. A lane waiting for its
+*	temperature to settle costs the others almost nothing.
+* - The stepper keeps each lane's time, less the time spent stepping the
+*	other lanes, to estimate how long the lanes would have taken one after
+*	another - the wall-clock time saved is reported by GetTimingReport().
+*	A lane stepped between the other lanes' steps waits less for its next
+*	poll than it would alone, so with many lanes the estimate is low (by
+*	about a quarter for 6 one-component lanes in AutotuneLaneBenchmark).
+*
+* Example usage:
+*
+*	AutotuneCouplingTable coupling;
+*	AutotuneCouplingTable::Parse("PM 1 - PM 2", coupling);
+*	for (const vector<size_t>& lane : PlanAutotuneLanes(components, coupling))
+*		...	// one manager per lane
+*
+*	auto stepper = make_shared<AutotuneLaneStepper>(laneProcedures);
+*	stepExecutor.Start({
+*		[stepper] { return stepper->IsRunning(); },
+*		[stepper] { stepper->Step(); },
+*		[stepper] { return stepper->GetStepSummary(); },
+*		[stepper] { stepper->Cancel(); }
+*	});
+*
+* Sharing lc:
+* - Every lane's AutotunePowerManager is built on the panel's one
+*	MainLaserControllerInterface (lc). lc isn't documented as thread-safe
+*	(it owns the serial link and its cached readouts), so lanes must not
+*	add callers that run at the same time.
+* - They don't. AutotuneLaneStepper calls the lanes' Step() one after
+*	another on the executor's single worker thread, so no two managers are
+*	ever inside lc at once. That is the same thread and the same
+*	one-call-at-a-time use as a run with a single manager. Cancel() reaches
+*	the managers from the UI thread, as it always has.
+* - Never step lanes from more than one thread. The AutotuneCouplingTable_
+*	<serial> entry only decides which components share a lane; it can't
+*	make the managers use lc concurrently.
+*
+* AutotuneLaneBenchmark runs lanes like this against a simulated laser.
+*
+* @file AutotuneScheduler.h
+* @created October 2026
+* @version 1.0
+*/
+#pragma once
+
+#include <chrono>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "ProcedureExecutor.h"
+
+
+// A component to tune, as the scheduler sees it
+struct AutotuneSchedulerComponent {
+	int pmId;
+	// Name of the component in the coupling table, e.g. "Motor 1"
+	std::string key;
+};
+
+
+// Which components interact, besides those on the same power monitor
+class AutotuneCouplingTable {
+
+public:
+	// Parse pairs separated by ';', e.g. "PM 1 - PM 2; Temperature 3 - Motor 1".
+	//   An empty text couples nothing. Returns false if a pair is malformed.
+	static bool Parse(const std::string& text, AutotuneCouplingTable& table);
+
+	// Couple two keys - power monitors ("PM 1") or components ("Motor 1")
+	void AddCoupling(const std::string& key_a, const std::string& key_b);
+	bool AreCoupled(const AutotuneSchedulerComponent& a, const AutotuneSchedulerComponent& b) const;
+
+
+private:
+	std::set<std::pair<std::string, std::string>> couplings;
+
+	bool HasCoupling(const std::string& key_a, const std::string& key_b) const;
+
+};
+
+
+// Lanes of component indices, in the order of their first component
+std::vector<std::vector<size_t>> PlanAutotuneLanes(const std::vector<AutotuneSchedulerComponent>& components,
+	const AutotuneCouplingTable& coupling);
+
+
+// Steps the procedures of several lanes in turns. Lives on the step thread
+//   while running; read the timing after the executor has finished.
+class AutotuneLaneStepper {
+
+public:
+	explicit AutotuneLaneStepper(const std::vector<ProcedureExecutor::Procedure>& lane_procedures);
+
+	// True while any lane is running
+	bool IsRunning();
+	// One step of each running lane
+	void Step();
+	std::string GetStepSummary() const;
+	void Cancel();
+
+	size_t GetLaneCount() const;
+	// Time from the first step until the last lane stopped
+	std::chrono::steady_clock::duration GetWallTime() const;
+	// Estimated time the lanes would have taken one after another
+	std::chrono::steady_clock::duration GetSequentialTime() const;
+	// E.g. "3 lanes in parallel: 95.0 s (about 240.3 s one after another, 145.3 s saved)"
+	std::string GetTimingReport() const;
+
+
+private:
+	struct Lane {
+		ProcedureExecutor::Procedure procedure;
+		bool running = true;
+		// From the first step until the lane stopped
+		std::chrono::steady_clock::duration elapsed{ 0 };
+		// Part of elapsed spent stepping other lanes
+		std::chrono::steady_clock::duration otherLanesStepTime{ 0 };
+	};
+	std::vector<Lane> lanes;
+	bool started = false;
+	std::chrono::steady_clock::time_point startTime;
+	std::chrono::steady_clock::time_point endTime;
+	std::string stepSummary;
+
+	void Begin();
+	void UpdateRunningLanes();
+
+};
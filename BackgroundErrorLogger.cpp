@@ -1,29 +1,93 @@
 #include <filesystem>
+#ifdef _WIN32
+#include <Windows.h>
+#endif
 
 #include "BackgroundErrorLogger.h"
+#include "../CommonFunctions.h"
+#include "../ErrorMessageStream.h"
 #include "../WindowsFunctions.h"
 
 using namespace std;
 
 
-const string TEMP_ERROR_FILE_NAME = "errorLogTemp.log";
+const string JOURNAL_FOLDER_NAME = "ErrorJournals";
+const string JOURNAL_EXTENSION = ".log";
+
+// Errors that can wait for the writer thread at once
+const size_t ERROR_QUEUE_CAPACITY = 4096;
+// How long a reporting thread waits for room in a full queue before the
+// error is dropped. Only reached if the writer thread is stuck, e.g. on a
+// full disk.
+const chrono::seconds ERROR_QUEUE_FULL_TIMEOUT(1);
+// The writer thread also checks for errors this often, in case a wake-up
+// was missed (reporting threads notify without taking a lock)
+const chrono::milliseconds ERROR_WRITER_POLL_INTERVAL(100);
+
+
+static unsigned long GetCurrentThreadNumber() {
+#ifdef _WIN32
+	return GetCurrentThreadId();
+#else
+	return (unsigned long)hash<thread::id>()(this_thread::get_id());
+#endif
+}
+
+
+// Builds one error message per thread and reports it on flush/std::endl.
+// The message buffer is reused, so it stops allocating once it has grown.
+class ThreadErrorStreambuf : public streambuf {
+
+protected:
+	int_type overflow(int_type c) override {
+		if (!traits_type::eq_int_type(c, traits_type::eof()))
+			message += traits_type::to_char_type(c);
+		return traits_type::not_eof(c);
+	}
+
+	streamsize xsputn(const char* s, streamsize count) override {
+		message.append(s, size_t(count));
+		return count;
+	}
+
+	int sync() override {
+		while (!message.empty() and (message.back() == '\n' or message.back() == '\r'))
+			message.pop_back();
+		if (!message.empty())
+			BackgroundErrorLogger::GetInstance().LogError(message);
+		message.clear();
+		return 0;
+	}
+
+
+private:
+	string message;
+
+};
 
 
 // ------ For Singleton implementation ------
-BackgroundErrorLogger::BackgroundErrorLogger() {
-	// When first created, set target file to a temporary error log output file.
-	// This will capture all error messages before mainLaserController loads.
-	// Once MainLaserController loads, can finally call Init() on this
-	// logger, which will redirect output to the correct error log file in the
-	// correct directory for this laser, date, and category.
-	tempErrorFilePath = GetAppDataPath() + TEMP_ERROR_FILE_NAME;
-	filesystem::create_directory(GetAppDataPath());
-	SetFilePath(tempErrorFilePath);
+BackgroundErrorLogger::BackgroundErrorLogger() : errorQueue(ERROR_QUEUE_CAPACITY) {
+	// Errors before mainLaserController loads go to a journal, created by
+	// the writer thread with the first of them. Once MainLaserController
+	// loads, can finally call Init() on this logger, which will redirect
+	// output to the correct error log file in the correct directory for
+	// this laser, date, and category.
+	monotonicStartTime = chrono::steady_clock::now();
+	errorWriterThread = thread(&BackgroundErrorLogger::WriteErrors, this);
 }
 
 BackgroundErrorLogger::~BackgroundErrorLogger() {
+	// Write out everything reported so far
+	{
+		lock_guard<mutex> lock(writerMutex);
+		stopRequested = true;
+	}
+	errorQueuedCondition.notify_all();
+	if (errorWriterThread.joinable())
+		errorWriterThread.join();
 }
-BackgroundErrorLogger::BackgroundErrorLogger(const BackgroundErrorLogger&) { }
+BackgroundErrorLogger::BackgroundErrorLogger(const BackgroundErrorLogger&) : errorQueue(1) { }
 const BackgroundErrorLogger& BackgroundErrorLogger::operator=(const BackgroundErrorLogger&) {
 	return BackgroundErrorLogger::GetInstance();
 }
@@ -35,11 +99,230 @@ BackgroundErrorLogger& BackgroundErrorLogger::GetInstance() {
 // -----------------------------------------
 
 void BackgroundErrorLogger::Init() {
-	BackgroundLogger::Init();
-	isInitialized = true;
-	AddColumn("Error #");
-	AddColumn("Error");
-	WriteHeaderLine();
+	RunOnWriterThread([this]() {
+		BackgroundLogger::Init();
+		// The async output thread was started by BackgroundLogger::Init()
+		outputThreadID = asyncWriter ? asyncWriter->GetWriterThreadID() : thread::id();
+		isInitialized = true;
+		AddColumn("Error #");
+		AddColumn("Thread");
+		AddColumn("Monotonic Time (us)");
+		AddColumn("Error");
+		WriteHeaderLine();
+		// Point to the errors from before the laser was loaded
+		if (bindEndByte > bindStartByte) {
+			LoggerBase::CommitLineMetadata("Errors before laser connected - " + laserSerialNumber + " - " + laserModel
+				+ " - journal \"" + journalFilePath + "\" bytes " + to_string(bindStartByte) + "-" + to_string(bindEndByte));
+		}
+	});
+}
+
+void BackgroundErrorLogger::OnLogFileClaimed() {
+	// Runs on the writer thread, so errors reported meanwhile wait in
+	// errorQueue until the new error log's header is written.
+	bindStartByte = bindEndByte = journalBoundBytes;
+	if (!journalHasUnboundErrors or GetLogFilePath() != journalFilePath) {
+		CloseLogFile();
+		return;
+	}
+
+	// The journal's errors end here. Name the error log they continue in,
+	// so the journal can be followed either way.
+	Flush();
+	error_code error;
+	uintmax_t journalBytes = filesystem::file_size(journalFilePath, error);
+	if (!error)
+		bindEndByte = journalBytes;
+	LoggerBase::CommitLineMetadata("Continued in error log - " + laserSerialNumber + " - " + laserModel
+		+ " - \"" + logFilePath + "\"");
+	CloseLogFile();
+
+	journalBoundBytes = filesystem::file_size(journalFilePath, error);
+	if (error)
+		journalBoundBytes = bindEndByte;
+	journalHasUnboundErrors = false;
+}
+
+void BackgroundErrorLogger::OpenJournal() {
+	if (journalFilePath.empty()) {
+		string journalDirectory = GetJournalDirectory();
+		filesystem::create_directories(journalDirectory);
+		DeleteOldJournals();
+
+		// A GUI and an API process may start at once, so claim a file of our own
+		string date = GenerateDateString();
+		auto fileNameForID = [date](int id) { return "ErrorJournal_(" + date + ")_" + to_string(id) + JOURNAL_EXTENSION; };
+		LogSessionIndex journalIndex(journalDirectory, fileNameForID);
+		int journalID = journalIndex.ClaimNextLogID();
+		if (journalID == 0)
+			return;
+		journalFilePath = journalDirectory + "\\" + fileNameForID(journalID);
+	}
+	SetFilePath(journalFilePath);
+}
+
+string BackgroundErrorLogger::GetJournalDirectory() const {
+	return (baseDirectory.empty() ? GetAppDataPath() : baseDirectory) + JOURNAL_FOLDER_NAME;
+}
+
+void BackgroundErrorLogger::DeleteOldJournals() {
+	auto oldestKept = filesystem::file_time_type::clock::now() - chrono::hours(24) * JOURNAL_MAX_AGE_DAYS;
+	error_code error;
+	for (const auto& entry : filesystem::directory_iterator(GetJournalDirectory(), error)) {
+		if (entry.path().extension() != JOURNAL_EXTENSION)
+			continue;
+		auto lastWriteTime = entry.last_write_time(error);
+		if (!error and lastWriteTime < oldestKept)
+			filesystem::remove(entry.path(), error);
+	}
+}
+
+
+//-------------------------------------------------------------------------
+// Reporting errors from any thread
+
+void BackgroundErrorLogger::LogError(string_view message) {
+	// The writer threads can't wait for themselves to write the error, and
+	// an error about writing the error log would only fail again
+	if (IsWriterThread()) {
+		errorsDropped++;
+		return;
+	}
+
+	unsigned long threadID = GetCurrentThreadNumber();
+	long long monotonicMicroseconds = chrono::duration_cast<chrono::microseconds>(
+		chrono::steady_clock::now() - monotonicStartTime).count();
+
+	chrono::steady_clock::time_point giveUpTime;
+	bool waiting = false;
+	while (!errorQueue.TryPush(message, threadID, monotonicMicroseconds)) {
+		if (!waiting) {
+			giveUpTime = chrono::steady_clock::now() + ERROR_QUEUE_FULL_TIMEOUT;
+			waiting = true;
+		}
+		if (chrono::steady_clock::now() > giveUpTime) {
+			errorsDropped++;
+			return;
+		}
+		errorQueuedCondition.notify_one();
+		this_thread::yield();
+	}
+	errorsQueued++;
+	errorQueuedCondition.notify_one();
+}
+
+void BackgroundErrorLogger::LogDataPoint(const vector<string>& values) {
+	LogError(values.empty() ? string_view() : string_view(values.back()));
+}
+
+void BackgroundErrorLogger::CommitLine(string line) {
+	LogError(line);
+}
+
+ostream& BackgroundErrorLogger::GetThreadErrorStream() {
+	thread_local ThreadErrorStreambuf buffer;
+	thread_local ostream stream(&buffer);
+	return stream;
+}
+
+void BackgroundErrorLogger::FlushErrors() {
+	unsigned long long target = errorsQueued.load();
+	if (IsWriterThread())
+		return;
+	errorQueuedCondition.notify_one();
+	{
+		unique_lock<mutex> lock(writerMutex);
+		errorsWrittenCondition.wait(lock, [&] { return errorsWritten >= target or stopRequested; });
+	}
+	RunOnWriterThread([this]() { Flush(); });
+}
+
+unsigned long long BackgroundErrorLogger::GetDroppedErrorCount() const {
+	return errorsDropped.load();
+}
+
+bool BackgroundErrorLogger::IsWriterThread() const {
+	thread::id id = this_thread::get_id();
+	return id == errorWriterThread.get_id() or id == outputThreadID.load();
+}
+
+
+//-------------------------------------------------------------------------
+// Writer thread
+
+void BackgroundErrorLogger::RunOnWriterThread(const function<void()>& task) {
+	if (this_thread::get_id() == errorWriterThread.get_id()) {
+		task();
+		return;
+	}
+
+	unique_lock<mutex> lock(writerMutex);
+	// One task at a time
+	errorsWrittenCondition.wait(lock, [this] { return writerTask == nullptr or stopRequested; });
+	if (stopRequested)
+		return;
+	writerTask = &task;
+	unsigned long long finished = writerTasksFinished + 1;
+	errorQueuedCondition.notify_one();
+	errorsWrittenCondition.wait(lock, [&] { return writerTasksFinished >= finished; });
+}
+
+void BackgroundErrorLogger::WriteErrors() {
+	LogRecord record;
+	record.message.reserve(256);
+	while (true) {
+		bool stopping;
+		const function<void()>* task;
+		{
+			unique_lock<mutex> lock(writerMutex);
+			errorQueuedCondition.wait_for(lock, ERROR_WRITER_POLL_INTERVAL,
+				[this] { return stopRequested or writerTask or !errorQueue.IsEmpty(); });
+			stopping = stopRequested;
+			task = writerTask;
+		}
+
+		// At most a queue's worth, so reporters can't hold off a task
+		unsigned long long written = 0;
+		while (written < ERROR_QUEUE_CAPACITY and errorQueue.TryPop(record)) {
+			WriteError(record);
+			written++;
+		}
+		if (task)
+			(*task)();
+
+		{
+			lock_guard<mutex> lock(writerMutex);
+			errorsWritten += written;
+			if (task) {
+				writerTask = nullptr;
+				writerTasksFinished++;
+			}
+		}
+		errorsWrittenCondition.notify_all();
+
+		if (stopping and errorQueue.IsEmpty())
+			return;
+	}
+}
+
+void BackgroundErrorLogger::WriteError(const LogRecord& record) {
+	errorNumber++;
+	if (isInitialized) {
+		LoggerBase::LogDataPoint(errorNumber, record.threadID, record.monotonicMicroseconds, string_view(record.message));
+		return;
+	}
+
+	// Journal before Init(): no error columns yet. Mark where each
+	// connection starts, since the journal is continued after a disconnect.
+	if (GetLogFilePath().empty())
+		OpenJournal();
+	journalHasUnboundErrors = true;
+	if (!journalSessionMarked) {
+		LoggerBase::CommitLineMetadata("Errors before laser connected - " + GenerateDateString() + " " + GenerateTimeString());
+		journalSessionMarked = true;
+	}
+	LoggerBase::CommitLine(GenerateDateString() + "," + GenerateTimeString() + "," + to_string(errorNumber) + ","
+		+ to_string(record.threadID) + "," + to_string(record.monotonicMicroseconds) + "," + record.message);
 }
 
 bool BackgroundErrorLogger::IsInitialized() {
@@ -47,11 +330,7 @@ bool BackgroundErrorLogger::IsInitialized() {
 }
 
 bool BackgroundErrorLogger::DetectedErrorBeforeMainLaserControllerLoaded() {
-	if (filesystem::exists(tempErrorFilePath)) {
-		if (!filesystem::is_empty(tempErrorFilePath))
-			return true;
-	}
-	return false;
+	return journalHasUnboundErrors;
 }
 
 bool BackgroundErrorLogger::LaserLoaded() {
@@ -63,31 +342,28 @@ bool BackgroundErrorLogger::SetLaserLoaded(bool loaded) {
 }
 
 void BackgroundErrorLogger::TransferTemporaryErrorLogs() {
+}
 
-	// Open temporary error log file
-	ifstream tempErrorLogFile(tempErrorFilePath);
-
-	// Open main error log file
-	logFile.open(filePath, ios::app);
-
-	// Transfer contents of temporary log file to main log file
-	if (tempErrorLogFile.is_open() and logFile.is_open()) {
-		string line;
-		while (getline(tempErrorLogFile, line)) {
-			logFile << line << "\n";
-		}
-	}
-	tempErrorLogFile.close();
-	logFile.close();
-
-	// Remove temporary log file
-	filesystem::remove(tempErrorFilePath);
+string BackgroundErrorLogger::GetJournalFilePath() {
+	string path;
+	RunOnWriterThread([&]() { path = journalFilePath; });
+	return path;
+}
 
+void BackgroundErrorLogger::SetBaseDirectory(const string& base_directory) {
+	RunOnWriterThread([&]() { BackgroundLogger::SetBaseDirectory(base_directory); });
 }
 
 void BackgroundErrorLogger::ResetToTemporaryOutputFile() {
-	Reset();
-	isInitialized = false;
-	laserLoaded = false;
-	SetFilePath(tempErrorFilePath);
+	RunOnWriterThread([this]() {
+		Reset();
+		// Reset() also removes the automatic date and time columns
+		AddColumn("Date");
+		AddColumn("Time");
+		LogLifecycleManager::GetInstance().UnregisterActiveLogFile(this);
+		isInitialized = false;
+		laserLoaded = false;
+		journalSessionMarked = false;
+		// The journal is continued with the next error
+	});
 }
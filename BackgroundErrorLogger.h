@@ -5,6 +5,21 @@
 * - Allows error logging while GUI is using this LaserController project as a dll
 * - Writes to a .log file automatically created for each GUI session,
 *	located in "ErrorLogFiles" folder in local app data Logs folder for this laser.
+* - Until a laser is loaded, errors go to an append-only journal file,
+*	one per process, in the "ErrorJournals" folder in local app data. The
+*	journal is created with the first such error.
+* - Init() binds the journal to the laser without moving its errors: the
+*	journal gets a metadata line naming the new error log, and the error
+*	log gets one naming the journal and the byte range of the errors
+*	before it, e.g.
+*		>>> Errors before laser connected - 23-001 - RX-355-30 - journal "C:\...\ErrorJournals\ErrorJournal_(2026-10-17)_4.log" bytes 0-5120
+*	Nothing is copied or deleted, so binding takes the same time however
+*	many errors there are, and a crash can't lose or duplicate errors: at
+*	worst the bind line is missing and the errors are only in the journal.
+*	After ResetToTemporaryOutputFile(), errors continue in the same journal
+*	and the next Init() binds the range after the last bind.
+* - Journals older than JOURNAL_MAX_AGE_DAYS are deleted when a new one is
+*	created.
 *
 * Usage:
 * - Use "e" just like "cout".
@@ -20,8 +35,28 @@
 *	e << "This is another error!"  <<  endl;
 *
 * In error log file:
-*   2022-5-4,18:47:46,1,This is an error! Error code:3.
-*   2022-5-4,18:47:46,2,This is another error!
+*   2022-5-4,18:47:46,1,7412,1520113,This is an error! Error code:3.
+*   2022-5-4,18:47:46,2,7412,1520145,This is another error!
+*	(Error #, thread ID, microseconds on the steady clock, message)
+*
+* Thread safety:
+* - Errors may be reported from any thread at once. LogError(..) copies the
+*	message into a lock-free queue (see LogRecordQueue.h) and returns; a
+*	dedicated writer thread is the only thread that writes to the log, so
+*	messages from different threads never interleave. LogDataPoint(values)
+*	and CommitLine(..), which "e" reports errors through, forward to
+*	LogError(..). LoggerBase's other ways of writing a line are deleted
+*	here, so they can't be used to write around the writer thread.
+* - Init(), TransferTemporaryErrorLogs() and ResetToTemporaryOutputFile()
+*	hand their work to the writer thread and wait for it, so no lock is
+*	held while a line waits for the async file writer.
+* - GetThreadErrorStream() gives each thread its own stream to build a
+*	message in. std::endl (or std::flush) reports the message built so far
+*	as one error.
+* - Errors reported on the error logger's own writer threads (e.g. its file
+*	can't be written) are dropped and counted, since they could only wait
+*	for themselves.
+* - Once warmed up, reporting an error doesn't allocate.
 *
 * @file BackgroundErrorLogger.h - formerly "ErrorLogger.h" created 5/4/22
 * @author James Butcher
@@ -30,7 +65,18 @@
 */
 #pragma once
 
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <ostream>
+#include <string_view>
+#include <thread>
+
 #include "BackgroundLogger.h"
+#include "LogRecordQueue.h"
 
 
 class BackgroundErrorLogger : public BackgroundLogger {
@@ -44,28 +90,110 @@ private:
 	const BackgroundErrorLogger& operator=(const BackgroundErrorLogger&);
 	////////////////////////////
 
-	// Need these flags to delay initializing (adding header metadata) until 
+	// Need these flags to delay initializing (adding header metadata) until
 	// after MainLaserController loads and adds serial number and laser model
 	// information and there is at least 1 error to add.
 	// This prevents cluttering error log files with header information
 	// even when there are no errors.
-	bool isInitialized = false; 
-	bool laserLoaded = false;
+	std::atomic<bool> isInitialized{ false };
+	std::atomic<bool> laserLoaded{ false };
+	// A session marker was written to the journal for this GUI session
+	bool journalSessionMarked = false;
+
+	// Journal of this process, "" until the first error before Init()
+	std::string journalFilePath;
+	// Bytes of the journal bound to an error log so far
+	std::uintmax_t journalBoundBytes = 0;
+	// Journal bytes bound by the last Init(), for its bind line
+	std::uintmax_t bindStartByte = 0;
+	std::uintmax_t bindEndByte = 0;
+	// Errors were written to the journal since the last bind
+	std::atomic<bool> journalHasUnboundErrors{ false };
+
+	// Errors waiting for the writer thread
+	LogRecordQueue errorQueue;
+	std::chrono::steady_clock::time_point monotonicStartTime;
+	std::atomic<unsigned long long> errorsQueued{ 0 };
+	std::atomic<unsigned long long> errorsDropped{ 0 };
+	// Writer thread of the async file output, whose errors are dropped too
+	std::atomic<std::thread::id> outputThreadID;
+
+	// Written by the writer thread only
+	unsigned long long errorNumber = 0;
 
-	std::string tempErrorFilePath;
+	std::thread errorWriterThread;
+	std::mutex writerMutex;
+	std::condition_variable errorQueuedCondition;
+	std::condition_variable errorsWrittenCondition;
+	unsigned long long errorsWritten = 0;
+	// Work handed to the writer thread by RunOnWriterThread(..)
+	const std::function<void()>* writerTask = nullptr;
+	unsigned long long writerTasksFinished = 0;
+	bool stopRequested = false;
+
+	void WriteErrors();
+	void WriteError(const LogRecord& record);
+	// Run task on the writer thread, after the errors queued so far, and
+	//   wait for it.
+	void RunOnWriterThread(const std::function<void()>& task);
+	bool IsWriterThread() const;
+	// Continue the journal, or create it and delete old ones
+	void OpenJournal();
+	void DeleteOldJournals();
+	std::string GetJournalDirectory() const;
 
 protected:
 	virtual std::string GetLogType() override { return "ErrorLogs"; }
+	// Write the journal's bind line and close it once the new error log is
+	//   claimed
+	virtual void OnLogFileClaimed() override;
 
 public:
+	// Journals not written to for this many days are deleted
+	static const int JOURNAL_MAX_AGE_DAYS = 90;
+
 	LOG_API static BackgroundErrorLogger& GetInstance();
 
+	// Report an error from any thread. Returns without waiting for the
+	//   error to be written.
+	LOG_API void LogError(std::string_view message);
+	// This thread's stream for building an error message. Flushing it
+	//   (std::endl) reports the message.
+	LOG_API static std::ostream& GetThreadErrorStream();
+	// Wait until every error reported so far has been written to the file.
+	LOG_API void FlushErrors();
+	// Errors lost because the queue stayed full for over a second, or
+	//   because they were reported on the error logger's writer threads.
+	LOG_API unsigned long long GetDroppedErrorCount() const;
+
+	// Report an error (Error #, Error) the way "e" does. Only the last
+	//   value, the message, is used: errors are numbered by the writer
+	//   thread in the order they're written.
+	LOG_API void LogDataPoint(const std::vector<std::string>& values);
+	// Report line as an error.
+	LOG_API void CommitLine(std::string line);
+
+	template <typename... Values>
+	void LogDataPoint(const Values&... values) = delete;
+	void LogDataPointAt(std::chrono::system_clock::time_point acquisition_time, const std::vector<std::string>& values) = delete;
+	template <typename... Values>
+	void LogDataPointAt(std::chrono::system_clock::time_point acquisition_time, const Values&... values) = delete;
+	void CommitLineEncrypt(std::string line) = delete;
+	void CommitLineMetadata(std::string line) = delete;
+
 	LOG_API void Init();
 	LOG_API bool IsInitialized();
+	// True if errors went to the journal since the last Init()
 	LOG_API bool DetectedErrorBeforeMainLaserControllerLoaded();
 	LOG_API bool LaserLoaded();
 	LOG_API bool SetLaserLoaded(bool loaded);
+	// Does nothing: Init() binds the journal with a single line, so there
+	//   is nothing left to transfer. Kept for existing callers.
 	LOG_API void TransferTemporaryErrorLogs();
+	// Journal of this process, "" if no error went to one yet
+	LOG_API std::string GetJournalFilePath();
+	// Also moves the journal folder, if no journal was created yet.
+	LOG_API void SetBaseDirectory(const std::string& base_directory);
 
 	// Call this when disconnecting from a laser
 	LOG_API void ResetToTemporaryOutputFile();
@@ -21,6 +21,10 @@ BackgroundLogger::BackgroundLogger(string laser_serial_number, string laser_mode
 BackgroundLogger::BackgroundLogger() {
 }
 
+BackgroundLogger::~BackgroundLogger() {
+	LogLifecycleManager::GetInstance().UnregisterActiveLogFile(this);
+}
+
 
 void BackgroundLogger::SetSerialNumberAndModel(string laser_serial_number, string laser_model) {
 	laserSerialNumber = laser_serial_number;
@@ -34,24 +38,72 @@ void BackgroundLogger::SetSerialNumberAndModel(string laser_serial_number, strin
 }
 
 
+void BackgroundLogger::SetBaseDirectory(const string& base_directory) {
+	baseDirectory = base_directory;
+}
+
+
 void BackgroundLogger::Init() {
 	// All background loggers will have their log data encrypted
 	// Custom lines added by CommitLine will remain unencrypted
 	SetEncryptOption(true);
 
+	// Encryption and file output happen on a writer thread so background
+	// logging never stalls the GUI. Lines are never dropped.
+	EnableAsyncOutput(4096, LogBackPressure::BLOCK);
+
+	// Background loggers run for the whole GUI session, which may last weeks.
+	// Keep memory use flat without losing lines for SaveMemoryLogToFile(..).
+	SetMemoryLogPolicy(MemoryLogPolicy::SPILL_TO_DISK, 8 * 1024 * 1024);
+
+	// Keep each day in its own folder so finished days can be compressed,
+	// and keep single files small enough to open in a viewer.
+	LogRotationPolicy rotationPolicy;
+	rotationPolicy.maxFileBytes = 64 * 1024 * 1024;
+	rotationPolicy.newFileEachDay = true;
+	SetRotationPolicy(rotationPolicy);
+
 	InitLogDirectory();
 	InitLogFilePath();
+	OnLogFileClaimed();
 	SetFilePath(logFilePath);
 
 	// Write these non-encrypted lines to the top of the log file for traceability
-	
+	for (const string& line : GetHeaderMetadataLines())
+		CommitLineMetadata(line);
+
+	// Compression and retention run on a background thread
+	LogLifecycleManager::GetInstance().RegisterActiveLogFile(this, logFilePath);
+	LogLifecycleManager::GetInstance().RequestMaintenance();
+}
+
+vector<string> BackgroundLogger::GetHeaderMetadataLines() {
+	vector<string> lines;
 	// If logged in, add username to top of log file
 	if (LoginManager::GetInstance().IsLoggedIn())
-		CommitLineMetadata("User: " + LoginManager::GetInstance().GetLoggedInUsername());
-	CommitLineMetadata(laserSerialNumber + " - " + laserModel);
-	CommitLineMetadata(GenerateDateString());
-	CommitLineMetadata(GenerateTimeString());
-	CommitLineMetadata(GetLogType());
+		lines.push_back("User: " + LoginManager::GetInstance().GetLoggedInUsername());
+	lines.push_back(laserSerialNumber + " - " + laserModel);
+	lines.push_back(GenerateDateString());
+	lines.push_back(GenerateTimeString());
+	lines.push_back(GetLogType());
+	return lines;
+}
+
+string BackgroundLogger::GetRotationFilePath() {
+	// The date may have changed since the last file was started
+	InitLogDirectory();
+	InitLogFilePath();
+	LogLifecycleManager::GetInstance().RegisterActiveLogFile(this, logFilePath);
+	// Index the file just finished
+	LogLifecycleManager::GetInstance().RequestMaintenance();
+	return logFilePath;
+}
+
+void BackgroundLogger::WriteRotationHeader(const string& previous_file_path) {
+	// Same header as the first file, without repeating it in memory
+	for (const string& line : GetHeaderMetadataLines())
+		OutputLine(GetMetadataLinePrefix() + line, false);
+	LoggerBase::WriteRotationHeader(previous_file_path);
 }
 
 
@@ -64,7 +116,7 @@ void BackgroundLogger::InitLogDirectory() {
 	//						2022-2-8/
 	//							LaserStateLogs/
 	//
-	string baseDirectoryName = GetLogBaseDirectory();
+	string baseDirectoryName = baseDirectory.empty() ? GetLogBaseDirectory() : baseDirectory;
 	string laserDirectoryName = laserSerialNumber + "_" + laserModel+ "\\";
 	string dateDirectoryName = GenerateDateString() + "\\";
 	string logTypeDirectoryName = GetLogType(); // <-- This is the virtual function that derived classes must override
@@ -85,52 +137,31 @@ string BackgroundLogger::GetLogDirectory() const {
 }
 
 void BackgroundLogger::InitLogFilePath() {
-	logFilePath = logDirectory + "\\" + GetLogFilename();
+	// Claim the next ID by creating its file, so a GUI and an API process
+	// starting at the same time can't both write to the same log file.
+	LogSessionIndex sessionIndex(logDirectory, [this](int id) { return GetLogFilenameForID(id); });
+	int logID = sessionIndex.ClaimNextLogID();
+	if (logID == 0) {
+		e << "Failed to create a new log file in: " << logDirectory << endl;
+		logID = sessionIndex.PeekNextLogID();
+	}
+	logFilePath = logDirectory + "\\" + GetLogFilenameForID(logID);
 }
 
 string BackgroundLogger::GetLogFilename() {
 	// Create a log file name with the name being an integer one higher than
 	//   the highest log file name in the folder.
 	// E.g., ".._1.log" , ".._2.log" , ".._3.log" , ...
-	//
+	return GetLogFilenameForID(stoi(GenerateLogIDString()));
+}
+
+string BackgroundLogger::GetLogFilenameForID(int id) {
 	// Format: LogType_(SN#)_(Model)_(Date)_LogID.log
 	return GetLogType() + "_(" + laserSerialNumber + ")_(" + laserModel + ")_(" + 
-		GenerateDateString() + ")_" + GenerateLogIDString() + EXTENSION;
-}
-
-string BackgroundLogger::GenerateLogIDString() const {
-	return to_string(FindHighestLogFileNumber() + 1);
-}
-
-int BackgroundLogger::FindHighestLogFileNumber() const {
-	// Find the highest number appearing at the end of all filenames in the 
-	// log files folder.
-	// Example:
-	//		".._1.log"
-	//		".._2.log"
-	//	--> ".._3.log"
-	//   Returns "3"
-
-	int maxID = 0;
-
-	for (const auto& file : filesystem::directory_iterator(logDirectory)) {
-		string filename = file.path().filename().string();
-
-		string extractedGuiSessionNumber = "";
-		bool reachedExtensionEnd = false;
-		for (string::reverse_iterator it = filename.rbegin(); it != filename.rend(); ++it) {
-			if (reachedExtensionEnd and (*it == '_' or !isdigit(*it)))
-				break;
-			if (reachedExtensionEnd and isdigit(*it))
-				extractedGuiSessionNumber = *it + extractedGuiSessionNumber;
-			if (*it == '.')
-				reachedExtensionEnd = true;
-		}
-
-		if (extractedGuiSessionNumber.length() > 0) {
-			if (ToIntSafely(extractedGuiSessionNumber) > maxID)
-				maxID = ToIntSafely(extractedGuiSessionNumber);
-		}
-	}
-	return maxID;
+		GenerateDateString() + ")_" + to_string(id) + EXTENSION;
+}
+
+string BackgroundLogger::GenerateLogIDString() {
+	LogSessionIndex sessionIndex(logDirectory, [this](int id) { return GetLogFilenameForID(id); });
+	return to_string(sessionIndex.PeekNextLogID());
 }
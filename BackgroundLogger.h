@@ -4,7 +4,13 @@
 *   with file name defaulting to an incrementing integer series.
 *   Meant to be run continuously in the background during each GUI session.
 * 
-* All background loggers are set to log encrypted values.
+* All background loggers are set to log encrypted values, one encrypted
+* line per data point, which the log viewer can read.
+* 
+* Background log files are rotated: a new file is started each day and
+* whenever the current file gets too big (see LoggerBase::SetRotationPolicy).
+* Closed days are compressed and old files deleted by LogLifecycleManager,
+* when configured to.
 * 
 *  File structure:
 * 
@@ -19,6 +25,7 @@
 *					[ Log type name ] /
 * 
 *						[ log files indexed by GUI session # ]
+*						.session_index  <-- Highest session # so far (see LogSessionIndex.h)
 * 
 * 
 *	Example: Three child loggers derived from BackgroundLogger:
@@ -60,6 +67,8 @@
 #pragma once
 
 #include "LoggerBase.h"
+#include "LogLifecycleManager.h"
+#include "LogSessionIndex.h"
 
 
 // Get the top-level default directory for saving background logger log files.
@@ -74,6 +83,8 @@ protected:
 	std::string laserModel = "";
 	std::string logDirectory = "";
 	std::string logFilePath = "";
+	// "" for GetLogBaseDirectory()
+	std::string baseDirectory = "";
 
 	// Derived classes must override this method with the desired folder name to 
 	// contain this type of log files. e.g., "LaserStateLogs", "ErrorLogs", etc.
@@ -81,8 +92,18 @@ protected:
 
 	void InitLogFilePath();
 	void InitLogDirectory();
-	std::string GenerateLogIDString() const;
-	int FindHighestLogFileNumber() const;
+	std::string GenerateLogIDString();
+	std::string GetLogFilenameForID(int id);
+	// Lines at the top of every log file (user, laser, date, time, type)
+	std::vector<std::string> GetHeaderMetadataLines();
+
+	// Called by Init() once the (empty) log file has been created and
+	// before it is opened, e.g. to move existing log lines into place.
+	virtual void OnLogFileClaimed() {}
+
+	// Continue in a new file with the next ID in today's folder
+	virtual std::string GetRotationFilePath() override;
+	virtual void WriteRotationHeader(const std::string& previous_file_path) override;
 
 
 public:
@@ -91,9 +112,15 @@ public:
 
 
 	LOG_API BackgroundLogger();
+	LOG_API virtual ~BackgroundLogger();
 	LOG_API void SetSerialNumberAndModel(std::string laser_serial_number,
 		std::string laser_model);
 
+	// Keep this logger's files under base_directory instead of
+	//   GetLogBaseDirectory(), e.g. in a test. Must end with a path
+	//   separator. Call before Init().
+	LOG_API void SetBaseDirectory(const std::string& base_directory);
+
 	// Initializes LoggerBase with the file path initialized and set
 	//   to a pre-defined file name in a pre-defined directory.
 	// You MUST call Init() before logging.
@@ -0,0 +1,180 @@
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "AutotuneLaneBenchmark.h"
+#include "../AutotuneScheduler.h"
+#include "PeakSearchBenchmark.h"
+#include "../ProcedureExecutor.h"
+
+using namespace std;
+
+
+struct SimulatedTuneComponent {
+	SimulatedPowerCurve curve;
+	bool temperature = false;
+	mt19937 noiseRandom;
+	unique_ptr<PeakSearch> search;
+	double bestSetting = 0;
+};
+
+
+// One lane's procedure: tunes its components one after another, one command per step
+class SimulatedTuneLane {
+
+public:
+	SimulatedTuneLane(SimulatedLaser& laser, const AutotuneLaneBenchmarkSettings& settings,
+		vector<SimulatedTuneComponent*> components) : laser(laser), settings(settings), components(components) {}
+
+	bool IsRunning() const {
+		return current < components.size();
+	}
+
+	void Step() {
+		if (cancelled) {
+			current = components.size();
+			return;
+		}
+		if (!IsRunning() or chrono::steady_clock::now() < settledTime)
+			return;
+
+		SimulatedTuneComponent& component = *components[current];
+		if (!component.search)
+			component.search = PeakSearch::Create(settings.strategy, settings.search);
+
+		if (measuring) {
+			laser.SendCommand("READ PM");
+			normal_distribution<double> noise(0, 1);
+			double power = component.curve.GetPower(component.search->GetNextSetting());
+			component.search->AddMeasurement(power * (1 + settings.search.relativeNoise * noise(component.noiseRandom)));
+			measuring = false;
+			if (component.search->IsFinished()) {
+				component.bestSetting = component.search->GetBestSetting();
+				laser.SendCommand("SET " + to_string(component.bestSetting));
+				current++;
+			}
+			return;
+		}
+
+		laser.SendCommand("SET " + to_string(component.search->GetNextSetting()));
+		measuring = true;
+		settledTime = chrono::steady_clock::now();
+		if (component.temperature)
+			settledTime += chrono::duration_cast<chrono::steady_clock::duration>(
+				chrono::duration<double, milli>(settings.settleMilliseconds));
+	}
+
+	string GetStepSummary() const {
+		return "Component " + to_string(min(current + 1, components.size())) + " of " + to_string(components.size());
+	}
+
+	void Cancel() {
+		cancelled = true;
+	}
+
+
+private:
+	SimulatedLaser& laser;
+	const AutotuneLaneBenchmarkSettings& settings;
+	vector<SimulatedTuneComponent*> components;
+	size_t current = 0;
+	bool measuring = false;
+	chrono::steady_clock::time_point settledTime;
+	atomic<bool> cancelled{ false };
+
+};
+
+
+static vector<SimulatedTuneComponent> MakeComponents(const AutotuneLaneBenchmarkSettings& settings) {
+	size_t count = settings.laneCount * settings.componentsPerLane;
+	vector<SimulatedPowerCurve> curves = GenerateSimulatedPowerCurves(settings.search, count, settings.seed);
+	vector<SimulatedTuneComponent> components(count);
+	for (size_t i = 0; i < count; i++) {
+		components[i].curve = curves[i];
+		components[i].temperature = i % 2 == 0;
+		components[i].noiseRandom.seed(settings.seed + unsigned(i) + 1);
+	}
+	return components;
+}
+
+// Tunes the components in the given lanes, the way AutotunePowerPanel steps its managers.
+//	Returns the wall time in seconds.
+static double RunLanes(const AutotuneLaneBenchmarkSettings& settings, SimulatedLaser& laser,
+	vector<SimulatedTuneComponent>& components, const vector<vector<size_t>>& lanes, double& estimated_sequential_seconds) {
+
+	vector<shared_ptr<SimulatedTuneLane>> tuneLanes;
+	vector<ProcedureExecutor::Procedure> laneProcedures;
+	for (const vector<size_t>& lane : lanes) {
+		vector<SimulatedTuneComponent*> laneComponents;
+		for (size_t component : lane)
+			laneComponents.push_back(&components[component]);
+		shared_ptr<SimulatedTuneLane> tuneLane = make_shared<SimulatedTuneLane>(laser, settings, laneComponents);
+		tuneLanes.push_back(tuneLane);
+		laneProcedures.push_back({
+			[tuneLane] { return tuneLane->IsRunning(); },
+			[tuneLane] { tuneLane->Step(); },
+			[tuneLane] { return tuneLane->GetStepSummary(); },
+			[tuneLane] { tuneLane->Cancel(); }
+		});
+	}
+
+	shared_ptr<AutotuneLaneStepper> stepper = make_shared<AutotuneLaneStepper>(laneProcedures);
+	ProcedureExecutor executor;
+	auto startTime = chrono::steady_clock::now();
+	executor.Start({
+		[stepper] { return stepper->IsRunning(); },
+		[stepper] { stepper->Step(); },
+		[stepper] { return stepper->GetStepSummary(); },
+		[stepper] { stepper->Cancel(); }
+	});
+	executor.Join();
+	double seconds = chrono::duration<double>(chrono::steady_clock::now() - startTime).count();
+
+	estimated_sequential_seconds = chrono::duration<double>(stepper->GetSequentialTime()).count();
+	return seconds;
+}
+
+
+AutotuneLaneBenchmarkResult RunAutotuneLaneBenchmark(const AutotuneLaneBenchmarkSettings& settings) {
+	AutotuneLaneBenchmarkResult result;
+	result.laneCount = settings.laneCount;
+	result.componentCount = settings.laneCount * settings.componentsPerLane;
+
+	vector<vector<size_t>> lanes(settings.laneCount);
+	vector<size_t> allComponents;
+	for (size_t i = 0; i < result.componentCount; i++) {
+		lanes[i / settings.componentsPerLane].push_back(i);
+		allComponents.push_back(i);
+	}
+
+	vector<SimulatedTuneComponent> sequentialComponents = MakeComponents(settings);
+	SimulatedLaser sequentialLaser(settings.laser);
+	double unused;
+	result.sequentialSeconds = RunLanes(settings, sequentialLaser, sequentialComponents, { allComponents }, unused);
+
+	vector<SimulatedTuneComponent> parallelComponents = MakeComponents(settings);
+	SimulatedLaser parallelLaser(settings.laser);
+	result.parallelSeconds = RunLanes(settings, parallelLaser, parallelComponents, lanes, result.estimatedSequentialSeconds);
+
+	result.commandCount = parallelLaser.GetCommandCount();
+	result.maxConcurrentCommands = max(sequentialLaser.GetMaxConcurrentCommands(), parallelLaser.GetMaxConcurrentCommands());
+	for (size_t i = 0; i < result.componentCount; i++)
+		if (sequentialComponents[i].bestSetting != parallelComponents[i].bestSetting)
+			result.settingMismatches++;
+	return result;
+}
+
+
+string FormatAutotuneLaneBenchmark(const AutotuneLaneBenchmarkResult& result) {
+	char line[300];
+	snprintf(line, sizeof(line),
+		"%zu lane%s, %zu components, %zu commands: %.2f s one after another (estimated %.2f s), %.2f s in parallel, "
+		"%zu command%s in flight at most, %zu settings differ",
+		result.laneCount, result.laneCount == 1 ? "" : "s", result.componentCount, result.commandCount, result.sequentialSeconds,
+		result.estimatedSequentialSeconds, result.parallelSeconds, result.maxConcurrentCommands,
+		result.maxConcurrentCommands == 1 ? "" : "s", result.settingMismatches);
+	return line;
+}
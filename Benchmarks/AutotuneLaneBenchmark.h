@@ -0,0 +1,77 @@
+/**
+* Autotune Lane Benchmark - Runs parallel Autotune lanes against a simulated
+*	laser, to check that AutotuneLaneStepper keeps the lanes' commands apart
+*	and to measure the time it saves.
+*
+* - Each lane tunes its components one after another: for each measurement
+*	it sends a set command, waits for the component to settle (temperature
+*	components only), sends a read command and hands the power of a
+*	simulated power curve (GenerateSimulatedPowerCurves(..)) to a
+*	PeakSearch. Each component has its own noise, so a component measures
+*	the same in every run.
+* - The same components are run once as a single lane (one after another)
+*	and once in settings.laneCount lanes, each time through
+*	AutotuneLaneStepper on a ProcedureExecutor, as AutotunePowerPanel does.
+* - Checks: the simulated link never has two commands in flight, and every
+*	component ends on the same best setting in both runs.
+* - The parallel run's stepper also estimates the one-after-another time
+*	(GetSequentialTime()), which is compared with the measured one.
+*
+* The lanes stand in for AutotunePowerManager, which isn't part of this
+* code, so this checks the stepping and the link, not the managers.
+*
+* Example usage:
+*
+*	AutotuneLaneBenchmarkSettings settings;
+*	cout << FormatAutotuneLaneBenchmark(RunAutotuneLaneBenchmark(settings)) << endl;
+*
+* @file AutotuneLaneBenchmark.h
+* @created October 2026
+* @version 1.0
+*/
+#pragma once
+
+#include <string>
+
+#include "PeakSearch.h"
+#include "../SimulatedLaser.h"
+
+
+struct AutotuneLaneBenchmarkSettings {
+	size_t laneCount = 3;
+	size_t componentsPerLane = 2;
+	// Every other component is a temperature, which waits this long after each set command
+	double settleMilliseconds = 20;
+	SimulatedLaserSettings laser;
+	// The sweep Autotune-Power uses
+	PeakSearchStrategy strategy = PeakSearchStrategy::SWEEP;
+	PeakSearchSettings search;
+	unsigned seed = 1;
+
+	AutotuneLaneBenchmarkSettings() {
+		laser.commandMilliseconds = 1;
+		search.range = 20;
+		search.precision = 0.5;
+	}
+};
+
+
+struct AutotuneLaneBenchmarkResult {
+	size_t laneCount = 0;
+	size_t componentCount = 0;
+	size_t commandCount = 0;
+	double sequentialSeconds = 0;
+	double parallelSeconds = 0;
+	// The parallel stepper's estimate of sequentialSeconds
+	double estimatedSequentialSeconds = 0;
+	// Most commands in flight at once in either run (1 if the lanes take turns)
+	size_t maxConcurrentCommands = 0;
+	// Components whose best setting differs between the runs
+	size_t settingMismatches = 0;
+};
+
+
+AutotuneLaneBenchmarkResult RunAutotuneLaneBenchmark(const AutotuneLaneBenchmarkSettings& settings);
+
+// One line, e.g. "3 lanes, 6 components, 150 commands: 1.52 s one after another (estimated 1.49 s), 0.61 s in parallel, 1 command in flight at most, 0 settings differ"
+std::string FormatAutotuneLaneBenchmark(const AutotuneLaneBenchmarkResult& result);
@@ -0,0 +1,31 @@
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#include "BenchmarkAllocations.h"
+
+using namespace std;
+
+
+static atomic<long long> allocationCount{ 0 };
+
+
+void* operator new(size_t size) {
+	allocationCount.fetch_add(1, memory_order_relaxed);
+	if (void* memory = malloc(size > 0 ? size : 1))
+		return memory;
+	throw bad_alloc();
+}
+
+void operator delete(void* memory) noexcept {
+	free(memory);
+}
+
+void operator delete(void* memory, size_t) noexcept {
+	free(memory);
+}
+
+
+long long GetBenchmarkAllocationCount() {
+	return allocationCount.load(memory_order_relaxed);
+}
@@ -0,0 +1,17 @@
+/**
+* Benchmark Allocations - Counts the heap allocations of the benchmark
+*	program, for benchmarks that report allocations per row.
+*
+* - BenchmarkAllocations.cpp replaces the global operator new and delete.
+*	It is only part of the benchmark program, never of the logging library
+*	or the application.
+*
+* @file BenchmarkAllocations.h
+* @created October 2026
+* @version 1.0
+*/
+#pragma once
+
+
+// Heap allocations of this process so far
+long long GetBenchmarkAllocationCount();
@@ -0,0 +1,128 @@
+/**
+* Benchmark Main - Entry point of the benchmark program, which runs every
+*	benchmark of the logging library and the GUI and prints one line per
+*	result.
+*
+* - Built as its own program against the logging library and the GUI
+*	sources it benchmarks, together with every .cpp file of this folder.
+* - Files are written to a temporary folder, which is deleted afterwards.
+* - The Real-Time Observer benchmark needs a window and an event loop, so
+*	the program is a wxWidgets app. The benchmarks run once the main loop
+*	has started, and the program exits when they're done.
+* - Returns 1 if a benchmark that checks its results failed.
+*
+* @file BenchmarkMain.cpp
+* @created October 2026
+* @version 1.0
+*/
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <string>
+
+#include "AutotuneLaneBenchmark.h"
+#include "LogFileDecoderBenchmark.h"
+#include "LogNotifierBenchmark.h"
+#include "LogSessionIndexBenchmark.h"
+#include "LoggerBaseBenchmark.h"
+#include "MemoryLogBenchmark.h"
+#include "PeakSearchBenchmark.h"
+#include "RealTimeObserverBenchmark.h"
+#include "wx/wx.h"
+
+using namespace std;
+
+
+static void PrintLine(const string& line) {
+	printf("%s\n", line.c_str());
+	fflush(stdout);
+}
+
+
+// Runs every benchmark in directory. Returns false if one failed its check.
+static bool RunBenchmarks(wxWindow* parent, const filesystem::path& directory) {
+	bool passed = true;
+
+	PrintLine("LoggerBase");
+	for (const LoggerBenchmarkResult& result : RunLoggerBaseBenchmark((directory / "LoggerBase").string(), 100000))
+		PrintLine(FormatLoggerBenchmark(result));
+
+	PrintLine("MemoryLog");
+	for (MemoryLogPolicy policy : { MemoryLogPolicy::UNBOUNDED, MemoryLogPolicy::RING, MemoryLogPolicy::SPILL_TO_DISK }) {
+		MemoryLogBenchmarkResult result = RunMemoryLogBenchmark(policy, 8 * 1024 * 1024, 1000000);
+		PrintLine(FormatMemoryLogBenchmark(result));
+		passed = passed and result.passed;
+	}
+
+	PrintLine("LogNotifier");
+	for (const LogNotifierBenchmarkResult& result : RunLogNotifierBenchmark((directory / "LogNotifier").string(), 20000))
+		PrintLine(FormatLogNotifierBenchmark(result));
+
+	PrintLine("LogSessionIndex");
+	LogSessionIndexBenchmarkResult sessionIndexResult = RunLogSessionIndexBenchmark((directory / "LogSessionIndex").string(), 10000, 100, 8);
+	PrintLine(FormatLogSessionIndexBenchmark(sessionIndexResult));
+	passed = passed and sessionIndexResult.duplicateIDs == 0 and sessionIndexResult.failedClaims == 0;
+
+	PrintLine("LogFileDecoder");
+	for (const LogFileDecoderBenchmarkResult& result : RunLogFileDecoderBenchmark((directory / "LogFileDecoder").string(), 256ull << 20)) {
+		PrintLine(FormatLogFileDecoderBenchmark(result));
+		passed = passed and result.passed;
+	}
+
+	PrintLine("PeakSearch");
+	PeakSearchSettings searchSettings;
+	searchSettings.range = 20;
+	searchSettings.precision = 0.5;
+	auto curves = GenerateSimulatedPowerCurves(searchSettings, 1000, 1);
+	for (PeakSearchStrategy strategy : { PeakSearchStrategy::SWEEP, PeakSearchStrategy::PARABOLIC })
+		PrintLine(FormatPeakSearchBenchmark(RunPeakSearchBenchmark(strategy, searchSettings, curves, 2)));
+
+	PrintLine("AutotuneLane");
+	AutotuneLaneBenchmarkResult laneResult = RunAutotuneLaneBenchmark(AutotuneLaneBenchmarkSettings());
+	PrintLine(FormatAutotuneLaneBenchmark(laneResult));
+	passed = passed and laneResult.settingMismatches == 0;
+
+	PrintLine("RealTimeObserver");
+	for (RealTimeViewType type : { RealTimeViewType::PER_VALUE, RealTimeViewType::BATCHED })
+		PrintLine(FormatRealTimeObserverBenchmark(RunRealTimeObserverBenchmark(parent, type, 100, 10, 12)));
+
+	return passed;
+}
+
+
+class BenchmarkApp : public wxApp {
+
+public:
+	bool OnInit() override {
+		frame = new wxFrame(nullptr, wxID_ANY, "Benchmarks");
+		frame->Show();
+
+		CallAfter([this]() {
+			filesystem::path directory = filesystem::temp_directory_path() /
+				("LaserControllerBenchmarks_" + to_string(chrono::steady_clock::now().time_since_epoch().count()));
+			filesystem::create_directories(directory);
+
+			exitCode = RunBenchmarks(frame, directory) ? 0 : 1;
+
+			error_code error;
+			filesystem::remove_all(directory, error);
+			frame->Destroy();
+			ExitMainLoop();
+		});
+		return true;
+	}
+
+	int OnRun() override {
+		wxApp::OnRun();
+		return exitCode;
+	}
+
+
+private:
+	wxFrame* frame = nullptr;
+	int exitCode = 1;
+
+};
+
+
+wxIMPLEMENT_APP_CONSOLE(BenchmarkApp);
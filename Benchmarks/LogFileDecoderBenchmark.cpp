@@ -0,0 +1,128 @@
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <thread>
+
+#include "LogFileDecoderBenchmark.h"
+#include "../LogFileDecoder.h"
+#include "../LogLifecycleManager.h"
+#include "../LoggerBase.h"
+#include "../../Security/DataDecryptor.h"
+
+using namespace std;
+
+
+static const size_t BENCHMARK_COLUMN_COUNT = 8;
+static const size_t DISTINCT_ROW_COUNT = 1000;
+static const size_t METADATA_LINE_INTERVAL = 10000;
+static const double BYTES_PER_MEGABYTE = 1024.0 * 1024.0;
+
+
+static vector<string> MakeLines() {
+	vector<string> lines;
+	char value[32];
+	for (size_t row = 0; row < DISTINCT_ROW_COUNT; row++) {
+		string line = "2026-10-17,12:34:56.789";
+		for (size_t col = 0; col < BENCHMARK_COLUMN_COUNT; col++) {
+			snprintf(value, sizeof(value), ",%.6f", double(row) * 0.001 + double(col) * 1.5);
+			line += value;
+		}
+		lines.push_back(line);
+	}
+	return lines;
+}
+
+// Write rows until the file holds about file_bytes. Returns the number of
+//   lines the decoder should find.
+static unsigned long long WriteSyntheticLogFile(const string& file_path, unsigned long long file_bytes, unsigned long long& metadata_line_count) {
+
+	error_code error;
+	filesystem::remove(file_path, error);
+	vector<string> lines = MakeLines();
+
+	LoggerBase logger;
+	for (size_t col = 0; col < BENCHMARK_COLUMN_COUNT; col++)
+		logger.AddColumn("Value " + to_string(col));
+	logger.SetFilePath(file_path);
+	logger.SetDurability(LogDurability::BUFFERED);
+	logger.SetMemoryLogPolicy(MemoryLogPolicy::RING, 8 * 1024 * 1024);
+	logger.WriteHeaderLine();
+	unsigned long long lineCount = 1;
+	metadata_line_count = 0;
+
+	// Encrypted lines are about as long as the text
+	unsigned long long textBytes = 0;
+	for (size_t row = 0; textBytes < file_bytes; row++) {
+		if (row % METADATA_LINE_INTERVAL == 0) {
+			logger.CommitLineMetadata("Rows from " + to_string(row));
+			lineCount++;
+			metadata_line_count++;
+		}
+		const string& line = lines[row % lines.size()];
+		logger.CommitLineEncrypt(line);
+		textBytes += line.size() + 1;
+		lineCount++;
+	}
+	logger.Flush();
+	return lineCount;
+}
+
+static LogFileDecoderBenchmarkResult TimeDecode(const string& file_path, const string& file, unsigned int thread_count,
+	unsigned long long expected_line_count, unsigned long long metadata_line_count) {
+
+	LogFileDecoderBenchmarkResult result;
+	result.file = file;
+	result.threadCount = thread_count;
+	result.expectedLineCount = expected_line_count;
+
+	LogFileDecoder decoder([](const string& line) { return decryptofy(line); }, thread_count);
+	unsigned long long dataLineCount = 0;
+	bool completed = decoder.Decode(file_path, [&](const LogDecodedChunk& chunk) {
+		for (const LogDecodedLine& line : chunk.lines) {
+			if (line.type == LogLineType::DATA and line.fieldCount == 2 + BENCHMARK_COLUMN_COUNT)
+				dataLineCount++;
+		}
+		return true;
+	});
+
+	LogDecodeStatistics statistics = decoder.GetStatistics();
+	result.bytesRead = statistics.bytesRead;
+	result.lineCount = statistics.lineCount;
+	result.seconds = statistics.durationSeconds;
+	result.megabytesPerSecond = result.seconds > 0 ? double(result.bytesRead) / BYTES_PER_MEGABYTE / result.seconds : 0;
+	// Every line but the metadata lines has the header's field count
+	result.passed = completed and statistics.unreadableLineCount == 0 and result.lineCount == expected_line_count
+		and dataLineCount == expected_line_count - metadata_line_count;
+	return result;
+}
+
+
+vector<LogFileDecoderBenchmarkResult> RunLogFileDecoderBenchmark(const string& directory, unsigned long long file_bytes) {
+	error_code error;
+	filesystem::create_directories(directory, error);
+	unsigned int coreCount = max(thread::hardware_concurrency(), 1u);
+
+	vector<LogFileDecoderBenchmarkResult> results;
+	string filePath = (filesystem::path(directory) / "DecoderBenchmark.log").string();
+	unsigned long long metadataLineCount;
+	unsigned long long lineCount = WriteSyntheticLogFile(filePath, file_bytes, metadataLineCount);
+
+	results.push_back(TimeDecode(filePath, "Text", 1, lineCount, metadataLineCount));
+	results.push_back(TimeDecode(filePath, "Text", coreCount, lineCount, metadataLineCount));
+
+	if (LogLifecycleManager::CompressLogFile(filePath)) {
+		filePath += LogLifecycleManager::COMPRESSED_LOG_EXTENSION;
+		results.push_back(TimeDecode(filePath, "Compressed", coreCount, lineCount, metadataLineCount));
+	}
+	filesystem::remove(filePath, error);
+	return results;
+}
+
+
+string FormatLogFileDecoderBenchmark(const LogFileDecoderBenchmarkResult& result) {
+	char line[200];
+	snprintf(line, sizeof(line), "%s, %u thread%s: %.1f MB, %llu lines in %.2f s, %.1f MB/s, %s", result.file.c_str(),
+		result.threadCount, result.threadCount == 1 ? "" : "s", double(result.bytesRead) / BYTES_PER_MEGABYTE,
+		result.lineCount, result.seconds, result.megabytesPerSecond, result.passed ? "passed" : "FAILED");
+	return line;
+}
@@ -0,0 +1,47 @@
+/**
+* Log File Decoder Benchmark - Measures how fast LogFileDecoder reads a large
+*	synthetic log file, in MB of log file text per second.
+*
+* - A text log file of about file_bytes, with encrypted rows, a header line
+*	and a metadata line every 10000 rows, is written in the given directory.
+* - The file is decoded with one thread and with one thread per core. It is
+*	then compressed (LogLifecycleManager::CompressLogFile(..)) and decoded
+*	again, which streams it through the reader thread.
+* - Per-line rows are decrypted with decryptofy(..), which the decoder
+*	calls one at a time.
+* - Every line is counted, so a decoder that loses lines fails the check.
+*
+* Example usage:
+*
+*	for (const LogFileDecoderBenchmarkResult& result : RunLogFileDecoderBenchmark("C:/Temp/DecoderBenchmark", 1ull << 30))
+*		cout << FormatLogFileDecoderBenchmark(result) << endl;
+*
+* @file LogFileDecoderBenchmark.h
+* @created October 2026
+* @version 1.0
+*/
+#pragma once
+
+#include <string>
+#include <vector>
+
+
+struct LogFileDecoderBenchmarkResult {
+	// "Text" or "Compressed"
+	std::string file;
+	unsigned int threadCount = 0;
+	// Log file text, after decompression
+	unsigned long long bytesRead = 0;
+	unsigned long long lineCount = 0;
+	unsigned long long expectedLineCount = 0;
+	double seconds = 0;
+	double megabytesPerSecond = 0;
+	// Every line was decoded and none was unreadable
+	bool passed = false;
+};
+
+
+std::vector<LogFileDecoderBenchmarkResult> RunLogFileDecoderBenchmark(const std::string& directory, unsigned long long file_bytes);
+
+// One line, e.g. "Text, 8 threads: 1024.0 MB, 10485760 lines in 2.31 s, 443.3 MB/s, passed"
+std::string FormatLogFileDecoderBenchmark(const LogFileDecoderBenchmarkResult& result);
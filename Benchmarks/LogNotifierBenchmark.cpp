@@ -0,0 +1,172 @@
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <map>
+#include <memory>
+
+#include "LogNotifierBenchmark.h"
+#include "../LoggerBase.h"
+#include "../../CommonFunctions.h"
+
+using namespace std;
+
+
+// The observer interface before row views: the map is passed by value
+class ByValueMapObserver {
+
+public:
+	virtual ~ByValueMapObserver() = default;
+	virtual void onDataPointLogged(map<string, string> data) = 0;
+
+};
+
+
+class ByValueMapReader : public ByValueMapObserver {
+
+public:
+	ByValueMapReader(const string& column_name, double& checksum) : columnName(column_name), sum(checksum) {};
+
+	void onDataPointLogged(map<string, string> data) override {
+		sum += stod(data[columnName]);
+	};
+
+private:
+	string columnName;
+	double& sum;
+
+};
+
+
+class MapReader : public LogObserver {
+
+public:
+	MapReader(const string& column_name, double& checksum) : columnName(column_name), sum(checksum) {};
+
+	void onDataPointLogged(map<string, string> data) override {
+		sum += stod(data[columnName]);
+	};
+
+private:
+	string columnName;
+	double& sum;
+
+};
+
+
+class RowReader : public LogRowObserver {
+
+public:
+	RowReader(const string& column_name, double& checksum) : columnName(column_name), sum(checksum) {};
+
+	void onRowLogged(const LogRowView& row) override {
+		if (row.GetSchema() != schema) {
+			schema = row.GetSchema();
+			column = schema->IndexOf(columnName);
+		}
+		double value;
+		if (column != LogColumnSchema::NOT_FOUND and row.GetNumber(column, value))
+			sum += value;
+	};
+
+private:
+	string columnName;
+	double& sum;
+	shared_ptr<const LogColumnSchema> schema;
+	size_t column = LogColumnSchema::NOT_FOUND;
+
+};
+
+
+// Logs the rows and hands each one to the by-value observers the way the
+//	notifier used to
+class ByValueMapLogger : public LoggerBase {
+
+public:
+	vector<ByValueMapObserver*> observers;
+
+	void LogRow(const vector<string>& values) {
+		LogDataPoint(values);
+		if (observers.empty())
+			return;
+
+		map<string, string> data;
+		data["Date"] = GenerateDateString();
+		data["Time"] = GenerateTimeString();
+		for (size_t col = 0; col < values.size(); col++)
+			data["Value " + to_string(col)] = values[col];
+		for (ByValueMapObserver* observer : observers)
+			observer->onDataPointLogged(data);
+	};
+
+};
+
+
+static string GetColumnName(size_t col) {
+	return "Value " + to_string(col);
+}
+
+
+vector<LogNotifierBenchmarkResult> RunLogNotifierBenchmark(const string& directory, size_t row_count) {
+	error_code error;
+	filesystem::create_directories(directory, error);
+	string filePath = (filesystem::path(directory) / "LogNotifierBenchmark.log").string();
+
+	vector<vector<string>> rows;
+	for (size_t row = 0; row < 100; row++) {
+		rows.emplace_back();
+		for (size_t col = 0; col < LOG_NOTIFIER_BENCHMARK_COLUMNS; col++)
+			rows.back().push_back(to_string(double(row) * 0.01 + double(col)));
+	}
+
+	vector<LogNotifierBenchmarkResult> results;
+	for (string observerType : { "By-value map", "LogObserver", "LogRowObserver", "No observers" }) {
+		filesystem::remove(filePath, error);
+
+		LogNotifierBenchmarkResult result;
+		result.observerType = observerType;
+		result.rowCount = row_count;
+
+		vector<unique_ptr<ByValueMapObserver>> byValueObservers;
+		vector<shared_ptr<LogRowObserver>> observers;
+		{
+			ByValueMapLogger logger;
+			for (size_t col = 0; col < LOG_NOTIFIER_BENCHMARK_COLUMNS; col++)
+				logger.AddColumn(GetColumnName(col));
+			logger.SetFilePath(filePath);
+			logger.SetDurability(LogDurability::BUFFERED);
+
+			for (size_t i = 0; i < LOG_NOTIFIER_BENCHMARK_OBSERVERS; i++) {
+				string columnName = GetColumnName(i * 7 % LOG_NOTIFIER_BENCHMARK_COLUMNS);
+				if (observerType == "By-value map") {
+					byValueObservers.push_back(make_unique<ByValueMapReader>(columnName, result.checksum));
+					logger.observers.push_back(byValueObservers.back().get());
+				}
+				else if (observerType == "LogObserver")
+					observers.push_back(make_shared<MapReader>(columnName, result.checksum));
+				else if (observerType == "LogRowObserver")
+					observers.push_back(make_shared<RowReader>(columnName, result.checksum));
+			}
+			for (const auto& observer : observers)
+				logger.addObserver(observer);
+
+			auto startTime = chrono::steady_clock::now();
+			for (size_t row = 0; row < row_count; row++)
+				logger.LogRow(rows[row % rows.size()]);
+			logger.Flush();
+			double seconds = chrono::duration<double>(chrono::steady_clock::now() - startTime).count();
+			result.microsecondsPerRow = row_count > 0 ? 1e6 * seconds / double(row_count) : 0;
+		}
+		results.push_back(result);
+	}
+
+	filesystem::remove(filePath, error);
+	return results;
+}
+
+
+string FormatLogNotifierBenchmark(const LogNotifierBenchmarkResult& result) {
+	char line[200];
+	snprintf(line, sizeof(line), "%s: %zu rows, %.1f us/row", result.observerType.c_str(), result.rowCount,
+		result.microsecondsPerRow);
+	return line;
+}
@@ -0,0 +1,45 @@
+/**
+* Log Notifier Benchmark - Measures the time per row LoggerBase spends
+*	logging and notifying observers, for each kind of observer.
+*
+* - Each run logs rows of 50 float columns with 5 observers subscribed,
+*	BUFFERED, into a fresh file in the given directory.
+* - "By-value map" replays the old notification: a map of the row built
+*	for the notifier and copied into each observer.
+* - "LogObserver" uses the map adapter, "LogRowObserver" reads the row view,
+*	and "No observers" is the cost of logging alone.
+* - Every observer reads one column, so the work it does is the same.
+*
+* Example usage:
+*
+*	for (const LogNotifierBenchmarkResult& result : RunLogNotifierBenchmark("C:/Temp/LogNotifierBenchmark", 20000))
+*		cout << FormatLogNotifierBenchmark(result) << endl;
+*
+* @file LogNotifierBenchmark.h
+* @created October 2026
+* @version 1.0
+*/
+#pragma once
+
+#include <string>
+#include <vector>
+
+
+const size_t LOG_NOTIFIER_BENCHMARK_COLUMNS = 50;
+const size_t LOG_NOTIFIER_BENCHMARK_OBSERVERS = 5;
+
+
+struct LogNotifierBenchmarkResult {
+	// "By-value map", "LogObserver", "LogRowObserver" or "No observers"
+	std::string observerType;
+	size_t rowCount = 0;
+	double microsecondsPerRow = 0;
+	// Sum of the column each observer read, so the work can't be skipped
+	double checksum = 0;
+};
+
+
+std::vector<LogNotifierBenchmarkResult> RunLogNotifierBenchmark(const std::string& directory, size_t row_count);
+
+// One line, e.g. "LogRowObserver: 20000 rows, 1.9 us/row"
+std::string FormatLogNotifierBenchmark(const LogNotifierBenchmarkResult& result);
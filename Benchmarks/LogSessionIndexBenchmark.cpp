@@ -0,0 +1,100 @@
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include "LogSessionIndexBenchmark.h"
+#include "../LogSessionIndex.h"
+
+using namespace std;
+
+
+static string GetBenchmarkFileName(int id) {
+	return "BenchmarkLogs_" + to_string(id) + ".log";
+}
+
+static double GetMillisecondsSince(chrono::steady_clock::time_point start_time) {
+	return chrono::duration<double, milli>(chrono::steady_clock::now() - start_time).count();
+}
+
+
+LogSessionIndexBenchmarkResult RunLogSessionIndexBenchmark(const string& directory, size_t existing_file_count,
+	size_t claim_count, size_t thread_count) {
+
+	LogSessionIndexBenchmarkResult result;
+	result.existingFileCount = existing_file_count;
+	result.threadCount = thread_count;
+
+	error_code error;
+	filesystem::create_directories(directory, error);
+	filesystem::remove(filesystem::path(directory) / LogSessionIndex::SESSION_INDEX_FILENAME, error);
+	for (size_t id = 1; id <= existing_file_count; id++)
+		ofstream((filesystem::path(directory) / GetBenchmarkFileName(int(id))).string());
+
+	auto startTime = chrono::steady_clock::now();
+	LogSessionIndex::ScanHighestLogID(directory);
+	result.scanMilliseconds = GetMillisecondsSince(startTime);
+
+	LogSessionIndex index(directory, GetBenchmarkFileName);
+	startTime = chrono::steady_clock::now();
+	index.ClaimNextLogID();
+	result.firstClaimMilliseconds = GetMillisecondsSince(startTime);
+
+	if (claim_count > 0) {
+		startTime = chrono::steady_clock::now();
+		for (size_t i = 0; i < claim_count; i++)
+			index.ClaimNextLogID();
+		result.claimMilliseconds = GetMillisecondsSince(startTime) / double(claim_count);
+
+		startTime = chrono::steady_clock::now();
+		for (size_t i = 0; i < claim_count; i++)
+			index.PeekNextLogID();
+		result.peekMilliseconds = GetMillisecondsSince(startTime) / double(claim_count);
+	}
+
+	// Concurrent claims
+	mutex idsMutex;
+	multiset<int> ids;
+	vector<thread> threads;
+	for (size_t t = 0; t < thread_count; t++) {
+		threads.emplace_back([&]() {
+			LogSessionIndex threadIndex(directory, GetBenchmarkFileName);
+			for (size_t i = 0; i < claim_count; i++) {
+				int id = threadIndex.ClaimNextLogID();
+				lock_guard<mutex> lock(idsMutex);
+				ids.insert(id);
+			}
+		});
+	}
+	for (thread& claimingThread : threads)
+		claimingThread.join();
+
+	result.concurrentClaims = ids.size();
+	result.failedClaims = ids.count(0);
+	for (auto id = ids.begin(); id != ids.end(); id = ids.upper_bound(*id)) {
+		if (*id != 0)
+			result.duplicateIDs += ids.count(*id) - 1;
+	}
+
+	// Everything created here has a benchmark name
+	for (const auto& file : filesystem::directory_iterator(directory, error)) {
+		string filename = file.path().filename().string();
+		if (filename.rfind("BenchmarkLogs_", 0) == 0 or filename.rfind(LogSessionIndex::SESSION_INDEX_FILENAME, 0) == 0)
+			filesystem::remove(file.path(), error);
+	}
+	return result;
+}
+
+
+string FormatLogSessionIndexBenchmark(const LogSessionIndexBenchmarkResult& result) {
+	char line[300];
+	snprintf(line, sizeof(line), "%zu files: scan %.2f ms, first claim %.2f ms, claim %.3f ms, peek %.3f ms, "
+		"%zu threads x %zu claims: %zu duplicate IDs, %zu failed", result.existingFileCount, result.scanMilliseconds,
+		result.firstClaimMilliseconds, result.claimMilliseconds, result.peekMilliseconds, result.threadCount,
+		result.threadCount > 0 ? result.concurrentClaims / result.threadCount : 0, result.duplicateIDs, result.failedClaims);
+	return line;
+}
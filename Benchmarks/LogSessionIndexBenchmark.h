@@ -0,0 +1,48 @@
+/**
+* Log Session Index Benchmark - Compares finding the next log ID by
+*	scanning the directory (the old BackgroundLogger way) with the
+*	LogSessionIndex sidecar, in a directory of many existing log files.
+*
+* - Fills the given directory with existing_file_count empty log files,
+*	and deletes everything it created at the end.
+* - "Scan" is one ScanHighestLogID(..), which the old code did for every
+*	new log and every suggested file name. "First claim" builds the
+*	missing sidecar. "Claim" and "Peek" are the mean of later calls.
+* - Then thread_count threads claim IDs at once, each with its own
+*	LogSessionIndex like separate GUI/API processes would, and the IDs are
+*	checked to be unique.
+*
+* Example usage:
+*
+*	LogSessionIndexBenchmarkResult result = RunLogSessionIndexBenchmark("C:/Temp/LogSessionIndexBenchmark", 10000, 100, 8);
+*	cout << FormatLogSessionIndexBenchmark(result) << endl;
+*
+* @file LogSessionIndexBenchmark.h
+* @created October 2026
+* @version 1.0
+*/
+#pragma once
+
+#include <string>
+
+
+struct LogSessionIndexBenchmarkResult {
+	size_t existingFileCount = 0;
+	double scanMilliseconds = 0;
+	double firstClaimMilliseconds = 0;
+	double claimMilliseconds = 0;
+	double peekMilliseconds = 0;
+	// Concurrent claims
+	size_t threadCount = 0;
+	size_t concurrentClaims = 0;
+	size_t duplicateIDs = 0;
+	size_t failedClaims = 0;
+};
+
+
+LogSessionIndexBenchmarkResult RunLogSessionIndexBenchmark(const std::string& directory, size_t existing_file_count,
+	size_t claim_count, size_t thread_count);
+
+// One line, e.g. "10000 files: scan 9.10 ms, first claim 15.00 ms, claim 0.160 ms, peek 0.020 ms,
+//   8 threads x 100 claims: 0 duplicate IDs, 0 failed"
+std::string FormatLogSessionIndexBenchmark(const LogSessionIndexBenchmarkResult& result);
@@ -0,0 +1,232 @@
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <map>
+#ifdef _WIN32
+#include <Windows.h>
+#endif
+
+#include "LoggerBaseBenchmark.h"
+#include "BenchmarkAllocations.h"
+#include "../LoggerBase.h"
+#include "../../CommonFunctions.h"
+#include "../../Security/DataDecryptor.h"
+
+using namespace std;
+
+
+static const size_t BENCHMARK_COLUMN_COUNT = 8;
+static const size_t SYNC_ROW_DIVISOR = 10;
+// Rows logged before timing, so buffers have grown to their steady size
+static const size_t WARM_UP_ROW_COUNT = 1000;
+
+
+// Write operations of this process so far, or -1 if unknown
+static long long GetWriteCallCount() {
+#ifdef _WIN32
+	IO_COUNTERS counters;
+	if (!GetProcessIoCounters(GetCurrentProcess(), &counters))
+		return -1;
+	return (long long)counters.WriteOperationCount;
+#else
+	ifstream io("/proc/self/io");
+	string name;
+	long long value;
+	while (io >> name >> value) {
+		if (name == "syscw:")
+			return value;
+	}
+	return -1;
+#endif
+}
+
+
+// The old LoggerBase output path: open, append and close for every line
+class ReopeningLogger {
+
+public:
+	explicit ReopeningLogger(const string& file_path) : filePath(file_path) {
+		columnNames = { "Date", "Time" };
+		for (size_t col = 0; col < BENCHMARK_COLUMN_COUNT; col++)
+			columnNames.push_back("Value " + to_string(col));
+	}
+
+	void CommitLine(string line) {
+		logDataInMemory.push_back(line);
+		WriteLineToFile(line);
+	}
+
+	void CommitLineEncrypt(string line) {
+		logDataInMemory.push_back(line);
+		WriteLineToFile(GetEncryptedLinePrefix() + cryptofy(line));
+	}
+
+	void LogDataPoint(const vector<string>& values) {
+		string date = GenerateDateString();
+		string time = GenerateTimeString();
+
+		map<string, string> dataForObservers;
+		dataForObservers["Date"] = date;
+		dataForObservers["Time"] = time;
+		for (size_t col = 2; col < columnNames.size(); col++)
+			dataForObservers[columnNames[col]] = values[col - 2];
+
+		string line = "";
+		line += date + ",";
+		line += time + ",";
+		for (string value : values)
+			line += value + ",";
+		line[line.length() - 1] = ' ';
+		CommitLine(line);
+	}
+
+
+private:
+	string filePath;
+	ofstream logFile;
+	vector<string> columnNames;
+	vector<string> logDataInMemory;
+
+	void WriteLineToFile(string line) {
+		logFile.open(filePath, ios::app);
+		if (logFile.is_open()) {
+			if (line.back() != '\n')
+				line = line + '\n';
+			logFile << line;
+			logFile.close();
+		}
+	}
+
+};
+
+
+static LoggerBenchmarkResult TimeRows(const string& path, const string& operation, size_t row_count,
+	const function<void(size_t)>& log_row, const function<void()>& finish) {
+
+	LoggerBenchmarkResult result;
+	result.path = path;
+	result.operation = operation;
+	result.rowCount = row_count;
+
+	for (size_t row = 0; row < WARM_UP_ROW_COUNT; row++)
+		log_row(row);
+	finish();
+
+	long long allocationsBefore = GetBenchmarkAllocationCount();
+	long long writeCallsBefore = GetWriteCallCount();
+	auto startTime = chrono::steady_clock::now();
+	for (size_t row = 0; row < row_count; row++)
+		log_row(row);
+	finish();
+	double seconds = chrono::duration<double>(chrono::steady_clock::now() - startTime).count();
+	long long writeCallsAfter = GetWriteCallCount();
+	long long allocationsAfter = GetBenchmarkAllocationCount();
+
+	result.rowsPerSecond = seconds > 0 ? double(row_count) / seconds : 0;
+	if (writeCallsBefore >= 0 and writeCallsAfter >= 0 and row_count > 0)
+		result.writeCallsPerRow = double(writeCallsAfter - writeCallsBefore) / double(row_count);
+	if (allocationsBefore >= 0 and row_count > 0)
+		result.allocationsPerRow = double(allocationsAfter - allocationsBefore) / double(row_count);
+	return result;
+}
+
+static vector<string> MakeRowValues(size_t row) {
+	vector<string> values;
+	for (size_t col = 0; col < BENCHMARK_COLUMN_COUNT; col++)
+		values.push_back(to_string(double(row) * 0.001 + double(col)));
+	return values;
+}
+
+
+vector<LoggerBenchmarkResult> RunLoggerBaseBenchmark(const string& directory, size_t row_count) {
+	error_code error;
+	filesystem::create_directories(directory, error);
+
+	// Same text for every path
+	vector<vector<string>> rowValues;
+	vector<vector<double>> rowNumbers;
+	vector<string> lines;
+	for (size_t row = 0; row < 1000; row++) {
+		rowValues.push_back(MakeRowValues(row));
+		rowNumbers.emplace_back();
+		for (const string& value : rowValues.back())
+			rowNumbers.back().push_back(stod(value));
+		string line;
+		for (const string& value : rowValues.back())
+			line += value + ",";
+		lines.push_back(line);
+	}
+
+	vector<LoggerBenchmarkResult> results;
+	int fileNumber = 0;
+	auto nextFilePath = [&]() {
+		string filePath = (filesystem::path(directory) / ("LoggerBenchmark_" + to_string(fileNumber++) + ".log")).string();
+		filesystem::remove(filePath, error);
+		return filePath;
+	};
+
+	// Old path
+	for (string operation : { "CommitLine", "CommitLineEncrypt", "LogDataPoint" }) {
+		ReopeningLogger logger(nextFilePath());
+		results.push_back(TimeRows("Open/append/close per line", operation, row_count, [&](size_t row) {
+			if (operation == "CommitLine")
+				logger.CommitLine(lines[row % lines.size()]);
+			else if (operation == "CommitLineEncrypt")
+				logger.CommitLineEncrypt(lines[row % lines.size()]);
+			else
+				logger.LogDataPoint(rowValues[row % rowValues.size()]);
+		}, [] {}));
+	}
+
+	// LoggerBase, file kept open
+	vector<pair<string, LogDurability>> durabilities = {
+		{ "FLUSH_EACH_LINE_TO_OS", LogDurability::FLUSH_EACH_LINE_TO_OS },
+		{ "BUFFERED", LogDurability::BUFFERED },
+		{ "SYNC_EACH_LINE", LogDurability::SYNC_EACH_LINE },
+	};
+	for (const auto& durability : durabilities) {
+		size_t rows = durability.second == LogDurability::SYNC_EACH_LINE ? row_count / SYNC_ROW_DIVISOR : row_count;
+		for (string operation : { "CommitLine", "CommitLineEncrypt", "LogDataPoint", "LogDataPoint typed" }) {
+			LoggerBase logger;
+			for (size_t col = 0; col < BENCHMARK_COLUMN_COUNT; col++)
+				logger.AddColumn("Value " + to_string(col));
+			logger.SetFilePath(nextFilePath());
+			logger.SetDurability(durability.second);
+			results.push_back(TimeRows(durability.first, operation, rows, [&](size_t row) {
+				if (operation == "CommitLine")
+					logger.CommitLine(lines[row % lines.size()]);
+				else if (operation == "CommitLineEncrypt")
+					logger.CommitLineEncrypt(lines[row % lines.size()]);
+				else if (operation == "LogDataPoint")
+					logger.LogDataPoint(rowValues[row % rowValues.size()]);
+				else {
+					const vector<double>& numbers = rowNumbers[row % rowNumbers.size()];
+					logger.LogDataPoint(numbers[0], numbers[1], numbers[2], numbers[3], numbers[4], numbers[5], numbers[6], numbers[7]);
+				}
+			}, [&] { logger.Flush(); }));
+		}
+	}
+
+	for (int i = 0; i < fileNumber; i++)
+		filesystem::remove(filesystem::path(directory) / ("LoggerBenchmark_" + to_string(i) + ".log"), error);
+	return results;
+}
+
+
+string FormatLoggerBenchmark(const LoggerBenchmarkResult& result) {
+	char line[200];
+	snprintf(line, sizeof(line), "%s / %s: %zu rows, %.0f rows/s", result.path.c_str(),
+		result.operation.c_str(), result.rowCount, result.rowsPerSecond);
+	string text = line;
+	if (result.writeCallsPerRow >= 0) {
+		snprintf(line, sizeof(line), ", %.2f write calls/row", result.writeCallsPerRow);
+		text += line;
+	}
+	if (result.allocationsPerRow >= 0) {
+		snprintf(line, sizeof(line), ", %.3f allocations/row", result.allocationsPerRow);
+		text += line;
+	}
+	return text;
+}
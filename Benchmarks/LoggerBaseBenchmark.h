@@ -0,0 +1,54 @@
+/**
+* Logger Base Benchmark - Compares the rows per second and the OS write calls
+*	per row of LoggerBase's output modes with the old path, which opened,
+*	appended to and closed the log file for every line.
+*
+* - Each path is run for CommitLine(..), CommitLineEncrypt(..) and
+*	LogDataPoint(..) with 8 float columns, into a fresh file in the given
+*	directory.
+* - Write calls are the process' write operations as counted by the OS
+*	(GetProcessIoCounters on Windows, /proc/self/io elsewhere). Opening and
+*	closing files isn't counted, so the old path makes two more system calls
+*	per row than shown.
+* - SYNC_EACH_LINE waits for the disk on every row, so it runs a tenth of
+*	the rows.
+* - LoggerBase paths also run "LogDataPoint typed", which passes the 8
+*	values as doubles to the LogDataPoint(values...) overload.
+* - Each path logs 1000 rows before it is timed, so only the steady state
+*	is measured.
+* - Heap allocations per row are counted by the benchmark program's
+*	operator new (BenchmarkAllocations.h).
+*
+* Example usage:
+*
+*	for (const LoggerBenchmarkResult& result : RunLoggerBaseBenchmark("C:/Temp/LoggerBenchmark", 100000))
+*		cout << FormatLoggerBenchmark(result) << endl;
+*
+* @file LoggerBaseBenchmark.h
+* @created October 2026
+* @version 1.0
+*/
+#pragma once
+
+#include <string>
+#include <vector>
+
+
+struct LoggerBenchmarkResult {
+	// e.g. "Open/append/close per line", "BUFFERED"
+	std::string path;
+	// "CommitLine", "CommitLineEncrypt" or "LogDataPoint"
+	std::string operation;
+	size_t rowCount = 0;
+	double rowsPerSecond = 0;
+	// -1 if the OS doesn't count write calls
+	double writeCallsPerRow = -1;
+	// -1 if allocations aren't counted
+	double allocationsPerRow = -1;
+};
+
+
+std::vector<LoggerBenchmarkResult> RunLoggerBaseBenchmark(const std::string& directory, size_t row_count);
+
+// One line, e.g. "BUFFERED / LogDataPoint: 100000 rows, 812345 rows/s, 0.02 write calls/row, 0.000 allocations/row"
+std::string FormatLoggerBenchmark(const LoggerBenchmarkResult& result);
@@ -0,0 +1,135 @@
+#include <chrono>
+#include <cstdio>
+#include <vector>
+#ifdef _WIN32
+#include <Windows.h>
+#include <Psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+#include "MemoryLogBenchmark.h"
+
+using namespace std;
+
+
+static const size_t BENCHMARK_COLUMN_COUNT = 8;
+
+
+// Peak memory of this process so far in bytes, or -1 if unknown
+static long long GetPeakProcessMemory() {
+#ifdef _WIN32
+	PROCESS_MEMORY_COUNTERS counters;
+	if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+		return -1;
+	return (long long)counters.PeakWorkingSetSize;
+#else
+	struct rusage usage;
+	if (getrusage(RUSAGE_SELF, &usage) != 0)
+		return -1;
+#ifdef __APPLE__
+	return (long long)usage.ru_maxrss;
+#else
+	return (long long)usage.ru_maxrss * 1024;
+#endif
+#endif
+}
+
+
+static const size_t BENCHMARK_VALUE_ROWS = 1000;
+
+
+// Float columns for a few rows, reused so formatting doesn't dominate the timing
+static vector<string> MakeRowValues() {
+	vector<string> rowValues;
+	char value[32];
+	for (size_t row = 0; row < BENCHMARK_VALUE_ROWS; row++) {
+		string values;
+		for (size_t col = 0; col < BENCHMARK_COLUMN_COUNT; col++) {
+			snprintf(value, sizeof(value), ",%.3f", double(row) * 0.001 + double(col));
+			values += value;
+		}
+		rowValues.push_back(values);
+	}
+	return rowValues;
+}
+
+// Same text for the same row, so it can be checked when read back
+static void MakeRow(size_t row, const vector<string>& row_values, string& line) {
+	char dateTime[40];
+	snprintf(dateTime, sizeof(dateTime), "2026-10-%02zu,%02zu:%02zu:%02zu.%03zu", 1 + row / 86400000 % 28,
+		row / 3600000 % 24, row / 60000 % 60, row / 1000 % 60, row % 1000);
+	line = dateTime;
+	line += row_values[row % row_values.size()];
+}
+
+
+static string ToString(MemoryLogPolicy policy) {
+	switch (policy) {
+	case MemoryLogPolicy::RING: return "RING";
+	case MemoryLogPolicy::SPILL_TO_DISK: return "SPILL_TO_DISK";
+	default: return "UNBOUNDED";
+	}
+}
+
+
+MemoryLogBenchmarkResult RunMemoryLogBenchmark(MemoryLogPolicy policy, size_t max_bytes_in_memory, size_t row_count) {
+	MemoryLogBenchmarkResult result;
+	result.policy = policy;
+	result.maxBytesInMemory = max_bytes_in_memory;
+	result.rowCount = row_count;
+
+	vector<string> rowValues = MakeRowValues();
+	long long peakBefore = GetPeakProcessMemory();
+	{
+		MemoryLog memoryLog;
+		memoryLog.SetPolicy(policy, max_bytes_in_memory);
+
+		string line;
+		auto startTime = chrono::steady_clock::now();
+		for (size_t row = 0; row < row_count; row++) {
+			MakeRow(row, rowValues, line);
+			memoryLog.push_back(line);
+			if (memoryLog.GetBytesInMemory() > result.peakBytesInMemory)
+				result.peakBytesInMemory = memoryLog.GetBytesInMemory();
+		}
+		double seconds = chrono::duration<double>(chrono::steady_clock::now() - startTime).count();
+		result.rowsPerSecond = seconds > 0 ? double(row_count) / seconds : 0;
+
+		// RING keeps only the newest rows
+		size_t firstRow = row_count - memoryLog.size();
+		string expected;
+		startTime = chrono::steady_clock::now();
+		memoryLog.ForEachLine([&](const string& read) {
+			MakeRow(firstRow + result.rowsReadBack, rowValues, expected);
+			if (read != expected)
+				result.rowsMismatched++;
+			result.rowsReadBack++;
+		});
+		result.readBackSeconds = chrono::duration<double>(chrono::steady_clock::now() - startTime).count();
+	}
+	long long peakAfter = GetPeakProcessMemory();
+	if (peakBefore >= 0 and peakAfter >= 0)
+		result.peakProcessGrowth = peakAfter - peakBefore;
+
+	// One chunk may be over the limit until the next line is added
+	size_t chunkSize = max_bytes_in_memory / 4;
+	bool withinLimit = policy == MemoryLogPolicy::UNBOUNDED or
+		(result.peakBytesInMemory <= max_bytes_in_memory + chunkSize and
+		(result.peakProcessGrowth < 0 or size_t(result.peakProcessGrowth) <= max_bytes_in_memory + MEMORY_LOG_CEILING_SLACK));
+	bool allRead = policy == MemoryLogPolicy::RING or result.rowsReadBack == row_count;
+	result.passed = withinLimit and allRead and result.rowsMismatched == 0;
+	return result;
+}
+
+
+string FormatMemoryLogBenchmark(const MemoryLogBenchmarkResult& result) {
+	const double MB = 1024.0 * 1024.0;
+	char line[300];
+	snprintf(line, sizeof(line), "%s, %.0f MB: %zu rows, %.0f rows/s, peak %.1f MB in memory, process %s%.1f MB, "
+		"%zu read back in %.1f s (%zu wrong), %s", ToString(result.policy).c_str(), result.maxBytesInMemory / MB,
+		result.rowCount, result.rowsPerSecond, result.peakBytesInMemory / MB, result.peakProcessGrowth < 0 ? "?" : "+",
+		result.peakProcessGrowth < 0 ? 0.0 : result.peakProcessGrowth / MB, result.rowsReadBack, result.readBackSeconds,
+		result.rowsMismatched, result.passed ? "passed" : "FAILED");
+	return line;
+}
@@ -0,0 +1,55 @@
+/**
+* Memory Log Benchmark - Checks that a MemoryLog stays under its memory
+*	ceiling while logging many rows, and that every row can be read back.
+*
+* - Rows look like LoggerBase data lines (date, time and 8 float columns).
+* - The ceiling is checked two ways: the largest GetBytesInMemory() seen,
+*	which must stay within the limit plus one chunk, and the growth of the
+*	process' peak memory (peak working set on Windows, max RSS elsewhere),
+*	which must stay within the limit plus MEMORY_LOG_CEILING_SLACK.
+* - Run it first in a fresh process, the peak memory of earlier work
+*	hides the growth.
+*
+* Example usage:
+*
+*	MemoryLogBenchmarkResult result = RunMemoryLogBenchmark(MemoryLogPolicy::SPILL_TO_DISK, 8 * 1024 * 1024, 10000000);
+*	cout << FormatMemoryLogBenchmark(result) << endl;
+*	if (!result.passed)
+*		...
+*
+* @file MemoryLogBenchmark.h
+* @created October 2026
+* @version 1.0
+*/
+#pragma once
+
+#include <string>
+
+#include "../MemoryLog.h"
+
+
+// Allowed process peak memory growth above the memory limit
+const size_t MEMORY_LOG_CEILING_SLACK = 16 * 1024 * 1024;
+
+
+struct MemoryLogBenchmarkResult {
+	MemoryLogPolicy policy = MemoryLogPolicy::UNBOUNDED;
+	size_t maxBytesInMemory = 0;
+	size_t rowCount = 0;
+	double rowsPerSecond = 0;
+	size_t peakBytesInMemory = 0;
+	// -1 if the OS doesn't report it
+	long long peakProcessGrowth = -1;
+	// Rows visited by ForEachLine(..) afterwards, and how many differed
+	size_t rowsReadBack = 0;
+	size_t rowsMismatched = 0;
+	double readBackSeconds = 0;
+	bool passed = false;
+};
+
+
+MemoryLogBenchmarkResult RunMemoryLogBenchmark(MemoryLogPolicy policy, size_t max_bytes_in_memory, size_t row_count);
+
+// One line, e.g. "SPILL_TO_DISK, 8 MB: 10000000 rows, 1412781 rows/s, peak 8.0 MB in memory, process +8.3 MB,
+//   10000000 read back in 6.8 s (0 wrong), passed"
+std::string FormatMemoryLogBenchmark(const MemoryLogBenchmarkResult& result);
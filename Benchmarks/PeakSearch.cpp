@@ -0,0 +1,293 @@
+#include <algorithm>
+#include <cmath>
+
+#include "PeakSearch.h"
+
+using namespace std;
+
+
+// Fraction of an interval the golden-section step goes into it
+static const double GOLDEN_SECTION = 0.381966;
+// Bracketing steps grow by the golden ratio
+static const double GOLDEN_RATIO = 1.618034;
+// Power differences within this many standard deviations are noise
+static const double NOISE_MARGIN = 3;
+
+
+string ToString(PeakSearchStrategy strategy) {
+	switch (strategy) {
+	case PeakSearchStrategy::SWEEP:
+		return "Sweep";
+	case PeakSearchStrategy::PARABOLIC:
+		return "Parabolic";
+	}
+	return "";
+}
+
+bool ParsePeakSearchStrategy(const string& name, PeakSearchStrategy& strategy) {
+	for (PeakSearchStrategy candidate : { PeakSearchStrategy::SWEEP, PeakSearchStrategy::PARABOLIC }) {
+		if (name == ToString(candidate)) {
+			strategy = candidate;
+			return true;
+		}
+	}
+	return false;
+}
+
+
+//-------------------------------------------------------------------------
+// PeakSearch
+
+unique_ptr<PeakSearch> PeakSearch::Create(PeakSearchStrategy strategy, const PeakSearchSettings& settings) {
+	if (strategy == PeakSearchStrategy::PARABOLIC)
+		return make_unique<ParabolicPeakSearch>(settings);
+	return make_unique<SweepPeakSearch>(settings);
+}
+
+PeakSearch::PeakSearch(const PeakSearchSettings& search_settings) :
+	settings(search_settings) {
+
+	if (settings.wholeNumbers)
+		settings.precision = max(1.0, round(settings.precision));
+	else if (settings.precision <= 0)
+		settings.precision = max(settings.range, 1.0) / 100;
+	settings.range = max(settings.range, 0.0);
+
+	lowLimit = settings.start - settings.range;
+	highLimit = settings.start + settings.range;
+	if (settings.wholeNumbers) {
+		lowLimit = ceil(lowLimit);
+		highLimit = floor(highLimit);
+	}
+	nextSetting = Limit(settings.start);
+	bestSetting = nextSetting;
+}
+
+double PeakSearch::GetNextSetting() const {
+	return nextSetting;
+}
+
+void PeakSearch::AddMeasurement(double power) {
+	if (finished)
+		return;
+
+	double setting = nextSetting;
+	measurements[setting] = power;
+	measurementCount++;
+	bestSetting = GetHighestMeasurement()->first;
+
+	if (measurementCount >= settings.maxMeasurements)
+		Finish(bestSetting);
+	else
+		OnMeasurement(setting, power);
+}
+
+bool PeakSearch::IsFinished() const {
+	return finished;
+}
+
+double PeakSearch::GetBestSetting() const {
+	return bestSetting;
+}
+
+int PeakSearch::GetMeasurementCount() const {
+	return measurementCount;
+}
+
+void PeakSearch::Finish(double best_setting) {
+	finished = true;
+	bestSetting = Limit(best_setting);
+}
+
+map<double, double>::const_iterator PeakSearch::GetHighestMeasurement() const {
+	return max_element(measurements.begin(), measurements.end(),
+		[](const pair<const double, double>& a, const pair<const double, double>& b) { return a.second < b.second; });
+}
+
+bool PeakSearch::IsPastPeak(double power) const {
+	return power < GetHighestMeasurement()->second * (1 - settings.dropThresholdPercent / 100);
+}
+
+// Settings are on a grid of the precision, starting at the start setting
+double PeakSearch::Limit(double setting) const {
+	double steps = round((setting - settings.start) / settings.precision);
+	setting = settings.start + steps * settings.precision;
+	if (settings.wholeNumbers)
+		setting = round(setting);
+	return min(max(setting, lowLimit), highLimit);
+}
+
+bool PeakSearch::IsMeasured(double setting) const {
+	auto nearest = measurements.lower_bound(setting - settings.precision / 2);
+	return nearest != measurements.end() and nearest->first < setting + settings.precision / 2;
+}
+
+
+//-------------------------------------------------------------------------
+// SweepPeakSearch
+
+SweepPeakSearch::SweepPeakSearch(const PeakSearchSettings& search_settings) :
+	PeakSearch(search_settings) {
+}
+
+void SweepPeakSearch::OnMeasurement(double setting, double power) {
+	if (findingLowerBound) {
+		if (IsPastPeak(power) or setting <= lowLimit) {
+			// Main tuning stage: sweep up from the lower bound
+			findingLowerBound = false;
+			nextSetting = Limit(setting + settings.precision);
+		}
+		else
+			nextSetting = Limit(setting - settings.precision);
+		return;
+	}
+
+	double peakSetting = GetHighestMeasurement()->first;
+	if ((setting > peakSetting and IsPastPeak(power)) or setting >= highLimit)
+		Finish(peakSetting);
+	else
+		nextSetting = Limit(setting + settings.precision);
+}
+
+
+//-------------------------------------------------------------------------
+// ParabolicPeakSearch
+
+ParabolicPeakSearch::ParabolicPeakSearch(const PeakSearchSettings& search_settings) :
+	PeakSearch(search_settings) {
+
+	step = max(settings.precision, settings.range / 8);
+	nextSetting = Limit(settings.start);
+}
+
+void ParabolicPeakSearch::OnMeasurement(double setting, double power) {
+	double start = Limit(settings.start);
+	double startPower = measurements.at(start);
+
+	if (measurements.size() == 1) {
+		nextSetting = Limit(start + step);
+		if (nextSetting == start)
+			stage = Stage::PROBE_DOWN, nextSetting = Limit(start - step);
+		if (nextSetting == start)
+			Finish(start);
+		return;
+	}
+
+	// Probe both sides of the start for the direction uphill
+	if (stage == Stage::PROBE_UP or stage == Stage::PROBE_DOWN) {
+		if (power > startPower) {
+			direction = stage == Stage::PROBE_UP ? 1 : -1;
+			stage = Stage::EXPAND;
+		}
+		else if (stage == Stage::PROBE_UP and Limit(start - step) != start) {
+			stage = Stage::PROBE_DOWN;
+			nextSetting = Limit(start - step);
+			return;
+		}
+		// Flat on both sides: on the baseline, far from the peak
+		else if (IsWithinNoise(GetHighestMeasurement()->second, measurements.begin()->second) and
+			IsWithinNoise(GetHighestMeasurement()->second, measurements.rbegin()->second)) {
+			direction = measurements.rbegin()->second > measurements.begin()->second ? 1 : -1;
+			stage = Stage::EXPAND;
+			setting = direction > 0 ? measurements.rbegin()->first : measurements.begin()->first;
+		}
+		else
+			stage = Stage::REFINE;
+	}
+	// Keep going uphill with growing steps until past the peak
+	else if (stage == Stage::EXPAND and IsPastPeak(power))
+		stage = Stage::REFINE;
+
+	if (stage == Stage::EXPAND) {
+		step *= GOLDEN_RATIO;
+		nextSetting = Limit(setting + direction * step);
+		if (nextSetting != setting)
+			return;
+
+		// Reached the end of the range without the power rising by the drop
+		// threshold, so the peak may be the other way (e.g. started on the baseline)
+		if (!reversed and GetHighestMeasurement()->second < startPower * (1 + settings.dropThresholdPercent / 100)) {
+			reversed = true;
+			direction = -direction;
+			step = max(settings.precision, settings.range / 8);
+			double farthest = direction > 0 ? measurements.rbegin()->first : measurements.begin()->first;
+			nextSetting = Limit(farthest + direction * step);
+			if (nextSetting != farthest)
+				return;
+		}
+		stage = Stage::REFINE;
+	}
+
+	Refine();
+}
+
+void ParabolicPeakSearch::Refine() {
+	auto best = GetHighestMeasurement();
+	double b = best->first;
+	double fb = best->second;
+
+	// The best setting's neighbours bracket the peak. Look beyond the best
+	// setting if nothing was measured on one side, unless that's the limit.
+	double a = b, fa = fb, c = b, fc = fb;
+	if (best != measurements.begin()) {
+		a = prev(best)->first;
+		fa = prev(best)->second;
+	}
+	else if (b > lowLimit) {
+		nextSetting = Limit(b - step);
+		return;
+	}
+	if (next(best) != measurements.end()) {
+		c = next(best)->first;
+		fc = next(best)->second;
+	}
+	else if (b < highLimit) {
+		nextSetting = Limit(b + step);
+		return;
+	}
+
+	double vertex;
+	bool hasVertex = GetParabolaVertex(a, fa, b, fb, c, fc, vertex);
+	double finalSetting = hasVertex ? vertex : b;
+
+	// Stop at the precision, or when the bracket is flat within the noise
+	if (c - a <= 2 * settings.precision * 1.0001 or (IsWithinNoise(fb, fa) and IsWithinNoise(fb, fc))) {
+		Finish(finalSetting);
+		return;
+	}
+
+	// Measure at the vertex, or else a golden-section step into the larger side
+	double candidate = hasVertex ? Limit(vertex) : b;
+	if (candidate <= a or candidate >= c or IsMeasured(candidate)) {
+		bool rightLarger = c - b > b - a;
+		candidate = Limit(rightLarger ? b + GOLDEN_SECTION * (c - b) : b - GOLDEN_SECTION * (b - a));
+		if (IsMeasured(candidate))
+			candidate = Limit(rightLarger ? b - GOLDEN_SECTION * (b - a) : b + GOLDEN_SECTION * (c - b));
+		if (IsMeasured(candidate)) {
+			Finish(finalSetting);
+			return;
+		}
+	}
+	nextSetting = candidate;
+}
+
+bool ParabolicPeakSearch::IsWithinNoise(double power_a, double power_b) const {
+	return fabs(power_a - power_b) <= NOISE_MARGIN * settings.relativeNoise * max(fabs(power_a), fabs(power_b));
+}
+
+bool ParabolicPeakSearch::GetParabolaVertex(double a, double fa, double b, double fb, double c, double fc, double& vertex) const {
+	if (!(a < b and b < c))
+		return false;
+
+	double curvature = ((fc - fb) / (c - b) - (fb - fa) / (b - a)) / (c - a);
+	if (curvature >= 0)
+		return false;
+
+	double numerator = (b - a) * (b - a) * (fb - fc) - (b - c) * (b - c) * (fb - fa);
+	double denominator = (b - a) * (fb - fc) - (b - c) * (fb - fa);
+	if (denominator == 0)
+		return false;
+
+	vertex = b - 0.5 * numerator / denominator;
+	return vertex >= a and vertex <= c;
+}
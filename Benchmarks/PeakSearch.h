@@ -0,0 +1,159 @@
+/**
+* Peak Search - Finds the motor index or temperature with the most power,
+*	one measurement at a time. Each measurement waits for the hardware to
+*	settle, so the strategies are compared by how many they need.
+*
+* - Part of the benchmark program only. Autotune-Power's engine
+*	(AutotunePowerManager) runs its own sweep and has no way to take a
+*	search strategy, so the GUI doesn't ship this. SWEEP stands in for the
+*	engine's sweep in the benchmarks, and PARABOLIC waits here, measured
+*	against it, until the engine can use a strategy.
+* - The caller asks for the next setting, moves there, waits, measures the
+*	power and hands it back, until the search is finished. The search
+*	never touches hardware, so any procedure can step it.
+* - SWEEP: the fixed-precision sweep Autotune-Power uses. Steps down from
+*	the start until the power drops the power drop threshold below the
+*	highest power so far (or the range ends), then steps up from there
+*	until it drops again past the peak.
+* - PARABOLIC: brackets the peak with growing steps (same drop threshold,
+*	so local dips shallower than it are stepped over), then shrinks the
+*	bracket with parabolas through the best point and its neighbours,
+*	falling back to golden-section steps when a parabola is no use. Stops
+*	at the precision, or when the bracket is flat within the measurement
+*	noise. The best setting is the vertex of the last parabola.
+*
+* Example usage:
+*
+*	unique_ptr<PeakSearch> search = PeakSearch::Create(PeakSearchStrategy::PARABOLIC, settings);
+*	while (!search->IsFinished()) {
+*		MoveTo(search->GetNextSetting());
+*		search->AddMeasurement(MeasurePower());
+*	}
+*	MoveTo(search->GetBestSetting());
+*
+* @file PeakSearch.h
+* @created October 2026
+* @version 1.0
+*/
+#pragma once
+
+#include <map>
+#include <memory>
+#include <string>
+
+
+enum class PeakSearchStrategy {
+	SWEEP,
+	PARABOLIC
+};
+
+std::string ToString(PeakSearchStrategy strategy);
+// Returns false for an unknown name
+bool ParsePeakSearchStrategy(const std::string& name, PeakSearchStrategy& strategy);
+
+
+struct PeakSearchSettings {
+	double start = 0;
+	// Search within start +/- range
+	double range = 1;
+	// Smallest step between settings
+	double precision = 1;
+	// Percent below the highest power that counts as past the peak
+	double dropThresholdPercent = 15;
+	// Standard deviation of a power measurement, as a fraction of the power
+	double relativeNoise = 0.005;
+	// Only whole-number settings (motor index)
+	bool wholeNumbers = false;
+	// Stop after this many measurements
+	int maxMeasurements = 1000;
+};
+
+
+class PeakSearch {
+
+public:
+	static std::unique_ptr<PeakSearch> Create(PeakSearchStrategy strategy, const PeakSearchSettings& settings);
+	virtual ~PeakSearch() = default;
+
+	// Setting to measure next, while not finished
+	double GetNextSetting() const;
+	// The power measured at GetNextSetting()
+	void AddMeasurement(double power);
+	bool IsFinished() const;
+
+	// Best setting found so far
+	double GetBestSetting() const;
+	int GetMeasurementCount() const;
+
+
+protected:
+	PeakSearchSettings settings;
+	double lowLimit;
+	double highLimit;
+	double nextSetting;
+	bool finished = false;
+	double bestSetting;
+	// Measured power at each setting
+	std::map<double, double> measurements;
+
+	explicit PeakSearch(const PeakSearchSettings& search_settings);
+
+	// Choose nextSetting, or call Finish(..)
+	virtual void OnMeasurement(double setting, double power) = 0;
+
+	void Finish(double best_setting);
+	// Highest measured power, and its setting
+	std::map<double, double>::const_iterator GetHighestMeasurement() const;
+	bool IsPastPeak(double power) const;
+	// Into the range, and onto whole numbers if needed
+	double Limit(double setting) const;
+	bool IsMeasured(double setting) const;
+
+
+private:
+	int measurementCount = 0;
+
+};
+
+
+class SweepPeakSearch : public PeakSearch {
+
+public:
+	explicit SweepPeakSearch(const PeakSearchSettings& search_settings);
+
+
+private:
+	bool findingLowerBound = true;
+
+	void OnMeasurement(double setting, double power) override;
+
+};
+
+
+class ParabolicPeakSearch : public PeakSearch {
+
+public:
+	explicit ParabolicPeakSearch(const PeakSearchSettings& search_settings);
+
+
+private:
+	enum class Stage {
+		PROBE_UP,
+		PROBE_DOWN,
+		EXPAND,
+		REFINE
+	};
+	Stage stage = Stage::PROBE_UP;
+	double step;
+	double direction = 1;
+	// Expanded the other way after finding no peak the first way
+	bool reversed = false;
+
+	void OnMeasurement(double setting, double power) override;
+	void Refine();
+	bool IsWithinNoise(double power_a, double power_b) const;
+	// Vertex of the parabola through three points, if it opens downward
+	//   and lies between the outer two
+	bool GetParabolaVertex(double a, double fa, double b, double fb, double c, double fc, double& vertex) const;
+
+};
@@ -0,0 +1,100 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <random>
+
+#include "PeakSearchBenchmark.h"
+
+using namespace std;
+
+
+double SimulatedPowerCurve::GetPower(double setting) const {
+	double distance = (setting - peakSetting) / width;
+	double power = peakPower * exp(-distance * distance / 2);
+	if (secondPeakRatio > 0) {
+		double secondDistance = (setting - peakSetting - secondPeakOffset) / width;
+		power += peakPower * secondPeakRatio * exp(-secondDistance * secondDistance / 2);
+	}
+	return baseline + power;
+}
+
+double SimulatedPowerCurve::GetHighestPower(double low, double high) const {
+	double highest = 0;
+	const int samples = 10000;
+	for (int i = 0; i <= samples; i++)
+		highest = max(highest, GetPower(low + (high - low) * i / samples));
+	return highest;
+}
+
+
+vector<SimulatedPowerCurve> GenerateSimulatedPowerCurves(const PeakSearchSettings& settings, size_t count, unsigned seed) {
+	mt19937 random(seed);
+	uniform_real_distribution<double> unit(0, 1);
+
+	vector<SimulatedPowerCurve> curves;
+	for (size_t i = 0; i < count; i++) {
+		SimulatedPowerCurve curve;
+		// The peak is usually near the start (the last tuned value)
+		curve.peakSetting = settings.start + settings.range * 0.6 * (2 * unit(random) - 1);
+		curve.peakPower = 1 + 9 * unit(random);
+		curve.width = settings.range * (0.1 + 0.25 * unit(random));
+		curve.baseline = curve.peakPower * 0.05 * unit(random);
+		// Some components have a lower second peak close by (e.g. SHG)
+		if (unit(random) < 0.3) {
+			curve.secondPeakOffset = curve.width * (2.5 + unit(random)) * (unit(random) < 0.5 ? -1 : 1);
+			curve.secondPeakRatio = 0.3 + 0.4 * unit(random);
+		}
+		curves.push_back(curve);
+	}
+	return curves;
+}
+
+
+PeakSearchBenchmarkResult RunPeakSearchBenchmark(PeakSearchStrategy strategy, const PeakSearchSettings& settings,
+	const vector<SimulatedPowerCurve>& curves, unsigned seed) {
+
+	mt19937 random(seed);
+	normal_distribution<double> noise(0, 1);
+
+	PeakSearchBenchmarkResult result;
+	result.strategy = strategy;
+	result.curveCount = curves.size();
+	if (curves.empty())
+		return result;
+
+	vector<double> powerErrors;
+	double measurementSum = 0;
+	for (const SimulatedPowerCurve& curve : curves) {
+		unique_ptr<PeakSearch> search = PeakSearch::Create(strategy, settings);
+		while (!search->IsFinished()) {
+			double power = curve.GetPower(search->GetNextSetting());
+			search->AddMeasurement(power * (1 + settings.relativeNoise * noise(random)));
+		}
+
+		double highestPower = curve.GetHighestPower(settings.start - settings.range, settings.start + settings.range);
+		double powerError = 100 * (highestPower - curve.GetPower(search->GetBestSetting())) / highestPower;
+		powerErrors.push_back(max(powerError, 0.0));
+
+		measurementSum += search->GetMeasurementCount();
+		result.maxMeasurements = max(result.maxMeasurements, double(search->GetMeasurementCount()));
+	}
+
+	sort(powerErrors.begin(), powerErrors.end());
+	result.meanMeasurements = measurementSum / double(curves.size());
+	double powerErrorSum = 0;
+	for (double powerError : powerErrors)
+		powerErrorSum += powerError;
+	result.meanPowerErrorPercent = powerErrorSum / double(powerErrors.size());
+	result.p95PowerErrorPercent = powerErrors[min(powerErrors.size() - 1, size_t(double(powerErrors.size()) * 0.95))];
+	result.maxPowerErrorPercent = powerErrors.back();
+	return result;
+}
+
+
+string FormatPeakSearchBenchmark(const PeakSearchBenchmarkResult& result) {
+	char line[200];
+	snprintf(line, sizeof(line), "%s: %zu curves, %.1f measurements (max %.0f), power error mean %.2f%% p95 %.2f%% max %.2f%%",
+		ToString(result.strategy).c_str(), result.curveCount, result.meanMeasurements, result.maxMeasurements,
+		result.meanPowerErrorPercent, result.p95PowerErrorPercent, result.maxPowerErrorPercent);
+	return line;
+}
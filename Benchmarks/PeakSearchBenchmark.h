@@ -0,0 +1,64 @@
+/**
+* Peak Search Benchmark - Runs peak search strategies over simulated power
+*	curves and compares the measurements they need and the power they
+*	leave on the table.
+*
+* - Curves are a Gaussian peak somewhere in the search range, some with a
+*	lower second peak next to it, plus a baseline. Each measurement adds
+*	Gaussian noise of PeakSearchSettings::relativeNoise.
+* - The power error of a search is how far the true (noise-free) power at
+*	its best setting is below the curve's highest power, in percent.
+* - The same seed gives the same curves and noise for every strategy.
+*
+* Example usage:
+*
+*	auto curves = GenerateSimulatedPowerCurves(settings, 1000, 1);
+*	for (PeakSearchStrategy strategy : { PeakSearchStrategy::SWEEP, PeakSearchStrategy::PARABOLIC })
+*		cout << FormatPeakSearchBenchmark(RunPeakSearchBenchmark(strategy, settings, curves, 2)) << endl;
+*
+* @file PeakSearchBenchmark.h
+* @created October 2026
+* @version 1.0
+*/
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "PeakSearch.h"
+
+
+struct SimulatedPowerCurve {
+	double peakSetting;
+	double peakPower;
+	double width;
+	// Second peak, relative to the first (ratio 0 = none)
+	double secondPeakOffset = 0;
+	double secondPeakRatio = 0;
+	double baseline = 0;
+
+	double GetPower(double setting) const;
+	// Highest power of the curve within low..high
+	double GetHighestPower(double low, double high) const;
+};
+
+
+struct PeakSearchBenchmarkResult {
+	PeakSearchStrategy strategy;
+	size_t curveCount = 0;
+	double meanMeasurements = 0;
+	double maxMeasurements = 0;
+	double meanPowerErrorPercent = 0;
+	double p95PowerErrorPercent = 0;
+	double maxPowerErrorPercent = 0;
+};
+
+
+// Curves with their peak within the settings' range around the start
+std::vector<SimulatedPowerCurve> GenerateSimulatedPowerCurves(const PeakSearchSettings& settings, size_t count, unsigned seed);
+
+PeakSearchBenchmarkResult RunPeakSearchBenchmark(PeakSearchStrategy strategy, const PeakSearchSettings& settings,
+	const std::vector<SimulatedPowerCurve>& curves, unsigned seed);
+
+// One line, e.g. "Parabolic: 1000 curves, 12.3 measurements (max 20), power error mean 0.12% p95 0.40% max 1.10%"
+std::string FormatPeakSearchBenchmark(const PeakSearchBenchmarkResult& result);
@@ -0,0 +1,150 @@
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "RealTimeObserverBenchmark.h"
+#include "../RealTimeObserver.h"
+#include "../../CommonUtilities/Logging/LoggerBase.h"
+#include "wx/evtloop.h"
+
+using namespace std;
+
+
+// How often the UI timer checks that the event loop is responsive
+static const int UI_PROBE_INTERVAL_MS = 10;
+// Time after the last row for the view to catch up
+static const chrono::milliseconds DRAIN_TIME(500);
+
+
+// The old RealTimeObserver, made safe to call from the logging thread
+class PerValueObserver : public LogObserver {
+
+public:
+	PerValueObserver(wxTextCtrl* text_ctrl) : textCtrl(text_ctrl) {};
+
+	void onDataPointLogged(map<string, string> data) override {
+		// The text control must outlive the pending calls, or delete them with it
+		textCtrl->CallAfter([this, data]() {
+			auto startTime = chrono::steady_clock::now();
+			textCtrl->AppendText("Received Data:\n");
+			for (const auto& entry : data) {
+				string logEntry = entry.first + ": " + entry.second + "\n";
+				textCtrl->AppendText(logEntry);
+			}
+			statistics.textUpdates += data.size() + 1;
+			statistics.rowsRendered++;
+			statistics.renderSeconds += chrono::duration<double>(chrono::steady_clock::now() - startTime).count();
+		});
+	};
+
+	// UI thread only
+	RealTimeObserver::RenderStatistics statistics;
+
+private:
+	wxTextCtrl* textCtrl;
+
+};
+
+
+RealTimeObserverBenchmarkResult RunRealTimeObserverBenchmark(wxWindow* parent, RealTimeViewType type,
+	double rows_per_second, double seconds, size_t column_count) {
+
+	RealTimeObserverBenchmarkResult result;
+	result.type = type;
+	result.rowsPerSecond = rows_per_second;
+	result.seconds = seconds;
+	if (rows_per_second <= 0 or seconds <= 0)
+		return result;
+
+	wxFrame* frame = new wxFrame(parent, wxID_ANY, "Real-Time Observer Benchmark", wxDefaultPosition, wxSize(500, 300));
+	wxTextCtrl* textCtrl = new wxTextCtrl(frame, wxID_ANY, wxEmptyString, wxDefaultPosition, wxDefaultSize, wxTE_MULTILINE | wxTE_READONLY);
+	frame->Show();
+
+	string logFilePath = (filesystem::temp_directory_path() / "RealTimeObserverBenchmark.log").string();
+	error_code error;
+	filesystem::remove(logFilePath, error);
+
+	unique_ptr<LoggerBase> logger = make_unique<LoggerBase>();
+	for (size_t col = 0; col < column_count; col++)
+		logger->AddColumn("ActualTemp-" + to_string(col));
+	logger->SetFilePath(logFilePath);
+
+	shared_ptr<PerValueObserver> perValueObserver;
+	shared_ptr<RealTimeObserver> batchedObserver;
+	LogSubscription subscription;
+	if (type == RealTimeViewType::PER_VALUE) {
+		perValueObserver = make_shared<PerValueObserver>(textCtrl);
+		subscription = logger->subscribe(perValueObserver);
+	}
+	else {
+		batchedObserver = make_shared<RealTimeObserver>(textCtrl);
+		subscription = logger->subscribe(batchedObserver);
+	}
+
+	// UI probe
+	wxTimer probeTimer;
+	auto lastProbeTime = chrono::steady_clock::now();
+	probeTimer.Bind(wxEVT_TIMER, [&](wxTimerEvent&) {
+		auto now = chrono::steady_clock::now();
+		double lateMilliseconds = chrono::duration<double, milli>(now - lastProbeTime).count() - UI_PROBE_INTERVAL_MS;
+		if (lateMilliseconds > result.longestUiStallMilliseconds)
+			result.longestUiStallMilliseconds = lateMilliseconds;
+		lastProbeTime = now;
+	});
+	probeTimer.Start(UI_PROBE_INTERVAL_MS);
+
+	wxGUIEventLoop eventLoop;
+	atomic<size_t> rowsLogged{ 0 };
+	thread loggingThread([&]() {
+		vector<string> values(column_count);
+		auto rowInterval = chrono::duration_cast<chrono::steady_clock::duration>(chrono::duration<double>(1 / rows_per_second));
+		size_t rowCount = size_t(rows_per_second * seconds);
+		auto nextRowTime = chrono::steady_clock::now();
+		for (size_t row = 0; row < rowCount; row++) {
+			this_thread::sleep_until(nextRowTime);
+			nextRowTime += rowInterval;
+			for (size_t col = 0; col < column_count; col++)
+				values[col] = to_string(25.0 + 0.001 * double(row % 1000) + double(col));
+			logger->LogDataPoint(values);
+			rowsLogged++;
+		}
+
+		this_thread::sleep_for(DRAIN_TIME);
+		textCtrl->CallAfter([&eventLoop]() { eventLoop.Exit(); });
+	});
+
+	eventLoop.Run();
+	loggingThread.join();
+	probeTimer.Stop();
+	// Rows still queued for the UI thread are the view falling behind
+	wxYield();
+
+	subscription.Unsubscribe();
+	RealTimeObserver::RenderStatistics statistics = perValueObserver ? perValueObserver->statistics : batchedObserver->GetRenderStatistics();
+	result.rowsLogged = rowsLogged;
+	result.rowsShown = statistics.rowsRendered;
+	result.textUpdates = statistics.textUpdates;
+	result.uiMillisecondsPerSecond = 1000 * statistics.renderSeconds / seconds;
+	result.finalTextLength = textCtrl->GetLastPosition();
+
+	// Pending calls are deleted with the text control
+	frame->Destroy();
+	logger.reset();
+	filesystem::remove(logFilePath, error);
+	return result;
+}
+
+
+string FormatRealTimeObserverBenchmark(const RealTimeObserverBenchmarkResult& result) {
+	char line[300];
+	snprintf(line, sizeof(line), "%s: %zu rows at %.0f rows/s over %.0f s, %zu shown, %zu text updates (%.1f/s), UI %.1f ms/s, "
+		"longest UI stall %.0f ms, %ld characters kept", result.type == RealTimeViewType::PER_VALUE ? "PER_VALUE" : "BATCHED",
+		result.rowsLogged, result.rowsPerSecond, result.seconds, result.rowsShown, result.textUpdates,
+		result.seconds > 0 ? double(result.textUpdates) / result.seconds : 0, result.uiMillisecondsPerSecond,
+		result.longestUiStallMilliseconds, result.finalTextLength);
+	return line;
+}
@@ -0,0 +1,61 @@
+/**
+* Real-Time Observer Benchmark - Logs rows at a fixed rate into a visible
+*	real-time text view and measures what the view costs the UI thread.
+*
+* - A LoggerBase on a worker thread logs rows_per_second rows of
+*	column_count values into a temporary file, for the given seconds.
+* - PER_VALUE replays the old RealTimeObserver: one AppendText(..) for the
+*	header and one per value, never trimmed. The old observer appended
+*	straight from the logging thread, which wxWidgets doesn't allow, so
+*	here each row is passed to the UI thread with CallAfter(..) first.
+* - BATCHED is RealTimeObserver: rows are queued and appended once per
+*	frame, and only the newest rows are kept.
+* - A 10 ms UI timer runs during the benchmark. The longest it is late is
+*	the longest the UI was unresponsive.
+* - Runs a nested event loop, so call it on the UI thread from an event
+*	handler (e.g. a debug menu item). It returns when the run is over.
+*
+* Example usage:
+*
+*	for (RealTimeViewType type : { RealTimeViewType::PER_VALUE, RealTimeViewType::BATCHED })
+*		wxLogMessage(FormatRealTimeObserverBenchmark(RunRealTimeObserverBenchmark(this, type, 100, 60, 12)).c_str());
+*
+* @file RealTimeObserverBenchmark.h
+* @created October 2026
+* @version 1.0
+*/
+#pragma once
+
+#include <string>
+
+#include "wx/wx.h"
+
+
+enum class RealTimeViewType {
+	PER_VALUE,
+	BATCHED,
+};
+
+
+struct RealTimeObserverBenchmarkResult {
+	RealTimeViewType type = RealTimeViewType::BATCHED;
+	double rowsPerSecond = 0;
+	double seconds = 0;
+	size_t rowsLogged = 0;
+	size_t rowsShown = 0;
+	// AppendText(..)/ChangeValue(..) calls
+	size_t textUpdates = 0;
+	// UI thread time spent updating the text control, per second of logging
+	double uiMillisecondsPerSecond = 0;
+	double longestUiStallMilliseconds = 0;
+	// Characters in the text control at the end
+	long finalTextLength = 0;
+};
+
+
+RealTimeObserverBenchmarkResult RunRealTimeObserverBenchmark(wxWindow* parent, RealTimeViewType type,
+	double rows_per_second, double seconds, size_t column_count);
+
+// One line, e.g. "BATCHED: 6000 rows at 100 rows/s over 60 s, 1790 text updates (29.8/s), UI 2.1 ms/s,
+//   longest UI stall 14 ms, 61200 characters kept"
+std::string FormatRealTimeObserverBenchmark(const RealTimeObserverBenchmarkResult& result);
@@ -0,0 +1,607 @@
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+
+#include "ColumnarLogFile.h"
+#include "LogBlockCipher.h"
+#include "LogCompression.h"
+#include "../ErrorMessageStream.h"
+
+using namespace std;
+
+
+const char COLUMNAR_MAGIC[8] = { 'P', 'I', 'L', 'O', 'G', 'C', 'O', 'L' };
+const uint32_t COLUMNAR_VERSION = 2;
+
+const uint8_t BLOCK_SCHEMA = 1;
+const uint8_t BLOCK_ROWS = 2;
+const uint8_t BLOCK_TEXT = 3;
+const uint8_t FLAG_ENCRYPTED = 0x01;
+const size_t BLOCK_HEADER_SIZE = 2 + 5 * 4;
+
+const uint8_t COLUMN_STRING_PLAIN = 0;
+const uint8_t COLUMN_STRING_DICTIONARY = 1;
+const uint8_t COLUMN_DECIMAL = 2;
+const int MAX_DECIMAL_DIGITS = 18;
+
+
+
+//-----------------------------------------------------------------------------
+// Encoding helpers
+
+static void PutU32(string& out, uint32_t value) {
+	for (int i = 0; i < 4; i++)
+		out += char(value >> (8 * i));
+}
+
+static void PutVarint(string& out, uint64_t value) {
+	while (value >= 0x80) {
+		out += char((value & 0x7F) | 0x80);
+		value >>= 7;
+	}
+	out += char(value);
+}
+
+static void PutSignedVarint(string& out, int64_t value) {
+	PutVarint(out, (uint64_t(value) << 1) ^ uint64_t(value >> 63)); // ZigZag
+}
+
+static void PutString(string& out, const string& value) {
+	PutVarint(out, value.size());
+	out += value;
+}
+
+static void PutDouble(string& out, double value) {
+	uint64_t bits;
+	memcpy(&bits, &value, sizeof(bits));
+	for (int i = 0; i < 8; i++)
+		out += char(bits >> (8 * i));
+}
+
+
+// Sequential reader over a decoded byte buffer
+class ByteReader {
+public:
+	ByteReader(const string& _data, size_t start = 0) : data(_data), pos(start) {}
+
+	bool Failed() const { return failed; }
+	size_t Position() const { return pos; }
+
+	uint8_t U8() {
+		if (pos + 1 > data.size()) { failed = true; return 0; }
+		return uint8_t(data[pos++]);
+	}
+	uint32_t U32() {
+		if (pos + 4 > data.size()) { failed = true; return 0; }
+		uint32_t value = 0;
+		for (int i = 0; i < 4; i++)
+			value |= uint32_t(uint8_t(data[pos++])) << (8 * i);
+		return value;
+	}
+	uint64_t Varint() {
+		uint64_t value = 0;
+		for (int shift = 0; shift < 64; shift += 7) {
+			uint8_t byte = U8();
+			if (failed) return 0;
+			value |= uint64_t(byte & 0x7F) << shift;
+			if ((byte & 0x80) == 0)
+				return value;
+		}
+		failed = true;
+		return 0;
+	}
+	int64_t SignedVarint() {
+		uint64_t value = Varint();
+		return int64_t(value >> 1) ^ -int64_t(value & 1);
+	}
+	string String() {
+		uint64_t length = Varint();
+		if (failed or pos + length > data.size()) { failed = true; return ""; }
+		string value = data.substr(pos, size_t(length));
+		pos += size_t(length);
+		return value;
+	}
+	double Double() {
+		if (pos + 8 > data.size()) { failed = true; return 0.0; }
+		uint64_t bits = 0;
+		for (int i = 0; i < 8; i++)
+			bits |= uint64_t(uint8_t(data[pos++])) << (8 * i);
+		double value;
+		memcpy(&value, &bits, sizeof(value));
+		return value;
+	}
+
+private:
+	const string& data;
+	size_t pos;
+	bool failed = false;
+};
+
+
+// Parse text like "-12.50" into mantissa -1250 and scale 2.
+// Only accepts text that FormatDecimal(..) reproduces exactly.
+static bool ParseDecimal(const string& text, int64_t& mantissa, int& scale, int& digits) {
+	size_t pos = 0;
+	bool negative = false;
+	if (pos < text.size() and text[pos] == '-') {
+		negative = true;
+		pos++;
+	}
+
+	size_t integerStart = pos;
+	while (pos < text.size() and isdigit((unsigned char)text[pos]))
+		pos++;
+	size_t integerDigits = pos - integerStart;
+	if (integerDigits == 0 or (integerDigits > 1 and text[integerStart] == '0'))
+		return false;
+
+	scale = 0;
+	if (pos < text.size() and text[pos] == '.') {
+		pos++;
+		size_t fractionStart = pos;
+		while (pos < text.size() and isdigit((unsigned char)text[pos]))
+			pos++;
+		scale = int(pos - fractionStart);
+		if (scale == 0)
+			return false;
+	}
+	if (pos != text.size())
+		return false;
+
+	digits = int(integerDigits) + scale;
+	if (digits > MAX_DECIMAL_DIGITS)
+		return false;
+
+	mantissa = 0;
+	for (size_t i = integerStart; i < text.size(); i++) {
+		if (text[i] != '.')
+			mantissa = mantissa * 10 + (text[i] - '0');
+	}
+	if (negative and mantissa == 0)
+		return false; // "-0.0" wouldn't round-trip
+	if (negative)
+		mantissa = -mantissa;
+	return true;
+}
+
+static string FormatDecimal(int64_t mantissa, int scale) {
+	bool negative = mantissa < 0;
+	string digits = to_string(negative ? -mantissa : mantissa);
+	if (scale > 0) {
+		if (int(digits.size()) <= scale)
+			digits.insert(0, size_t(scale + 1 - int(digits.size())), '0');
+		digits.insert(digits.size() - size_t(scale), ".");
+	}
+	return negative ? "-" + digits : digits;
+}
+
+static int64_t PowerOf10(int exponent) {
+	int64_t value = 1;
+	for (int i = 0; i < exponent; i++)
+		value *= 10;
+	return value;
+}
+
+
+// Encode one column of a block, appending its min/max to the index
+static void EncodeColumn(const vector<string>& values, string& payload, string& index) {
+	size_t rowCount = values.size();
+
+	// Try numeric first
+	vector<int64_t> mantissas(rowCount);
+	vector<uint8_t> scales(rowCount);
+	bool numeric = rowCount > 0;
+	int maxScale = 0;
+	int maxIntegerDigits = 0;
+	for (size_t row = 0; numeric and row < rowCount; row++) {
+		int scale, digits;
+		numeric = ParseDecimal(values[row], mantissas[row], scale, digits);
+		scales[row] = uint8_t(scale);
+		maxScale = max(maxScale, scale);
+		maxIntegerDigits = max(maxIntegerDigits, digits - scale);
+	}
+	if (numeric and maxIntegerDigits + maxScale > MAX_DECIMAL_DIGITS)
+		numeric = false;
+
+	if (numeric) {
+		bool uniformScale = true;
+		for (uint8_t scale : scales)
+			uniformScale = uniformScale and scale == scales[0];
+
+		payload += char(COLUMN_DECIMAL);
+		payload += char(maxScale);
+		payload += char(uniformScale ? 1 : 0);
+		if (!uniformScale)
+			payload.append((const char*)scales.data(), scales.size());
+
+		// Store values normalized to the largest scale, delta-encoded
+		int64_t previous = 0;
+		int64_t minValue = INT64_MAX;
+		int64_t maxValue = INT64_MIN;
+		for (size_t row = 0; row < rowCount; row++) {
+			int64_t normalized = mantissas[row] * PowerOf10(maxScale - scales[row]);
+			PutSignedVarint(payload, normalized - previous);
+			previous = normalized;
+			minValue = min(minValue, normalized);
+			maxValue = max(maxValue, normalized);
+		}
+
+		double divisor = double(PowerOf10(maxScale));
+		index += char(1);
+		PutDouble(index, double(minValue) / divisor);
+		PutDouble(index, double(maxValue) / divisor);
+		return;
+	}
+
+	index += char(0);
+
+	// Dictionary-encode strings if they repeat enough to be worth it
+	vector<string> dictionary;
+	vector<uint8_t> ids(rowCount);
+	size_t maxDictionarySize = min<size_t>(256, rowCount / 2);
+	bool useDictionary = true;
+	for (size_t row = 0; row < rowCount; row++) {
+		// Consecutive repeats are the common case - check the last entry first
+		size_t id = dictionary.size();
+		if (!dictionary.empty() and dictionary.back() == values[row])
+			id = dictionary.size() - 1;
+		else {
+			for (size_t i = 0; i < dictionary.size(); i++) {
+				if (dictionary[i] == values[row]) {
+					id = i;
+					break;
+				}
+			}
+		}
+		if (id == dictionary.size()) {
+			if (dictionary.size() >= maxDictionarySize) {
+				useDictionary = false;
+				break;
+			}
+			dictionary.push_back(values[row]);
+		}
+		ids[row] = uint8_t(id);
+	}
+
+	if (useDictionary) {
+		payload += char(COLUMN_STRING_DICTIONARY);
+		PutVarint(payload, dictionary.size());
+		for (const string& entry : dictionary)
+			PutString(payload, entry);
+		payload.append((const char*)ids.data(), ids.size());
+	}
+	else {
+		payload += char(COLUMN_STRING_PLAIN);
+		for (const string& value : values)
+			PutString(payload, value);
+	}
+}
+
+
+static bool DecodeColumn(ByteReader& reader, size_t rowCount, vector<string>& values) {
+	values.resize(rowCount);
+	uint8_t encoding = reader.U8();
+
+	if (encoding == COLUMN_DECIMAL) {
+		int maxScale = reader.U8();
+		bool uniformScale = reader.U8() == 1;
+		vector<uint8_t> scales(rowCount, uint8_t(maxScale));
+		if (!uniformScale) {
+			for (size_t row = 0; row < rowCount; row++)
+				scales[row] = reader.U8();
+		}
+		if (maxScale > MAX_DECIMAL_DIGITS)
+			return false;
+
+		int64_t previous = 0;
+		for (size_t row = 0; row < rowCount; row++) {
+			int64_t normalized = previous + reader.SignedVarint();
+			previous = normalized;
+			if (scales[row] > maxScale)
+				return false;
+			int64_t mantissa = normalized / PowerOf10(maxScale - scales[row]);
+			values[row] = FormatDecimal(mantissa, scales[row]);
+		}
+	}
+	else if (encoding == COLUMN_STRING_DICTIONARY) {
+		vector<string> dictionary(size_t(reader.Varint()));
+		if (dictionary.size() > 256)
+			return false;
+		for (string& entry : dictionary)
+			entry = reader.String();
+		for (size_t row = 0; row < rowCount; row++) {
+			uint8_t id = reader.U8();
+			if (id >= dictionary.size())
+				return false;
+			values[row] = dictionary[id];
+		}
+	}
+	else if (encoding == COLUMN_STRING_PLAIN) {
+		for (size_t row = 0; row < rowCount; row++)
+			values[row] = reader.String();
+	}
+	else
+		return false;
+
+	return !reader.Failed();
+}
+
+
+
+//-----------------------------------------------------------------------------
+// Writer
+
+ColumnarLogWriter::ColumnarLogWriter(const string& file_path, const vector<string>& column_names, bool _encrypt, size_t rows_per_block) :
+	columnNames(column_names),
+	encrypt(_encrypt),
+	rowsPerBlock(rows_per_block > 0 ? rows_per_block : 1) {
+
+	pendingColumns.resize(columnNames.size());
+
+	file.open(file_path, ios::binary | ios::app);
+	if (!file.is_open()) {
+		e << "Failed to open columnar log file: \"" << file_path << "\"." << endl;
+		return;
+	}
+
+	// New (empty) file - write the file header first
+	file.seekp(0, ios::end);
+	if (file.tellp() == streampos(0)) {
+		file.write(COLUMNAR_MAGIC, sizeof(COLUMNAR_MAGIC));
+		string version;
+		PutU32(version, COLUMNAR_VERSION);
+		file.write(version.data(), version.size());
+	}
+
+	WriteSchemaBlock();
+}
+
+ColumnarLogWriter::~ColumnarLogWriter() {
+	Flush();
+}
+
+bool ColumnarLogWriter::IsOpen() const {
+	return file.is_open();
+}
+
+size_t ColumnarLogWriter::GetColumnCount() const {
+	return columnNames.size();
+}
+
+
+void ColumnarLogWriter::AppendRow(const vector<string>& values) {
+	AppendRowHelper(values);
+}
+
+void ColumnarLogWriter::AppendRow(const vector<string_view>& values) {
+	AppendRowHelper(values);
+}
+
+template <typename Value>
+void ColumnarLogWriter::AppendRowHelper(const vector<Value>& values) {
+	if (values.size() != columnNames.size()) {
+		e << "ERROR - Columnar log: Number of values to write does not match number of columns." << endl;
+		return;
+	}
+
+	// Keep rows and text lines in the order they were logged
+	if (!pendingTextLines.empty())
+		WriteTextBlock();
+
+	for (size_t col = 0; col < values.size(); col++)
+		pendingColumns[col].emplace_back(values[col]);
+	pendingRowCount++;
+
+	if (pendingRowCount >= rowsPerBlock)
+		WriteRowBlock();
+}
+
+void ColumnarLogWriter::AppendTextLine(const string& line) {
+	if (pendingRowCount > 0)
+		WriteRowBlock();
+	pendingTextLines.push_back(line);
+}
+
+void ColumnarLogWriter::Flush() {
+	WriteRowBlock();
+	WriteTextBlock();
+	if (file.is_open())
+		file.flush();
+}
+
+
+void ColumnarLogWriter::WriteSchemaBlock() {
+	string payload;
+	PutVarint(payload, columnNames.size());
+	for (const string& name : columnNames)
+		PutString(payload, name);
+
+	// Schema is never encrypted, so a file's columns can be listed without
+	// decryptofy(..)
+	bool encryptSetting = encrypt;
+	encrypt = false;
+	WriteBlock(BLOCK_SCHEMA, uint32_t(columnNames.size()), "", payload);
+	encrypt = encryptSetting;
+}
+
+void ColumnarLogWriter::WriteRowBlock() {
+	if (pendingRowCount == 0)
+		return;
+
+	string payload;
+	string index;
+	for (auto& column : pendingColumns) {
+		EncodeColumn(column, payload, index);
+		column.clear();
+	}
+
+	WriteBlock(BLOCK_ROWS, uint32_t(pendingRowCount), index, payload);
+	pendingRowCount = 0;
+}
+
+void ColumnarLogWriter::WriteTextBlock() {
+	if (pendingTextLines.empty())
+		return;
+
+	string payload;
+	for (const string& line : pendingTextLines)
+		PutString(payload, line);
+
+	WriteBlock(BLOCK_TEXT, uint32_t(pendingTextLines.size()), "", payload);
+	pendingTextLines.clear();
+}
+
+void ColumnarLogWriter::WriteBlock(uint8_t kind, uint32_t count, string index, const string& rawPayload) {
+	if (!file.is_open())
+		return;
+
+	string stored = kind == BLOCK_SCHEMA ? rawPayload : CompressLogBlock(rawPayload);
+
+	// Index and payload are encrypted separately so the small index can be
+	// decrypted on its own when scanning.
+	if (encrypt) {
+		if (!index.empty())
+			index = EncryptLogBlock(index);
+		stored = EncryptLogBlock(stored);
+	}
+
+	string header;
+	header += char(kind);
+	header += char(encrypt ? FLAG_ENCRYPTED : 0);
+	PutU32(header, count);
+	PutU32(header, blockNumber);
+	PutU32(header, uint32_t(index.size()));
+	PutU32(header, uint32_t(stored.size()));
+	PutU32(header, uint32_t(rawPayload.size()));
+
+	file.write(header.data(), header.size());
+	file.write(index.data(), index.size());
+	file.write(stored.data(), stored.size());
+
+	blockNumber++;
+}
+
+
+
+//-----------------------------------------------------------------------------
+// Reader
+
+ColumnarLogReader::ColumnarLogReader(const string& file_path) :
+	filePath(file_path) {
+	valid = IsColumnarLogFile(filePath);
+}
+
+bool ColumnarLogReader::IsColumnarLogFile(const string& file_path) {
+	ifstream file(file_path, ios::binary);
+	char magic[sizeof(COLUMNAR_MAGIC)];
+	if (!file.read(magic, sizeof(magic)))
+		return false;
+	return equal(begin(magic), end(magic), begin(COLUMNAR_MAGIC));
+}
+
+bool ColumnarLogReader::IsValid() const {
+	return valid;
+}
+
+
+bool ColumnarLogReader::ReadAll(RowVisitor on_row, TextVisitor on_text, BlockFilter filter) {
+	if (!valid)
+		return false;
+
+	ifstream file(filePath, ios::binary);
+	string version(4, '\0');
+	file.seekg(sizeof(COLUMNAR_MAGIC));
+	if (!file.read(version.data(), version.size()) or ByteReader(version).U32() != COLUMNAR_VERSION) {
+		e << "Columnar log file \"" << filePath << "\" has an unsupported version." << endl;
+		return false;
+	}
+
+	vector<string> columns;
+	vector<vector<string>> columnValues;
+	vector<string> rowValues;
+
+	string header(BLOCK_HEADER_SIZE, '\0');
+	while (file.read(header.data(), header.size())) {
+		ByteReader headerReader(header);
+		uint8_t kind = headerReader.U8();
+		bool encrypted = (headerReader.U8() & FLAG_ENCRYPTED) != 0;
+		uint32_t count = headerReader.U32();
+		headerReader.U32();	// Block number
+		uint32_t indexSize = headerReader.U32();
+		uint32_t storedSize = headerReader.U32();
+		uint32_t rawSize = headerReader.U32();
+
+		string index(indexSize, '\0');
+		if (!file.read(index.data(), indexSize))
+			return false;
+
+		if (encrypted and !index.empty() and !DecryptLogBlock(index, index))
+			return false;
+
+		// Let the caller skip row blocks based on the min/max index
+		if (kind == BLOCK_ROWS and filter) {
+			ColumnarBlockIndex blockIndex;
+			ByteReader indexReader(index);
+			for (size_t col = 0; col < columns.size(); col++) {
+				bool numeric = indexReader.U8() == 1;
+				blockIndex.isNumeric.push_back(numeric);
+				blockIndex.minValues.push_back(numeric ? indexReader.Double() : 0.0);
+				blockIndex.maxValues.push_back(numeric ? indexReader.Double() : 0.0);
+			}
+			if (indexReader.Failed())
+				return false;
+			if (!filter(columns, blockIndex)) {
+				file.seekg(storedSize, ios::cur);
+				continue;
+			}
+		}
+
+		string stored(storedSize, '\0');
+		if (!file.read(stored.data(), storedSize))
+			return false;
+		if (encrypted and !DecryptLogBlock(stored, stored))
+			return false;
+
+		string raw;
+		if (kind == BLOCK_SCHEMA)
+			raw = stored;
+		else if (!DecompressLogBlock(stored, rawSize, raw))
+			return false;
+
+		ByteReader reader(raw);
+
+		if (kind == BLOCK_SCHEMA) {
+			columns.resize(size_t(reader.Varint()));
+			for (string& name : columns)
+				name = reader.String();
+			if (reader.Failed())
+				return false;
+			columnValues.assign(columns.size(), {});
+			rowValues.resize(columns.size());
+		}
+		else if (kind == BLOCK_ROWS) {
+			for (auto& values : columnValues) {
+				if (!DecodeColumn(reader, count, values))
+					return false;
+			}
+			for (size_t row = 0; row < count; row++) {
+				for (size_t col = 0; col < columns.size(); col++)
+					rowValues[col] = columnValues[col][row];
+				if (on_row)
+					on_row(columns, rowValues);
+			}
+		}
+		else if (kind == BLOCK_TEXT) {
+			for (uint32_t i = 0; i < count; i++) {
+				string line = reader.String();
+				if (reader.Failed())
+					return false;
+				if (on_text)
+					on_text(line);
+			}
+		}
+	}
+
+	return file.eof();
+}
@@ -0,0 +1,125 @@
+/**
+* Columnar Log File - Compact binary alternative to the comma-separated text
+*	format written by LoggerBase.
+*
+* - Rows are collected into blocks. Each block stores its values column by
+*	column:
+*		- Numeric columns (integers and decimals like "15.500000") are stored
+*			as delta-encoded scaled integers, so the exact text is recovered.
+*		- All other columns are stored as strings, dictionary-encoded when
+*			values repeat (e.g., the Date column).
+* - Each block is compressed (LogCompression.h) and optionally encrypted
+*	(LogBlockCipher.h). The index and the payload are encrypted separately,
+*	so the index can be decrypted on its own when scanning.
+* - Each block has a small index with the min/max of every numeric column,
+*	so readers can skip blocks without decompressing them.
+* - Custom and metadata lines (CommitLine(..), CommitLineMetadata(..)) are
+*	stored in text blocks, in order with the rows.
+*
+* File layout:
+*	"PILOGCOL" magic, u32 version
+*	Blocks, each:
+*		u8 kind (SCHEMA, ROWS, TEXT), u8 flags (ENCRYPTED), u32 row/line count,
+*		u32 block number, u32 stored index size, u32 stored payload size,
+*		u32 raw payload size, index bytes, payload bytes
+*	A SCHEMA block (column names, never encrypted) precedes the rows that
+*	use it, so a file can be appended to by several logging sessions.
+*
+* Use LoggerBase::SetOutputFormat(LogOutputFormat::COLUMNAR_BINARY) to
+*	write this format, and ColumnarLogReader to read it back.
+*
+* @file ColumnarLogFile.h
+* @created October 2026
+* @version 1.0
+*/
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+
+#define LOG_API __declspec(dllexport)
+
+
+// Min/max of each numeric column in one block of rows.
+struct ColumnarBlockIndex {
+	std::vector<bool> isNumeric;
+	std::vector<double> minValues;
+	std::vector<double> maxValues;
+};
+
+
+class ColumnarLogWriter {
+
+public:
+	// Opens file_path for appending and writes a schema block for column_names.
+	LOG_API ColumnarLogWriter(const std::string& file_path,
+		const std::vector<std::string>& column_names,
+		bool encrypt,
+		size_t rows_per_block = 4096);
+	// Writes any pending rows and lines.
+	LOG_API ~ColumnarLogWriter();
+
+	LOG_API bool IsOpen() const;
+	LOG_API size_t GetColumnCount() const;
+
+	// Number of values must match the number of columns.
+	LOG_API void AppendRow(const std::vector<std::string>& values);
+	LOG_API void AppendRow(const std::vector<std::string_view>& values);
+	LOG_API void AppendTextLine(const std::string& line);
+
+	// Write pending rows and lines as a (possibly partial) block.
+	LOG_API void Flush();
+
+
+private:
+	std::ofstream file;
+	std::vector<std::string> columnNames;
+	bool encrypt;
+	size_t rowsPerBlock;
+	uint32_t blockNumber = 0;
+
+	std::vector<std::vector<std::string>> pendingColumns;
+	size_t pendingRowCount = 0;
+	std::vector<std::string> pendingTextLines;
+
+	template <typename Value>
+	void AppendRowHelper(const std::vector<Value>& values);
+	void WriteSchemaBlock();
+	void WriteRowBlock();
+	void WriteTextBlock();
+	void WriteBlock(uint8_t kind, uint32_t count, std::string index, const std::string& rawPayload);
+
+};
+
+
+class ColumnarLogReader {
+
+public:
+	// Receives the column names of the current schema and one row of values.
+	using RowVisitor = std::function<void(const std::vector<std::string>& columns, const std::vector<std::string>& values)>;
+	// Receives one custom or metadata line.
+	using TextVisitor = std::function<void(const std::string& line)>;
+	// Return false to skip a block of rows without decoding it.
+	using BlockFilter = std::function<bool(const std::vector<std::string>& columns, const ColumnarBlockIndex& index)>;
+
+	LOG_API ColumnarLogReader(const std::string& file_path);
+
+	// True if the file starts with the columnar log file magic.
+	LOG_API static bool IsColumnarLogFile(const std::string& file_path);
+
+	LOG_API bool IsValid() const;
+
+	// Read the whole file in order. Returns false if the file is corrupt.
+	LOG_API bool ReadAll(RowVisitor on_row, TextVisitor on_text, BlockFilter filter = nullptr);
+
+
+private:
+	std::string filePath;
+	bool valid = false;
+
+};
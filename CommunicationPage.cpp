@@ -1,6 +1,7 @@
 #include <wx/gbsizer.h>
 
 #include "../CommonFunctions_GUI.h"
+#include "Logging/UserActionJournal.h"
 #include "CommunicationPage.h"
 
 using namespace std;
@@ -160,28 +161,35 @@ string CommunicationPage::GetResponseFromCommand() {
 	// - In the future, when I add more service and factory functionality, I should re-design the communication
 	//   architecture to eliminate repeated code.
 	string command = string(ManualRS232CommandTextCtrl->GetValue());
-	STAGE_ACTION_ARGUMENTS(command)
+	JOURNALED_STAGE_ACTION_ARGUMENTS(command)
 	bool autoFillChecksum = ManualRS232ChecksumCheckBox->GetValue();
 	responseWaitTimeInMs = CommandLoggingWaitTimeSpinCtrl->GetValue();
 	string response = lc->SendManualRS232Command(command, autoFillChecksum, responseWaitTimeInMs);
-	string formattedResponse;
+	return ShowResponse(response);
+}
+
+
+string CommunicationPage::FormatResponse(const string& response, bool& is_error) {
+	// Valid responses always start with "03..." (read response) or "02..." (write response)
+	is_error = (response.length() < 2 or (response[1] != '3' && response[1] != '2'));
+	if (is_error)
+		return response;
+
+	// Separate the extracted response payload
+	string prefix = safe_substr(response, 0, 8);
+	int payloadLength = HexStringToDecimal(safe_substr(response, 2, 2)) * 2;
+	string responsePayload = safe_substr(response, 8, payloadLength);
+	string suffix = safe_substr(response, 8 + payloadLength, response.length());
+	return prefix + " " + responsePayload + " " + suffix;
+}
 
-	// Change response text color if error
-	bool isError = (response[1] != '3' && response[1] != '2'); // Valid responses always start with "03..." (read response) or "02..." (write response)
-	if (isError) {
-		ManualRS232ResponseTextCtrl->SetForegroundColour(TEXT_COLOR_RED);
-		formattedResponse = response;
-	}
-	else {
-		ManualRS232ResponseTextCtrl->SetForegroundColour(TEXT_COLOR_BLACK);
-		// Separate the extracted response payload
-		string prefix = safe_substr(response, 0, 8);
-		int payloadLength = HexStringToDecimal(safe_substr(response, 2, 2)) * 2;
-		string responsePayload = safe_substr(response, 8, payloadLength);
-		string suffix = safe_substr(response, 8 + payloadLength, response.length());
-		formattedResponse = prefix + " " + responsePayload + " " + suffix;
-	}
 
+string CommunicationPage::ShowResponse(const string& response) {
+	bool isError;
+	string formattedResponse = FormatResponse(response, isError);
+
+	// Change response text color if error
+	ManualRS232ResponseTextCtrl->SetForegroundColour(isError ? TEXT_COLOR_RED : TEXT_COLOR_BLACK);
 	ManualRS232ResponseTextCtrl->SetLabelText(to_wx_string(formattedResponse));
 	this->Update();
 
@@ -190,39 +198,19 @@ string CommunicationPage::GetResponseFromCommand() {
 
 
 void CommunicationPage::OnRS232CommandEntered(wxCommandEvent& evt) {
-	STAGE_ACTION("Manual RS232 Command Entered")
+	JOURNALED_STAGE_ACTION("Manual RS232 Command Entered")
 	GetResponseFromCommand();
-	LOG_ACTION()
+	JOURNALED_LOG_ACTION()
 }
 
 
 void CommunicationPage::OnStartLoggingButtonClicked(wxCommandEvent& evt) {
-	STAGE_ACTION("Start Logging Manual RS232 Commands button clicked")
+	JOURNALED_STAGE_ACTION("Start Logging Manual RS232 Commands button clicked")
 	if (loggingStarted)
 		StopLogging();
 	else
 		StartLogging();
-	LOG_ACTION()
-}
-
-
-void CommunicationPage::OnLogCommandTimerTick(wxTimerEvent& evt) {
-	RefreshCommandLoggingParameters();
-	RefreshCommandLoggingButton();
-
-	if (loggingStarted) {
-
-		if (!timeParametersCorrect) {
-			StopLogging();
-		}
-
-		string response = GetResponseFromCommand();
-
-		vector<string> values;
-		values.push_back(string(ManualRS232CommandTextCtrl->GetValue()));
-		values.push_back(response);
-		commandsLogger->LogDataPoint(values);
-	}
+	JOURNALED_LOG_ACTION()
 }
 
 
@@ -240,7 +228,21 @@ void CommunicationPage::StartLogging() {
 	commandsLogger->AddColumn("Response");
 	commandsLogger->WriteHeaderLine();
 
-	commandLoggingTimer.Start(logTimeIntervalInMs);
+	// The command and timing are fixed for the run, as written in the metadata
+	string command = string(ManualRS232CommandTextCtrl->GetValue());
+	bool autoFillChecksum = ManualRS232ChecksumCheckBox->GetValue();
+	int waitTimeInMs = responseWaitTimeInMs;
+	shared_ptr<RS232CommandsLogger> logger = commandsLogger;
+
+	// Sampled on the UI thread, since lc isn't thread-safe. Rows are stamped
+	// with the time the command was sent, not when the response came back.
+	commandSampler = make_unique<SamplingScheduler>([this, logger, command, autoFillChecksum, waitTimeInMs](chrono::system_clock::time_point acquired) {
+		string response = lc->SendManualRS232Command(command, autoFillChecksum, waitTimeInMs);
+		logger->LogDataPointAt(acquired, command, ShowResponse(response));
+	});
+	commandSampler->SetInterval(chrono::milliseconds(logTimeIntervalInMs));
+	commandSampler->StartOnCallerThread();
+	commandLoggingTimer.StartOnce(1);
 	loggingStarted = true;
 	LoggingStatusMessage->ShowProcessingMessage();
 	wxLogStatus(wxString::Format("Start logging command \"%s\" every %i ms with %i ms wait time",
@@ -252,9 +254,25 @@ void CommunicationPage::StartLogging() {
 }
 
 
+// One-shot, restarted for the next deadline, so the commands follow the
+// sampler's schedule instead of drifting with the timer.
+void CommunicationPage::OnLogCommandTimerTick(wxTimerEvent& evt) {
+	if (commandSampler)
+		commandLoggingTimer.StartOnce(max(int(commandSampler->SampleIfDue().count()), 1));
+}
+
+
 void CommunicationPage::StopLogging() {
 	LoggingStatusMessage->ShowTimedCompletionMessage();
 	commandLoggingTimer.Stop();
+	if (commandSampler) {
+		commandSampler->Stop();
+		string timing = FormatSamplingStatistics(commandSampler->GetStatistics());
+		commandSampler.reset();
+
+		commandsLogger->CommitLineMetadata(timing);
+		wxLogStatus(to_wx_string("Stopped logging command. " + timing));
+	}
 	loggingStarted = false;
 	RefreshCommandLoggingButton();
 }
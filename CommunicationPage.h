@@ -12,12 +12,15 @@
 
 #pragma once
 
+#include <memory>
+
 #include <wx/wx.h>
 #include <wx/spinctrl.h>
 
 #include "../CommonGUIComponents/TimedStatusMessage.h"
 #include "Loggers/RS232CommandsLogger.h"
 #include "SettingsPage_Base.h"
+#include "../CommonUtilities/Logging/SamplingScheduler.h"
 
 
 
@@ -33,6 +36,9 @@ public:
 
 protected:
     std::shared_ptr<RS232CommandsLogger> commandsLogger = nullptr;
+    // Schedules the logged command without drifting. Sampled on the UI
+    //   thread through commandLoggingTimer.
+    std::unique_ptr<SamplingScheduler> commandSampler;
     wxTimer commandLoggingTimer;
     bool loggingStarted = false;
     bool timeParametersCorrect;
@@ -62,6 +68,10 @@ protected:
     void OnStartLoggingButtonClicked(wxCommandEvent& evt);
     void OnLogCommandTimerTick(wxTimerEvent& evt);
     std::string GetResponseFromCommand();
+    // Separates the payload of a valid response
+    static std::string FormatResponse(const std::string& response, bool& is_error);
+    // Show a response in the response text box. Returns it formatted.
+    std::string ShowResponse(const std::string& response);
     void StartLogging();
     void StopLogging();
 
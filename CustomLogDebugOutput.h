@@ -6,7 +6,7 @@
 class CustomLogDebugOutput : public LogObserver {
 
 private:
-	void onDataPointLogged(std::map<std::string, std::string> data);
+	void onDataPointLogged(std::map<std::string, std::string> data) override;
 
 };
 
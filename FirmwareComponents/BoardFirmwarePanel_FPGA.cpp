@@ -4,6 +4,7 @@
 #include "LaserControlProcedures/FirmwareManagement/FirmwarePathFunctions.h"
 #include "../CommonUtilities/Security/AccessByIPAddress.h"
 #include "../../CommonFunctions_GUI.h"
+#include "Logging/UserActionJournal.h"
 
 #include "wx/statline.h"
 
@@ -159,6 +160,7 @@ void BoardFirmwarePanel_FPGA::OnChangeFPGASlotButtonClicked(wxCommandEvent& evt)
 
 void BoardFirmwarePanel_FPGA::OnSlotChoiceSelected(wxCommandEvent& evt) {
 	lc->StageUserAction("FPGA slot choice selected");
+	JOURNAL_STAGE_ACTION("FPGA slot choice selected")
 	
 	int selectedSlot = evt.GetInt();
 	wxString msg = wxString::Format("Chose slot %d", selectedSlot);
@@ -181,7 +183,9 @@ void BoardFirmwarePanel_FPGA::OnSlotChoiceSelected(wxCommandEvent& evt) {
 	Refresh();
 
 	lc->StageUserActionArguments(to_string(selectedSlot) + " - " + lc->GetFPGAVersion());
+	JOURNAL_STAGE_ARGUMENTS(to_string(selectedSlot) + " - " + lc->GetFPGAVersion())
 	lc->LogUserAction(GetResultingError());
+	JOURNAL_LOG_ACTION(GetResultingError())
 }
 
 
@@ -208,16 +212,19 @@ void BoardFirmwarePanel_FPGA::RefreshStatusMessage() {
 
 void BoardFirmwarePanel_FPGA::OnUpdateToLatestEngRevClicked(wxCommandEvent& evt) {
 	lc->StageUserAction("Update FPGA to latest engineering rev. clicked");
+	JOURNAL_STAGE_ACTION("Update FPGA to latest engineering rev. clicked")
 	UpdateFPGA(lc->GetFactoryFirmwareLatestEngRevFolderPath());
 }
 
 void BoardFirmwarePanel_FPGA::OnUpdateToReleaseClicked(wxCommandEvent& evt) {
 	lc->StageUserAction("Update FPGA to release clicked");
+	JOURNAL_STAGE_ACTION("Update FPGA to release clicked")
 	UpdateFPGA(lc->GetFactoryFirmwareReleasesFolderPath());
 }
 
 void BoardFirmwarePanel_FPGA::OnUpdateToOtherClicked(wxCommandEvent& evt) {
 	lc->StageUserAction("Update FPGA to other clicked");
+	JOURNAL_STAGE_ACTION("Update FPGA to other clicked")
 	UpdateFPGA(lc->GetFactoryFirmwareOldFolderPath());
 }
 
@@ -250,7 +257,9 @@ void BoardFirmwarePanel_FPGA::UpdateFPGA(std::string defaultDirectoryPath) {
 	RefreshVersionStatus();
 
 	lc->StageUserActionArguments(lc->GetFPGAVersion());
+	JOURNAL_STAGE_ARGUMENTS(lc->GetFPGAVersion())
 	lc->LogUserAction(GetResultingError());
+	JOURNAL_LOG_ACTION(GetResultingError())
 }
 
 
@@ -6,6 +6,7 @@
 #include "LaserControlProcedures/LaserResetter.h"
 #include "../CommonUtilities/Security/AccessByIPAddress.h"
 #include "../../CommonFunctions_GUI.h"
+#include "Logging/UserActionJournal.h"
 #include "../../Resources.h"
 
 #include "wx/statline.h"
@@ -160,22 +161,26 @@ void BoardFirmwarePanel_Firmware::RefreshStrings() {
 
 void BoardFirmwarePanel_Firmware::OnUpdateToLatestEngRevClicked(wxCommandEvent& evt) {
 	lc->StageUserAction("Update firmware to latest engineering rev. clicked");
+	JOURNAL_STAGE_ACTION("Update firmware to latest engineering rev. clicked")
 	UpdateFirmware(lc->GetFactoryFirmwareLatestEngRevFolderPath());
 }
 
 void BoardFirmwarePanel_Firmware::OnUpdateToReleaseClicked(wxCommandEvent& evt) {
 	lc->StageUserAction("Update firmware to release clicked");
+	JOURNAL_STAGE_ACTION("Update firmware to release clicked")
 	UpdateFirmware(lc->GetFactoryFirmwareReleasesFolderPath());
 }
 
 void BoardFirmwarePanel_Firmware::OnUpdateToOtherClicked(wxCommandEvent& evt) {
 	lc->StageUserAction("Update firmware to other clicked");
+	JOURNAL_STAGE_ACTION("Update firmware to other clicked")
 	UpdateFirmware(lc->GetFactoryFirmwareOldFolderPath());
 }
 
 void BoardFirmwarePanel_Firmware::OnSwitchFlashBankButtonClicked(wxCommandEvent& evt) {
 
 	lc->StageUserAction("Switch firmware flash bank button clicked");
+	JOURNAL_STAGE_ACTION("Switch firmware flash bank button clicked")
 
 	lc->ActivateFirmwareFlashBank();
 
@@ -211,7 +216,9 @@ void BoardFirmwarePanel_Firmware::OnSwitchFlashBankButtonClicked(wxCommandEvent&
 	updateStatusMessage->StopCycling();
 
 	lc->StageUserActionArguments(lc->GetFirmwareVersion());
+	JOURNAL_STAGE_ARGUMENTS(lc->GetFirmwareVersion())
 	lc->LogUserAction(GetResultingError());
+	JOURNAL_LOG_ACTION(GetResultingError())
 
 }
 
@@ -233,7 +240,9 @@ void BoardFirmwarePanel_Firmware::UpdateFirmware(std::string defaultDirectoryPat
 
 	if (loadFirmwareFileDialog.ShowModal() == wxID_CANCEL) {
 		lc->StageUserActionArguments("Canceled");
+		JOURNAL_STAGE_ARGUMENTS("Canceled")
 		lc->LogUserAction(GetResultingError());
+		JOURNAL_LOG_ACTION(GetResultingError())
 		return;
 	}
 
@@ -251,7 +260,9 @@ void BoardFirmwarePanel_Firmware::UpdateFirmware(std::string defaultDirectoryPat
 	RefreshVersionStatus();
 
 	lc->StageUserActionArguments(lc->GetFirmwareVersion());
+	JOURNAL_STAGE_ARGUMENTS(lc->GetFirmwareVersion())
 	lc->LogUserAction(GetResultingError());
+	JOURNAL_LOG_ACTION(GetResultingError())
 }
 
 
@@ -1,6 +1,7 @@
 #include "FirmwarePage.h"
 #include "LaserControlProcedures/FirmwareManagement/FPGAManager.h"
 #include "../CommonFunctions_GUI.h"
+#include "Logging/UserActionJournal.h"
 #include "../AccessCodeDialog.h"
 
 using namespace std;
@@ -120,7 +121,7 @@ void FirmwarePage::InitFPGAPanel() {
 
 
 void FirmwarePage::OnGetFirmwareAccessKeyButtonClicked(wxCommandEvent& evt) {
-	STAGE_ACTION("Generate firmware updating access key")
+	JOURNALED_STAGE_ACTION("Generate firmware updating access key")
 
 	wxString code = GenerateOfflinePartialKey(AccessCodeType::FIRMWARE_UPDATE);
 	AccessCodeDialog accessCodeDialog(this, code, _(FIRMWARE_ACCESS_KEY_MESSAGE_STR));
@@ -150,5 +151,5 @@ void FirmwarePage::OnGetFirmwareAccessKeyButtonClicked(wxCommandEvent& evt) {
 	//		accessCodeDialog.ShowModal();
 	//	}
 
-	LOG_ACTION()
+	JOURNALED_LOG_ACTION()
 }
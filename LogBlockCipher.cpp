@@ -0,0 +1,93 @@
+#include <array>
+#include <cstdint>
+
+#include "LogBlockCipher.h"
+#include "../Security/DataDecryptor.h"
+
+using namespace std;
+
+
+static const char BASE64_DIGITS[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+static string EncodeBase64(const string& data) {
+	string encoded((data.size() + 2) / 3 * 4, '\0');
+	char* out = &encoded[0];
+	const uint8_t* in = reinterpret_cast<const uint8_t*>(data.data());
+
+	size_t i = 0;
+	for (; i + 3 <= data.size(); i += 3) {
+		uint32_t bits = (uint32_t(in[i]) << 16) | (uint32_t(in[i + 1]) << 8) | in[i + 2];
+		*out++ = BASE64_DIGITS[(bits >> 18) & 63];
+		*out++ = BASE64_DIGITS[(bits >> 12) & 63];
+		*out++ = BASE64_DIGITS[(bits >> 6) & 63];
+		*out++ = BASE64_DIGITS[bits & 63];
+	}
+	size_t remaining = data.size() - i;
+	if (remaining > 0) {
+		uint32_t bits = uint32_t(in[i]) << 16;
+		if (remaining == 2)
+			bits |= uint32_t(in[i + 1]) << 8;
+		*out++ = BASE64_DIGITS[(bits >> 18) & 63];
+		*out++ = BASE64_DIGITS[(bits >> 12) & 63];
+		*out++ = remaining == 2 ? BASE64_DIGITS[(bits >> 6) & 63] : '=';
+		*out++ = '=';
+	}
+	return encoded;
+}
+
+// Value of each base64 digit, or -1 for other characters
+static const array<int8_t, 256> BASE64_VALUES = [] {
+	array<int8_t, 256> values;
+	values.fill(-1);
+	for (int i = 0; i < 64; i++)
+		values[uint8_t(BASE64_DIGITS[i])] = int8_t(i);
+	return values;
+}();
+
+static bool DecodeBase64(const string& encoded, string& data) {
+	if (encoded.size() % 4 != 0)
+		return false;
+
+	size_t padding = 0;
+	while (padding < 2 and padding < encoded.size() and encoded[encoded.size() - 1 - padding] == '=')
+		padding++;
+	size_t digitCount = encoded.size() - padding;
+
+	data.resize(digitCount * 3 / 4);
+	char* out = &data[0];
+	uint32_t bits = 0;
+	int invalid = 0;
+	for (size_t i = 0; i < digitCount; i++) {
+		int value = BASE64_VALUES[uint8_t(encoded[i])];
+		invalid |= value;
+		bits = (bits << 6) | uint32_t(value & 63);
+		if ((i & 3) == 3) {
+			*out++ = char(bits >> 16);
+			*out++ = char(bits >> 8);
+			*out++ = char(bits);
+		}
+	}
+	if (invalid < 0)
+		return false;
+
+	if (padding == 1) {
+		bits <<= 6;
+		*out++ = char(bits >> 16);
+		*out++ = char(bits >> 8);
+	}
+	else if (padding == 2) {
+		bits <<= 12;
+		*out++ = char(bits >> 16);
+	}
+	return true;
+}
+
+
+string EncryptLogBlock(const string& data) {
+	return cryptofy(EncodeBase64(data));
+}
+
+bool DecryptLogBlock(const string& encrypted, string& data) {
+	string encoded = decryptofy(encrypted);
+	return DecodeBase64(encoded, data);
+}
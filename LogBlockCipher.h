@@ -0,0 +1,25 @@
+/**
+* Log Block Cipher - Encrypts whole blocks of binary log data (spilled
+*	memory log chunks, columnar log blocks) with the Security library.
+*
+* - Blocks are encrypted with cryptofy(..) and decrypted with decryptofy(..)
+*	from DataDecryptor, the same as encrypted log lines, so no key material
+*	lives in the logging code.
+* - cryptofy(..) works on text, so the block is base64-encoded first. An
+*	encrypted block is therefore about a third bigger than the data.
+*
+* @file LogBlockCipher.h
+* @created October 2026
+* @version 1.0
+*/
+#pragma once
+
+#include <string>
+
+
+// Encrypt data, which may hold any bytes.
+std::string EncryptLogBlock(const std::string& data);
+
+// Decrypt a block from EncryptLogBlock(..). Returns false if it isn't one.
+//   encrypted and data may be the same string.
+bool DecryptLogBlock(const std::string& encrypted, std::string& data);
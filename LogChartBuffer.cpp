@@ -0,0 +1,228 @@
+#include <cmath>
+#include <limits>
+
+#include "LogChartBuffer.h"
+
+using namespace std;
+
+
+// Smallest pyramid block is 1 << PYRAMID_BASE_SHIFT samples
+static const unsigned int PYRAMID_BASE_SHIFT = 4;
+
+
+static void AddToBucket(LogChartBucket& bucket, float min_value, float max_value) {
+	if (!bucket.hasValues) {
+		bucket.minValue = min_value;
+		bucket.maxValue = max_value;
+		bucket.hasValues = true;
+	}
+	else {
+		bucket.minValue = min(bucket.minValue, min_value);
+		bucket.maxValue = max(bucket.maxValue, max_value);
+	}
+}
+
+
+LogChartBuffer::LogChartBuffer(size_t sample_capacity) :
+	capacity(sample_capacity > 0 ? sample_capacity : 1) {
+}
+
+
+// Called on the logging thread
+void LogChartBuffer::onRowLogged(const LogRowView& row) {
+	auto now = chrono::steady_clock::now();
+	lock_guard<mutex> lock(bufferMutex);
+
+	if (row.GetSchema() != schema)
+		ResetColumns(row.GetSchema());
+
+	if (sampleCount == 0)
+		startTime = now;
+
+	// Overwrite the oldest sample once full
+	size_t index = size_t(nextSample % capacity);
+	if (sampleCount < capacity)
+		sampleCount++;
+
+	sampleTimes[index] = chrono::duration<double>(now - startTime).count();
+	for (size_t col = 0; col < columnValues.size(); col++) {
+		double value;
+		if (row.GetNumber(rowColumnIndexes[col], value))
+			columnValues[col][index] = float(value);
+		else
+			columnValues[col][index] = numeric_limits<float>::quiet_NaN();
+	}
+	AddToPyramid(nextSample);
+	nextSample++;
+	version++;
+}
+
+void LogChartBuffer::AddToPyramid(unsigned long long sample_number) {
+	size_t index = size_t(sample_number % capacity);
+	for (PyramidLevel& level : pyramid) {
+		size_t slot = size_t((sample_number >> level.shift) % level.slotCount);
+		// A block starts empty with its first sample
+		bool firstInBlock = (sample_number & ((1ULL << level.shift) - 1)) == 0;
+
+		for (size_t col = 0; col < columnValues.size(); col++) {
+			float& minValue = level.minValues[col][slot];
+			float& maxValue = level.maxValues[col][slot];
+			if (firstInBlock) {
+				minValue = numeric_limits<float>::infinity();
+				maxValue = -numeric_limits<float>::infinity();
+			}
+			float value = columnValues[col][index];
+			if (!isnan(value)) {
+				minValue = min(minValue, value);
+				maxValue = max(maxValue, value);
+			}
+		}
+	}
+}
+
+void LogChartBuffer::ResetColumns(const shared_ptr<const LogColumnSchema>& new_schema) {
+	schema = new_schema;
+	columnNames.clear();
+	rowColumnIndexes.clear();
+	for (size_t col = 0; col < schema->GetColumnCount(); col++) {
+		const string& name = schema->GetColumnName(col);
+		if (name == "Date" or name == "Time")
+			continue;
+		columnNames.push_back(name);
+		rowColumnIndexes.push_back(col);
+	}
+
+	// Allocated once here so logging a row never allocates
+	sampleTimes.assign(capacity, 0.0);
+	columnValues.assign(columnNames.size(), vector<float>(capacity));
+	nextSample = 0;
+	sampleCount = 0;
+
+	// Levels up to the block size that covers the whole ring. The kept
+	//   samples touch at most capacity / size + 1 blocks of a level.
+	pyramid.clear();
+	for (unsigned int shift = PYRAMID_BASE_SHIFT; (1ULL << shift) < capacity * 2; shift++) {
+		PyramidLevel level;
+		level.shift = shift;
+		level.slotCount = size_t(capacity >> shift) + 2;
+		level.minValues.assign(columnNames.size(), vector<float>(level.slotCount));
+		level.maxValues.assign(columnNames.size(), vector<float>(level.slotCount));
+		pyramid.push_back(move(level));
+	}
+}
+
+
+void LogChartBuffer::Clear() {
+	lock_guard<mutex> lock(bufferMutex);
+	nextSample = 0;
+	sampleCount = 0;
+	version++;
+}
+
+unsigned long long LogChartBuffer::GetVersion() const {
+	lock_guard<mutex> lock(bufferMutex);
+	return version;
+}
+
+vector<string> LogChartBuffer::GetColumnNames() const {
+	lock_guard<mutex> lock(bufferMutex);
+	return columnNames;
+}
+
+bool LogChartBuffer::GetTimeRange(double& start_time, double& end_time) const {
+	lock_guard<mutex> lock(bufferMutex);
+	if (sampleCount == 0)
+		return false;
+	start_time = sampleTimes[(nextSample - sampleCount) % capacity];
+	end_time = sampleTimes[(nextSample - 1) % capacity];
+	return true;
+}
+
+
+// Sample times never decrease, so this is a binary search
+unsigned long long LogChartBuffer::FindSample(double time, bool after) const {
+	unsigned long long first = nextSample - sampleCount;
+	unsigned long long last = nextSample;
+	while (first < last) {
+		unsigned long long middle = first + (last - first) / 2;
+		double middleTime = sampleTimes[middle % capacity];
+		if (middleTime < time or (after and middleTime == time))
+			first = middle + 1;
+		else
+			last = middle;
+	}
+	return first;
+}
+
+// Takes the largest aligned block that fits at each step, so a range costs
+//	about two steps per level plus up to two blocks of raw samples
+void LogChartBuffer::AddRangeToBucket(size_t col, unsigned long long first, unsigned long long last, LogChartBucket& bucket) const {
+	const vector<float>& values = columnValues[col];
+
+	while (first < last) {
+		// Largest power of two that first is aligned to and that fits
+		unsigned int shift = 0;
+		while (shift < 63 and ((first >> shift) & 1) == 0 and (2ULL << shift) <= last - first)
+			shift++;
+
+		const PyramidLevel* block = nullptr;
+		if (shift >= PYRAMID_BASE_SHIFT and !pyramid.empty())
+			block = &pyramid[min(size_t(shift - PYRAMID_BASE_SHIFT), pyramid.size() - 1)];
+
+		if (block) {
+			size_t slot = size_t((first >> block->shift) % block->slotCount);
+			float minValue = block->minValues[col][slot];
+			float maxValue = block->maxValues[col][slot];
+			if (minValue <= maxValue)
+				AddToBucket(bucket, minValue, maxValue);
+			first += 1ULL << block->shift;
+		}
+		else {
+			float value = values[first % capacity];
+			if (!isnan(value))
+				AddToBucket(bucket, value, value);
+			first++;
+		}
+	}
+}
+
+
+bool LogChartBuffer::Decimate(const string& column_name, double start_time, double end_time,
+	size_t bucket_count, vector<LogChartBucket>& buckets,
+	float& min_value, float& max_value) const {
+
+	buckets.assign(bucket_count, LogChartBucket());
+	if (bucket_count == 0)
+		return false;
+
+	lock_guard<mutex> lock(bufferMutex);
+
+	size_t col = 0;
+	while (col < columnNames.size() and columnNames[col] != column_name)
+		col++;
+	if (col == columnNames.size() or sampleCount == 0)
+		return false;
+
+	// Bucket i holds the samples from its start time up to the next bucket's
+	double timeSpan = end_time - start_time;
+	unsigned long long bucketFirst = FindSample(start_time, false);
+	unsigned long long rangeLast = FindSample(end_time, true);
+	for (size_t i = 0; i < bucket_count and bucketFirst < rangeLast; i++) {
+		unsigned long long bucketLast = rangeLast;
+		if (i + 1 < bucket_count and timeSpan > 0)
+			bucketLast = min(FindSample(start_time + timeSpan * double(i + 1) / double(bucket_count), false), rangeLast);
+		AddRangeToBucket(col, bucketFirst, bucketLast, buckets[i]);
+		bucketFirst = bucketLast;
+	}
+
+	LogChartBucket range;
+	for (const LogChartBucket& bucket : buckets) {
+		if (bucket.hasValues)
+			AddToBucket(range, bucket.minValue, bucket.maxValue);
+	}
+	if (!range.hasValues)
+		return false;
+	min_value = range.minValue;
+	max_value = range.maxValue;
+	return true;
+}
@@ -0,0 +1,109 @@
+/**
+* Log Chart Buffer - Keeps recent logged data points in memory for charting.
+*
+* - Subscribe it to a logger (LogNotifier::subscribe(..)) to receive rows.
+*	Rows may arrive on any thread; the chart reads from the UI thread.
+* - Samples are stored in a fixed-capacity ring, one array per column
+*	(struct-of-arrays), so memory use doesn't grow during long sessions
+*	and reading one column for a chart is a contiguous scan.
+* - Decimate(..) reduces any number of samples to one min/max pair per
+*	pixel column, so drawing costs the same for 10 samples or 10 million.
+*	Each column also keeps a pyramid of min/max values over aligned blocks
+*	of 16, 32, 64, ... samples, updated as rows arrive, so a bucket is
+*	answered from a few blocks of the level that fits it instead of
+*	scanning its samples. Decimate(..) holds the lock for
+*	O(buckets * levels), not O(samples).
+* - Values that aren't numbers are stored as NaN and skipped when drawing.
+*
+* Used by LogChartPanel.
+*
+* @file LogChartBuffer.h
+* @created October 2026
+* @version 1.0
+*/
+#pragma once
+
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "../CommonUtilities/Logging/LogRowObserver.h"
+
+
+// Range of a column's values within one bucket of time.
+struct LogChartBucket {
+	float minValue;
+	float maxValue;
+	bool hasValues = false;
+};
+
+
+class LogChartBuffer : public LogRowObserver {
+
+public:
+	// Default capacity holds 24 hours of data at 1 sample per second
+	LogChartBuffer(size_t sample_capacity = 24 * 60 * 60);
+
+	void onRowLogged(const LogRowView& row) override;
+
+	void Clear();
+
+	// Increments whenever samples or columns change, so the chart can skip
+	//   repainting when nothing is new.
+	unsigned long long GetVersion() const;
+
+	// Names of the charted columns (every column except Date and Time).
+	std::vector<std::string> GetColumnNames() const;
+
+	// Time of the oldest and newest sample, in seconds since the first
+	//   sample. Returns false if there are no samples.
+	bool GetTimeRange(double& start_time, double& end_time) const;
+
+	// Split [start_time, end_time] into bucket_count equal buckets and find
+	//   the range of the column's values in each.
+	//   - Returns false if the column doesn't exist or has no numeric values
+	//     in the time range. Otherwise min_value/max_value are the overall
+	//     range of the values found.
+	bool Decimate(const std::string& column_name, double start_time, double end_time,
+		size_t bucket_count, std::vector<LogChartBucket>& buckets,
+		float& min_value, float& max_value) const;
+
+
+private:
+	mutable std::mutex bufferMutex;
+	const size_t capacity;
+
+	std::shared_ptr<const LogColumnSchema> schema;
+	std::vector<std::string> columnNames;
+	std::vector<size_t> rowColumnIndexes;  // Index in the logged row of each charted column
+
+	// Ring of samples: sample number n is at index n % capacity. The kept
+	//   samples are numbers [nextSample - sampleCount, nextSample).
+	std::vector<double> sampleTimes;
+	std::vector<std::vector<float>> columnValues;
+	unsigned long long nextSample = 0;
+	size_t sampleCount = 0;
+
+	// Block b of a level covers sample numbers [b << shift, (b + 1) << shift)
+	//   and is kept in slot b % slotCount. An empty block has min > max.
+	struct PyramidLevel {
+		unsigned int shift;
+		size_t slotCount;
+		std::vector<std::vector<float>> minValues;  // [column][slot]
+		std::vector<std::vector<float>> maxValues;
+	};
+	std::vector<PyramidLevel> pyramid;
+
+	std::chrono::steady_clock::time_point startTime;
+	unsigned long long version = 0;
+
+	void ResetColumns(const std::shared_ptr<const LogColumnSchema>& new_schema);
+	void AddToPyramid(unsigned long long sample_number);
+	// First sample number at or after time (or after it, if after is true)
+	unsigned long long FindSample(double time, bool after) const;
+	// Add the column's values of sample numbers [first, last) to the bucket
+	void AddRangeToBucket(size_t col, unsigned long long first, unsigned long long last, LogChartBucket& bucket) const;
+
+};
@@ -0,0 +1,233 @@
+#include <algorithm>
+#include <wx/dcbuffer.h>
+
+#include "LogChartPanel.h"
+#include "../CommonFunctions_GUI.h"
+
+using namespace std;
+
+
+static wxString CHART_NO_COLUMNS_STR = _("Select data to chart");
+static wxString CHART_WAITING_FOR_DATA_STR = _("Waiting for data...");
+static wxString CHART_NO_NUMERIC_DATA_STR = _("no numeric data");
+
+// Columns checked when they first appear
+static const size_t DEFAULT_CHECKED_COLUMNS = 3;
+
+// How often the chart checks for new data to draw
+static const int CHART_REFRESH_INTERVAL_MS = 250;
+
+
+static wxString FormatElapsedTime(double seconds) {
+    int totalSeconds = int(seconds);
+    return wxString::Format("%d:%02d:%02d", totalSeconds / 3600, (totalSeconds / 60) % 60, totalSeconds % 60);
+}
+
+
+//-------------------------------------------------------------------------
+// LogChartCanvas
+
+LogChartCanvas::LogChartCanvas(
+    shared_ptr<LogChartBuffer> _buffer,
+    wxWindow* parent,
+    wxWindowID winid,
+    const wxPoint& pos,
+    const wxSize& size) :
+    wxPanel(parent, winid, pos, size, wxTAB_TRAVERSAL | wxBORDER_THEME) {
+
+    buffer = _buffer;
+    padding = 5;
+
+    // Required by wxAutoBufferedPaintDC
+    this->SetBackgroundStyle(wxBG_STYLE_PAINT);
+    this->SetBackgroundColour(EXTRA_LIGHT_BACKGROUND_COLOR);
+    this->SetFont(FONT_EXTRA_SMALL);
+
+    this->Bind(wxEVT_PAINT, &LogChartCanvas::paintEvent, this);
+    this->Bind(wxEVT_SIZE, [this](wxSizeEvent& evt) { Refresh(); evt.Skip(); });
+}
+
+void LogChartCanvas::SetColumns(const vector<string>& _columns) {
+    columns = _columns;
+    Refresh();
+}
+
+void LogChartCanvas::paintEvent(wxPaintEvent& evt) {
+    wxAutoBufferedPaintDC dc(this);
+    render(dc);
+}
+
+void LogChartCanvas::render(wxDC& dc) {
+    dc.SetBackground(wxBrush(GetBackgroundColour()));
+    dc.Clear();
+
+    wxSize size = GetClientSize();
+    if (columns.empty()) {
+        dc.DrawText(CHART_NO_COLUMNS_STR, padding, padding);
+        return;
+    }
+
+    double startTime, endTime;
+    if (!buffer->GetTimeRange(startTime, endTime)) {
+        dc.DrawText(CHART_WAITING_FOR_DATA_STR, padding, padding);
+        return;
+    }
+
+    // Time axis labels along the bottom
+    int textHeight = dc.GetCharHeight();
+    int timeAxisY = size.y - padding - textHeight;
+    wxString endLabel = FormatElapsedTime(endTime);
+    dc.SetTextForeground(TEXT_COLOR_GRAY);
+    dc.DrawText(FormatElapsedTime(startTime), padding, timeAxisY);
+    dc.DrawText(endLabel, size.x - padding - dc.GetTextExtent(endLabel).x, timeAxisY);
+
+    const wxColour colors[] = { TEXT_COLOR_BLUE, TEXT_COLOR_GREEN, TEXT_COLOR_LIGHT_BLUE, TEXT_COLOR_GRAY };
+    const size_t colorCount = sizeof(colors) / sizeof(colors[0]);
+
+    int stripHeight = (timeAxisY - padding) / int(columns.size());
+    for (size_t i = 0; i < columns.size(); i++) {
+        wxRect area(padding, padding + int(i) * stripHeight, size.x - 2 * padding, stripHeight - padding);
+        RenderColumn(dc, columns[i], area, startTime, endTime, colors[i % colorCount]);
+    }
+}
+
+// Draw one column in its own strip. Each pixel column shows the range of
+// values in its slice of time, joined to the previous pixel column.
+void LogChartCanvas::RenderColumn(wxDC& dc, const string& column, const wxRect& area, double startTime, double endTime, const wxColour& color) {
+    int textHeight = dc.GetCharHeight();
+    wxRect plotArea(area.x, area.y + textHeight, area.width, area.height - textHeight);
+    if (plotArea.width <= 0 or plotArea.height <= 0)
+        return;
+
+    float minValue = 0, maxValue = 0;
+    bool hasData = buffer->Decimate(column, startTime, endTime, size_t(plotArea.width), buckets, minValue, maxValue);
+
+    dc.SetTextForeground(color);
+    if (hasData)
+        dc.DrawText(wxString::Format("%s  (%g to %g)", column, minValue, maxValue), area.x, area.y);
+    else
+        dc.DrawText(wxString::Format("%s  (%s)", column, CHART_NO_NUMERIC_DATA_STR), area.x, area.y);
+
+    dc.SetPen(wxPen(TEXT_COLOR_LIGHT_GRAY, 1, wxPENSTYLE_SOLID));
+    dc.SetBrush(*wxTRANSPARENT_BRUSH);
+    dc.DrawRectangle(plotArea);
+    if (!hasData)
+        return;
+
+    // Center a flat line instead of dividing by zero
+    if (maxValue == minValue) {
+        minValue -= 1;
+        maxValue += 1;
+    }
+    auto scaleY = [&](float value) {
+        return plotArea.GetBottom() - int((value - minValue) / (maxValue - minValue) * (plotArea.height - 1));
+    };
+
+    dc.SetPen(wxPen(color, 1, wxPENSTYLE_SOLID));
+    bool hasPrevious = false;
+    int previousX = 0, previousY = 0;
+    for (size_t i = 0; i < buckets.size(); i++) {
+        const LogChartBucket& bucket = buckets[i];
+        if (!bucket.hasValues)
+            continue;
+
+        int x = plotArea.x + int(i);
+        int yMin = scaleY(bucket.minValue);
+        int yMax = scaleY(bucket.maxValue);
+        int yMid = (yMin + yMax) / 2;
+
+        if (hasPrevious)
+            dc.DrawLine(previousX, previousY, x, yMid);
+        dc.DrawLine(x, yMax, x, yMin + 1);
+
+        hasPrevious = true;
+        previousX = x;
+        previousY = yMid;
+    }
+}
+
+
+//-------------------------------------------------------------------------
+// LogChartPanel
+
+LogChartPanel::LogChartPanel(
+    shared_ptr<LogChartBuffer> _buffer,
+    wxWindow* parent,
+    wxWindowID winid,
+    const wxPoint& pos,
+    const wxSize& size) :
+    wxPanel(parent, winid, pos, size, wxTAB_TRAVERSAL) {
+
+    buffer = _buffer;
+
+    wxBoxSizer* sizer = new wxBoxSizer(wxHORIZONTAL);
+
+    ColumnsCheckList = new wxCheckListBox(this, wxID_ANY, wxDefaultPosition, wxSize(200, -1));
+    ColumnsCheckList->SetFont(FONT_VERY_SMALL_SEMIBOLD);
+    ColumnsCheckList->Bind(wxEVT_CHECKLISTBOX, &LogChartPanel::OnColumnChecked, this);
+    sizer->Add(ColumnsCheckList, 0, wxALL | wxEXPAND, 5);
+
+    ChartCanvas = new LogChartCanvas(buffer, this, wxID_ANY, wxDefaultPosition, wxSize(600, 300));
+    sizer->Add(ChartCanvas, 1, wxALL | wxEXPAND, 5);
+
+    this->SetSizer(sizer);
+    this->Layout();
+    sizer->Fit(this);
+
+    refreshTimer.Bind(wxEVT_TIMER, &LogChartPanel::OnRefreshTimer, this, refreshTimer.GetId());
+    refreshTimer.Start(CHART_REFRESH_INTERVAL_MS);
+}
+
+void LogChartPanel::RefreshAll() {
+    RefreshColumnList();
+    ChartCanvas->Refresh();
+}
+
+// Rebuild the list of columns if the logger's columns changed, keeping
+// the columns that were checked before.
+void LogChartPanel::RefreshColumnList() {
+    vector<string> columns = buffer->GetColumnNames();
+    if (columns == availableColumns)
+        return;
+
+    vector<string> checkedColumns;
+    for (unsigned int i = 0; i < ColumnsCheckList->GetCount(); i++) {
+        if (ColumnsCheckList->IsChecked(i))
+            checkedColumns.push_back(availableColumns[i]);
+    }
+    bool firstColumns = availableColumns.empty();
+    availableColumns = columns;
+
+    ColumnsCheckList->Clear();
+    for (size_t i = 0; i < availableColumns.size(); i++) {
+        ColumnsCheckList->Append(wxString(availableColumns[i]));
+        bool wasChecked = find(checkedColumns.begin(), checkedColumns.end(), availableColumns[i]) != checkedColumns.end();
+        if (wasChecked or (firstColumns and i < DEFAULT_CHECKED_COLUMNS))
+            ColumnsCheckList->Check(int(i));
+    }
+
+    wxCommandEvent evt;
+    OnColumnChecked(evt);
+}
+
+void LogChartPanel::OnColumnChecked(wxCommandEvent& evt) {
+    vector<string> shownColumns;
+    for (unsigned int i = 0; i < ColumnsCheckList->GetCount(); i++) {
+        if (ColumnsCheckList->IsChecked(i))
+            shownColumns.push_back(availableColumns[i]);
+    }
+    ChartCanvas->SetColumns(shownColumns);
+}
+
+void LogChartPanel::OnRefreshTimer(wxTimerEvent& evt) {
+    if (!IsShownOnScreen())
+        return;
+
+    unsigned long long version = buffer->GetVersion();
+    if (version == lastDrawnVersion)
+        return;
+    lastDrawnVersion = version;
+
+    RefreshColumnList();
+    ChartCanvas->Refresh();
+}
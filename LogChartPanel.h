@@ -0,0 +1,62 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <wx/wx.h>
+
+#include "LogChartBuffer.h"
+
+
+class LogChartCanvas : public wxPanel {
+
+public:
+    LogChartCanvas(std::shared_ptr<LogChartBuffer> _buffer, wxWindow* parent,
+        wxWindowID winid = wxID_ANY,
+        const wxPoint& pos = wxDefaultPosition,
+        const wxSize& size = wxDefaultSize);
+
+    void SetColumns(const std::vector<std::string>& columns);
+
+private:
+    std::shared_ptr<LogChartBuffer> buffer;
+    std::vector<std::string> columns;
+    std::vector<LogChartBucket> buckets;  // Reused between paints
+    int padding;
+
+    void paintEvent(wxPaintEvent& evt);
+    void render(wxDC& dc);
+    void RenderColumn(wxDC& dc, const std::string& column, const wxRect& area, double startTime, double endTime, const wxColour& color);
+};
+
+
+// Log Chart Panel - Live chart of the numeric columns of a logger.
+//
+// Rows are collected by a LogChartBuffer subscribed to the logger. The
+// user picks which columns to show, and each shown column is drawn in
+// its own strip with its own value range, since columns have different
+// units. The chart is repainted (double-buffered) a few times per second
+// when new data has arrived.
+class LogChartPanel : public wxPanel {
+
+public:
+    LogChartPanel(std::shared_ptr<LogChartBuffer> _buffer, wxWindow* parent,
+        wxWindowID winid = wxID_ANY,
+        const wxPoint& pos = wxDefaultPosition,
+        const wxSize& size = wxDefaultSize);
+
+    void RefreshAll();
+
+private:
+    std::shared_ptr<LogChartBuffer> buffer;
+    unsigned long long lastDrawnVersion = 0;
+    std::vector<std::string> availableColumns;
+
+    wxCheckListBox* ColumnsCheckList;
+    LogChartCanvas* ChartCanvas;
+    wxTimer refreshTimer;
+
+    void RefreshColumnList();
+    void OnColumnChecked(wxCommandEvent& evt);
+    void OnRefreshTimer(wxTimerEvent& evt);
+};
@@ -0,0 +1,368 @@
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <ctime>
+#include <fstream>
+#include <limits>
+
+#include "LogCompaction.h"
+#include "LoggerBase.h"
+
+using namespace std;
+
+
+const string COMPACTION_METADATA_PREFIX = "Compaction: ";
+// Part of the compaction metadata line of change-only files
+static const string CHANGE_ONLY_TEXT = "changed values only";
+
+
+static tm ToLocalTime(time_t seconds) {
+	tm localTime{};
+#ifdef _WIN32
+	localtime_s(&localTime, &seconds);
+#else
+	localtime_r(&seconds, &localTime);
+#endif
+	return localTime;
+}
+
+static long long FloorDivide(long long value, long long divisor) {
+	long long quotient = value / divisor;
+	if (value % divisor != 0 and (value < 0) != (divisor < 0))
+		quotient--;
+	return quotient;
+}
+
+static bool ParseNumber(string_view text, double& number) {
+	if (text.empty())
+		return false;
+	auto result = from_chars(text.data(), text.data() + text.size(), number);
+	return result.ec == errc() and result.ptr == text.data() + text.size();
+}
+
+// Same format as LoggerBase::AppendRowValue(double)
+static string FormatNumber(double value) {
+	char digits[400];
+	auto result = to_chars(digits, digits + sizeof(digits), value, chars_format::fixed, 6);
+	return string(digits, result.ptr);
+}
+
+
+//-------------------------------------------------------------------------
+// LogRowCompactor
+
+LogRowCompactor::LogRowCompactor(const LogCompactionPolicy& compaction_policy, const vector<string>& column_names) :
+	policy(compaction_policy), columnNames(column_names) {
+
+	numericColumns.assign(columnNames.size(), true);
+	lastValues.assign(columnNames.size(), "");
+	lastNumbers.assign(columnNames.size(), NAN);
+	deadbands.assign(columnNames.size(), -1);
+	for (size_t i = 2; i < columnNames.size(); i++) {
+		auto columnDeadband = policy.columnDeadbands.find(columnNames[i]);
+		double deadband = columnDeadband != policy.columnDeadbands.end() ? columnDeadband->second : policy.deadband;
+		deadbands[i] = deadband > 0 ? deadband : -1;
+	}
+}
+
+void LogRowCompactor::StartFile(bool with_header, vector<LogCompactedLine>& lines) {
+	fileStarted = true;
+	writeFullRow = true;
+	lines.push_back({ GetMetadataLine(), true });
+
+	// Aggregated rows have their own columns
+	if (with_header or aggregating) {
+		string header;
+		for (const string& name : GetOutputColumnNames())
+			header += name + ",";
+		header.back() = ' ';
+		lines.push_back({ header, false });
+	}
+}
+
+void LogRowCompactor::FinishFile(vector<LogCompactedLine>& lines) {
+	FinishWindow(lines);
+	fileStarted = false;
+}
+
+void LogRowCompactor::AddRow(chrono::system_clock::time_point time, const vector<string_view>& values,
+	vector<LogCompactedLine>& lines) {
+
+	if (!fileStarted)
+		StartFile(false, lines);
+
+	if (policy.aggregateWindow.count() <= 0) {
+		WriteRow(values, lines);
+		return;
+	}
+
+	if (!sessionStarted) {
+		sessionStarted = true;
+		sessionStartTime = time;
+	}
+	if (!aggregating) {
+		for (size_t i = 2; i < values.size() and i < numericColumns.size(); i++) {
+			double number;
+			if (!values[i].empty() and !ParseNumber(values[i], number))
+				numericColumns[i] = false;
+		}
+		if (time - sessionStartTime < policy.rawDuration) {
+			WriteRow(values, lines);
+			return;
+		}
+		StartAggregating(lines);
+	}
+
+	long long milliseconds = chrono::duration_cast<chrono::milliseconds>(time.time_since_epoch()).count();
+	AddToWindow(milliseconds, values, lines);
+}
+
+void LogRowCompactor::FinishWindow(vector<LogCompactedLine>& lines) {
+	if (!windowOpen)
+		return;
+	windowOpen = false;
+
+	time_t seconds = time_t(FloorDivide(windowStartMilliseconds, 1000));
+	int milliseconds = int(windowStartMilliseconds - FloorDivide(windowStartMilliseconds, 1000) * 1000);
+	tm localTime = ToLocalTime(seconds);
+	char date[16], time[16];
+	strftime(date, sizeof(date), "%m-%d-%Y", &localTime);
+	size_t timeLength = strftime(time, sizeof(time), "%H:%M:%S", &localTime);
+	snprintf(time + timeLength, sizeof(time) - timeLength, ".%03d", milliseconds);
+
+	vector<string> texts = { date, time };
+	for (size_t i = 2; i < columnNames.size(); i++) {
+		const ColumnWindow& column = window[i];
+		if (!numericColumns[i])
+			texts.push_back(column.lastValue);
+		else if (column.count == 0)
+			texts.insert(texts.end(), 3, "");
+		else {
+			texts.push_back(FormatNumber(column.minValue));
+			texts.push_back(FormatNumber(column.sum / double(column.count)));
+			texts.push_back(FormatNumber(column.maxValue));
+		}
+	}
+	vector<string_view> values(texts.begin(), texts.end());
+	WriteRow(values, lines);
+}
+
+vector<string> LogRowCompactor::GetOutputColumnNames() const {
+	if (!aggregating)
+		return columnNames;
+
+	vector<string> names = { columnNames[0], columnNames[1] };
+	for (size_t i = 2; i < columnNames.size(); i++) {
+		if (numericColumns[i]) {
+			names.push_back(columnNames[i] + " (min)");
+			names.push_back(columnNames[i] + " (mean)");
+			names.push_back(columnNames[i] + " (max)");
+		}
+		else
+			names.push_back(columnNames[i]);
+	}
+	return names;
+}
+
+string LogRowCompactor::GetMetadataLine() const {
+	string line = COMPACTION_METADATA_PREFIX;
+	if (policy.changeOnly) {
+		line += CHANGE_ONLY_TEXT;
+		bool lossy = any_of(deadbands.begin(), deadbands.end(), [](double deadband) { return deadband > 0; });
+		if (lossy)
+			line += " (with deadband)";
+	}
+	if (policy.aggregateWindow.count() > 0) {
+		if (policy.changeOnly)
+			line += ", ";
+		string windowText = to_string(policy.aggregateWindow.count()) + " s min/mean/max";
+		if (aggregating)
+			line += windowText;
+		else
+			line += "raw for " + to_string(policy.rawDuration.count()) + " s, then " + windowText;
+	}
+	return line;
+}
+
+// Switch from raw rows to one row per window. The numeric columns are
+// those that held only numbers so far.
+void LogRowCompactor::StartAggregating(vector<LogCompactedLine>& lines) {
+	aggregating = true;
+	window.assign(columnNames.size(), ColumnWindow());
+
+	vector<double> columnDeadbands = { -1, -1 };
+	for (size_t i = 2; i < columnNames.size(); i++)
+		columnDeadbands.insert(columnDeadbands.end(), numericColumns[i] ? 3 : 1, deadbands[i]);
+	deadbands = columnDeadbands;
+	lastValues.assign(deadbands.size(), "");
+	lastNumbers.assign(deadbands.size(), NAN);
+
+	StartFile(true, lines);
+}
+
+void LogRowCompactor::AddToWindow(long long time_milliseconds, const vector<string_view>& values,
+	vector<LogCompactedLine>& lines) {
+
+	long long windowMilliseconds = chrono::duration_cast<chrono::milliseconds>(policy.aggregateWindow).count();
+	long long windowStart = FloorDivide(time_milliseconds, windowMilliseconds) * windowMilliseconds;
+	if (windowOpen and windowStart != windowStartMilliseconds)
+		FinishWindow(lines);
+
+	if (!windowOpen) {
+		windowOpen = true;
+		windowStartMilliseconds = windowStart;
+		for (ColumnWindow& column : window) {
+			column.minValue = numeric_limits<double>::infinity();
+			column.maxValue = -numeric_limits<double>::infinity();
+			column.sum = 0;
+			column.count = 0;
+			column.lastValue.clear();
+		}
+	}
+
+	for (size_t i = 2; i < values.size() and i < window.size(); i++) {
+		ColumnWindow& column = window[i];
+		double number;
+		if (!numericColumns[i])
+			column.lastValue.assign(values[i]);
+		else if (ParseNumber(values[i], number)) {
+			column.minValue = min(column.minValue, number);
+			column.maxValue = max(column.maxValue, number);
+			column.sum += number;
+			column.count++;
+		}
+	}
+}
+
+void LogRowCompactor::WriteRow(const vector<string_view>& values, vector<LogCompactedLine>& lines) {
+	rowText.clear();
+	for (size_t i = 0; i < values.size(); i++) {
+		string_view value = values[i];
+		if (!policy.changeOnly or i < 2)
+			rowText.append(value);
+		else if (writeFullRow or i >= lastValues.size() or !IsUnchanged(i, value)) {
+			// Empty means unchanged, so mark real empty values
+			if (value.empty() or value[0] == '"')
+				rowText += '"';
+			rowText.append(value);
+			if (i < lastValues.size()) {
+				lastValues[i].assign(value);
+				double number;
+				lastNumbers[i] = deadbands[i] >= 0 and ParseNumber(value, number) ? number : NAN;
+			}
+		}
+		rowText += ',';
+	}
+	rowText.back() = ' ';
+	writeFullRow = false;
+	lines.push_back({ rowText, false });
+}
+
+bool LogRowCompactor::IsUnchanged(size_t column, string_view value) const {
+	if (deadbands[column] < 0 or isnan(lastNumbers[column]))
+		return value == lastValues[column];
+
+	double number;
+	if (ParseNumber(value, number))
+		return fabs(number - lastNumbers[column]) <= deadbands[column];
+	return false;
+}
+
+
+//-------------------------------------------------------------------------
+// LogRowExpander
+
+bool LogRowExpander::ReadMetadataLine(string_view line) {
+	static const string compactionLinePrefix = GetMetadataLinePrefix() + COMPACTION_METADATA_PREFIX;
+	if (line.compare(0, compactionLinePrefix.size(), compactionLinePrefix) != 0)
+		return false;
+
+	active = line.find(CHANGE_ONLY_TEXT) != string_view::npos;
+	lastValues.clear();
+	return active;
+}
+
+void LogRowExpander::ReadHeaderLine(size_t field_count) {
+	columnCount = field_count;
+	lastValues.assign(field_count, "");
+}
+
+void LogRowExpander::ExpandRow(vector<string_view>& fields) {
+	if (!active)
+		return;
+
+	// Commas in the last value split it into more fields
+	if (columnCount > 2 and fields.size() > columnCount) {
+		const char* start = fields[columnCount - 1].data();
+		const char* end = fields.back().data() + fields.back().size();
+		fields[columnCount - 1] = string_view(start, size_t(end - start));
+		fields.resize(columnCount);
+	}
+	if (lastValues.size() < fields.size())
+		lastValues.resize(fields.size());
+
+	for (size_t i = 2; i < fields.size(); i++) {
+		string_view field = fields[i];
+		if (!field.empty()) {
+			if (field[0] == '"')
+				field.remove_prefix(1);
+			lastValues[i].assign(field);
+		}
+		fields[i] = lastValues[i];
+	}
+}
+
+bool LogRowExpander::IsActive() const {
+	return active;
+}
+
+
+//-------------------------------------------------------------------------
+
+bool ExpandCompactedLogFile(const string& file_path, const string& output_path, LogFileDecoder::LineDecryptor line_decryptor) {
+	ofstream output(output_path, ios::trunc);
+	if (!output.is_open())
+		return false;
+
+	LogFileDecoder decoder(line_decryptor);
+	LogRowExpander expander;
+	vector<string_view> fields;
+	string row;
+
+	bool decoded = decoder.Decode(file_path, [&](const LogDecodedChunk& chunk) {
+		for (const LogDecodedLine& line : chunk.lines) {
+			string_view text = chunk.GetLine(line);
+			if (line.type == LogLineType::METADATA) {
+				if (!expander.ReadMetadataLine(text))
+					output << text << '\n';
+				continue;
+			}
+			bool isRow = line.type == LogLineType::DATA and line.fieldCount >= 2;
+			if (isRow and chunk.GetField(line, 0) == "Date" and chunk.GetField(line, 1) == "Time") {
+				expander.ReadHeaderLine(line.fieldCount);
+				isRow = false;
+			}
+			if (!isRow or !expander.IsActive()) {
+				output << text << '\n';
+				continue;
+			}
+
+			fields.clear();
+			for (size_t i = 0; i < line.fieldCount; i++)
+				fields.push_back(chunk.GetField(line, i));
+			expander.ExpandRow(fields);
+
+			row.clear();
+			for (string_view field : fields) {
+				row.append(field);
+				row += ',';
+			}
+			row.back() = ' ';
+			output << row << '\n';
+		}
+		return true;
+	});
+
+	output.close();
+	return decoded and !output.fail();
+}
@@ -0,0 +1,177 @@
+/**
+* Log Compaction - Makes long logging sessions at short intervals smaller by
+*	leaving out values that didn't change, and by replacing raw rows with
+*	per-window aggregates after a while. (See LoggerBase::SetCompactionPolicy(..))
+*
+* - Change-only encoding: a value equal to the last value written in its
+*	column is written as an empty field. A value that really is empty is
+*	written as a single quote ("), and a value starting with a quote gets
+*	one more quote in front. The date and time are always written, and
+*	every file (and each header line in it) starts with a full row.
+*	With no deadband this is lossless: LogRowExpander gives back exactly
+*	the values that were logged.
+* - Deadband: numeric values within the column's deadband of the last
+*	value written count as unchanged. Lossy - the expanded value is the
+*	last one written, which is off by at most the deadband.
+* - Aggregation: after the first rawDuration of the session, rows are
+*	collected into windows of aggregateWindow and one row is written per
+*	window, timed at the window's start. Numeric columns become three
+*	columns ("Temp (min)", "Temp (mean)", "Temp (max)"); other columns
+*	keep the window's last value. A metadata line and a new header line
+*	mark the switch. The current window's row is written when a row of
+*	the next window arrives, or when the file is closed. Numeric columns
+*	are those whose values were all numbers before aggregation started.
+* - Files are marked with a metadata line starting with
+*	COMPACTION_METADATA_PREFIX. Readers that don't know about compaction
+*	see unchanged values as empty fields; LogFileMerger fills them in,
+*	LogQueryIndex::FindRows(..) doesn't (a column query only matches the
+*	rows where the value changed).
+* - Only applies to CSV log files. Columnar files already store runs of
+*	repeated values in a few bytes (see ColumnarLogFile.h).
+*
+* Example usage (reconstructing a change-only file):
+*
+*	ExpandCompactedLogFile(compactedPath, expandedPath,
+*		[](const string& line) { return decryptofy(line); });
+*
+* @file LogCompaction.h
+* @created October 2026
+* @version 1.0
+*/
+#pragma once
+
+#include <chrono>
+#include <map>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "LogFileDecoder.h"
+
+
+#define LOG_API __declspec(dllexport)
+
+
+// Start of the metadata line (after GetMetadataLinePrefix()) that marks a
+//   compacted log file
+extern LOG_API const std::string COMPACTION_METADATA_PREFIX;
+
+
+// How a logger compacts the rows it writes. Everything is off by default.
+struct LogCompactionPolicy {
+	// Leave out values that didn't change since the last row written
+	bool changeOnly = false;
+	// Numeric values within this of the last value written count as
+	//   unchanged. 0 writes every change (lossless).
+	double deadband = 0;
+	// Deadbands of single columns, overriding deadband
+	std::map<std::string, double> columnDeadbands;
+
+	// Write one aggregated row per window of this length. 0 = off.
+	std::chrono::seconds aggregateWindow{ 0 };
+	// How long rows are written as they are before aggregation starts
+	std::chrono::seconds rawDuration{ 0 };
+};
+
+
+// A line produced by LogRowCompactor
+struct LogCompactedLine {
+	std::string text;
+	bool metadata = false;
+};
+
+
+// Applies a compaction policy to the rows of one logger. Used by LoggerBase.
+class LogRowCompactor {
+
+public:
+	// column_names includes Date and Time.
+	LogRowCompactor(const LogCompactionPolicy& compaction_policy, const std::vector<std::string>& column_names);
+
+	// Lines a new file starts with: the compaction metadata line, and the
+	//   header line if with_header. The next row is written in full.
+	void StartFile(bool with_header, std::vector<LogCompactedLine>& lines);
+
+	// A row logged at time, values starting with the date and time. Appends
+	//   the lines to write, if any.
+	void AddRow(std::chrono::system_clock::time_point time, const std::vector<std::string_view>& values,
+		std::vector<LogCompactedLine>& lines);
+	// Lines of the window being collected. Call before closing the file;
+	//   the next row starts a new file.
+	void FinishFile(std::vector<LogCompactedLine>& lines);
+
+
+private:
+	LogCompactionPolicy policy;
+	std::vector<std::string> columnNames;
+	// Deadband of each column. Negative: compare the text.
+	std::vector<double> deadbands;
+	bool fileStarted = false;
+
+	// Last value written in each output column ("" before the first row),
+	//   and as a number if the column has a deadband (else NaN)
+	std::vector<std::string> lastValues;
+	std::vector<double> lastNumbers;
+	bool writeFullRow = true;
+	std::string rowText;
+
+	// Columns whose values were all numbers so far
+	std::vector<bool> numericColumns;
+	bool sessionStarted = false;
+	std::chrono::system_clock::time_point sessionStartTime;
+	bool aggregating = false;
+
+	struct ColumnWindow {
+		double minValue;
+		double maxValue;
+		double sum;
+		size_t count;
+		std::string lastValue;
+	};
+	std::vector<ColumnWindow> window;
+	long long windowStartMilliseconds = 0;
+	bool windowOpen = false;
+
+	std::vector<std::string> GetOutputColumnNames() const;
+	std::string GetMetadataLine() const;
+	void StartAggregating(std::vector<LogCompactedLine>& lines);
+	void FinishWindow(std::vector<LogCompactedLine>& lines);
+	void AddToWindow(long long time_milliseconds, const std::vector<std::string_view>& values, std::vector<LogCompactedLine>& lines);
+	void WriteRow(const std::vector<std::string_view>& values, std::vector<LogCompactedLine>& lines);
+	bool IsUnchanged(size_t column, std::string_view value) const;
+
+};
+
+
+// Fills in the values a change-only file left out. Feed it every line of a
+//   file in order.
+class LogRowExpander {
+
+public:
+	// Returns true if the line marks the file as change-only.
+	LOG_API bool ReadMetadataLine(std::string_view line);
+	// A header line starts a new run of full and change-only rows.
+	LOG_API void ReadHeaderLine(size_t field_count);
+	// Replace the fields of a row (date, time, values) with the full values.
+	//   Fields past the header's last column are joined into it, so the
+	//   fields must be views of one line. The views stay valid until the
+	//   next call.
+	LOG_API void ExpandRow(std::vector<std::string_view>& fields);
+
+	// The file read so far uses change-only encoding
+	LOG_API bool IsActive() const;
+
+
+private:
+	bool active = false;
+	size_t columnCount = 0;
+	std::vector<std::string> lastValues;
+
+};
+
+
+// Write file_path with every left-out value filled in to output_path
+//   (unencrypted, as the logger would have written it without change-only
+//   encoding). Returns false if a file can't be opened.
+LOG_API bool ExpandCompactedLogFile(const std::string& file_path, const std::string& output_path,
+	LogFileDecoder::LineDecryptor line_decryptor = nullptr);
@@ -0,0 +1,150 @@
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "LogCompression.h"
+
+using namespace std;
+
+
+// Sequence format:
+//   token:    [literal length : 4 bits][match length - MIN_MATCH : 4 bits]
+//             A nibble of 15 means more length bytes follow (255 = keep going).
+//   literals: literal length bytes copied as-is
+//   offset:   2 bytes, little-endian, distance back to the start of the match
+// The last sequence has only literals and no offset.
+
+const size_t MIN_MATCH = 4;
+const size_t MAX_OFFSET = 65535;
+const size_t LAST_LITERALS = 5; // Last bytes of a block are always literals
+const int HASH_BITS = 14;
+
+
+static uint32_t Read32(const char* p) {
+	uint32_t value;
+	memcpy(&value, p, sizeof(value));
+	return value;
+}
+
+static uint32_t HashOf(uint32_t sequence) {
+	return (sequence * 2654435761u) >> (32 - HASH_BITS);
+}
+
+static void WriteLength(string& out, size_t length) {
+	while (length >= 255) {
+		out += char(255);
+		length -= 255;
+	}
+	out += char(length);
+}
+
+static void WriteSequence(string& out, const char* literals, size_t literalLength, size_t offset, size_t matchLength) {
+	size_t matchCode = matchLength > 0 ? matchLength - MIN_MATCH : 0;
+	char token = char(((literalLength < 15 ? literalLength : 15) << 4) | (matchCode < 15 ? matchCode : 15));
+	out += token;
+	if (literalLength >= 15)
+		WriteLength(out, literalLength - 15);
+	out.append(literals, literalLength);
+
+	if (matchLength == 0)
+		return;
+	out += char(offset & 0xFF);
+	out += char((offset >> 8) & 0xFF);
+	if (matchCode >= 15)
+		WriteLength(out, matchCode - 15);
+}
+
+
+string CompressLogBlock(const string& raw) {
+	string out;
+	out.reserve(raw.size() / 2 + 16);
+
+	const char* src = raw.data();
+	size_t size = raw.size();
+	size_t anchor = 0;
+	size_t pos = 0;
+
+	if (size > MIN_MATCH + LAST_LITERALS) {
+		vector<int64_t> table(size_t(1) << HASH_BITS, -1);
+		size_t matchLimit = size - LAST_LITERALS;
+
+		while (pos + MIN_MATCH <= matchLimit) {
+			uint32_t sequence = Read32(src + pos);
+			uint32_t hash = HashOf(sequence);
+			int64_t candidate = table[hash];
+			table[hash] = int64_t(pos);
+
+			if (candidate < 0 or pos - size_t(candidate) > MAX_OFFSET or Read32(src + candidate) != sequence) {
+				pos++;
+				continue;
+			}
+
+			size_t matchLength = MIN_MATCH;
+			while (pos + matchLength < matchLimit and src[candidate + matchLength] == src[pos + matchLength])
+				matchLength++;
+
+			WriteSequence(out, src + anchor, pos - anchor, pos - size_t(candidate), matchLength);
+			pos += matchLength;
+			anchor = pos;
+		}
+	}
+
+	WriteSequence(out, src + anchor, size - anchor, 0, 0);
+	return out;
+}
+
+
+static bool ReadLength(const string& in, size_t& pos, size_t& length) {
+	while (true) {
+		if (pos >= in.size())
+			return false;
+		unsigned char byte = in[pos++];
+		length += byte;
+		if (byte != 255)
+			return true;
+	}
+}
+
+
+bool DecompressLogBlock(const string& compressed, size_t raw_size, string& raw) {
+	raw.clear();
+	raw.reserve(raw_size);
+	size_t pos = 0;
+
+	while (pos < compressed.size()) {
+		unsigned char token = compressed[pos++];
+
+		size_t literalLength = token >> 4;
+		if (literalLength == 15 and !ReadLength(compressed, pos, literalLength))
+			return false;
+		if (pos + literalLength > compressed.size() or raw.size() + literalLength > raw_size)
+			return false;
+		raw.append(compressed, pos, literalLength);
+		pos += literalLength;
+
+		// Last sequence has no match
+		if (pos == compressed.size())
+			break;
+
+		if (pos + 2 > compressed.size())
+			return false;
+		size_t offset = (unsigned char)compressed[pos] | ((unsigned char)compressed[pos + 1] << 8);
+		pos += 2;
+
+		size_t matchLength = token & 0x0F;
+		if (matchLength == 15 and !ReadLength(compressed, pos, matchLength))
+			return false;
+		matchLength += MIN_MATCH;
+
+		if (offset == 0 or offset > raw.size() or raw.size() + matchLength > raw_size)
+			return false;
+
+		// Byte-by-byte because matches may overlap the bytes being written
+		size_t matchStart = raw.size() - offset;
+		for (size_t i = 0; i < matchLength; i++)
+			raw += raw[matchStart + i];
+	}
+
+	return raw.size() == raw_size;
+}
@@ -0,0 +1,26 @@
+/**
+* Log Compression - Small, dependency-free LZ77 block compressor for log data.
+*
+* - Byte-oriented (LZ4-style sequences of literals + back-references), so it
+*	is fast to compress and very fast to decompress.
+* - Works best on repetitive data like log rows and encoded log columns.
+* - The caller stores the uncompressed size alongside the compressed block;
+*	DecompressLogBlock(..) needs it to size its output.
+*
+* @file LogCompression.h
+* @created October 2026
+* @version 1.0
+*/
+#pragma once
+
+#include <string>
+
+
+// Compress a block of bytes. Never fails; incompressible data grows by at
+//   most 1 byte per 255 bytes of input plus a few bytes of overhead.
+std::string CompressLogBlock(const std::string& raw);
+
+// Decompress a block produced by CompressLogBlock(..).
+//   - Returns false if the block is corrupt or doesn't decompress to
+//     exactly raw_size bytes.
+bool DecompressLogBlock(const std::string& compressed, size_t raw_size, std::string& raw);
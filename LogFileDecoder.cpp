@@ -0,0 +1,415 @@
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "LogFileDecoder.h"
+#include "LoggerBase.h"
+#include "LogLifecycleManager.h"
+
+using namespace std;
+
+
+// Line decryptors such as decryptofy(..) aren't known to be reentrant, so
+// unless told otherwise, all decoders call them one at a time.
+static mutex lineDecryptorMutex;
+
+
+static bool IsCompressedLogFile(const string& file_path) {
+	const string& extension = LogLifecycleManager::COMPRESSED_LOG_EXTENSION;
+	return file_path.size() > extension.size()
+		and file_path.compare(file_path.size() - extension.size(), string::npos, extension) == 0;
+}
+
+
+// Read-only view of a whole file, memory-mapped when possible.
+class MappedLogFile {
+
+public:
+	MappedLogFile(const string& file_path) {
+#ifdef _WIN32
+		file = CreateFileA(file_path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+			nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+		if (file == INVALID_HANDLE_VALUE)
+			return;
+		LARGE_INTEGER size;
+		if (!GetFileSizeEx(file, &size))
+			return;
+		opened = true;
+		if (size.QuadPart == 0)
+			return;
+		mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (!mapping) {
+			opened = false;
+			return;
+		}
+		view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+		if (!view) {
+			opened = false;
+			return;
+		}
+		contents = string_view(static_cast<const char*>(view), size_t(size.QuadPart));
+#else
+		descriptor = open(file_path.c_str(), O_RDONLY);
+		if (descriptor < 0)
+			return;
+		struct stat status;
+		if (fstat(descriptor, &status) != 0)
+			return;
+		opened = true;
+		if (status.st_size == 0)
+			return;
+		view = mmap(nullptr, size_t(status.st_size), PROT_READ, MAP_PRIVATE, descriptor, 0);
+		if (view == MAP_FAILED) {
+			view = nullptr;
+			opened = false;
+			return;
+		}
+		madvise(view, size_t(status.st_size), MADV_SEQUENTIAL);
+		contents = string_view(static_cast<const char*>(view), size_t(status.st_size));
+#endif
+	}
+
+	~MappedLogFile() {
+#ifdef _WIN32
+		if (view)
+			UnmapViewOfFile(view);
+		if (mapping)
+			CloseHandle(mapping);
+		if (file != INVALID_HANDLE_VALUE)
+			CloseHandle(file);
+#else
+		if (view)
+			munmap(view, contents.size());
+		if (descriptor >= 0)
+			close(descriptor);
+#endif
+	}
+
+	MappedLogFile(const MappedLogFile&) = delete;
+	const MappedLogFile& operator=(const MappedLogFile&) = delete;
+
+	bool IsOpen() const { return opened; }
+	string_view GetContents() const { return contents; }
+
+
+private:
+	bool opened = false;
+	string_view contents;
+#ifdef _WIN32
+	HANDLE file = INVALID_HANDLE_VALUE;
+	HANDLE mapping = nullptr;
+	void* view = nullptr;
+#else
+	int descriptor = -1;
+	void* view = nullptr;
+#endif
+
+};
+
+
+//-------------------------------------------------------------------------
+// LogDecodedChunk
+
+string_view LogDecodedChunk::GetLine(const LogDecodedLine& line) const {
+	return string_view(text).substr(line.offset, line.length);
+}
+
+string_view LogDecodedChunk::GetField(const LogDecodedLine& line, size_t field) const {
+	if (field >= line.fieldCount)
+		return string_view();
+	size_t start = fieldStarts[line.firstField + field];
+	size_t end = fieldEnds[line.firstField + field];
+	return string_view(text).substr(start, end - start);
+}
+
+
+//-------------------------------------------------------------------------
+// LogFileDecoder
+
+LogFileDecoder::LogFileDecoder(LineDecryptor line_decryptor, unsigned int thread_count) :
+	decryptLine(line_decryptor) {
+
+	threadCount = thread_count > 0 ? thread_count : max(thread::hardware_concurrency(), 1u);
+}
+
+void LogFileDecoder::SetChunkBytes(size_t chunk_bytes) {
+	chunkBytes = max(chunk_bytes, size_t(1024));
+}
+
+void LogFileDecoder::SetLineDecryptorReentrant(bool reentrant) {
+	lineDecryptorReentrant = reentrant;
+}
+
+LogDecodeStatistics LogFileDecoder::GetStatistics() const {
+	return statistics;
+}
+
+bool LogFileDecoder::Decode(const string& file_path, const ChunkHandler& handle_chunk) {
+	auto startTime = chrono::steady_clock::now();
+	statistics = LogDecodeStatistics();
+
+	// Workers decode ahead of the handler by at most this many chunks
+	const size_t window = 2 * size_t(threadCount);
+
+	// Chunks end right after a newline. A mapped file is split up front; a
+	// compressed file is decompressed by a reader thread, at most window
+	// chunks ahead of the handler, so it is never all in memory.
+	mutex decodeMutex;
+	condition_variable chunkRead;
+	condition_variable chunkDecoded;
+	condition_variable chunkDelivered;
+	vector<string_view> chunkData;
+	map<size_t, unique_ptr<string>> chunkStorage;
+	bool allChunksRead = false;
+	bool readSucceeded = true;
+	map<size_t, unique_ptr<LogDecodedChunk>> decodedChunks;
+	size_t nextChunk = 0;
+	size_t deliveredCount = 0;
+	bool stopRequested = false;
+
+	unique_ptr<MappedLogFile> mappedFile;
+	thread reader;
+	vector<thread> workers;
+
+	// Stops and joins every thread, also when handle_chunk throws
+	struct ThreadJoiner {
+		function<void()> stop;
+		~ThreadJoiner() { stop(); }
+	} joiner{ [&]() {
+		{
+			lock_guard<mutex> lock(decodeMutex);
+			stopRequested = true;
+		}
+		chunkRead.notify_all();
+		chunkDelivered.notify_all();
+		for (thread& worker : workers) {
+			if (worker.joinable())
+				worker.join();
+		}
+		if (reader.joinable())
+			reader.join();
+	} };
+
+	if (IsCompressedLogFile(file_path)) {
+		if (!ifstream(file_path, ios::binary).is_open())
+			return false;
+
+		reader = thread([&]() {
+			string pending;
+			auto addChunk = [&](size_t length) {
+				auto data = make_unique<string>(pending, 0, length);
+				pending.erase(0, length);
+				unique_lock<mutex> lock(decodeMutex);
+				chunkDelivered.wait(lock, [&] { return stopRequested or chunkData.size() < deliveredCount + window; });
+				if (stopRequested)
+					return false;
+				statistics.bytesRead += data->size();
+				chunkData.push_back(*data);
+				chunkStorage[chunkData.size() - 1] = move(data);
+				chunkRead.notify_all();
+				return true;
+			};
+
+			bool succeeded = LogLifecycleManager::ReadCompressedLogFile(file_path, [&](const string& block) {
+				pending += block;
+				while (pending.size() >= chunkBytes) {
+					size_t newline = pending.find('\n', chunkBytes - 1);
+					if (newline == string::npos)
+						break;
+					if (!addChunk(newline + 1))
+						return false;
+				}
+				return true;
+			});
+			if (succeeded and !pending.empty())
+				succeeded = addChunk(pending.size());
+
+			lock_guard<mutex> lock(decodeMutex);
+			readSucceeded = succeeded;
+			allChunksRead = true;
+			chunkRead.notify_all();
+			chunkDecoded.notify_all();
+		});
+	}
+	else {
+		mappedFile = make_unique<MappedLogFile>(file_path);
+		if (!mappedFile->IsOpen())
+			return false;
+		string_view contents = mappedFile->GetContents();
+		statistics.bytesRead = contents.size();
+
+		size_t start = 0;
+		while (start < contents.size()) {
+			size_t end = min(start + chunkBytes, contents.size());
+			if (end < contents.size()) {
+				size_t newline = contents.find('\n', end - 1);
+				end = newline == string_view::npos ? contents.size() : newline + 1;
+			}
+			chunkData.push_back(contents.substr(start, end - start));
+			start = end;
+		}
+		allChunksRead = true;
+	}
+
+	auto work = [&]() {
+		while (true) {
+			size_t index;
+			string_view data;
+			{
+				unique_lock<mutex> lock(decodeMutex);
+				chunkRead.wait(lock, [&] { return stopRequested or nextChunk < chunkData.size() or allChunksRead; });
+				if (stopRequested or nextChunk >= chunkData.size())
+					return;
+				index = nextChunk++;
+				chunkDelivered.wait(lock, [&] { return stopRequested or index < deliveredCount + window; });
+				if (stopRequested)
+					return;
+				data = chunkData[index];
+			}
+
+			auto chunk = make_unique<LogDecodedChunk>();
+			chunk->index = index;
+			DecodeChunk(data, *chunk);
+
+			lock_guard<mutex> lock(decodeMutex);
+			decodedChunks[index] = move(chunk);
+			chunkDecoded.notify_all();
+		}
+	};
+
+	// All chunks of a mapped file are known, so don't start idle workers
+	size_t workerCount = mappedFile ? min(size_t(threadCount), chunkData.size()) : size_t(threadCount);
+	for (size_t i = 0; i < workerCount; i++)
+		workers.emplace_back(work);
+
+	// Deliver chunks in order on this thread
+	bool completed = true;
+	for (size_t index = 0; ; index++) {
+		unique_ptr<LogDecodedChunk> chunk;
+		{
+			unique_lock<mutex> lock(decodeMutex);
+			chunkDecoded.wait(lock, [&] {
+				return decodedChunks.count(index) > 0 or (allChunksRead and index >= chunkData.size());
+			});
+			if (decodedChunks.count(index) == 0) {
+				completed = readSucceeded;
+				break;
+			}
+			chunk = move(decodedChunks[index]);
+			decodedChunks.erase(index);
+			chunkStorage.erase(index);
+		}
+
+		statistics.lineCount += chunk->lines.size();
+		for (const LogDecodedLine& line : chunk->lines) {
+			if (line.type == LogLineType::UNREADABLE)
+				statistics.unreadableLineCount++;
+		}
+
+		bool keepGoing = handle_chunk(*chunk);
+		{
+			lock_guard<mutex> lock(decodeMutex);
+			deliveredCount = index + 1;
+			if (!keepGoing)
+				stopRequested = true;
+		}
+		chunkDelivered.notify_all();
+		if (!keepGoing) {
+			completed = false;
+			break;
+		}
+	}
+
+	joiner.stop();
+	statistics.chunkCount = deliveredCount;
+	statistics.durationSeconds = chrono::duration<double>(chrono::steady_clock::now() - startTime).count();
+	return completed;
+}
+
+void LogFileDecoder::DecodeChunk(string_view data, LogDecodedChunk& chunk) const {
+	// Decoded text is about as long as the file text
+	chunk.text.reserve(data.size());
+
+	const string encryptedLinePrefix = GetEncryptedLinePrefix();
+	string encryptedLine;
+
+	size_t start = 0;
+	while (start < data.size()) {
+		size_t end = data.find('\n', start);
+		if (end == string_view::npos)
+			end = data.size();
+		string_view line = data.substr(start, end - start);
+		start = end + 1;
+
+		if (!line.empty() and line.back() == '\r')
+			line.remove_suffix(1);
+		if (line.empty())
+			continue;
+
+		if (line.compare(0, encryptedLinePrefix.size(), encryptedLinePrefix) == 0) {
+			if (!decryptLine) {
+				AddLine(line, LogLineType::UNREADABLE, chunk);
+				continue;
+			}
+			encryptedLine.assign(line.substr(encryptedLinePrefix.size()));
+			if (lineDecryptorReentrant)
+				AddLine(decryptLine(encryptedLine), LogLineType::DATA, chunk);
+			else {
+				unique_lock<mutex> lock(lineDecryptorMutex);
+				string decrypted = decryptLine(encryptedLine);
+				lock.unlock();
+				AddLine(decrypted, LogLineType::DATA, chunk);
+			}
+		}
+		else
+			AddLine(line, LogLineType::DATA, chunk);
+	}
+}
+
+// Append a line to the chunk, splitting DATA lines into fields.
+void LogFileDecoder::AddLine(string_view line, LogLineType type, LogDecodedChunk& chunk) const {
+	static const string metadataLinePrefix = GetMetadataLinePrefix();
+	if (type == LogLineType::DATA and line.compare(0, metadataLinePrefix.size(), metadataLinePrefix) == 0)
+		type = LogLineType::METADATA;
+
+	LogDecodedLine decoded;
+	decoded.type = type;
+	decoded.offset = chunk.text.size();
+	decoded.length = line.size();
+	decoded.firstField = chunk.fieldStarts.size();
+	decoded.fieldCount = 0;
+	chunk.text.append(line.data(), line.size());
+	chunk.text += '\n';
+
+	if (type == LogLineType::DATA) {
+		// Loggers end each row with a space where the last comma would be
+		if (!line.empty() and line.back() == ' ')
+			line.remove_suffix(1);
+
+		size_t fieldStart = 0;
+		while (true) {
+			size_t comma = line.find(',', fieldStart);
+			size_t fieldEnd = comma == string_view::npos ? line.size() : comma;
+			chunk.fieldStarts.push_back(decoded.offset + fieldStart);
+			chunk.fieldEnds.push_back(decoded.offset + fieldEnd);
+			decoded.fieldCount++;
+			if (comma == string_view::npos)
+				break;
+			fieldStart = comma + 1;
+		}
+	}
+	chunk.lines.push_back(decoded);
+}
@@ -0,0 +1,123 @@
+/**
+* Log File Decoder - Reads a text (CSV) log file written by LoggerBase and
+*	hands back its decrypted, comma-split lines, using every core.
+*
+* - The file is memory-mapped and split into chunks on line boundaries.
+*	Chunks are decrypted and parsed on a pool of worker threads.
+* - Chunks are delivered to the handler one at a time, in file order, as
+*	soon as they're ready, so a viewer can show the first rows while the
+*	rest of the file is still being decoded. Metadata lines stay in place
+*	among the data lines.
+* - Handles all line kinds a logger writes: plain lines, metadata lines
+*	(GetMetadataLinePrefix()) and encrypted lines (GetEncryptedLinePrefix(),
+*	decrypted with the LineDecryptor supplied).
+* - The LineDecryptor is called by one worker at a time, across all
+*	decoders, since decryptofy(..) isn't known to be reentrant. Per-line
+*	encrypted files therefore decrypt on one core; parsing still uses all
+*	of them. See SetLineDecryptorReentrant(..).
+* - Compressed log files (LogLifecycleManager::COMPRESSED_LOG_EXTENSION)
+*	are decompressed block by block on a reader thread, alongside decoding.
+* - Only a few chunks are held at once, so memory use doesn't grow with the
+*	file size. All threads are joined before Decode(..) returns or throws.
+*
+* Example usage (on a background thread):
+*
+*	LogFileDecoder decoder([](const string& line) { return decryptofy(line); });
+*	decoder.Decode(path, [&](const LogDecodedChunk& chunk) {
+*		for (const LogDecodedLine& line : chunk.lines) {
+*			if (line.type == LogLineType::DATA)
+*				AddRow(chunk.GetField(line, 0), chunk.GetField(line, 1), ...);
+*		}
+*		return !cancelRequested;
+*	});
+*
+* @file LogFileDecoder.h
+* @created October 2026
+* @version 1.0
+*/
+#pragma once
+
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+
+#define LOG_API __declspec(dllexport)
+
+
+enum class LogLineType {
+	DATA,		// Header or data row, split into fields
+	METADATA,	// Starts with GetMetadataLinePrefix(). Not split.
+	UNREADABLE,	// Encrypted line that couldn't be decrypted
+};
+
+struct LogDecodedLine {
+	LogLineType type;
+	// Position of the decoded line in LogDecodedChunk::text, without the
+	// newline
+	size_t offset;
+	size_t length;
+	// Fields of a DATA line in LogDecodedChunk::fieldStarts/fieldEnds
+	size_t firstField;
+	size_t fieldCount;
+};
+
+// Decoded lines of one part of a log file
+struct LogDecodedChunk {
+	size_t index = 0; // Chunks are delivered in order: 0, 1, 2, ...
+	std::string text;
+	std::vector<LogDecodedLine> lines;
+	std::vector<size_t> fieldStarts;
+	std::vector<size_t> fieldEnds;
+
+	std::string_view GetLine(const LogDecodedLine& line) const;
+	std::string_view GetField(const LogDecodedLine& line, size_t field) const;
+};
+
+struct LogDecodeStatistics {
+	unsigned long long bytesRead = 0;
+	unsigned long long lineCount = 0;
+	unsigned long long unreadableLineCount = 0;
+	size_t chunkCount = 0;
+	double durationSeconds = 0;
+};
+
+
+class LogFileDecoder {
+
+public:
+	// Decrypts the text after GetEncryptedLinePrefix(), e.g. decryptofy(..)
+	//   from DataDecryptor.
+	using LineDecryptor = std::function<std::string(const std::string& encrypted_line)>;
+	// Called on the thread that called Decode(..). Return false to stop.
+	using ChunkHandler = std::function<bool(const LogDecodedChunk& chunk)>;
+
+	// thread_count 0 uses one thread per core.
+	LOG_API LogFileDecoder(LineDecryptor line_decryptor = nullptr, unsigned int thread_count = 0);
+
+	// Approximate size of the part of the file in each chunk
+	LOG_API void SetChunkBytes(size_t chunk_bytes);
+	// Let workers call the LineDecryptor at the same time. Only for
+	//   decryptors known to be reentrant.
+	LOG_API void SetLineDecryptorReentrant(bool reentrant);
+
+	// Decode the whole file, calling handle_chunk for each chunk in order.
+	//   Blocks until done. Returns false if the file can't be read or the
+	//   handler stopped decoding.
+	LOG_API bool Decode(const std::string& file_path, const ChunkHandler& handle_chunk);
+
+	LOG_API LogDecodeStatistics GetStatistics() const;
+
+
+private:
+	LineDecryptor decryptLine;
+	unsigned int threadCount;
+	size_t chunkBytes = 4 * 1024 * 1024;
+	bool lineDecryptorReentrant = false;
+	LogDecodeStatistics statistics;
+
+	void DecodeChunk(std::string_view data, LogDecodedChunk& chunk) const;
+	void AddLine(std::string_view line, LogLineType type, LogDecodedChunk& chunk) const;
+
+};
@@ -0,0 +1,585 @@
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <unordered_map>
+
+#include "LogFileMerger.h"
+#include "ColumnarLogFile.h"
+#include "LogCompaction.h"
+#include "LogQueryIndex.h"
+#include "../ErrorMessageStream.h"
+#include "../Security/DataDecryptor.h"
+
+using namespace std;
+
+
+// Chunks an input may read ahead of the merge
+static const size_t CHUNKS_READ_AHEAD = 2;
+// How often a blocked input thread checks for a cancel
+static const chrono::milliseconds CANCEL_POLL_INTERVAL(50);
+static const size_t OUTPUT_BUFFER_BYTES = 1024 * 1024;
+
+
+namespace {
+
+struct MergeRow {
+	long long timestamp;
+	size_t firstField;
+	size_t fieldCount;
+};
+
+// Rows of one input, each row's values in the order of the input's columns
+struct MergeChunk {
+	string text;
+	vector<size_t> fieldStarts;
+	vector<size_t> fieldEnds;
+	vector<MergeRow> rows;
+
+	string_view GetField(const MergeRow& row, size_t field) const {
+		return string_view(text).substr(fieldStarts[row.firstField + field],
+			fieldEnds[row.firstField + field] - fieldStarts[row.firstField + field]);
+	}
+	// From the start of a field to the end of the row
+	string_view GetFieldsFrom(const MergeRow& row, size_t field) const {
+		size_t start = fieldStarts[row.firstField + field];
+		return string_view(text).substr(start, fieldEnds[row.firstField + row.fieldCount - 1] - start);
+	}
+};
+
+
+// Reads one input file on its own thread and hands its rows over in
+// chunks, at most CHUNKS_READ_AHEAD ahead of the merge.
+class MergeSource {
+
+public:
+	MergeSource(const string& file_path, const LogFileDecoder::LineDecryptor& decrypt_line, size_t chunk_bytes,
+		long long from_timestamp, long long to_timestamp, const atomic<bool>& cancel_requested) :
+		filePath(file_path), decryptLine(decrypt_line), chunkBytes(chunk_bytes),
+		fromTimestamp(from_timestamp), toTimestamp(to_timestamp), cancelRequested(cancel_requested) {
+
+		current = make_unique<MergeChunk>();
+		readerThread = thread(&MergeSource::Read, this);
+	}
+
+	~MergeSource() {
+		if (readerThread.joinable())
+			readerThread.join();
+	}
+
+	// The input's columns, starting with Date and Time. Waits until the
+	//   first header line (or row) has been read.
+	const vector<string>& WaitForColumns() {
+		unique_lock<mutex> lock(sourceMutex);
+		chunkReady.wait(lock, [this] { return columnsKnown or finished; });
+		return columns;
+	}
+
+	// The next chunk of rows, or nullptr once all rows were handed over.
+	unique_ptr<MergeChunk> NextChunk() {
+		unique_lock<mutex> lock(sourceMutex);
+		chunkReady.wait(lock, [this] { return !readyChunks.empty() or finished; });
+		if (readyChunks.empty())
+			return nullptr;
+		unique_ptr<MergeChunk> chunk = move(readyChunks.front());
+		readyChunks.pop_front();
+		chunkTaken.notify_one();
+		return chunk;
+	}
+
+	// Valid once NextChunk() returned nullptr
+	bool Failed() const { return failed; }
+	unsigned long long GetSkippedRowCount() const { return skippedRows; }
+
+
+private:
+	string filePath;
+	LogFileDecoder::LineDecryptor decryptLine;
+	size_t chunkBytes;
+	long long fromTimestamp;
+	long long toTimestamp;
+	const atomic<bool>& cancelRequested;
+
+	mutex sourceMutex;
+	condition_variable chunkReady;
+	condition_variable chunkTaken;
+	deque<unique_ptr<MergeChunk>> readyChunks;
+	vector<string> columns;
+	bool columnsKnown = false;
+	bool finished = false;
+	bool failed = false;
+
+	// Only used by the reader thread
+	unique_ptr<MergeChunk> current;
+	size_t widestRow = 0;
+	unsigned long long skippedRows = 0;
+	// Column of each field of the latest header that isn't the first
+	vector<int> columnOfField;
+	bool remapFields = false;
+	thread readerThread;
+
+	void Read() {
+		bool succeeded;
+		if (ColumnarLogReader::IsColumnarLogFile(filePath))
+			succeeded = ReadColumnarFile();
+		else
+			succeeded = ReadTextFile();
+		if (succeeded)
+			PushChunk();
+
+		lock_guard<mutex> lock(sourceMutex);
+		failed = !succeeded and !cancelRequested;
+		finished = true;
+		chunkReady.notify_all();
+	}
+
+	bool ReadTextFile() {
+		LogFileDecoder decoder(decryptLine, 1);
+		decoder.SetChunkBytes(chunkBytes);
+		LogRowExpander expander;
+		vector<string_view> rowFields;
+		bool stopped = false;
+
+		bool completed = decoder.Decode(filePath, [&](const LogDecodedChunk& chunk) {
+			for (const LogDecodedLine& line : chunk.lines) {
+				if (line.type == LogLineType::METADATA)
+					expander.ReadMetadataLine(chunk.GetLine(line));
+				if (line.type != LogLineType::DATA or line.fieldCount < 2)
+					continue;
+				string_view date = chunk.GetField(line, 0);
+				string_view time = chunk.GetField(line, 1);
+				if (date == "Date" and time == "Time") {
+					vector<string> header;
+					for (size_t i = 0; i < line.fieldCount; i++)
+						header.emplace_back(chunk.GetField(line, i));
+					SetHeader(header);
+					expander.ReadHeaderLine(line.fieldCount);
+					continue;
+				}
+
+				long long timestamp = LogQueryIndex::ParseTimestamp(date, time);
+				if (timestamp == LLONG_MIN or timestamp < fromTimestamp or timestamp > toTimestamp) {
+					skippedRows++;
+					continue;
+				}
+
+				MergeRow row{ timestamp, current->fieldStarts.size(), 0 };
+				if (expander.IsActive()) {
+					// Fill in the values a change-only file left out
+					rowFields.clear();
+					for (size_t i = 0; i < line.fieldCount; i++)
+						rowFields.push_back(chunk.GetField(line, i));
+					expander.ExpandRow(rowFields);
+					row.fieldCount = AddCopiedFields(rowFields);
+					if (!AddRow(row)) {
+						stopped = true;
+						return false;
+					}
+					continue;
+				}
+
+				string_view lineText = chunk.GetLine(line);
+				size_t lineStart = current->text.size();
+				current->text.append(lineText.data(), lineText.size());
+				if (!remapFields) {
+					for (size_t i = 0; i < line.fieldCount; i++) {
+						string_view field = chunk.GetField(line, i);
+						size_t start = lineStart + size_t(field.data() - lineText.data());
+						current->fieldStarts.push_back(start);
+						current->fieldEnds.push_back(start + field.size());
+					}
+					row.fieldCount = line.fieldCount;
+				}
+				else
+					row.fieldCount = AddRemappedFields(chunk, line, lineText, lineStart);
+				if (!AddRow(row)) {
+					stopped = true;
+					return false;
+				}
+			}
+			return !cancelRequested;
+		});
+		return completed and !stopped;
+	}
+
+	bool ReadColumnarFile() {
+		ColumnarLogReader reader(filePath);
+		if (!reader.IsValid())
+			return false;
+
+		vector<string> header;
+		bool stopped = false;
+		bool completed = reader.ReadAll([&](const vector<string>& row_columns, const vector<string>& values) {
+			if (stopped)
+				return;
+			if (row_columns != header) {
+				header = row_columns;
+				SetHeader(header);
+			}
+			if (values.size() < 2)
+				return;
+			long long timestamp = LogQueryIndex::ParseTimestamp(values[0], values[1]);
+			if (timestamp == LLONG_MIN or timestamp < fromTimestamp or timestamp > toTimestamp) {
+				skippedRows++;
+				return;
+			}
+
+			MergeRow row{ timestamp, current->fieldStarts.size(), 0 };
+			row.fieldCount = AddCopiedFields(vector<string_view>(values.begin(), values.end()));
+			if (!AddRow(row))
+				stopped = true;
+		}, [](const string&) {});
+		return completed and !stopped and !cancelRequested;
+	}
+
+	// The first header sets the columns. Later headers only change where
+	// each column's value is in a row.
+	void SetHeader(const vector<string>& header) {
+		if (!columnsKnown) {
+			lock_guard<mutex> lock(sourceMutex);
+			columns = header;
+			columnsKnown = true;
+			chunkReady.notify_all();
+			return;
+		}
+
+		remapFields = header != columns;
+		columnOfField.assign(header.size(), -1);
+		for (size_t i = 0; i < header.size(); i++) {
+			auto column = find(columns.begin(), columns.end(), header[i]);
+			// Aggregated rows of a compacted file (see LogCompaction.h) go
+			// into the raw column
+			const string meanSuffix = " (mean)";
+			if (column == columns.end() and header[i].size() > meanSuffix.size()
+				and header[i].compare(header[i].size() - meanSuffix.size(), meanSuffix.size(), meanSuffix) == 0)
+				column = find(columns.begin(), columns.end(), header[i].substr(0, header[i].size() - meanSuffix.size()));
+			if (column != columns.end())
+				columnOfField[i] = int(column - columns.begin());
+		}
+	}
+
+	int FieldOfColumn(size_t column) const {
+		auto field = find(columnOfField.begin(), columnOfField.end(), int(column));
+		return field == columnOfField.end() ? -1 : int(field - columnOfField.begin());
+	}
+
+	size_t AddRemappedFields(const LogDecodedChunk& chunk, const LogDecodedLine& line, string_view line_text, size_t line_start) {
+		for (size_t column = 0; column < columns.size(); column++) {
+			int field = FieldOfColumn(column);
+			size_t start = current->text.size();
+			size_t end = start;
+			if (field >= 0 and size_t(field) < line.fieldCount) {
+				string_view value = chunk.GetField(line, size_t(field));
+				start = line_start + size_t(value.data() - line_text.data());
+				end = start + value.size();
+			}
+			current->fieldStarts.push_back(start);
+			current->fieldEnds.push_back(end);
+		}
+		return columns.size();
+	}
+
+	// Copy a row's fields into the chunk, in the order of the columns
+	size_t AddCopiedFields(const vector<string_view>& fields) {
+		size_t fieldCount = remapFields ? columns.size() : fields.size();
+		for (size_t column = 0; column < fieldCount; column++) {
+			int field = remapFields ? FieldOfColumn(column) : int(column);
+			size_t start = current->text.size();
+			if (field >= 0 and size_t(field) < fields.size())
+				current->text.append(fields[field].data(), fields[field].size());
+			current->fieldStarts.push_back(start);
+			current->fieldEnds.push_back(current->text.size());
+		}
+		return fieldCount;
+	}
+
+	// Returns false on cancel
+	bool AddRow(const MergeRow& row) {
+		current->rows.push_back(row);
+		widestRow = max(widestRow, row.fieldCount);
+		if (current->text.size() >= chunkBytes) {
+			if (!WaitForRoom())
+				return false;
+			PushChunk();
+		}
+		return true;
+	}
+
+	void PushChunk() {
+		if (current->rows.empty())
+			return;
+		lock_guard<mutex> lock(sourceMutex);
+		// Rows before any header line: name their columns by position
+		if (!columnsKnown) {
+			columns = { "Date", "Time" };
+			for (size_t i = 2; i < widestRow; i++)
+				columns.push_back("Column " + to_string(i + 1));
+			columnsKnown = true;
+		}
+		readyChunks.push_back(move(current));
+		current = make_unique<MergeChunk>();
+		chunkReady.notify_all();
+	}
+
+	// Wait until the merge has taken enough chunks. Returns false on cancel.
+	bool WaitForRoom() {
+		unique_lock<mutex> lock(sourceMutex);
+		while (readyChunks.size() >= CHUNKS_READ_AHEAD) {
+			if (cancelRequested)
+				return false;
+			chunkTaken.wait_for(lock, CANCEL_POLL_INTERVAL);
+		}
+		return !cancelRequested;
+	}
+
+};
+
+
+// Writes merged rows as CSV, optionally encrypted line by line.
+class CsvMergeOutput {
+
+public:
+	CsvMergeOutput(const string& file_path, bool encrypt_rows) : encrypt(encrypt_rows) {
+		file.open(file_path, ios::trunc);
+	}
+
+	bool IsOpen() const { return file.is_open(); }
+
+	void WriteMetadataLine(const string& line) {
+		buffer += GetMetadataLinePrefix() + line + '\n';
+	}
+
+	void WriteRow(const vector<string_view>& values) {
+		string& target = encrypt ? row : buffer;
+		for (size_t i = 0; i < values.size(); i++) {
+			if (i > 0)
+				target += ',';
+			AppendValue(target, values[i]);
+		}
+		if (encrypt) {
+			buffer += GetEncryptedLinePrefix() + cryptofy(row);
+			row.clear();
+		}
+		buffer += '\n';
+
+		if (buffer.size() >= OUTPUT_BUFFER_BYTES)
+			WriteBuffer();
+	}
+
+	bool Close() {
+		WriteBuffer();
+		file.close();
+		return !file.fail();
+	}
+
+
+private:
+	ofstream file;
+	bool encrypt;
+	string buffer;
+	string row;
+
+	// Quote values that contain commas, so the export opens correctly in
+	// a spreadsheet
+	static void AppendValue(string& target, string_view value) {
+		if (value.find_first_of(",\"") == string_view::npos) {
+			target.append(value.data(), value.size());
+			return;
+		}
+		target += '"';
+		for (char c : value) {
+			if (c == '"')
+				target += '"';
+			target += c;
+		}
+		target += '"';
+	}
+
+	void WriteBuffer() {
+		file.write(buffer.data(), buffer.size());
+		buffer.clear();
+	}
+
+};
+
+}
+
+
+LogFileMerger::LogFileMerger(LogFileDecoder::LineDecryptor line_decryptor) :
+	decryptLine(line_decryptor) {
+}
+
+void LogFileMerger::AddInput(const string& file_path, const string& source) {
+	Input input;
+	input.filePath = file_path;
+	input.source = source;
+	if (input.source.empty()) {
+		// Without ".log" or ".log.plz"
+		input.source = filesystem::path(file_path).filename().string();
+		input.source = input.source.substr(0, input.source.find('.'));
+	}
+	inputs.push_back(input);
+}
+
+void LogFileMerger::SetTimeRange(long long from_timestamp, long long to_timestamp) {
+	fromTimestamp = from_timestamp;
+	toTimestamp = to_timestamp;
+}
+
+void LogFileMerger::SetChunkBytes(size_t chunk_bytes) {
+	chunkBytes = max(chunk_bytes, size_t(4096));
+}
+
+void LogFileMerger::Cancel() {
+	cancelRequested = true;
+}
+
+LogMergeStatistics LogFileMerger::GetStatistics() const {
+	return statistics;
+}
+
+bool LogFileMerger::Merge(const string& output_path, LogOutputFormat output_format, bool encrypt) {
+	auto startTime = chrono::steady_clock::now();
+	statistics = LogMergeStatistics();
+	statistics.inputCount = inputs.size();
+	cancelRequested = false;
+	if (inputs.empty())
+		return false;
+
+	vector<unique_ptr<MergeSource>> sources;
+	for (const Input& input : inputs)
+		sources.push_back(make_unique<MergeSource>(input.filePath, decryptLine, chunkBytes, fromTimestamp, toTimestamp, cancelRequested));
+
+	// Output columns: Date, Time, Source, then each input's other columns
+	// in order of appearance, shared by name
+	vector<string> outputColumns = { "Date", "Time", "Source" };
+	unordered_map<string, size_t> outputColumnIndices;
+	vector<vector<size_t>> outputColumnOfField(sources.size());
+	for (size_t s = 0; s < sources.size(); s++) {
+		const vector<string>& columns = sources[s]->WaitForColumns();
+		outputColumnOfField[s].assign(columns.size(), 0);
+		for (size_t i = 2; i < columns.size(); i++) {
+			auto column = outputColumnIndices.find(columns[i]);
+			if (column == outputColumnIndices.end()) {
+				column = outputColumnIndices.emplace(columns[i], outputColumns.size()).first;
+				outputColumns.push_back(columns[i]);
+			}
+			outputColumnOfField[s][i] = column->second;
+		}
+	}
+
+	string mergedFrom;
+	for (const Input& input : inputs)
+		mergedFrom += (mergedFrom.empty() ? "" : ", ") + input.source + " (" + input.filePath + ")";
+
+	error_code error;
+	filesystem::remove(output_path, error); // The columnar writer appends
+	unique_ptr<CsvMergeOutput> csvOutput;
+	unique_ptr<ColumnarLogWriter> columnarOutput;
+	bool outputOpen;
+	if (output_format == LogOutputFormat::COLUMNAR_BINARY) {
+		columnarOutput = make_unique<ColumnarLogWriter>(output_path, outputColumns, encrypt);
+		outputOpen = columnarOutput->IsOpen();
+		if (outputOpen)
+			columnarOutput->AppendTextLine(GetMetadataLinePrefix() + "Merged from: " + mergedFrom);
+	}
+	else {
+		csvOutput = make_unique<CsvMergeOutput>(output_path, encrypt);
+		outputOpen = csvOutput->IsOpen();
+		if (outputOpen) {
+			csvOutput->WriteMetadataLine("Merged from: " + mergedFrom);
+			vector<string_view> header(outputColumns.begin(), outputColumns.end());
+			csvOutput->WriteRow(header);
+		}
+	}
+	if (!outputOpen) {
+		e << "Failed to open merged log file: \"" << output_path << "\"." << endl;
+		Cancel();
+		sources.clear();
+		return false;
+	}
+
+	// Each input's current chunk and row, and a min-heap of the inputs by
+	// the time of their current row (ties go to the input added first)
+	vector<unique_ptr<MergeChunk>> chunks(sources.size());
+	vector<size_t> rowPositions(sources.size(), 0);
+	using HeapEntry = pair<long long, size_t>;
+	priority_queue<HeapEntry, vector<HeapEntry>, greater<HeapEntry>> heap;
+
+	auto advance = [&](size_t s) {
+		rowPositions[s]++;
+		while (!chunks[s] or rowPositions[s] >= chunks[s]->rows.size()) {
+			chunks[s] = sources[s]->NextChunk();
+			rowPositions[s] = 0;
+			if (!chunks[s])
+				return;
+		}
+		heap.emplace(chunks[s]->rows[rowPositions[s]].timestamp, s);
+	};
+	for (size_t s = 0; s < sources.size(); s++) {
+		rowPositions[s] = size_t(-1);
+		advance(s);
+	}
+
+	vector<string_view> values(outputColumns.size());
+	string lastColumnValue;
+	while (!heap.empty() and !cancelRequested) {
+		size_t s = heap.top().second;
+		heap.pop();
+		const MergeChunk& chunk = *chunks[s];
+		const MergeRow& row = chunk.rows[rowPositions[s]];
+		const vector<size_t>& columnOfField = outputColumnOfField[s];
+
+		fill(values.begin(), values.end(), string_view());
+		values[0] = chunk.GetField(row, 0);
+		values[1] = chunk.GetField(row, 1);
+		values[2] = inputs[s].source;
+		size_t fieldCount = min(row.fieldCount, columnOfField.size());
+		for (size_t i = 2; i < fieldCount; i++)
+			values[columnOfField[i]] = chunk.GetField(row, i);
+		// Commas in the last value (e.g. an error message) split it
+		if (row.fieldCount > columnOfField.size() and columnOfField.size() > 2)
+			values[columnOfField.back()] = chunk.GetFieldsFrom(row, columnOfField.size() - 1);
+
+		if (columnarOutput)
+			columnarOutput->AppendRow(values);
+		else
+			csvOutput->WriteRow(values);
+		statistics.rowsWritten++;
+
+		advance(s);
+	}
+
+	bool outputWritten = csvOutput ? csvOutput->Close() : true;
+	columnarOutput.reset();
+	bool canceled = cancelRequested;
+	if (canceled) {
+		// Unblock inputs still reading, then wait for them
+		for (size_t s = 0; s < sources.size(); s++) {
+			while (sources[s]->NextChunk()) {}
+		}
+	}
+
+	bool inputsRead = true;
+	for (size_t s = 0; s < sources.size(); s++) {
+		if (sources[s]->Failed()) {
+			e << "Failed to read log file for merging: \"" << inputs[s].filePath << "\"." << endl;
+			inputsRead = false;
+		}
+		statistics.rowsSkipped += sources[s]->GetSkippedRowCount();
+	}
+	sources.clear();
+
+	bool succeeded = outputWritten and inputsRead and !canceled;
+	if (!succeeded)
+		filesystem::remove(output_path, error);
+
+	statistics.durationSeconds = chrono::duration<double>(chrono::steady_clock::now() - startTime).count();
+	return succeeded;
+}
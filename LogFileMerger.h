@@ -0,0 +1,99 @@
+/**
+* Log File Merger - Combines several log files (e.g. the laser state,
+*	RS-232 command and error logs of one incident) into one file with
+*	their rows in time order.
+*
+* - Streaming k-way merge on the Date and Time columns every LoggerBase
+*	row starts with. Each input is read on its own thread, a chunk at a
+*	time, so memory use stays bounded (about 8 MB per input with the
+*	default chunk size) no matter how big the files are.
+* - Inputs may be text (CSV) log files in any encryption format,
+*	compressed log files, or columnar binary log files. Values left out
+*	of change-only files are filled in (see LogCompaction.h).
+* - The output has the columns Date, Time, Source (which input the row
+*	came from), then every other column of the inputs. Columns with the
+*	same name are shared; a row leaves the columns of other inputs empty.
+*	Rows with the same time keep the order the inputs were added in.
+* - The output may be CSV (optionally encrypted line by line) or the columnar
+*	binary format (see ColumnarLogFile.h), whose compressed column blocks
+*	with min/max indexes are what a viewer would load for big exports.
+* - Header, metadata and custom lines of the inputs aren't copied. A
+*	file's columns are those of its first header line.
+*
+* Example usage (on a background thread):
+*
+*	LogFileMerger merger([](const string& line) { return decryptofy(line); });
+*	merger.AddInput(laserStateLogPath, "LaserState");
+*	merger.AddInput(rs232CommandLogPath, "RS232");
+*	merger.AddInput(errorLogPath, "Errors");
+*	merger.SetTimeRange(LogQueryIndex::ParseTimestamp("10-17-2026", "14:00:00"),
+*		LogQueryIndex::ParseTimestamp("10-17-2026", "15:00:00"));
+*	merger.Merge(exportPath, LogOutputFormat::CSV);
+*
+* @file LogFileMerger.h
+* @created October 2026
+* @version 1.0
+*/
+#pragma once
+
+#include <atomic>
+#include <climits>
+#include <string>
+#include <vector>
+
+#include "LogFileDecoder.h"
+#include "LoggerBase.h"
+
+
+#define LOG_API __declspec(dllexport)
+
+
+struct LogMergeStatistics {
+	unsigned long long rowsWritten = 0;
+	// Rows outside the time range, or without a readable date and time
+	unsigned long long rowsSkipped = 0;
+	size_t inputCount = 0;
+	double durationSeconds = 0;
+};
+
+
+class LogFileMerger {
+
+public:
+	// line_decryptor is needed for files with per-line encryption (see
+	//   LogFileDecoder).
+	LOG_API LogFileMerger(LogFileDecoder::LineDecryptor line_decryptor = nullptr);
+
+	// source names the input in the Source column. "" uses the file name.
+	LOG_API void AddInput(const std::string& file_path, const std::string& source = "");
+	// Only merge rows with timestamps (see LogQueryIndex::ParseTimestamp(..))
+	//   in [from_timestamp, to_timestamp].
+	LOG_API void SetTimeRange(long long from_timestamp, long long to_timestamp);
+	// Approximate size of the pieces each input is read in
+	LOG_API void SetChunkBytes(size_t chunk_bytes);
+
+	// Merge all inputs into output_path, replacing it. Blocks until done.
+	//   Returns false if an input or the output can't be opened, or the
+	//   merge was canceled.
+	LOG_API bool Merge(const std::string& output_path, LogOutputFormat output_format, bool encrypt = false);
+	// Stop a merge running on another thread.
+	LOG_API void Cancel();
+
+	LOG_API LogMergeStatistics GetStatistics() const;
+
+
+private:
+	struct Input {
+		std::string filePath;
+		std::string source;
+	};
+
+	LogFileDecoder::LineDecryptor decryptLine;
+	std::vector<Input> inputs;
+	long long fromTimestamp = LLONG_MIN;
+	long long toTimestamp = LLONG_MAX;
+	size_t chunkBytes = 256 * 1024;
+	std::atomic<bool> cancelRequested{ false };
+	LogMergeStatistics statistics;
+
+};
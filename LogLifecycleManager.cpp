@@ -0,0 +1,493 @@
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <set>
+#include <sstream>
+#include <vector>
+#ifdef _WIN32
+#include <Windows.h>
+#endif
+
+#include "LogLifecycleManager.h"
+#include "BackgroundLogger.h"
+#include "LogCompression.h"
+#include "LogQueryIndex.h"
+#include "LogSessionIndex.h"
+#include "../CommonFunctions.h"
+#include "../ConfigurationManager.h"
+#include "../ErrorMessageStream.h"
+#include "../Security/DataDecryptor.h"
+
+using namespace std;
+
+
+const string LogLifecycleManager::COMPRESSED_LOG_EXTENSION = ".plz";
+const string LogLifecycleManager::COMPRESS_CLOSED_DAYS_KEY = "LogCompressClosedDays";
+const string LogLifecycleManager::RETENTION_KEY_PREFIX = "LogRetention_";
+
+// Compressed log file layout: magic, then blocks of
+// [raw size][compressed size][compressed bytes], sizes as 8-byte little-endian
+static const char COMPRESSED_LOG_MAGIC[] = "PILOGZ1\n";
+static const size_t COMPRESSED_LOG_MAGIC_LENGTH = 8;
+static const size_t COMPRESSION_BLOCK_BYTES = 1024 * 1024;
+static const string COMPRESSION_TEMP_EXTENSION = ".tmp";
+
+// Give the GUI time to finish starting up before the first pass
+static const chrono::seconds STARTUP_DELAY(30);
+
+
+static void WriteUInt64(ostream& output, unsigned long long value) {
+	char bytes[8];
+	for (int i = 0; i < 8; i++)
+		bytes[i] = char((value >> (8 * i)) & 0xFF);
+	output.write(bytes, sizeof(bytes));
+}
+
+static bool ReadUInt64(istream& input, unsigned long long& value) {
+	unsigned char bytes[8];
+	if (!input.read(reinterpret_cast<char*>(bytes), sizeof(bytes)))
+		return false;
+	value = 0;
+	for (int i = 7; i >= 0; i--)
+		value = (value << 8) | bytes[i];
+	return true;
+}
+
+static vector<filesystem::path> ListEntries(const filesystem::path& folder, bool folders) {
+	vector<filesystem::path> entries;
+	error_code error;
+	for (const auto& entry : filesystem::directory_iterator(folder, error)) {
+		bool isFolder = entry.is_directory(error);
+		if (isFolder == folders)
+			entries.push_back(entry.path());
+	}
+	return entries;
+}
+
+static string NormalizePath(const filesystem::path& path) {
+	return path.lexically_normal().string();
+}
+
+
+// Log types whose retention key is read even before a logger of that type
+//   registers its file
+static const vector<string> CONFIGURABLE_LOG_TYPES = { "ErrorLogs", "LaserStateLogs", "RS232CommandLogs" };
+
+
+LogLifecycleManager::LogLifecycleManager() {}
+
+LogLifecycleManager& LogLifecycleManager::GetInstance() {
+	static LogLifecycleManager* manager = new LogLifecycleManager();
+	// Constructed after the manager, so destroyed before anything that used
+	//   it earlier
+	static ExitJoiner exitJoiner;
+	return *manager;
+}
+
+LogLifecycleManager::ExitJoiner::~ExitJoiner() {
+	LogLifecycleManager& manager = GetInstance();
+	{
+		lock_guard<mutex> lock(manager.managerMutex);
+		manager.exiting = true;
+	}
+	manager.Stop();
+}
+
+
+void LogLifecycleManager::SetRetentionPolicy(const string& log_type, const LogRetentionPolicy& policy) {
+	lock_guard<mutex> lock(managerMutex);
+	retentionPolicies[log_type] = policy;
+}
+
+LogRetentionPolicy LogLifecycleManager::GetRetentionPolicy(const string& log_type) const {
+	lock_guard<mutex> lock(managerMutex);
+	auto policy = retentionPolicies.find(log_type);
+	return policy != retentionPolicies.end() ? policy->second : LogRetentionPolicy();
+}
+
+void LogLifecycleManager::SetCompressClosedDays(bool compress) {
+	lock_guard<mutex> lock(managerMutex);
+	compressClosedDays = compress;
+}
+
+void LogLifecycleManager::SetUpdateQueryIndexes(bool update) {
+	lock_guard<mutex> lock(managerMutex);
+	updateQueryIndexes = update;
+}
+
+void LogLifecycleManager::SetMaintenanceInterval(chrono::minutes interval) {
+	lock_guard<mutex> lock(managerMutex);
+	maintenanceInterval = max(interval, chrono::minutes(1));
+}
+
+void LogLifecycleManager::SetQuietPeriod(chrono::minutes quiet_period) {
+	lock_guard<mutex> lock(managerMutex);
+	quietPeriod = quiet_period;
+}
+
+
+void LogLifecycleManager::RegisterActiveLogFile(const void* owner, const string& file_path) {
+	lock_guard<mutex> lock(managerMutex);
+	activeLogFiles[owner] = file_path;
+}
+
+void LogLifecycleManager::UnregisterActiveLogFile(const void* owner) {
+	lock_guard<mutex> lock(managerMutex);
+	activeLogFiles.erase(owner);
+}
+
+
+void LogLifecycleManager::LoadConfiguration() {
+	ConfigurationManager& configuration = ConfigurationManager::GetInstance();
+
+	if (configuration.Exists(COMPRESS_CLOSED_DAYS_KEY))
+		SetCompressClosedDays(configuration.Get(COMPRESS_CLOSED_DAYS_KEY) == "1");
+
+	set<string> logTypes(CONFIGURABLE_LOG_TYPES.begin(), CONFIGURABLE_LOG_TYPES.end());
+	{
+		lock_guard<mutex> lock(managerMutex);
+		// .../[ log type ]/[ file ]
+		for (const auto& activeLogFile : activeLogFiles)
+			logTypes.insert(filesystem::path(activeLogFile.second).parent_path().filename().string());
+	}
+
+	for (const string& logType : logTypes) {
+		string key = RETENTION_KEY_PREFIX + logType;
+		if (!configuration.Exists(key))
+			continue;
+
+		LogRetentionPolicy policy;
+		istringstream value(configuration.Get(key));
+		if (value >> policy.maxAgeDays >> policy.maxTotalBytes and policy.maxAgeDays >= 0)
+			SetRetentionPolicy(logType, policy);
+		else
+			e << "Invalid log retention setting " << key << ": \"" << configuration.Get(key) << "\"" << endl;
+	}
+}
+
+
+void LogLifecycleManager::RequestMaintenance() {
+	LoadConfiguration();
+
+	lock_guard<mutex> lock(managerMutex);
+	if (exiting)
+		return;
+	maintenanceRequested = true;
+	if (!maintenanceThread.joinable()) {
+		stopRequested = false;
+		maintenanceThread = thread(&LogLifecycleManager::Run, this);
+	}
+	wakeUpCondition.notify_all();
+}
+
+void LogLifecycleManager::Stop() {
+	{
+		lock_guard<mutex> lock(managerMutex);
+		stopRequested = true;
+	}
+	wakeUpCondition.notify_all();
+	if (maintenanceThread.joinable())
+		maintenanceThread.join();
+}
+
+bool LogLifecycleManager::IsStopRequested() const {
+	lock_guard<mutex> lock(managerMutex);
+	return stopRequested;
+}
+
+LogMaintenanceStatistics LogLifecycleManager::GetLastMaintenanceStatistics() const {
+	lock_guard<mutex> lock(managerMutex);
+	return lastStatistics;
+}
+
+
+void LogLifecycleManager::Run() {
+#ifdef _WIN32
+	// Lowers I/O priority as well as CPU priority
+	SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_BACKGROUND_BEGIN);
+#endif
+
+	unique_lock<mutex> lock(managerMutex);
+	if (wakeUpCondition.wait_for(lock, STARTUP_DELAY, [this] { return stopRequested; }))
+		return;
+
+	while (!stopRequested) {
+		maintenanceRequested = false;
+		lock.unlock();
+		RunMaintenancePass();
+		lock.lock();
+		wakeUpCondition.wait_for(lock, maintenanceInterval, [this] { return stopRequested or maintenanceRequested; });
+	}
+}
+
+void LogLifecycleManager::RunMaintenancePass() {
+	auto startTime = chrono::steady_clock::now();
+	LogMaintenanceStatistics statistics;
+
+	// Work on copies so settings can change during a long pass
+	map<string, LogRetentionPolicy> policies;
+	set<string> activeFiles;
+	set<string> activeDayFolders;
+	bool compress;
+	bool updateIndexes;
+	chrono::minutes quiet;
+	{
+		lock_guard<mutex> lock(managerMutex);
+		policies = retentionPolicies;
+		for (const auto& activeLogFile : activeLogFiles) {
+			filesystem::path activePath = filesystem::path(activeLogFile.second).lexically_normal();
+			activeFiles.insert(activePath.string());
+			// .../[ date ]/[ log type ]/[ file ]
+			activeDayFolders.insert(activePath.parent_path().parent_path().string());
+		}
+		compress = compressClosedDays;
+		updateIndexes = updateQueryIndexes;
+		quiet = quietPeriod;
+	}
+
+	auto quietSince = filesystem::file_time_type::clock::now() - quiet;
+	string today = GenerateDateString();
+
+	struct LogFileInfo {
+		filesystem::path path;
+		unsigned long long bytes;
+		filesystem::file_time_type lastWriteTime;
+	};
+	map<string, vector<LogFileInfo>> filesByLogType;
+
+	// Compress closed days, and list every log file for retention
+	for (const filesystem::path& laserFolder : ListEntries(GetLogBaseDirectory(), true)) {
+		for (const filesystem::path& dayFolder : ListEntries(laserFolder, true)) {
+			vector<filesystem::path> logTypeFolders = ListEntries(dayFolder, true);
+
+			vector<vector<filesystem::path>> filesByFolder;
+			auto lastWriteTime = filesystem::file_time_type::min();
+			for (const filesystem::path& logTypeFolder : logTypeFolders) {
+				filesByFolder.push_back(ListEntries(logTypeFolder, false));
+				for (const filesystem::path& file : filesByFolder.back()) {
+					error_code error;
+					auto fileTime = filesystem::last_write_time(file, error);
+					if (!error)
+						lastWriteTime = max(lastWriteTime, fileTime);
+				}
+			}
+
+			bool dayClosed = dayFolder.filename().string() != today
+				and activeDayFolders.count(NormalizePath(dayFolder)) == 0
+				and lastWriteTime < quietSince;
+
+			for (size_t i = 0; i < logTypeFolders.size(); i++) {
+				string logType = logTypeFolders[i].filename().string();
+
+				for (filesystem::path file : filesByFolder[i]) {
+					if (IsStopRequested())
+						return;
+
+					error_code error;
+					auto fileTime = filesystem::last_write_time(file, error);
+					if (error)
+						continue;
+
+					// Session index, or a compression interrupted by shutdown
+					string filename = file.filename().string();
+					if (filename.compare(0, LogSessionIndex::SESSION_INDEX_FILENAME.size(), LogSessionIndex::SESSION_INDEX_FILENAME) == 0)
+						continue;
+					if (file.extension() == COMPRESSION_TEMP_EXTENSION) {
+						if (fileTime < quietSince)
+							filesystem::remove(file, error);
+						continue;
+					}
+
+					if (compress and dayClosed and file.extension() == ".log") {
+						unsigned long long bytesBefore = filesystem::file_size(file, error);
+						if (!error and CompressLogFile(file.string())) {
+							file += COMPRESSED_LOG_EXTENSION;
+							statistics.filesCompressed++;
+							statistics.bytesBeforeCompression += bytesBefore;
+							statistics.bytesAfterCompression += filesystem::file_size(file, error);
+						}
+					}
+
+					unsigned long long bytes = filesystem::file_size(file, error);
+					if (!error)
+						filesByLogType[logType].push_back({ file, bytes, fileTime });
+				}
+			}
+		}
+	}
+
+	// Retention: oldest files first
+	auto maxAgeReference = filesystem::file_time_type::clock::now();
+	for (auto& logTypeFiles : filesByLogType) {
+		auto policy = policies.find(logTypeFiles.first);
+		if (policy == policies.end())
+			continue;
+
+		vector<LogFileInfo>& files = logTypeFiles.second;
+		sort(files.begin(), files.end(), [](const LogFileInfo& a, const LogFileInfo& b) {
+			return a.lastWriteTime < b.lastWriteTime;
+		});
+
+		unsigned long long totalBytes = 0;
+		for (const LogFileInfo& file : files)
+			totalBytes += file.bytes;
+
+		for (const LogFileInfo& file : files) {
+			bool tooOld = policy->second.maxAgeDays > 0
+				and file.lastWriteTime < maxAgeReference - chrono::hours(24 * policy->second.maxAgeDays);
+			bool overQuota = policy->second.maxTotalBytes > 0 and totalBytes > policy->second.maxTotalBytes;
+			// Files are sorted, so the rest are newer and the total only shrinks
+			if (!tooOld and !overQuota)
+				break;
+
+			if (activeFiles.count(NormalizePath(file.path)) > 0 or file.lastWriteTime >= quietSince)
+				continue;
+			if (IsStopRequested())
+				return;
+
+			error_code error;
+			if (filesystem::remove(file.path, error)) {
+				totalBytes -= file.bytes;
+				statistics.filesDeleted++;
+				statistics.bytesDeleted += file.bytes;
+			}
+		}
+	}
+
+	// Remove past days' folders left empty, ignoring the session index.
+	// Today's folders are left alone, since a logger may be about to use them.
+	for (const filesystem::path& laserFolder : ListEntries(GetLogBaseDirectory(), true)) {
+		for (const filesystem::path& dayFolder : ListEntries(laserFolder, true)) {
+			bool pastDay = dayFolder.filename().string() != today
+				and activeDayFolders.count(NormalizePath(dayFolder)) == 0;
+			if (!pastDay)
+				continue;
+
+			error_code error;
+			for (const filesystem::path& logTypeFolder : ListEntries(dayFolder, true)) {
+				vector<filesystem::path> files = ListEntries(logTypeFolder, false);
+				if (files.size() == 1 and files[0].filename().string() == LogSessionIndex::SESSION_INDEX_FILENAME)
+					filesystem::remove(files[0], error);
+				filesystem::remove(logTypeFolder, error); // Fails unless empty
+			}
+			filesystem::remove(dayFolder, error);
+		}
+		error_code error;
+		filesystem::remove(laserFolder, error);
+	}
+
+	// Index files closed since the last pass. Files being written to are
+	// left for a later pass; a stop request leaves the rest too.
+	if (updateIndexes) {
+		for (const filesystem::path& laserFolder : ListEntries(GetLogBaseDirectory(), true)) {
+			if (IsStopRequested())
+				return;
+			LogQueryIndex queryIndex(laserFolder.string(), [](const string& line) { return decryptofy(line); });
+			queryIndex.SetDecodeThreadCount(1);
+			queryIndex.Load();
+			LogIndexUpdateStatistics indexStatistics = queryIndex.Update([&](const string& file_path) {
+				return IsStopRequested() or activeFiles.count(NormalizePath(file_path)) > 0;
+			});
+			statistics.filesIndexed += indexStatistics.filesDecoded;
+		}
+	}
+
+	statistics.durationSeconds = chrono::duration<double>(chrono::steady_clock::now() - startTime).count();
+	lock_guard<mutex> lock(managerMutex);
+	lastStatistics = statistics;
+}
+
+
+bool LogLifecycleManager::CompressLogFile(const string& file_path) {
+	string compressedFilePath = file_path + COMPRESSED_LOG_EXTENSION;
+	string tempFilePath = compressedFilePath + COMPRESSION_TEMP_EXTENSION;
+
+	error_code error;
+	auto lastWriteTime = filesystem::last_write_time(file_path, error);
+	if (error)
+		return false;
+
+	bool succeeded = true;
+	{
+		ifstream input(file_path, ios::binary);
+		ofstream output(tempFilePath, ios::binary | ios::trunc);
+		if (!input.is_open() or !output.is_open())
+			succeeded = false;
+		else
+			output.write(COMPRESSED_LOG_MAGIC, COMPRESSED_LOG_MAGIC_LENGTH);
+
+		string raw, roundTrip;
+		while (succeeded) {
+			raw.resize(COMPRESSION_BLOCK_BYTES);
+			input.read(&raw[0], raw.size());
+			raw.resize(size_t(input.gcount()));
+			if (raw.empty())
+				break;
+
+			// Check every block before the original is deleted
+			string compressed = CompressLogBlock(raw);
+			if (!DecompressLogBlock(compressed, raw.size(), roundTrip) or roundTrip != raw) {
+				succeeded = false;
+				break;
+			}
+			WriteUInt64(output, raw.size());
+			WriteUInt64(output, compressed.size());
+			output.write(compressed.data(), compressed.size());
+		}
+		succeeded = succeeded and !input.bad();
+		output.close();
+		succeeded = succeeded and output.good();
+	}
+
+	if (succeeded) {
+		// Keep the original time so retention still sees the file's real age
+		filesystem::last_write_time(tempFilePath, lastWriteTime, error);
+		filesystem::rename(tempFilePath, compressedFilePath, error);
+		succeeded = !error;
+	}
+	if (!succeeded) {
+		filesystem::remove(tempFilePath, error);
+		return false;
+	}
+
+	// Never keep both copies, or the log would appear twice
+	if (!filesystem::remove(file_path, error)) {
+		filesystem::remove(compressedFilePath, error);
+		return false;
+	}
+	return true;
+}
+
+bool LogLifecycleManager::ReadCompressedLogFile(const string& file_path, const function<bool(const string& block)>& handle_block) {
+	ifstream input(file_path, ios::binary);
+	char magic[COMPRESSED_LOG_MAGIC_LENGTH];
+	if (!input.read(magic, sizeof(magic)) or string(magic, sizeof(magic)) != COMPRESSED_LOG_MAGIC)
+		return false;
+
+	unsigned long long rawSize, compressedSize;
+	string compressed, raw;
+	while (ReadUInt64(input, rawSize)) {
+		if (!ReadUInt64(input, compressedSize))
+			return false;
+		// Blocks are never bigger than this, so anything else is corrupt
+		if (rawSize > COMPRESSION_BLOCK_BYTES or compressedSize > 2 * COMPRESSION_BLOCK_BYTES)
+			return false;
+
+		compressed.resize(size_t(compressedSize));
+		if (!input.read(&compressed[0], compressed.size()))
+			return false;
+		if (!DecompressLogBlock(compressed, size_t(rawSize), raw))
+			return false;
+		if (!handle_block(raw))
+			return false;
+	}
+	return input.eof();
+}
+
+bool LogLifecycleManager::ReadCompressedLogFile(const string& file_path, string& contents) {
+	contents.clear();
+	return ReadCompressedLogFile(file_path, [&](const string& block) {
+		contents += block;
+		return true;
+	});
+}
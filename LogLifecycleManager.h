@@ -0,0 +1,174 @@
+/**
+* Log Lifecycle Manager - Keeps the background log folders from growing
+*	forever. Runs on its own low-priority thread, so it never delays
+*	logging or BackgroundLogger::Init().
+*
+* Each maintenance pass goes through every laser and date folder under
+* GetLogBaseDirectory() and:
+*
+* - If enabled, compresses the .log files of closed day folders into
+*	.log.plz files (see LogCompression.h). A day folder is closed once it
+*	isn't today's, no background logger is writing to it, and none of its
+*	files has been written to for a while. Read them back with
+*	ReadCompressedLogFile(..), one block at a time.
+* - Applies the retention policy of each log type that has one (the folder
+*	name, e.g. "ErrorLogs"): files older than the maximum age are deleted,
+*	then the oldest files are deleted until the log type fits in its byte
+*	quota. Files being written to are never deleted.
+* - Removes folders left empty.
+* - Brings each laser's LogQueryIndex up to date, so queries don't have
+*	to decode files that closed since the last pass.
+*
+* Compression and retention delete or replace log files, so both are off
+* until configured. RequestMaintenance() reads them from the
+* ConfigurationManager each time:
+*
+*	LogCompressClosedDays = 1
+*	LogRetention_<log type> = <max age in days> <max total bytes>, e.g.
+*	LogRetention_LaserStateLogs = 90 2147483648
+*
+* or they can be set in code, as below. Configuration values override
+* values set in code.
+*
+* Passes run when requested (BackgroundLogger::Init() requests one) and
+* then periodically. Rotation of the file being written to is done by the
+* logger itself (see LoggerBase::SetRotationPolicy(..)). The maintenance
+* thread is stopped and joined during static destruction at the latest.
+*
+* Example usage:
+*
+*	LogRetentionPolicy policy;
+*	policy.maxAgeDays = 30;
+*	policy.maxTotalBytes = 500ull * 1024 * 1024;
+*	LogLifecycleManager::GetInstance().SetRetentionPolicy("LaserStateLogs", policy);
+*	LogLifecycleManager::GetInstance().RequestMaintenance();
+*
+* @file LogLifecycleManager.h
+* @created October 2026
+* @version 1.0
+*/
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+
+
+#define LOG_API __declspec(dllexport)
+
+
+// How long the files of one log type are kept. Each limit is off when zero.
+struct LogRetentionPolicy {
+	// Delete files last written more than this many days ago
+	int maxAgeDays = 0;
+	// Delete the oldest files once all files of this log type (for all
+	// lasers and dates) take up more than this many bytes
+	unsigned long long maxTotalBytes = 0;
+};
+
+// What the last maintenance pass did
+struct LogMaintenanceStatistics {
+	unsigned long long filesCompressed = 0;
+	unsigned long long bytesBeforeCompression = 0;
+	unsigned long long bytesAfterCompression = 0;
+	unsigned long long filesDeleted = 0;
+	unsigned long long bytesDeleted = 0;
+	unsigned long long filesIndexed = 0;
+	double durationSeconds = 0;
+};
+
+
+class LogLifecycleManager {
+
+public:
+	// Extension appended to compressed log files, e.g. "1.log" -> "1.log.plz"
+	static const std::string COMPRESSED_LOG_EXTENSION;
+
+	// Configuration keys, see above
+	static const std::string COMPRESS_CLOSED_DAYS_KEY;
+	static const std::string RETENTION_KEY_PREFIX;
+
+	// Never destroyed, so loggers can still unregister during static
+	//   destruction. Its maintenance thread is joined before then.
+	LOG_API static LogLifecycleManager& GetInstance();
+
+	// Retention for a log type (the log type folder name, e.g. "ErrorLogs").
+	//   Log types without a policy are kept forever.
+	LOG_API void SetRetentionPolicy(const std::string& log_type, const LogRetentionPolicy& policy);
+	LOG_API LogRetentionPolicy GetRetentionPolicy(const std::string& log_type) const;
+
+	LOG_API void SetCompressClosedDays(bool compress);
+	LOG_API void SetUpdateQueryIndexes(bool update);
+	// Time between passes when none is requested
+	LOG_API void SetMaintenanceInterval(std::chrono::minutes interval);
+	// How long a day folder's files must go unwritten before it counts as
+	//   closed. Also protects files other processes may still be writing.
+	LOG_API void SetQuietPeriod(std::chrono::minutes quiet_period);
+
+	// The log file a logger is writing to. Its folder is never compressed
+	//   and the file is never deleted. One file per owner.
+	LOG_API void RegisterActiveLogFile(const void* owner, const std::string& file_path);
+	LOG_API void UnregisterActiveLogFile(const void* owner);
+
+	// Apply compression and retention settings found in the
+	//   ConfigurationManager. Called by RequestMaintenance().
+	LOG_API void LoadConfiguration();
+
+	// Start the maintenance thread if necessary and run a pass soon.
+	//   Returns immediately.
+	LOG_API void RequestMaintenance();
+	// Stop the maintenance thread, abandoning a pass in progress between
+	//   files. RequestMaintenance() starts it again.
+	LOG_API void Stop();
+
+	LOG_API LogMaintenanceStatistics GetLastMaintenanceStatistics() const;
+
+	// Replace a log file with a compressed copy named file_path +
+	//   COMPRESSED_LOG_EXTENSION. The original is only removed once the
+	//   copy is complete and verified.
+	LOG_API static bool CompressLogFile(const std::string& file_path);
+	// Read a compressed log file one block (at most 1 MB) at a time, so
+	//   the whole file is never in memory. Stops early, returning false,
+	//   when handle_block(..) returns false.
+	LOG_API static bool ReadCompressedLogFile(const std::string& file_path,
+		const std::function<bool(const std::string& block)>& handle_block);
+	// Read the full contents of a compressed log file. Only for small files.
+	LOG_API static bool ReadCompressedLogFile(const std::string& file_path, std::string& contents);
+
+
+private:
+	LogLifecycleManager();
+	LogLifecycleManager(const LogLifecycleManager&) = delete;
+	const LogLifecycleManager& operator=(const LogLifecycleManager&) = delete;
+
+	mutable std::mutex managerMutex;
+	std::condition_variable wakeUpCondition;
+	std::thread maintenanceThread;
+	bool stopRequested = false;
+	bool maintenanceRequested = false;
+	// Set during static destruction, after which the thread isn't restarted
+	bool exiting = false;
+
+	// Guarded by managerMutex
+	std::map<std::string, LogRetentionPolicy> retentionPolicies;
+	std::map<const void*, std::string> activeLogFiles;
+	bool compressClosedDays = false;
+	bool updateQueryIndexes = true;
+	std::chrono::minutes maintenanceInterval{ 6 * 60 };
+	std::chrono::minutes quietPeriod{ 60 };
+	LogMaintenanceStatistics lastStatistics;
+
+	// Joins the maintenance thread when static objects are destroyed
+	struct ExitJoiner {
+		~ExitJoiner();
+	};
+
+	void Run();
+	void RunMaintenancePass();
+	bool IsStopRequested() const;
+
+};
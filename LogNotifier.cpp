@@ -0,0 +1,185 @@
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+
+#include "LogNotifier.h"
+
+using namespace std;
+
+
+struct LogObserverSlot {
+	weak_ptr<LogRowObserver> observer;          // subscribe(..)
+	shared_ptr<LogRowObserver> ownedObserver;   // addObserver(shared_ptr)
+	LogRowObserver* rawObserver = nullptr;      // addObserver(pointer)
+
+	atomic<bool> subscribed{ true };
+	atomic<int> notificationsInProgress{ 0 };
+	// Signalled when the last notification finishes after unsubscribing
+	mutex finishedMutex;
+	condition_variable notificationsFinished;
+};
+
+using LogObserverSlots = vector<shared_ptr<LogObserverSlot>>;
+
+struct LogObserverRegistry {
+	// Replaced as a whole on every change
+#ifdef __cpp_lib_atomic_shared_ptr
+	atomic<shared_ptr<const LogObserverSlots>> slots{ make_shared<const LogObserverSlots>() };
+
+	shared_ptr<const LogObserverSlots> LoadSlots() const {
+		return slots.load();
+	}
+	void StoreSlots(shared_ptr<const LogObserverSlots> new_slots) {
+		slots.store(move(new_slots));
+	}
+#else
+	// Before C++20 the atomic shared_ptr functions are the only lock-free option
+	shared_ptr<const LogObserverSlots> slots = make_shared<const LogObserverSlots>();
+
+	shared_ptr<const LogObserverSlots> LoadSlots() const {
+		return atomic_load(&slots);
+	}
+	void StoreSlots(shared_ptr<const LogObserverSlots> new_slots) {
+		atomic_store(&slots, move(new_slots));
+	}
+#endif
+	mutex changeMutex;
+};
+
+
+// Slot being notified on this thread, so an observer can unsubscribe
+// itself without waiting on its own notification
+static thread_local const LogObserverSlot* slotBeingNotified = nullptr;
+
+
+static void RemoveSlot(LogObserverRegistry& registry, const shared_ptr<LogObserverSlot>& slot) {
+	lock_guard<mutex> lock(registry.changeMutex);
+	auto slots = make_shared<LogObserverSlots>(*registry.LoadSlots());
+	slots->erase(remove(slots->begin(), slots->end(), slot), slots->end());
+	registry.StoreSlots(move(slots));
+}
+
+
+//-------------------------------------------------------------------------
+// LogSubscription
+
+LogSubscription::LogSubscription(weak_ptr<LogObserverRegistry> observer_registry, shared_ptr<LogObserverSlot> observer_slot) :
+	registry(observer_registry),
+	slot(observer_slot) {
+}
+
+LogSubscription& LogSubscription::operator=(LogSubscription&& other) noexcept {
+	if (this != &other) {
+		Unsubscribe();
+		registry = move(other.registry);
+		slot = move(other.slot);
+	}
+	return *this;
+}
+
+LogSubscription::~LogSubscription() {
+	Unsubscribe();
+}
+
+void LogSubscription::Unsubscribe() {
+	if (!slot)
+		return;
+
+	slot->subscribed = false;
+	if (auto observerRegistry = registry.lock())
+		RemoveSlot(*observerRegistry, slot);
+
+	// A notifier that already saw the slot as subscribed finishes first
+	if (slotBeingNotified != slot.get()) {
+		unique_lock<mutex> lock(slot->finishedMutex);
+		slot->notificationsFinished.wait(lock, [&] { return slot->notificationsInProgress == 0; });
+	}
+
+	slot.reset();
+	registry.reset();
+}
+
+bool LogSubscription::IsSubscribed() const {
+	return slot and slot->subscribed and !slot->observer.expired();
+}
+
+
+//-------------------------------------------------------------------------
+// LogNotifier
+
+LogNotifier::LogNotifier() :
+	registry(make_shared<LogObserverRegistry>()) {
+}
+
+LogSubscription LogNotifier::subscribe(shared_ptr<LogRowObserver> observer) {
+	if (!observer)
+		return LogSubscription();
+	auto slot = make_shared<LogObserverSlot>();
+	slot->observer = observer;
+	return LogSubscription(registry, AddSlot(slot));
+}
+
+void LogNotifier::addObserver(LogRowObserver* observer) {
+	if (!observer)
+		return;
+	auto slot = make_shared<LogObserverSlot>();
+	slot->rawObserver = observer;
+	AddSlot(slot);
+}
+
+void LogNotifier::addObserver(shared_ptr<LogRowObserver> observer) {
+	if (!observer)
+		return;
+	auto slot = make_shared<LogObserverSlot>();
+	slot->ownedObserver = observer;
+	AddSlot(slot);
+}
+
+shared_ptr<LogObserverSlot> LogNotifier::AddSlot(shared_ptr<LogObserverSlot> slot) {
+	lock_guard<mutex> lock(registry->changeMutex);
+	auto slots = make_shared<LogObserverSlots>(*registry->LoadSlots());
+	slots->push_back(slot);
+	registry->StoreSlots(move(slots));
+	return slot;
+}
+
+bool LogNotifier::hasObservers() const {
+	return !registry->LoadSlots()->empty();
+}
+
+void LogNotifier::dataPointLogged(const LogRowView& row) {
+	shared_ptr<const LogObserverSlots> slots = registry->LoadSlots();
+
+	for (const auto& slot : *slots) {
+		// Counted before checking subscribed, so Unsubscribe() either sees
+		// this notification in progress or this check sees it unsubscribed.
+		struct InProgress {
+			LogObserverSlot& slot;
+			const LogObserverSlot* previousSlot;
+			InProgress(LogObserverSlot& s) : slot(s), previousSlot(slotBeingNotified) {
+				slot.notificationsInProgress++;
+				slotBeingNotified = &slot;
+			}
+			~InProgress() {
+				slotBeingNotified = previousSlot;
+				// Unsubscribe() clears subscribed before checking the count, so
+				// one of the two sees the other
+				if (--slot.notificationsInProgress == 0 and !slot.subscribed) {
+					lock_guard<mutex> lock(slot.finishedMutex);
+					slot.notificationsFinished.notify_all();
+				}
+			}
+		} inProgress(*slot);
+
+		if (!slot->subscribed)
+			continue;
+
+		if (slot->rawObserver)
+			slot->rawObserver->onRowLogged(row);
+		else if (slot->ownedObserver)
+			slot->ownedObserver->onRowLogged(row);
+		else if (auto observer = slot->observer.lock())
+			observer->onRowLogged(row);
+	}
+}
@@ -3,34 +3,88 @@
 
 #pragma once
 
-#include <map>
 #include <memory>
-#include <set>
-#include <string>
 
 #include "LogObserver.h"
 
 
+#define LOG_API __declspec(dllexport)
+
+
+// Log Notifier - Base class for loggers that notify observers of each
+//	data point logged.
+//
+// - subscribe(..) holds only a weak reference to the observer and returns
+//	a LogSubscription token. The observer is notified until the token is
+//	destroyed (or Unsubscribe() is called on it), or until the observer
+//	itself is destroyed. Store the token next to whatever the observer
+//	refers to so both go away together.
+// - Once a token's Unsubscribe() returns, the observer is never called
+//	again, even if a row is being logged on another thread at the same time.
+// - Subscribing and unsubscribing are thread-safe. Notifying takes no lock:
+//	it iterates an immutable snapshot of the observer list, and each change
+//	publishes a new snapshot.
+// - Observers are called on whichever thread logged the row. Observers that
+//	touch the GUI must pass the data to the UI thread themselves.
+
+
+struct LogObserverSlot;
+struct LogObserverRegistry;
+
+
+// RAII handle for one observer subscription. Move-only.
+class LogSubscription {
+
+public:
+	LogSubscription() = default;
+	LogSubscription(LogSubscription&& other) noexcept = default;
+	LOG_API LogSubscription& operator=(LogSubscription&& other) noexcept;
+	LogSubscription(const LogSubscription&) = delete;
+	LogSubscription& operator=(const LogSubscription&) = delete;
+	LOG_API ~LogSubscription();
+
+	// Stop notifying the observer. Waits for a notification in progress on
+	//   another thread to finish.
+	LOG_API void Unsubscribe();
+	LOG_API bool IsSubscribed() const;
+
+
+private:
+	friend class LogNotifier;
+	LogSubscription(std::weak_ptr<LogObserverRegistry> observer_registry, std::shared_ptr<LogObserverSlot> observer_slot);
+
+	std::weak_ptr<LogObserverRegistry> registry;
+	std::shared_ptr<LogObserverSlot> slot;
+
+};
+
+
 class LogNotifier {
 //Adding Observers
 public:
-	void addObserver(LogObserver* observer) {
-		logObservers_p.insert(observer);
-	};
-	void addObserver(std::shared_ptr<LogObserver> observer) {
-		logObservers_sp.insert(observer);
-	};
+	LOG_API LogNotifier();
+
+	// Notify observer until the returned token is destroyed or the observer
+	//   is destroyed, whichever comes first.
+	[[nodiscard]] LOG_API LogSubscription subscribe(std::shared_ptr<LogRowObserver> observer);
+
+	// Notify observer for the lifetime of this notifier.
+	//   - The raw pointer version doesn't own the observer, which must outlive
+	//     this notifier. Prefer subscribe(..).
+	LOG_API void addObserver(LogRowObserver* observer);
+	LOG_API void addObserver(std::shared_ptr<LogRowObserver> observer);
 
 
 protected:
-	std::set<std::shared_ptr<LogObserver>> logObservers_sp;
-	std::set<LogObserver*> logObservers_p;
+	LOG_API bool hasObservers() const;
 	//Notifying Observers
-	void dataPointLogged(std::map<std::string, std::string> data) {
-		for (auto& observer : logObservers_p)
-			observer->onDataPointLogged(data);
-		for (auto& observer : logObservers_sp)
-			observer->onDataPointLogged(data);
-	};
+	LOG_API void dataPointLogged(const LogRowView& row);
+
+
+private:
+	// Shared with subscription tokens, which may outlive the notifier
+	std::shared_ptr<LogObserverRegistry> registry;
+
+	std::shared_ptr<LogObserverSlot> AddSlot(std::shared_ptr<LogObserverSlot> slot);
 
 };
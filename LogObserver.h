@@ -6,6 +6,8 @@
 #include <map>
 #include <string>
 
+#include "LogRowObserver.h"
+
 
 // Log Observer - Interface for classes that need to be notified when
 //	a Logger object logs a data point. (See LoggerBase::LogDataPoint(..)).
@@ -27,10 +29,19 @@
 //		{ "SetTemp-LD" : "35.0" },
 //		{ "ActualTemp-LD" : "22.3" },
 //	}
-class LogObserver {
+//
+// Adapter over LogRowObserver: the map is built once per row, and each
+//	map-based observer gets its own copy, as it always has. New observers
+//	that only need a few columns should derive from LogRowObserver directly
+//	(see LogRowObserver.h), which copies nothing.
+class LogObserver : public LogRowObserver {
 
 public:
 	virtual void onDataPointLogged(std::map<std::string, std::string> data) = 0;
 
+	void onRowLogged(const LogRowView& row) final {
+		onDataPointLogged(row.AsMap());
+	};
+
 };
 
@@ -0,0 +1,605 @@
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <set>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "LogQueryIndex.h"
+#include "LogLifecycleManager.h"
+
+using namespace std;
+
+
+const string LogQueryIndex::INDEX_FILENAME = ".query_index";
+
+static const string INDEX_FILE_VERSION = "PILOGINDEX1";
+// Beyond this, a file's words aren't listed and text searches always
+// decode it
+static const size_t MAX_WORDS_PER_FILE = 20000;
+
+
+static string_view Trim(string_view text) {
+	while (!text.empty() and (text.front() == ' ' or text.front() == '\t'))
+		text.remove_prefix(1);
+	while (!text.empty() and (text.back() == ' ' or text.back() == '\t'))
+		text.remove_suffix(1);
+	return text;
+}
+
+static bool ParseNumber(string_view text, double& value) {
+	if (text.empty())
+		return false;
+	if (text.front() == '+')
+		text.remove_prefix(1);
+	auto result = from_chars(text.data(), text.data() + text.size(), value);
+	return result.ec == errc() and result.ptr == text.data() + text.size();
+}
+
+static bool ParseInteger(string_view text, long long& value) {
+	auto result = from_chars(text.data(), text.data() + text.size(), value);
+	return result.ec == errc() and result.ptr == text.data() + text.size();
+}
+
+// Call handle_word for each lowercase word of at least two letters and
+// digits, with at least one letter. Numbers aren't words.
+template <typename WordHandler>
+static void ForEachWord(string_view text, WordHandler handle_word) {
+	string word;
+	bool hasLetter = false;
+	auto finishWord = [&]() {
+		if (word.size() >= 2 and hasLetter)
+			handle_word(string_view(word));
+		word.clear();
+		hasLetter = false;
+	};
+	for (char c : text) {
+		unsigned char character = static_cast<unsigned char>(c);
+		if (isalnum(character)) {
+			word += char(tolower(character));
+			hasLetter = hasLetter or isalpha(character);
+		}
+		else
+			finishWord();
+	}
+	finishWord();
+}
+
+static vector<string> GetQueryWords(const string& text) {
+	vector<string> words;
+	ForEachWord(text, [&](string_view word) { words.emplace_back(word); });
+	sort(words.begin(), words.end());
+	words.erase(unique(words.begin(), words.end()), words.end());
+	return words;
+}
+
+static bool EndsWith(const string& text, const string& suffix) {
+	return text.size() >= suffix.size() and text.compare(text.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+
+// A data row of a log file, with the column header it falls under.
+struct LogRow {
+	const LogDecodedChunk* chunk;
+	const LogDecodedLine* line;
+	const vector<string>* columns;
+	// Changes each time a new column header line is read
+	unsigned int headerNumber;
+	long long timestamp;
+};
+
+// Decode a log file and call handle_row for each row with a readable date
+// and time. Returns false if the file can't be read or handle_row stopped.
+static bool ForEachRow(const string& file_path, const LogFileDecoder::LineDecryptor& decrypt_line,
+	unsigned int thread_count, const function<bool(const LogRow&)>& handle_row) {
+
+	LogFileDecoder decoder(decrypt_line, thread_count);
+	vector<string> columns;
+	unsigned int headerNumber = 0;
+
+	return decoder.Decode(file_path, [&](const LogDecodedChunk& chunk) {
+		for (const LogDecodedLine& line : chunk.lines) {
+			if (line.type != LogLineType::DATA or line.fieldCount < 2)
+				continue;
+			string_view date = chunk.GetField(line, 0);
+			string_view time = chunk.GetField(line, 1);
+
+			// Header line, at the top of the file and after each rotation
+			if (date == "Date" and time == "Time") {
+				columns.clear();
+				for (size_t i = 0; i < line.fieldCount; i++)
+					columns.emplace_back(Trim(chunk.GetField(line, i)));
+				headerNumber++;
+				continue;
+			}
+
+			LogRow row{ &chunk, &line, &columns, headerNumber, LogQueryIndex::ParseTimestamp(date, time) };
+			if (row.timestamp == LLONG_MIN)
+				continue;
+			if (!handle_row(row))
+				return false;
+		}
+		return true;
+	});
+}
+
+
+LogQueryIndex::LogQueryIndex(const string& laser_directory, LogFileDecoder::LineDecryptor line_decryptor) :
+	directory(laser_directory),
+	indexFilePath((filesystem::path(laser_directory) / INDEX_FILENAME).string()),
+	decryptLine(line_decryptor) {
+}
+
+void LogQueryIndex::SetDecodeThreadCount(unsigned int thread_count) {
+	decodeThreadCount = thread_count;
+}
+
+const vector<LogFileSummary>& LogQueryIndex::GetFiles() const {
+	return files;
+}
+
+
+long long LogQueryIndex::ParseTimestamp(string_view date, string_view time) {
+	date = Trim(date);
+	time = Trim(time);
+
+	long long dateParts[3];
+	size_t dateFieldLengths[3];
+	for (int i = 0; i < 3; i++) {
+		size_t end = i < 2 ? date.find('-') : date.size();
+		if (end == string_view::npos or !ParseInteger(date.substr(0, end), dateParts[i]))
+			return LLONG_MIN;
+		dateFieldLengths[i] = end;
+		date.remove_prefix(i < 2 ? end + 1 : end);
+	}
+	long long year, month, day;
+	if (dateFieldLengths[0] == 4) {
+		year = dateParts[0]; month = dateParts[1]; day = dateParts[2];
+	}
+	else {
+		month = dateParts[0]; day = dateParts[1]; year = dateParts[2];
+	}
+	if (month < 1 or month > 12 or day < 1 or day > 31)
+		return LLONG_MIN;
+
+	long long timeParts[3] = { 0, 0, 0 };
+	long long milliseconds = 0;
+	size_t period = time.find('.');
+	if (period != string_view::npos) {
+		string_view fraction = time.substr(period + 1, 3);
+		long long value;
+		if (!fraction.empty() and ParseInteger(fraction, value)) {
+			for (size_t i = fraction.size(); i < 3; i++)
+				value *= 10;
+			milliseconds = value;
+		}
+		time = time.substr(0, period);
+	}
+	for (int i = 0; i < 3; i++) {
+		size_t end = i < 2 ? time.find(':') : time.size();
+		if (end == string_view::npos or !ParseInteger(time.substr(0, end), timeParts[i]))
+			return LLONG_MIN;
+		time.remove_prefix(i < 2 ? end + 1 : end);
+	}
+
+	// Days since 1970-01-01 of a proleptic Gregorian date
+	year -= month <= 2;
+	long long era = (year >= 0 ? year : year - 399) / 400;
+	long long yearOfEra = year - era * 400;
+	long long dayOfYear = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+	long long dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+	long long days = era * 146097 + dayOfEra - 719468;
+
+	return ((days * 24 + timeParts[0]) * 60 + timeParts[1]) * 60000 + timeParts[2] * 1000 + milliseconds;
+}
+
+
+//-------------------------------------------------------------------------
+// Building the index
+
+// Log files in [ date ]/[ log type ]/ folders of the laser folder.
+vector<LogQueryIndex::LogFileOnDisk> LogQueryIndex::ListLogFiles() const {
+	vector<LogFileOnDisk> logFiles;
+	error_code error;
+	for (const auto& dayFolder : filesystem::directory_iterator(directory, error)) {
+		if (!dayFolder.is_directory(error))
+			continue;
+		for (const auto& logTypeFolder : filesystem::directory_iterator(dayFolder.path(), error)) {
+			if (!logTypeFolder.is_directory(error))
+				continue;
+			for (const auto& entry : filesystem::directory_iterator(logTypeFolder.path(), error)) {
+				string filename = entry.path().filename().string();
+				if (!EndsWith(filename, ".log") and !EndsWith(filename, ".log" + LogLifecycleManager::COMPRESSED_LOG_EXTENSION))
+					continue;
+
+				LogFileOnDisk file;
+				file.fileBytes = entry.file_size(error);
+				if (error)
+					continue;
+				file.lastWriteTime = entry.last_write_time(error).time_since_epoch().count();
+				if (error)
+					continue;
+				file.relativePath = (dayFolder.path().filename() / logTypeFolder.path().filename() / filename).string();
+				file.logType = logTypeFolder.path().filename().string();
+				logFiles.push_back(file);
+			}
+		}
+	}
+	sort(logFiles.begin(), logFiles.end(), [](const LogFileOnDisk& a, const LogFileOnDisk& b) {
+		return a.relativePath < b.relativePath;
+	});
+	return logFiles;
+}
+
+bool LogQueryIndex::Summarize(const LogFileOnDisk& file, LogFileSummary& summary) const {
+	summary = LogFileSummary();
+	summary.relativePath = file.relativePath;
+	summary.logType = file.logType;
+	summary.fileBytes = file.fileBytes;
+	summary.lastWriteTime = file.lastWriteTime;
+
+	unordered_map<string, size_t> columnIndices;
+	vector<size_t> fieldColumns; // Summary column of each field of the current header
+	unsigned int headerNumber = 0;
+	unordered_set<string> words;
+
+	auto addWords = [&](string_view value) {
+		ForEachWord(value, [&](string_view word) {
+			if (words.size() < MAX_WORDS_PER_FILE)
+				words.emplace(word);
+			else if (words.count(string(word)) == 0)
+				summary.allWordsIndexed = false;
+		});
+	};
+
+	string filePath = (filesystem::path(directory) / file.relativePath).string();
+	bool readable = ForEachRow(filePath, decryptLine, decodeThreadCount, [&](const LogRow& row) {
+
+		summary.rowCount++;
+		summary.firstTimestamp = min(summary.firstTimestamp, row.timestamp);
+		summary.lastTimestamp = max(summary.lastTimestamp, row.timestamp);
+
+		if (row.headerNumber != headerNumber) {
+			headerNumber = row.headerNumber;
+			fieldColumns.clear();
+			for (size_t i = 0; i < row.columns->size(); i++) {
+				// Date and time are covered by the timestamps
+				const string& name = (*row.columns)[i];
+				if (i < 2) {
+					fieldColumns.push_back(SIZE_MAX);
+					continue;
+				}
+				auto column = columnIndices.find(name);
+				if (column == columnIndices.end()) {
+					column = columnIndices.emplace(name, summary.columns.size()).first;
+					summary.columns.push_back(LogColumnSummary());
+					summary.columns.back().name = name;
+				}
+				fieldColumns.push_back(column->second);
+			}
+		}
+
+		// The date and time aren't searched
+		for (size_t i = 2; i < row.line->fieldCount; i++) {
+			string_view value = Trim(row.chunk->GetField(*row.line, i));
+			if (value.empty())
+				continue;
+			double number;
+			bool isNumber = ParseNumber(value, number);
+			if (!isNumber)
+				addWords(value);
+			if (i >= fieldColumns.size())
+				continue;
+
+			LogColumnSummary& column = summary.columns[fieldColumns[i]];
+			if (!isNumber)
+				column.numeric = false;
+			else if (column.numeric) {
+				column.minValue = min(column.minValue, number);
+				column.maxValue = max(column.maxValue, number);
+			}
+		}
+		return true;
+	});
+
+	for (LogColumnSummary& column : summary.columns) {
+		if (!column.numeric or column.minValue > column.maxValue) {
+			column.minValue = numeric_limits<double>::infinity();
+			column.maxValue = -numeric_limits<double>::infinity();
+		}
+	}
+	summary.words.assign(words.begin(), words.end());
+	sort(summary.words.begin(), summary.words.end());
+	return readable;
+}
+
+LogIndexUpdateStatistics LogQueryIndex::Update(const FileFilter& skip_file) {
+	auto startTime = chrono::steady_clock::now();
+	LogIndexUpdateStatistics statistics;
+
+	map<string, const LogFileSummary*> previousSummaries;
+	for (const LogFileSummary& summary : files)
+		previousSummaries[summary.relativePath] = &summary;
+
+	vector<LogFileSummary> updatedFiles;
+	bool changed = false;
+	for (const LogFileOnDisk& file : ListLogFiles()) {
+		auto previous = previousSummaries.find(file.relativePath);
+		bool unchanged = previous != previousSummaries.end()
+			and previous->second->fileBytes == file.fileBytes
+			and previous->second->lastWriteTime == file.lastWriteTime;
+		if (unchanged) {
+			updatedFiles.push_back(*previous->second);
+			statistics.filesUnchanged++;
+			continue;
+		}
+
+		if (skip_file and skip_file((filesystem::path(directory) / file.relativePath).string())) {
+			if (previous != previousSummaries.end())
+				updatedFiles.push_back(*previous->second);
+			continue;
+		}
+
+		// Compression keeps the last write time, and the rows
+		if (EndsWith(file.relativePath, LogLifecycleManager::COMPRESSED_LOG_EXTENSION)) {
+			string originalPath = file.relativePath.substr(0, file.relativePath.size() - LogLifecycleManager::COMPRESSED_LOG_EXTENSION.size());
+			auto original = previousSummaries.find(originalPath);
+			if (original != previousSummaries.end() and original->second->lastWriteTime == file.lastWriteTime) {
+				updatedFiles.push_back(*original->second);
+				updatedFiles.back().relativePath = file.relativePath;
+				updatedFiles.back().fileBytes = file.fileBytes;
+				statistics.filesUnchanged++;
+				changed = true;
+				continue;
+			}
+		}
+
+		LogFileSummary summary;
+		if (!Summarize(file, summary))
+			continue;
+		updatedFiles.push_back(move(summary));
+		statistics.filesDecoded++;
+		statistics.bytesDecoded += file.fileBytes;
+		changed = true;
+	}
+
+	set<string> keptPaths;
+	for (const LogFileSummary& summary : updatedFiles)
+		keptPaths.insert(summary.relativePath);
+	for (const LogFileSummary& summary : files) {
+		if (keptPaths.count(summary.relativePath) == 0)
+			statistics.filesRemoved++;
+	}
+	changed = changed or statistics.filesRemoved > 0;
+
+	files = move(updatedFiles);
+	if (changed)
+		Save();
+
+	statistics.durationSeconds = chrono::duration<double>(chrono::steady_clock::now() - startTime).count();
+	return statistics;
+}
+
+
+//-------------------------------------------------------------------------
+// Index file
+//
+// One tab-separated record per line:
+//	F, relative path, log type, bytes, last write time, first timestamp,
+//		last timestamp, row count, all words indexed
+//	C, name, numeric, min, max (one per column of the F above)
+//	W, word, word, ... (words of the F above)
+
+static void AppendNumber(string& line, double value) {
+	char digits[32];
+	auto result = to_chars(digits, digits + sizeof(digits), value);
+	line.append(digits, result.ptr);
+}
+
+bool LogQueryIndex::Save() const {
+	error_code error;
+	if (files.empty()) {
+		filesystem::remove(indexFilePath, error);
+		return true;
+	}
+
+	// Replace the index in one step, so readers never see half of it
+	string tempFilePath = indexFilePath + ".tmp";
+	{
+		ofstream indexFile(tempFilePath, ios::binary | ios::trunc);
+		if (!indexFile.is_open())
+			return false;
+		indexFile << INDEX_FILE_VERSION << '\n';
+
+		string line;
+		for (const LogFileSummary& summary : files) {
+			indexFile << "F\t" << summary.relativePath << '\t' << summary.logType << '\t' << summary.fileBytes << '\t'
+				<< summary.lastWriteTime << '\t' << summary.firstTimestamp << '\t' << summary.lastTimestamp << '\t'
+				<< summary.rowCount << '\t' << (summary.allWordsIndexed ? 1 : 0) << '\n';
+			for (const LogColumnSummary& column : summary.columns) {
+				line = "C\t" + column.name + "\t" + (column.numeric ? "1" : "0") + "\t";
+				AppendNumber(line, column.minValue);
+				line += '\t';
+				AppendNumber(line, column.maxValue);
+				indexFile << line << '\n';
+			}
+			line = "W";
+			for (const string& word : summary.words)
+				line += "\t" + word;
+			indexFile << line << '\n';
+		}
+		if (!indexFile.good())
+			return false;
+	}
+
+	filesystem::rename(tempFilePath, indexFilePath, error);
+	if (error) {
+		filesystem::remove(tempFilePath, error);
+		return false;
+	}
+	return true;
+}
+
+bool LogQueryIndex::Load() {
+	files.clear();
+	ifstream indexFile(indexFilePath, ios::binary);
+	string line;
+	if (!getline(indexFile, line) or line != INDEX_FILE_VERSION)
+		return false;
+
+	vector<string_view> fields;
+	while (getline(indexFile, line)) {
+		fields.clear();
+		string_view rest = line;
+		while (true) {
+			size_t tab = rest.find('\t');
+			fields.push_back(rest.substr(0, tab));
+			if (tab == string_view::npos)
+				break;
+			rest.remove_prefix(tab + 1);
+		}
+
+		if (fields[0] == "F" and fields.size() == 9) {
+			LogFileSummary summary;
+			long long number;
+			summary.relativePath = string(fields[1]);
+			summary.logType = string(fields[2]);
+			bool valid = ParseInteger(fields[3], number);
+			summary.fileBytes = static_cast<unsigned long long>(number);
+			valid = valid and ParseInteger(fields[4], summary.lastWriteTime)
+				and ParseInteger(fields[5], summary.firstTimestamp)
+				and ParseInteger(fields[6], summary.lastTimestamp)
+				and ParseInteger(fields[7], number);
+			summary.rowCount = static_cast<unsigned long long>(number);
+			summary.allWordsIndexed = fields[8] == "1";
+			if (!valid) {
+				files.clear();
+				return false;
+			}
+			files.push_back(move(summary));
+		}
+		else if (fields[0] == "C" and fields.size() == 5 and !files.empty()) {
+			LogColumnSummary column;
+			column.name = string(fields[1]);
+			column.numeric = fields[2] == "1";
+			ParseNumber(fields[3], column.minValue);
+			ParseNumber(fields[4], column.maxValue);
+			files.back().columns.push_back(column);
+		}
+		else if (fields[0] == "W" and !files.empty()) {
+			for (size_t i = 1; i < fields.size(); i++)
+				files.back().words.emplace_back(fields[i]);
+		}
+	}
+	return true;
+}
+
+
+//-------------------------------------------------------------------------
+// Queries
+
+bool LogQueryIndex::MayMatch(const LogFileSummary& summary, const LogRowQuery& query, const vector<string>& query_words) const {
+	if (!query.logType.empty() and summary.logType != query.logType)
+		return false;
+	if (summary.rowCount == 0 or summary.lastTimestamp < query.fromTimestamp or summary.firstTimestamp > query.toTimestamp)
+		return false;
+
+	if (!query.column.empty()) {
+		auto column = find_if(summary.columns.begin(), summary.columns.end(),
+			[&](const LogColumnSummary& c) { return c.name == query.column; });
+		if (column == summary.columns.end())
+			return false;
+		if (column->numeric and (column->maxValue < query.minValue or column->minValue > query.maxValue))
+			return false;
+	}
+
+	if (summary.allWordsIndexed) {
+		for (const string& word : query_words) {
+			if (!binary_search(summary.words.begin(), summary.words.end(), word))
+				return false;
+		}
+	}
+	return true;
+}
+
+vector<string> LogQueryIndex::FindCandidateFiles(const LogRowQuery& query) const {
+	vector<string> queryWords = GetQueryWords(query.text);
+
+	map<string, const LogFileSummary*> summaries;
+	for (const LogFileSummary& summary : files)
+		summaries[summary.relativePath] = &summary;
+
+	vector<string> candidates;
+	for (const LogFileOnDisk& file : ListLogFiles()) {
+		if (!query.logType.empty() and file.logType != query.logType)
+			continue;
+
+		auto summary = summaries.find(file.relativePath);
+		bool indexed = summary != summaries.end()
+			and summary->second->fileBytes == file.fileBytes
+			and summary->second->lastWriteTime == file.lastWriteTime;
+		if (indexed and !MayMatch(*summary->second, query, queryWords))
+			continue;
+		candidates.push_back((filesystem::path(directory) / file.relativePath).string());
+	}
+	return candidates;
+}
+
+bool LogQueryIndex::FindRows(const LogRowQuery& query, const RowHandler& handle_row) const {
+	vector<string> queryWords = GetQueryWords(query.text);
+	vector<string> rowWords;
+	bool stopped = false;
+
+	for (const string& filePath : FindCandidateFiles(query)) {
+		size_t valueField = 0;
+		unsigned int headerNumber = 0;
+
+		ForEachRow(filePath, decryptLine, decodeThreadCount, [&](const LogRow& row) {
+			if (row.timestamp < query.fromTimestamp or row.timestamp > query.toTimestamp)
+				return true;
+
+			if (!query.column.empty()) {
+				if (row.headerNumber != headerNumber) {
+					headerNumber = row.headerNumber;
+					auto column = find(row.columns->begin(), row.columns->end(), query.column);
+					valueField = column == row.columns->end() ? 0 : size_t(column - row.columns->begin());
+				}
+				double value;
+				if (valueField < 2 or valueField >= row.line->fieldCount
+					or !ParseNumber(Trim(row.chunk->GetField(*row.line, valueField)), value)
+					or value < query.minValue or value > query.maxValue)
+					return true;
+			}
+
+			if (!queryWords.empty()) {
+				rowWords.clear();
+				for (size_t i = 2; i < row.line->fieldCount; i++) {
+					string_view value = Trim(row.chunk->GetField(*row.line, i));
+					double number;
+					if (!ParseNumber(value, number))
+						ForEachWord(value, [&](string_view word) { rowWords.emplace_back(word); });
+				}
+				for (const string& word : queryWords) {
+					if (find(rowWords.begin(), rowWords.end(), word) == rowWords.end())
+						return true;
+				}
+			}
+
+			LogQueryMatch match{ &filePath, row.chunk, row.line, row.columns, row.timestamp };
+			if (!handle_row(match)) {
+				stopped = true;
+				return false;
+			}
+			return true;
+		});
+
+		if (stopped)
+			return false;
+	}
+	return true;
+}
@@ -0,0 +1,169 @@
+/**
+* Log Query Index - Summary of every background log file of a laser, for
+*	finding rows across weeks of log sessions without decrypting files
+*	that can't contain them.
+*
+* - One index per laser folder (GetLogBaseDirectory()/<SN>_<Model>), kept
+*	in the INDEX_FILENAME file in that folder.
+* - For each log file, the index holds its log type, the time of its
+*	first and last row, its columns, the minimum and maximum of each
+*	numeric column, and the words in its text columns (e.g. error
+*	messages).
+* - Update() is incremental: only files that are new or changed since the
+*	last update are decoded. A compressed file reuses the summary of the
+*	.log file it was made from. LogLifecycleManager updates the indexes
+*	after each maintenance pass, skipping files still being written.
+* - FindRows(..) only decodes files whose summary may hold a matching row,
+*	plus files not indexed yet.
+*
+* Example usage (on a background thread, e.g. in a log viewer):
+*
+*	LogQueryIndex index(GetLogBaseDirectory() + "SN123_Model\\");
+*	index.Load();
+*	LogRowQuery query;
+*	query.logType = "LaserStateLogs";
+*	query.column = "ActualTemp-SHG";
+*	query.minValue = 40.5;
+*	query.fromTimestamp = LogQueryIndex::ParseTimestamp("10-01-2026", "00:00:00");
+*	query.toTimestamp = LogQueryIndex::ParseTimestamp("10-15-2026", "23:59:59");
+*	index.FindRows(query, [&](const LogQueryMatch& match) {
+*		AddRow(match.chunk->GetLine(*match.line));
+*		return !cancelRequested;
+*	});
+*
+* @file LogQueryIndex.h
+* @created October 2026
+* @version 1.0
+*/
+#pragma once
+
+#include <climits>
+#include <functional>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "LogFileDecoder.h"
+
+
+#define LOG_API __declspec(dllexport)
+
+
+struct LogColumnSummary {
+	std::string name;
+	// Every non-empty value is a number
+	bool numeric = true;
+	double minValue = std::numeric_limits<double>::infinity();
+	double maxValue = -std::numeric_limits<double>::infinity();
+};
+
+struct LogFileSummary {
+	// Relative to the laser folder, e.g. "10-17-2026\ErrorLogs\ErrorLogs_..._1.log"
+	std::string relativePath;
+	std::string logType;
+	unsigned long long fileBytes = 0;
+	long long lastWriteTime = 0;
+	// Timestamps of the first and last row (see ParseTimestamp(..))
+	long long firstTimestamp = LLONG_MAX;
+	long long lastTimestamp = LLONG_MIN;
+	unsigned long long rowCount = 0;
+	std::vector<LogColumnSummary> columns;
+	// Lowercase words of the text columns, sorted
+	std::vector<std::string> words;
+	// False if the file had too many distinct words to list
+	bool allWordsIndexed = true;
+};
+
+struct LogIndexUpdateStatistics {
+	unsigned long long filesDecoded = 0;
+	unsigned long long bytesDecoded = 0;
+	unsigned long long filesUnchanged = 0;
+	unsigned long long filesRemoved = 0;
+	double durationSeconds = 0;
+};
+
+// Rows matching every condition set
+struct LogRowQuery {
+	// Log type folder name, e.g. "ErrorLogs". "" for any.
+	std::string logType;
+	long long fromTimestamp = LLONG_MIN;
+	long long toTimestamp = LLONG_MAX;
+	// Column whose value must be in [minValue, maxValue]. "" for none.
+	std::string column;
+	double minValue = -std::numeric_limits<double>::infinity();
+	double maxValue = std::numeric_limits<double>::infinity();
+	// Words the row's text columns must all contain (whole words,
+	//   ignoring case). "" for none.
+	std::string text;
+};
+
+struct LogQueryMatch {
+	const std::string* filePath;
+	const LogDecodedChunk* chunk;
+	const LogDecodedLine* line;
+	// Column names of the line's fields (empty for rows before any header)
+	const std::vector<std::string>* columns;
+	long long timestamp;
+};
+
+
+class LogQueryIndex {
+
+public:
+	static const std::string INDEX_FILENAME;
+
+	// Called for each matching row, in file order. Return false to stop.
+	using RowHandler = std::function<bool(const LogQueryMatch& match)>;
+	// Return true to leave a file as it is in the index for now (e.g. it's
+	//   still being written)
+	using FileFilter = std::function<bool(const std::string& file_path)>;
+
+	// line_decryptor is needed for files with per-line encryption (see
+	//   LogFileDecoder).
+	LOG_API LogQueryIndex(const std::string& laser_directory, LogFileDecoder::LineDecryptor line_decryptor = nullptr);
+
+	// Threads used to decode a file. 0 uses one thread per core.
+	LOG_API void SetDecodeThreadCount(unsigned int thread_count);
+
+	// Read the index file. Returns false if there is none (or it can't be
+	//   read), leaving the index empty.
+	LOG_API bool Load();
+	// Bring the index up to date with the files on disk and save it.
+	LOG_API LogIndexUpdateStatistics Update(const FileFilter& skip_file = nullptr);
+
+	// Indexed files that may hold rows matching the query, plus files on
+	//   disk that aren't indexed (or changed since). Full paths.
+	LOG_API std::vector<std::string> FindCandidateFiles(const LogRowQuery& query) const;
+	// Decode the candidate files and hand over each matching row. Returns
+	//   false if the handler stopped the search.
+	LOG_API bool FindRows(const LogRowQuery& query, const RowHandler& handle_row) const;
+
+	LOG_API const std::vector<LogFileSummary>& GetFiles() const;
+
+	// Milliseconds since 1970 of a log row's date and time, as written
+	//   (local time). Dates may be MM-DD-YYYY or YYYY-MM-DD. Returns
+	//   LLONG_MIN if they can't be read.
+	LOG_API static long long ParseTimestamp(std::string_view date, std::string_view time);
+
+
+private:
+	std::string directory;
+	std::string indexFilePath;
+	LogFileDecoder::LineDecryptor decryptLine;
+	unsigned int decodeThreadCount = 0;
+	std::vector<LogFileSummary> files;
+
+	struct LogFileOnDisk {
+		std::string relativePath;
+		std::string logType;
+		unsigned long long fileBytes;
+		long long lastWriteTime;
+	};
+	std::vector<LogFileOnDisk> ListLogFiles() const;
+
+	bool Summarize(const LogFileOnDisk& file, LogFileSummary& summary) const;
+	bool Save() const;
+	bool MayMatch(const LogFileSummary& summary, const LogRowQuery& query, const std::vector<std::string>& query_words) const;
+
+};
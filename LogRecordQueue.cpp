@@ -0,0 +1,72 @@
+#include "LogRecordQueue.h"
+
+using namespace std;
+
+
+LogRecordQueue::LogRecordQueue(size_t capacity, size_t reserved_message_bytes) {
+	size_t slotCount = 2;
+	while (slotCount < capacity)
+		slotCount *= 2;
+	mask = slotCount - 1;
+
+	slots = make_unique<Slot[]>(slotCount);
+	for (size_t i = 0; i < slotCount; i++) {
+		slots[i].sequence.store(i, memory_order_relaxed);
+		slots[i].record.message.reserve(reserved_message_bytes);
+	}
+}
+
+
+// A slot is free for the push at position p when its sequence is p, and
+// holds the record for the pop at position p when its sequence is p + 1.
+bool LogRecordQueue::TryPush(string_view message, unsigned long thread_id, long long monotonic_microseconds) {
+	size_t position = enqueuePosition.load(memory_order_relaxed);
+	Slot* slot;
+	while (true) {
+		slot = &slots[position & mask];
+		size_t sequence = slot->sequence.load(memory_order_acquire);
+		auto difference = intptr_t(sequence) - intptr_t(position);
+		if (difference == 0) {
+			if (enqueuePosition.compare_exchange_weak(position, position + 1, memory_order_relaxed))
+				break;
+		}
+		else if (difference < 0)
+			return false; // Full
+		else
+			position = enqueuePosition.load(memory_order_relaxed);
+	}
+
+	slot->record.message.assign(message.data(), message.size());
+	slot->record.threadID = thread_id;
+	slot->record.monotonicMicroseconds = monotonic_microseconds;
+	slot->sequence.store(position + 1, memory_order_release);
+	return true;
+}
+
+bool LogRecordQueue::TryPop(LogRecord& record) {
+	size_t position = dequeuePosition.load(memory_order_relaxed);
+	Slot* slot;
+	while (true) {
+		slot = &slots[position & mask];
+		size_t sequence = slot->sequence.load(memory_order_acquire);
+		auto difference = intptr_t(sequence) - intptr_t(position + 1);
+		if (difference == 0) {
+			if (dequeuePosition.compare_exchange_weak(position, position + 1, memory_order_relaxed))
+				break;
+		}
+		else if (difference < 0)
+			return false; // Empty
+		else
+			position = dequeuePosition.load(memory_order_relaxed);
+	}
+
+	record.message.swap(slot->record.message);
+	record.threadID = slot->record.threadID;
+	record.monotonicMicroseconds = slot->record.monotonicMicroseconds;
+	slot->sequence.store(position + mask + 1, memory_order_release);
+	return true;
+}
+
+bool LogRecordQueue::IsEmpty() const {
+	return enqueuePosition.load(memory_order_acquire) == dequeuePosition.load(memory_order_acquire);
+}
@@ -0,0 +1,64 @@
+/**
+* Log Record Queue - Bounded lock-free queue of log records, for handing
+*	records from any thread to a single writer thread.
+*
+* - Any number of threads may push and pop at once (bounded MPMC ring with
+*	a sequence number per slot), without locks.
+* - Slots keep their message buffers. Popping swaps the message out, so
+*	once buffers have grown to the usual message size, neither pushing nor
+*	popping allocates.
+* - When the queue is full TryPush(..) fails and the caller decides what
+*	to do.
+*
+* Used by UserActionJournal for its encoded events.
+*
+* @file LogRecordQueue.h
+* @created October 2026
+* @version 1.0
+*/
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <string_view>
+
+
+struct LogRecord {
+	std::string message;
+	// Thread that pushed the record
+	unsigned long threadID = 0;
+	// Steady-clock time of the record, so records from different threads
+	// can be ordered even if the wall clock jumps
+	long long monotonicMicroseconds = 0;
+};
+
+
+class LogRecordQueue {
+
+public:
+	// capacity is rounded up to a power of two.
+	LogRecordQueue(size_t capacity, size_t reserved_message_bytes = 256);
+
+	bool TryPush(std::string_view message, unsigned long thread_id, long long monotonic_microseconds);
+	// record.message's buffer is handed to the slot in exchange.
+	bool TryPop(LogRecord& record);
+
+	// Only a hint while other threads are pushing or popping.
+	bool IsEmpty() const;
+
+
+private:
+	struct Slot {
+		std::atomic<size_t> sequence;
+		LogRecord record;
+	};
+
+	std::unique_ptr<Slot[]> slots;
+	size_t mask;
+
+	// On separate cache lines so producers and the consumer don't contend
+	alignas(64) std::atomic<size_t> enqueuePosition{ 0 };
+	alignas(64) std::atomic<size_t> dequeuePosition{ 0 };
+
+};
@@ -0,0 +1,118 @@
+/**
+* Log Row Observer - Interface for classes that need to be notified when
+*	a Logger object logs a data point, without copying the row.
+*
+* - Observers receive a LogRowView by const reference. The view points at
+*	the logger's own row buffer, so it is only valid for the duration of
+*	the onRowLogged(..) call. Copy out any values that must be kept.
+* - The view carries a handle to the logger's column schema. The schema
+*	only changes when columns are added, so observers can look up the
+*	column indexes they care about once and reuse them as long as
+*	GetSchema() returns the same pointer.
+* - Values are the text written to the log file. Use GetNumber(..) to read
+*	a numeric column without allocating.
+*
+* Observers that want the older map of <column name> : <value> pairs can
+*	derive from LogObserver instead (see LogObserver.h).
+*
+* @file LogRowObserver.h
+* @created October 2026
+* @version 1.0
+*/
+#pragma once
+
+#include <charconv>
+#include <map>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+
+// Column names of one logger, shared by every row it logs.
+class LogColumnSchema {
+
+public:
+	static const size_t NOT_FOUND = size_t(-1);
+
+	LogColumnSchema(std::vector<std::string> column_names) : columnNames(std::move(column_names)) {
+		for (size_t col = 0; col < columnNames.size(); col++)
+			columnIndexes.emplace(columnNames[col], col);
+	};
+
+	size_t GetColumnCount() const {
+		return columnNames.size();
+	};
+	const std::string& GetColumnName(size_t col) const {
+		return columnNames[col];
+	};
+	// Index of the column, or NOT_FOUND.
+	size_t IndexOf(const std::string& column_name) const {
+		auto it = columnIndexes.find(column_name);
+		return it != columnIndexes.end() ? it->second : NOT_FOUND;
+	};
+
+private:
+	std::vector<std::string> columnNames;
+	std::unordered_map<std::string, size_t> columnIndexes;
+
+};
+
+
+// One logged row: a schema handle plus one value per column.
+class LogRowView {
+
+public:
+	LogRowView(const std::shared_ptr<const LogColumnSchema>& column_schema,
+		const std::string_view* row_values) :
+			schema(column_schema), values(row_values) {};
+
+	const std::shared_ptr<const LogColumnSchema>& GetSchema() const {
+		return schema;
+	};
+	size_t size() const {
+		return schema->GetColumnCount();
+	};
+
+	std::string_view GetValue(size_t col) const {
+		return values[col];
+	};
+	// Returns an empty value if there is no such column.
+	std::string_view GetValue(const std::string& column_name) const {
+		size_t col = schema->IndexOf(column_name);
+		return col != LogColumnSchema::NOT_FOUND ? values[col] : std::string_view();
+	};
+
+	// Parse the value as a number. Returns false if it isn't one.
+	bool GetNumber(size_t col, double& number) const {
+		std::string_view value = values[col];
+		auto result = std::from_chars(value.data(), value.data() + value.size(), number);
+		return result.ec == std::errc() and result.ptr == value.data() + value.size();
+	};
+
+	// The row as a map of <column name> : <value> pairs. Built on first use
+	//   and shared by every map-based observer notified with this row.
+	const std::map<std::string, std::string>& AsMap() const {
+		if (map.empty()) {
+			for (size_t col = 0; col < size(); col++)
+				map.emplace(schema->GetColumnName(col), std::string(values[col]));
+		}
+		return map;
+	};
+
+private:
+	const std::shared_ptr<const LogColumnSchema>& schema;
+	const std::string_view* values;
+	mutable std::map<std::string, std::string> map;
+
+};
+
+
+class LogRowObserver {
+
+public:
+	virtual ~LogRowObserver() = default;
+	virtual void onRowLogged(const LogRowView& row) = 0;
+
+};
@@ -0,0 +1,120 @@
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <random>
+
+#include "LogSessionIndex.h"
+#include "../CommonFunctions.h"
+
+using namespace std;
+
+
+const string LogSessionIndex::SESSION_INDEX_FILENAME = ".session_index";
+
+// Give up after this many IDs in a row turn out to be taken
+const int MAX_CLAIM_ATTEMPTS = 1000;
+
+
+LogSessionIndex::LogSessionIndex(const string& log_directory, FileNameForID file_name_for_id) :
+	directory(log_directory),
+	indexFilePath(log_directory + "\\" + SESSION_INDEX_FILENAME),
+	fileNameForID(file_name_for_id) {
+}
+
+
+int LogSessionIndex::PeekNextLogID() const {
+	int id = ReadHighestID() + 1;
+	error_code error;
+	while (filesystem::exists(GetLogFilePath(id), error))
+		id++;
+	return id;
+}
+
+int LogSessionIndex::ClaimNextLogID() {
+	int id = ReadHighestID() + 1;
+
+	for (int attempt = 0; attempt < MAX_CLAIM_ATTEMPTS; attempt++, id++) {
+		// "x": fail if the file exists, atomically with creating it
+		FILE* file = fopen(GetLogFilePath(id).c_str(), "wx");
+		if (file) {
+			fclose(file);
+			WriteHighestID(id);
+			return id;
+		}
+
+		// Anything but "already taken" won't be fixed by trying the next ID
+		error_code error;
+		if (!filesystem::exists(GetLogFilePath(id), error))
+			return 0;
+	}
+	return 0;
+}
+
+
+string LogSessionIndex::GetLogFilePath(int id) const {
+	return directory + "\\" + fileNameForID(id);
+}
+
+int LogSessionIndex::ReadHighestID() const {
+	ifstream indexFile(indexFilePath);
+	int highestID;
+	if (indexFile >> highestID and highestID >= 0)
+		return highestID;
+
+	// No sidecar yet (or unreadable): build it from the files present
+	highestID = ScanHighestLogID(directory);
+	WriteHighestID(highestID);
+	return highestID;
+}
+
+// Replace the sidecar atomically so other processes never read a
+// partially written ID.
+void LogSessionIndex::WriteHighestID(int id) const {
+	// No digits right before a '.', so a leftover temp file can't be
+	// mistaken for a log ID by ScanHighestLogID(..)
+	random_device randomDevice;
+	string tempFilePath = indexFilePath + ".tmp_" + to_string(randomDevice());
+	{
+		ofstream tempFile(tempFilePath, ios::trunc);
+		if (!(tempFile << id))
+			return;
+	}
+	error_code error;
+	filesystem::rename(tempFilePath, indexFilePath, error);
+	if (error)
+		filesystem::remove(tempFilePath, error);
+}
+
+
+int LogSessionIndex::ScanHighestLogID(const string& log_directory) {
+	// Find the highest number appearing at the end of all filenames in the
+	// log files folder.
+	// Example:
+	//		".._1.log"
+	//		".._2.log"
+	//	--> Returns 2
+
+	int maxID = 0;
+
+	error_code error;
+	for (const auto& file : filesystem::directory_iterator(log_directory, error)) {
+		string filename = file.path().filename().string();
+
+		string extractedGuiSessionNumber = "";
+		bool reachedExtensionEnd = false;
+		for (string::reverse_iterator it = filename.rbegin(); it != filename.rend(); ++it) {
+			if (reachedExtensionEnd and (*it == '_' or !isdigit(*it)))
+				break;
+			if (reachedExtensionEnd and isdigit(*it))
+				extractedGuiSessionNumber = *it + extractedGuiSessionNumber;
+			if (*it == '.')
+				reachedExtensionEnd = true;
+		}
+
+		if (extractedGuiSessionNumber.length() > 0) {
+			if (ToIntSafely(extractedGuiSessionNumber) > maxID)
+				maxID = ToIntSafely(extractedGuiSessionNumber);
+		}
+	}
+	return maxID;
+}
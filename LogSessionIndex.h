@@ -0,0 +1,62 @@
+/**
+* Log Session Index - Hands out log file IDs for a background log directory
+*	without scanning the directory each time.
+*
+* - The highest ID handed out so far is kept in a small sidecar file
+*	(SESSION_INDEX_FILENAME) in the log directory. The first time a
+*	directory without the sidecar is used, the directory is scanned once
+*	to build it.
+* - An ID is claimed by creating its log file with an exclusive create,
+*	which fails if the file already exists. Two GUI/API processes starting
+*	at once therefore never get the same ID: the loser just tries the next
+*	one. The sidecar is only a starting point, so a stale or missing
+*	sidecar can't cause a collision either.
+*
+* Used by BackgroundLogger.
+*
+* @file LogSessionIndex.h
+* @created October 2026
+* @version 1.0
+*/
+#pragma once
+
+#include <functional>
+#include <string>
+
+
+#define LOG_API __declspec(dllexport)
+
+
+class LogSessionIndex {
+
+public:
+	static const std::string SESSION_INDEX_FILENAME;
+
+	// Builds the file name for a log ID, e.g. 3 -> "ErrorLogs_..._3.log".
+	using FileNameForID = std::function<std::string(int id)>;
+
+	LOG_API LogSessionIndex(const std::string& log_directory, FileNameForID file_name_for_id);
+
+	// The ID the next ClaimNextLogID() will most likely return. Doesn't
+	//   create anything - for suggesting a file name to the user.
+	LOG_API int PeekNextLogID() const;
+
+	// Create an empty log file for the next free ID and return the ID.
+	//   Returns 0 if no file could be created.
+	LOG_API int ClaimNextLogID();
+
+	// Highest ID at the end of any file name in the directory, found by
+	//   scanning every file. Only used to build a missing sidecar.
+	LOG_API static int ScanHighestLogID(const std::string& log_directory);
+
+
+private:
+	std::string directory;
+	std::string indexFilePath;
+	FileNameForID fileNameForID;
+
+	std::string GetLogFilePath(int id) const;
+	int ReadHighestID() const;
+	void WriteHighestID(int id) const;
+
+};
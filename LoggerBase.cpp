@@ -1,4 +1,13 @@
+#include <charconv>
+#include <cstdio>
+#include <ctime>
 #include <filesystem>
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
 
 #include "LoggerBase.h"
 #include "../CommonFunctions.h"
@@ -19,11 +28,70 @@ string GetMetadataLinePrefix() {
 
 
 
+static tm ToLocalTime(time_t seconds) {
+	tm localTime;
+#ifdef _WIN32
+	localtime_s(&localTime, &seconds);
+#else
+	localtime_r(&seconds, &localTime);
+#endif
+	return localTime;
+}
+
+static chrono::system_clock::time_point GetNextLocalMidnight() {
+	tm localTime = ToLocalTime(time(nullptr));
+	localTime.tm_mday += 1; // mktime(..) carries into the next month/year
+	localTime.tm_hour = 0;
+	localTime.tm_min = 0;
+	localTime.tm_sec = 0;
+	localTime.tm_isdst = -1;
+	return chrono::system_clock::from_time_t(mktime(&localTime));
+}
+
+
+// The ofstream doesn't expose its OS handle, so SYNC_EACH_LINE opens a second
+// handle to the same file. Syncing it writes out all of the file's cached data,
+// whichever handle wrote it.
+static intptr_t OpenSyncHandle(const string& file_path) {
+#ifdef _WIN32
+	HANDLE file = CreateFileA(file_path.c_str(), GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+		nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	return file == INVALID_HANDLE_VALUE ? -1 : intptr_t(file);
+#else
+	return open(file_path.c_str(), O_WRONLY);
+#endif
+}
+
+static bool SyncHandleToDisk(intptr_t handle) {
+#ifdef _WIN32
+	return FlushFileBuffers(HANDLE(handle)) != 0;
+#else
+	return fsync(int(handle)) == 0;
+#endif
+}
+
+static void CloseSyncHandle(intptr_t handle) {
+#ifdef _WIN32
+	CloseHandle(HANDLE(handle));
+#else
+	close(int(handle));
+#endif
+}
+
+
+
 LoggerBase::LoggerBase() {
 	AddColumn("Date");
 	AddColumn("Time");
 }
 
+LoggerBase::~LoggerBase() {
+	// Stop the writer and timer threads first - they write through this object
+	StopFlushTimer();
+	DisableAsyncOutput();
+	CloseLogFile();
+}
+
 
 //-------------------------------------------------------------------------
 // Default log output file
@@ -31,6 +99,9 @@ LoggerBase::LoggerBase() {
 void LoggerBase::SetFilePath(const string& file_path) {
 	setFilePathSuccessful = false;
 
+	// Finish writing to the previous target before switching
+	CloseLogFile();
+
 	if (PathIsValid(file_path))
 		filePath = file_path;
 	else {
@@ -38,10 +109,9 @@ void LoggerBase::SetFilePath(const string& file_path) {
 		return;
 	}
 
-	logFile.open(filePath, ios::app);
-	if (logFile.is_open()) {
+	if (OpenLogFile()) {
 		setFilePathSuccessful = true;
-		logFile.close();
+		ResetRotationState();
 	}
 	else {
 		e << "Failed to open log file: \"" << file_path << "\"." << endl;
@@ -56,6 +126,93 @@ bool LoggerBase::SetFilePathSuccessful() const {
 	return setFilePathSuccessful;
 }
 
+void LoggerBase::SetDurability(LogDurability log_durability) {
+	{
+		lock_guard<recursive_mutex> lock(fileMutex);
+		durability = log_durability;
+	}
+	if (durability == LogDurability::BUFFERED)
+		StartFlushTimer();
+	else {
+		StopFlushTimer();
+		Flush();
+	}
+}
+
+void LoggerBase::SetFlushThresholds(size_t bytes, unsigned int milliseconds) {
+	{
+		lock_guard<recursive_mutex> lock(fileMutex);
+		flushThresholdBytes = bytes;
+		flushThresholdTime = chrono::milliseconds(milliseconds);
+	}
+	// The timer thread waits for the old time threshold
+	if (durability == LogDurability::BUFFERED) {
+		StopFlushTimer();
+		StartFlushTimer();
+	}
+}
+
+void LoggerBase::Flush() {
+	if (columnarWriter)
+		columnarWriter->Flush();
+	if (asyncWriter)
+		asyncWriter->Drain();
+	else
+		WriteBufferToFile();
+}
+
+void LoggerBase::SetOutputFormat(LogOutputFormat output_format) {
+	CloseLogFile();
+	outputFormat = output_format;
+}
+
+LogOutputFormat LoggerBase::GetOutputFormat() const {
+	return outputFormat;
+}
+
+void LoggerBase::EnableAsyncOutput(size_t queue_capacity, LogBackPressure back_pressure) {
+	DisableAsyncOutput();
+	asyncWriter = make_unique<AsyncLogWriter>(
+		[this](const string& line, bool encrypt) {
+			if (encrypt)
+				WriteEncryptedLineToFile(line);
+			else
+				WriteLineToFile(line);
+		},
+		[this]() { WriteBufferToFile(); },
+		queue_capacity,
+		back_pressure);
+}
+
+void LoggerBase::DisableAsyncOutput() {
+	if (!asyncWriter)
+		return;
+	asyncWriter->Drain();
+	droppedLinesFromPreviousWriters += asyncWriter->GetDroppedLineCount();
+	asyncWriter.reset();
+}
+
+bool LoggerBase::IsAsyncOutputEnabled() const {
+	return asyncWriter != nullptr;
+}
+
+unsigned long long LoggerBase::GetDroppedLineCount() const {
+	unsigned long long dropped = droppedLinesFromPreviousWriters;
+	if (asyncWriter)
+		dropped += asyncWriter->GetDroppedLineCount();
+	return dropped;
+}
+
+void LoggerBase::SetRotationPolicy(const LogRotationPolicy& rotation_policy) {
+	rotationPolicy = rotation_policy;
+	ResetRotationState();
+}
+
+void LoggerBase::SetCompactionPolicy(const LogCompactionPolicy& compaction_policy) {
+	compactionPolicy = compaction_policy;
+	compactor.reset();
+}
+
 
 //-------------------------------------------------------------------------
 // Saving log contents to new file at any time
@@ -72,22 +229,37 @@ bool LoggerBase::SaveSuccessful() const {
 	return saveToFileSuccessful;
 }
 
+void LoggerBase::SetMemoryLogPolicy(MemoryLogPolicy policy, size_t max_bytes_in_memory) {
+	logDataInMemory.SetPolicy(policy, max_bytes_in_memory);
+}
+
 
 //-------------------------------------------------------------------------
 // Logging structured data
 
 void LoggerBase::AddColumn(const string& columnName) {
 	columnNames.push_back(columnName);
+	observerSchema.reset();
+	compactor.reset();
 }
 
 void LoggerBase::WriteHeaderLine() {
-	string header = "";
-	for (string columnName : columnNames)
-		header += columnName + ",";
+	string header = BuildHeaderLine();
+	headerLineWritten = true;
 
-	// Remove trailing comma
-	if (header.length() > 1)
-		header[header.length() - 1] = ' ';
+	// Columnar files store column names in their own schema block
+	if (outputFormat == LogOutputFormat::COLUMNAR_BINARY) {
+		logDataInMemory.push_back(header);
+		return;
+	}
+
+	// The compactor writes its own header (aggregated rows have other columns)
+	if (LogRowCompactor* rowCompactor = GetCompactor()) {
+		logDataInMemory.push_back(header);
+		rowCompactor->StartFile(true, compactedLines);
+		OutputCompactedLines();
+		return;
+	}
 
 	if (encryptData)
 		CommitLineEncrypt(header);
@@ -95,30 +267,32 @@ void LoggerBase::WriteHeaderLine() {
 		CommitLine(header);
 }
 
-void LoggerBase::LogDataPoint(const vector<string>& values) {
+void LoggerBase::LogDataPointAt(chrono::system_clock::time_point acquisition_time, const vector<string>& values) {
+	if (!BeginRowAt(values.size(), acquisition_time))
+		return;
+	for (const string& value : values)
+		AppendRowValue(string_view(value));
+	EndRow();
+}
 
-	if (values.size() != columnNames.size() - 2) {
-		e << "ERROR - Logging function: Number of values to write does not match number of columns." << endl;
+void LoggerBase::LogDataPoint(const vector<string>& values) {
+	if (!BeginRow(values.size()))
 		return;
-	}
+	for (const string& value : values)
+		AppendRowValue(string_view(value));
+	EndRow();
 
-	string date = GenerateDateString();
-	string time = GenerateTimeString();
 
-	// Notify all subscribed observers with data to be logged
-	map<string, string> dataForObservers;
-	dataForObservers["Date"] = date;
-	dataForObservers["Time"] = time;
-	for (size_t col = 2; col < columnNames.size(); col++) {
-		dataForObservers[columnNames[col]] = values[col - 2];
-	}
-	dataPointLogged(dataForObservers);
 
+	/*if (values.size() != columnNames.size() - 2) {
+		e << "ERROR - Logging function: Number of values to write does not match number of columns." << endl;
+		return;
+	}
 
 	string line = "";
 
-	line += date + ",";
-	line += time + ",";
+	line += GenerateDateString() + ",";
+	line += GenerateTimeString() + ",";
 
 	for (string value : values)
 		line += value + ",";
@@ -129,30 +303,151 @@ void LoggerBase::LogDataPoint(const vector<string>& values) {
 	if (encryptData)
 		CommitLineEncrypt(line);
 	else
-		CommitLine(line);
+		CommitLine(line);*/
+}
 
+// Start a new row in rowBuffer with the date and time values.
+bool LoggerBase::BeginRow(size_t value_count) {
+	if (value_count != columnNames.size() - 2) {
+		e << "ERROR - Logging function: Number of values to write does not match number of columns." << endl;
+		return false;
+	}
 
+	rowTime = chrono::system_clock::now();
+	rowBuffer.clear();
+	rowValueStarts.clear();
+	AppendRowValue(GenerateDateString());
+	AppendRowValue(GenerateTimeString());
+	return true;
+}
 
-	/*if (values.size() != columnNames.size() - 2) {
+// Start a new row with the date and time of acquisition_time.
+bool LoggerBase::BeginRowAt(size_t value_count, chrono::system_clock::time_point acquisition_time) {
+	if (value_count != columnNames.size() - 2) {
 		e << "ERROR - Logging function: Number of values to write does not match number of columns." << endl;
-		return;
+		return false;
 	}
 
-	string line = "";
+	time_t seconds = chrono::system_clock::to_time_t(acquisition_time);
+	auto milliseconds = chrono::duration_cast<chrono::milliseconds>(acquisition_time.time_since_epoch()).count() % 1000;
+	if (milliseconds < 0)
+		milliseconds += 1000;
+	tm localTime = ToLocalTime(seconds);
+
+	char date[16], time[16];
+	strftime(date, sizeof(date), "%m-%d-%Y", &localTime);
+	size_t timeLength = strftime(time, sizeof(time), "%H:%M:%S", &localTime);
+	snprintf(time + timeLength, sizeof(time) - timeLength, ".%03d", int(milliseconds));
+
+	rowTime = acquisition_time;
+	rowBuffer.clear();
+	rowValueStarts.clear();
+	AppendRowValue(string_view(date));
+	AppendRowValue(string_view(time));
+	return true;
+}
 
-	line += GenerateDateString() + ",";
-	line += GenerateTimeString() + ",";
+template <typename Number>
+static void AppendNumber(string& buffer, Number value) {
+	char digits[32];
+	auto result = to_chars(digits, digits + sizeof(digits), value);
+	buffer.append(digits, result.ptr);
+	buffer += ',';
+}
 
-	for (string value : values)
-		line += value + ",";
+template <typename Real>
+static void AppendReal(string& buffer, Real value) {
+	// Large enough for any double in fixed notation
+	char digits[400];
+	auto result = to_chars(digits, digits + sizeof(digits), value, chars_format::fixed, 6);
+	buffer.append(digits, result.ptr);
+	buffer += ',';
+}
 
-	if (line.length() > 0)
-		line[line.length() - 1] = ' ';
+void LoggerBase::AppendRowValue(int value) {
+	rowValueStarts.push_back(rowBuffer.size());
+	AppendNumber(rowBuffer, value);
+}
 
-	if (encryptData)
-		CommitLineEncrypt(line);
-	else
-		CommitLine(line);*/
+void LoggerBase::AppendRowValue(unsigned int value) {
+	rowValueStarts.push_back(rowBuffer.size());
+	AppendNumber(rowBuffer, value);
+}
+
+void LoggerBase::AppendRowValue(long value) {
+	rowValueStarts.push_back(rowBuffer.size());
+	AppendNumber(rowBuffer, value);
+}
+
+void LoggerBase::AppendRowValue(unsigned long value) {
+	rowValueStarts.push_back(rowBuffer.size());
+	AppendNumber(rowBuffer, value);
+}
+
+void LoggerBase::AppendRowValue(long long value) {
+	rowValueStarts.push_back(rowBuffer.size());
+	AppendNumber(rowBuffer, value);
+}
+
+void LoggerBase::AppendRowValue(unsigned long long value) {
+	rowValueStarts.push_back(rowBuffer.size());
+	AppendNumber(rowBuffer, value);
+}
+
+void LoggerBase::AppendRowValue(float value) {
+	rowValueStarts.push_back(rowBuffer.size());
+	AppendReal(rowBuffer, value);
+}
+
+void LoggerBase::AppendRowValue(double value) {
+	rowValueStarts.push_back(rowBuffer.size());
+	AppendReal(rowBuffer, value);
+}
+
+void LoggerBase::AppendRowValue(string_view value) {
+	rowValueStarts.push_back(rowBuffer.size());
+	rowBuffer.append(value);
+	rowBuffer += ',';
+}
+
+// Commit the row in rowBuffer: notify observers, keep it in memory, and
+// write it to the default log file.
+void LoggerBase::EndRow() {
+	// Replace trailing comma
+	rowBuffer.back() = ' ';
+
+	// Every value is followed by one separator character
+	rowValues.clear();
+	for (size_t col = 0; col < rowValueStarts.size(); col++) {
+		size_t end = col + 1 < rowValueStarts.size() ? rowValueStarts[col + 1] : rowBuffer.size();
+		rowValues.push_back(string_view(rowBuffer).substr(rowValueStarts[col], end - 1 - rowValueStarts[col]));
+	}
+
+	// Notify all subscribed observers with data to be logged
+	if (hasObservers()) {
+		if (!observerSchema)
+			observerSchema = make_shared<const LogColumnSchema>(columnNames);
+		dataPointLogged(LogRowView(observerSchema, rowValues.data()));
+	}
+
+	logDataInMemory.push_back(rowBuffer);
+
+	if (outputFormat == LogOutputFormat::COLUMNAR_BINARY) {
+		if (ColumnarLogWriter* writer = GetColumnarWriter())
+			writer->AppendRow(rowValues);
+		return;
+	}
+
+	if (LogRowCompactor* rowCompactor = GetCompactor()) {
+		// Rotate before compacting, so a new file starts with a full row.
+		// (A file may end up one row over the size limit.)
+		RotateIfNecessary(0);
+		rowCompactor->AddRow(rowTime, rowValues, compactedLines);
+		OutputCompactedLines();
+		return;
+	}
+
+	OutputLine(rowBuffer, encryptData);
 }
 
 
@@ -161,47 +456,307 @@ void LoggerBase::LogDataPoint(const vector<string>& values) {
 
 void LoggerBase::CommitLine(string line) {
 	logDataInMemory.push_back(line);
-	WriteLineToFile(line);
+	OutputLine(line, false);
 }
 
 void LoggerBase::CommitLineEncrypt(string line) {
 	logDataInMemory.push_back(line);
-	WriteEncryptedLineToFile(line);
+	OutputLine(line, true);
 }
 
 void LoggerBase::CommitLineMetadata(string line) {
 	line = GetMetadataLinePrefix() + line;
 	logDataInMemory.push_back(line);
-	WriteLineToFile(line);
+	OutputLine(line, false);
 }
 
 
 //-------------------------------------------------------------------------
 // Other
 
-string LoggerBase::AppendNewLineIfNecessary(string line) {
-	if (line == "")
-		return "";
-	if (line.back() != '\n')
-		line = line + '\n';
-	return line;
+bool LoggerBase::OpenLogFile() {
+	lock_guard<recursive_mutex> lock(fileMutex);
+	if (logFile.is_open())
+		return true;
+	if (filePath == "")
+		return false;
+
+	// The columnar writer opens the file itself once columns are known.
+	// Here, just make sure the file can be created.
+	if (outputFormat == LogOutputFormat::COLUMNAR_BINARY) {
+		ofstream testFile(filePath, ios::app | ios::binary);
+		return testFile.is_open();
+	}
+	logFile.clear();
+	logFile.open(filePath, ios::app);
+	return logFile.is_open();
 }
 
-void LoggerBase::WriteLineToFile(string line) {
-	logFile.open(filePath, ios::app);
-	if (logFile.is_open()) {
-		line = AppendNewLineIfNecessary(line);
-		logFile << line;
+void LoggerBase::CloseLogFile() {
+	// Let the writer thread catch up first, so it's done with the file
+	Flush();
+
+	// Write the aggregate of the window being collected
+	if (compactor and IsLogFileOpen()) {
+		compactor->FinishFile(compactedLines);
+		OutputCompactedLines();
+		Flush();
+	}
+	columnarWriter.reset();
+
+	lock_guard<recursive_mutex> lock(fileMutex);
+	if (syncHandle != -1) {
+		CloseSyncHandle(syncHandle);
+		syncHandle = -1;
+	}
+	if (logFile.is_open())
 		logFile.close();
+}
+
+bool LoggerBase::IsLogFileOpen() {
+	lock_guard<recursive_mutex> lock(fileMutex);
+	return logFile.is_open();
+}
+
+// Get the columnar writer for the current file path, starting a new schema
+// block if columns were added since it was created.
+ColumnarLogWriter* LoggerBase::GetColumnarWriter() {
+	if (filePath == "")
+		return nullptr;
+	if (!columnarWriter or columnarWriter->GetColumnCount() != columnNames.size()) {
+		columnarWriter.reset(); // Finish the previous schema's blocks first
+		columnarWriter = make_unique<ColumnarLogWriter>(filePath, columnNames, encryptData);
+	}
+	return columnarWriter->IsOpen() ? columnarWriter.get() : nullptr;
+}
+
+void LoggerBase::OutputLine(const string& line, bool encrypt) {
+	RotateIfNecessary(line.size() + 1);
+	WriteOutputLine(line, encrypt);
+}
+
+// Send a committed line to the default log file, either directly or through
+// the async writer thread if enabled.
+void LoggerBase::WriteOutputLine(const string& line, bool encrypt) {
+	if (outputFormat == LogOutputFormat::COLUMNAR_BINARY) {
+		if (ColumnarLogWriter* writer = GetColumnarWriter())
+			writer->AppendTextLine(line);
+	}
+	else if (asyncWriter)
+		asyncWriter->Push(line, encrypt);
+	else if (encrypt)
+		WriteEncryptedLineToFile(line);
+	else
+		WriteLineToFile(line);
+}
+
+string LoggerBase::BuildHeaderLine() const {
+	string header = "";
+	for (const string& columnName : columnNames)
+		header += columnName + ",";
+
+	// Remove trailing comma
+	if (header.length() > 1)
+		header[header.length() - 1] = ' ';
+	return header;
+}
+
+// The compactor for the current columns, or nullptr if rows aren't compacted.
+LogRowCompactor* LoggerBase::GetCompactor() {
+	bool compacting = compactionPolicy.changeOnly or compactionPolicy.aggregateWindow.count() > 0;
+	if (!compacting or outputFormat != LogOutputFormat::CSV)
+		return nullptr;
+	if (!compactor)
+		compactor = make_unique<LogRowCompactor>(compactionPolicy, columnNames);
+	return compactor.get();
+}
+
+// Write the lines the compactor produced. Rotation is checked before
+// compacting a row instead.
+void LoggerBase::OutputCompactedLines() {
+	for (const LogCompactedLine& line : compactedLines) {
+		if (line.metadata) {
+			string text = GetMetadataLinePrefix() + line.text;
+			bytesInCurrentFile += text.size() + 1;
+			WriteOutputLine(text, false);
+			continue;
+		}
+		bytesInCurrentFile += line.text.size() + 1;
+		WriteOutputLine(line.text, encryptData);
+	}
+	compactedLines.clear();
+}
+
+// Start counting size and age for the file just opened.
+void LoggerBase::ResetRotationState() {
+	error_code error;
+	uintmax_t existingBytes = filesystem::file_size(filePath, error);
+	bytesInCurrentFile = error ? 0 : size_t(existingBytes);
+	currentFileOpenedTime = chrono::steady_clock::now();
+	nextDayStartTime = GetNextLocalMidnight();
+}
+
+// Switch to the next file before writing incoming_bytes if the rotation
+// policy says the current file is full.
+void LoggerBase::RotateIfNecessary(size_t incoming_bytes) {
+	bool rotationEnabled = rotationPolicy.maxFileBytes > 0
+		or rotationPolicy.maxFileAge.count() > 0
+		or rotationPolicy.newFileEachDay;
+
+	if (rotationEnabled and !rotating and filePath != "") {
+		bool tooBig = rotationPolicy.maxFileBytes > 0 and bytesInCurrentFile > 0
+			and bytesInCurrentFile + incoming_bytes > rotationPolicy.maxFileBytes;
+		bool tooOld = rotationPolicy.maxFileAge.count() > 0
+			and chrono::steady_clock::now() - currentFileOpenedTime >= rotationPolicy.maxFileAge;
+		bool newDay = rotationPolicy.newFileEachDay
+			and chrono::system_clock::now() >= nextDayStartTime;
+
+		if (tooBig or tooOld or newDay) {
+			// The header lines written below come back through here
+			rotating = true;
+			string previousFilePath = filePath;
+			string nextFilePath = GetRotationFilePath();
+			if (nextFilePath == "" or nextFilePath == previousFilePath)
+				ResetRotationState();
+			else {
+				SetFilePath(nextFilePath);
+				if (setFilePathSuccessful)
+					WriteRotationHeader(previousFilePath);
+				else {
+					// Keep the old file, and don't retry until it's full again
+					SetFilePath(previousFilePath);
+					ResetRotationState();
+				}
+			}
+			rotating = false;
+		}
+	}
+
+	bytesInCurrentFile += incoming_bytes;
+}
+
+void LoggerBase::WriteRotationHeader(const string& previous_file_path) {
+	OutputLine(GetMetadataLinePrefix() + "Continued from " + filesystem::path(previous_file_path).filename().string(), false);
+	if (LogRowCompactor* rowCompactor = GetCompactor()) {
+		rowCompactor->StartFile(headerLineWritten, compactedLines);
+		OutputCompactedLines();
+	}
+	else if (headerLineWritten and outputFormat == LogOutputFormat::CSV)
+		OutputLine(BuildHeaderLine(), encryptData);
+}
+
+void LoggerBase::WriteLineToFile(const string& line) {
+	lock_guard<recursive_mutex> lock(fileMutex);
+
+	if (line == "")
+		return;
+	bool appendNewLine = line.back() != '\n';
+
+	if (durability == LogDurability::BUFFERED) {
+		if (writeBuffer.empty())
+			lastFlushTime = chrono::steady_clock::now();
+		writeBuffer += line;
+		if (appendNewLine)
+			writeBuffer += '\n';
+
+		bool bufferFull = writeBuffer.size() >= flushThresholdBytes;
+		bool intervalElapsed = chrono::steady_clock::now() - lastFlushTime >= flushThresholdTime;
+		if (bufferFull or intervalElapsed)
+			WriteBufferToFile();
+		return;
+	}
+
+	if (OpenLogFile()) {
+		logFile << line;
+		if (appendNewLine)
+			logFile << '\n';
+		logFile.flush();
+		if (durability == LogDurability::SYNC_EACH_LINE)
+			SyncLogFile();
 	}
 	else {
 		e << "Failed to commit line \"" << line << "\" to file \"" << filePath << "\"" << endl;
 	}
 }
 
-void LoggerBase::WriteEncryptedLineToFile(string line) {
-	line = GetEncryptedLinePrefix() + cryptofy(line);
-	WriteLineToFile(line);
+void LoggerBase::WriteBufferToFile() {
+	lock_guard<recursive_mutex> lock(fileMutex);
+
+	if (writeBuffer.empty())
+		return;
+
+	// Swap out the buffer first - a failure below is reported through the
+	// error logger, which may itself be this logger.
+	string pending;
+	pending.swap(writeBuffer);
+	lastFlushTime = chrono::steady_clock::now();
+
+	if (OpenLogFile()) {
+		logFile << pending;
+		logFile.flush();
+		if (durability == LogDurability::SYNC_EACH_LINE)
+			SyncLogFile();
+	}
+	else {
+		e << "Failed to write " << pending.size() << " buffered bytes to file \"" << filePath << "\"" << endl;
+	}
+
+	// Hand the capacity back so the next batch doesn't reallocate
+	pending.clear();
+	if (writeBuffer.empty())
+		writeBuffer.swap(pending);
+}
+
+void LoggerBase::WriteEncryptedLineToFile(const string& line) {
+	WriteLineToFile(GetEncryptedLinePrefix() + cryptofy(line));
+}
+
+// Force what was written so far onto the disk (SYNC_EACH_LINE).
+void LoggerBase::SyncLogFile() {
+	if (syncHandle == -1)
+		syncHandle = OpenSyncHandle(filePath);
+	if (syncHandle == -1 or !SyncHandleToDisk(syncHandle))
+		e << "Failed to sync log file \"" << filePath << "\" to disk" << endl;
+}
+
+void LoggerBase::StartFlushTimer() {
+	if (flushTimerThread.joinable())
+		return;
+	flushTimerStopRequested = false;
+	flushTimerThread = thread(&LoggerBase::RunFlushTimer, this);
+}
+
+void LoggerBase::StopFlushTimer() {
+	if (!flushTimerThread.joinable())
+		return;
+	{
+		lock_guard<mutex> lock(flushTimerMutex);
+		flushTimerStopRequested = true;
+	}
+	flushTimerWake.notify_all();
+	flushTimerThread.join();
+}
+
+// Checks twice per time threshold, so lines wait at most 1.5 times as long
+void LoggerBase::RunFlushTimer() {
+	chrono::milliseconds interval;
+	{
+		lock_guard<recursive_mutex> lock(fileMutex);
+		interval = flushThresholdTime / 2;
+		if (interval < chrono::milliseconds(1))
+			interval = chrono::milliseconds(1);
+	}
+
+	unique_lock<mutex> timerLock(flushTimerMutex);
+	while (!flushTimerWake.wait_for(timerLock, interval, [this] { return flushTimerStopRequested; })) {
+		timerLock.unlock();
+		{
+			lock_guard<recursive_mutex> lock(fileMutex);
+			if (!writeBuffer.empty() and chrono::steady_clock::now() - lastFlushTime >= flushThresholdTime)
+				WriteBufferToFile();
+		}
+		timerLock.lock();
+	}
 }
 
 void LoggerBase::SaveMemoryLogToFileHelper(const string& file_path, bool encrypt) {
@@ -213,12 +768,13 @@ void LoggerBase::SaveMemoryLogToFileHelper(const string& file_path, bool encrypt
 
 	ofstream file(file_path);
 	if (file.is_open()) {
-		for (string line : logDataInMemory) {
-			if (encrypt)
-				line = GetEncryptedLinePrefix() + cryptofy(line);
-			line = AppendNewLineIfNecessary(line);
-			file << line;
+		if (encrypt) {
+			logDataInMemory.ForEachLine([&](const string& line) {
+				file << GetEncryptedLinePrefix() + cryptofy(line) << '\n';
+			});
 		}
+		else
+			logDataInMemory.WriteTo(file);
 		file.close();
 		saveToFileSuccessful = true;
 	}
@@ -232,9 +788,15 @@ void LoggerBase::SetEncryptOption(const bool encrypt_data) {
 }
 
 void LoggerBase::Reset() {
+	CloseLogFile();
 	filePath = "";
 	logDataInMemory.clear();
 	columnNames.clear();
+	observerSchema.reset();
+	headerLineWritten = false;
+	rotationPolicy = LogRotationPolicy();
+	compactionPolicy = LogCompactionPolicy();
+	compactor.reset();
 	setFilePathSuccessful = false;
 	saveToFileSuccessful = false;
 }
@@ -4,7 +4,8 @@
 * - Call AddColumn("COLUMN_NAME") to designate a comma-separated data attribute for each row.
 * - The first two rows (date and time) are already automatically added for you.
 * - After creating the logger and adding columns, pass in a vector of strings to LogDataPoint()
-*		to commit a line of values to the log.
+*		to commit a line of values to the log. Or pass the values directly, e.g.
+*		LogDataPoint(pec, prf), to skip converting them to strings first.
 * - Can create many individual logger objects, each with its own columns.
 *
 * - Two methods of outputting data to log files:
@@ -14,6 +15,33 @@
 *			data to another file besides the initial target, call SaveMemoryLogToFile(). 
 *			This saves the data stored in memory to a new log file in addition to the
 *			initial target file.
+*		- By default, everything logged stays in memory. For long sessions, call
+*			SetMemoryLogPolicy(..) to keep only the most recent lines in memory or
+*			to spill older lines to a temporary file (see MemoryLog.h).
+*
+* - The target log file is kept open for the lifetime of the logger (or until
+*	SetFilePath(..)/Reset() is called). By default every line is handed to the
+*	OS as soon as it is committed. Call SetDurability(LogDurability::BUFFERED)
+*	to batch lines in memory and flush them once a byte or time threshold is
+*	reached, or SetDurability(LogDurability::SYNC_EACH_LINE) to force every
+*	line onto the disk.
+*
+* - Call EnableAsyncOutput(..) to hand encryption and file output to a
+*	dedicated writer thread (see AsyncLogWriter.h). Lines are still added to
+*	memory and observers are still notified on the calling thread.
+*
+* - Call SetOutputFormat(LogOutputFormat::COLUMNAR_BINARY) to write the target
+*	log file in the compressed columnar format (see ColumnarLogFile.h) instead
+*	of comma-separated text. The memory log stays comma-separated text.
+*
+* - Call SetRotationPolicy(..) to close the default log file and continue in
+*	a new one once it grows too big, gets too old, or the date changes.
+*	Derived classes choose the new file by overriding GetRotationFilePath().
+*
+* - Call SetCompactionPolicy(..) to leave unchanged values out of CSV log
+*	files, and/or to write per-window aggregates instead of raw rows after
+*	a while (see LogCompaction.h). Observers and the memory log still get
+*	every row as logged.
 *
 *
 * Example usage:
@@ -42,11 +70,22 @@
 */
 #pragma once
 
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
 #include <fstream>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <string_view>
+#include <thread>
 #include <vector>
 
+#include "AsyncLogWriter.h"
+#include "ColumnarLogFile.h"
+#include "LogCompaction.h"
 #include "LogNotifier.h"
+#include "MemoryLog.h"
 
 
 #define LOG_API __declspec(dllexport)
@@ -63,12 +102,54 @@ LOG_API std::string GetEncryptedLinePrefix();
 LOG_API std::string GetMetadataLinePrefix();
 
 
+// Controls when lines committed to the default log file reach the disk.
+//   - FLUSH_EACH_LINE_TO_OS: Every line is handed to the OS as soon as it is
+//     committed, so a GUI crash never loses a committed line. A power loss
+//     can still lose lines the OS hasn't written to the disk yet. (Default)
+//   - SYNC_EACH_LINE: Every line is also forced onto the disk
+//     (FlushFileBuffers/fsync) before the commit returns, so committed lines
+//     survive a power loss. Much slower - each line waits for the disk.
+//   - BUFFERED: Lines are collected in memory and written out together once
+//     the byte threshold is exceeded, or once the time threshold has elapsed
+//     since the last flush (checked by a timer thread, so a quiet logger still
+//     flushes). Pending lines are also flushed by Flush(), SetFilePath(..),
+//     Reset(), and destruction.
+enum class LogDurability {
+	FLUSH_EACH_LINE_TO_OS,
+	SYNC_EACH_LINE,
+	BUFFERED,
+};
+
+// File format of the default log file.
+//   - CSV: Comma-separated text lines, optionally encrypted line by line.
+//   - COLUMNAR_BINARY: Compressed (and optionally encrypted) blocks of typed
+//     columns. Blocks are written when full or on Flush(), regardless of
+//     the durability setting.
+enum class LogOutputFormat {
+	CSV,
+	COLUMNAR_BINARY,
+};
+
+// When the default log file is closed and logging continues in a new file.
+//   Each trigger is off when zero/false. (See LoggerBase::SetRotationPolicy(..))
+struct LogRotationPolicy {
+	// Roughly how many bytes may be committed to one file. Encrypted lines
+	// are counted before encryption.
+	size_t maxFileBytes = 0;
+	// How long one file may be written to
+	std::chrono::minutes maxFileAge{ 0 };
+	// Start a new file at local midnight
+	bool newFileEachDay = false;
+};
+
+
 class LoggerBase : public LogNotifier {
 
 public:
 	// Create a logger to log to the target file path.
 	//LOG_API LoggerBase(const std::string& file_path);
 	LOG_API LoggerBase();
+	LOG_API virtual ~LoggerBase();
 
 
 	//-------------------------------------------------------------------------
@@ -83,6 +164,41 @@ public:
 	//   the target file path.
 	LOG_API bool SetFilePathSuccessful() const;
 
+	// Choose when committed lines are written to the default log file.
+	LOG_API void SetDurability(LogDurability log_durability);
+	// Byte and time thresholds that trigger a flush in BUFFERED mode.
+	LOG_API void SetFlushThresholds(size_t bytes, unsigned int milliseconds);
+	// Write any buffered lines to the default log file immediately.
+	//   - In async mode, blocks until the writer thread has caught up.
+	LOG_API void Flush();
+
+	// Choose the file format of the default log file.
+	//   - Should be set before SetFilePath(..) and before logging anything.
+	LOG_API void SetOutputFormat(LogOutputFormat output_format);
+	LOG_API LogOutputFormat GetOutputFormat() const;
+
+	// Write lines to the default log file from a dedicated writer thread.
+	//   - queue_capacity is the number of lines that may wait to be written.
+	//   - back_pressure decides what happens when the queue is full.
+	LOG_API void EnableAsyncOutput(size_t queue_capacity = 4096,
+		LogBackPressure back_pressure = LogBackPressure::BLOCK);
+	// Write any queued lines, stop the writer thread, and go back to
+	//   writing on the calling thread.
+	LOG_API void DisableAsyncOutput();
+	LOG_API bool IsAsyncOutputEnabled() const;
+	// Number of lines discarded by the DROP_OLDEST/DROP_NEWEST policies.
+	LOG_API unsigned long long GetDroppedLineCount() const;
+
+	// Start a new default log file when the policy says the current one is
+	//   full. Checked whenever a line is committed. Does nothing unless a
+	//   derived class overrides GetRotationFilePath().
+	LOG_API void SetRotationPolicy(const LogRotationPolicy& rotation_policy);
+
+	// Compact the rows written to CSV log files.
+	//   - Should be set after adding columns and before logging anything.
+	//   - Has no effect on columnar log files.
+	LOG_API void SetCompactionPolicy(const LogCompactionPolicy& compaction_policy);
+
 
 	//-------------------------------------------------------------------------
 	// Saving log contents to new file at any time
@@ -94,6 +210,11 @@ public:
 	// Returns true if SaveMemoryLogToFile succeeded
 	LOG_API bool SaveSuccessful() const;
 
+	// Cap how much of the log is kept in memory for SaveMemoryLogToFile(..).
+	//   - RING keeps only the most recent lines.
+	//   - SPILL_TO_DISK moves older lines to a temporary file so nothing is lost.
+	LOG_API void SetMemoryLogPolicy(MemoryLogPolicy policy, size_t max_bytes_in_memory);
+
 
 	//-------------------------------------------------------------------------
 	// Logging structured data
@@ -117,6 +238,26 @@ public:
 	//   - A date and a time value are added automatically to the beginning
 	LOG_API void LogDataPoint(const std::vector<std::string>& values);
 
+	// Log a row of typed values that correspond to the columns added previously.
+	//   - Same rules as above, but values can be passed directly as numbers
+	//     or strings, e.g. LogDataPoint(power, temperature, "ON").
+	//   - Floating-point values are written with 6 decimal places, the same
+	//     as std::to_string(..).
+	//   - Values are formatted straight into a reused row buffer, so once the
+	//     buffers have grown, logging a row doesn't allocate (unless observers
+	//     are subscribed or the line is encrypted).
+	template <typename... Values>
+	void LogDataPoint(const Values&... values);
+
+	// Same as LogDataPoint(..), but the date and time values are taken from
+	//   acquisition_time (when the data was sampled) instead of the time the
+	//   row is written. The time is written with milliseconds, e.g.
+	//   "11:58:37.250", so rows sampled faster than once per second can be
+	//   told apart. (See SamplingScheduler.h)
+	LOG_API void LogDataPointAt(std::chrono::system_clock::time_point acquisition_time, const std::vector<std::string>& values);
+	template <typename... Values>
+	void LogDataPointAt(std::chrono::system_clock::time_point acquisition_time, const Values&... values);
+
 
 	//-------------------------------------------------------------------------
 	// Logging custom data
@@ -130,32 +271,137 @@ public:
 	// It will not get encrypted and will have a special prefix added.
 	LOG_API void CommitLineMetadata(std::string line);
 
-	// Reset all data for this logger.
+	// Reset all data for this logger, including the rotation and compaction
+	//   policies.
 	LOG_API void Reset();
 
 
 protected:
 	std::string filePath;
 	std::ofstream logFile;
-	std::vector<std::string> logDataInMemory;
+	MemoryLog logDataInMemory;
 	std::vector<std::string> columnNames;
 	bool setFilePathSuccessful = false;
 	bool saveToFileSuccessful = false;
 	bool encryptData = false;
 
-	std::vector<std::shared_ptr<LogObserver>> logObservers;
+	// Guards logFile and the buffers below - the async writer thread and the
+	// flush timer thread write through them too. Recursive, because a failed
+	// write is reported through the error logger, which may be this logger.
+	std::recursive_mutex fileMutex;
+	LogDurability durability = LogDurability::FLUSH_EACH_LINE_TO_OS;
+	size_t flushThresholdBytes = 64 * 1024;
+	std::chrono::milliseconds flushThresholdTime{ 1000 };
+	std::chrono::steady_clock::time_point lastFlushTime;
+	std::string writeBuffer;
+	// Native handle of the log file for SYNC_EACH_LINE, or -1
+	std::intptr_t syncHandle = -1;
+
+	LogOutputFormat outputFormat = LogOutputFormat::CSV;
+	std::unique_ptr<ColumnarLogWriter> columnarWriter;
+
+	std::unique_ptr<AsyncLogWriter> asyncWriter;
+	unsigned long long droppedLinesFromPreviousWriters = 0;
 
 	// If encrypt_data is set to true, each line logged via
 	// WriteHeaderLine() or LogDataPoint(..) will be encrypted.
 	LOG_API void SetEncryptOption(const bool encrypt_data);
 
+	// Open the default log file for appending if it isn't already open.
+	bool OpenLogFile();
+	// Flush any buffered lines and close the default log file.
+	void CloseLogFile();
+	bool IsLogFileOpen();
+
+	// Path of the file to continue in when the rotation policy says the
+	//   current file is full. Returning "" keeps the current file.
+	virtual std::string GetRotationFilePath() { return ""; }
+	// Write the first lines of a file started by rotation. By default, a
+	//   metadata line naming the previous file and the column header line
+	//   (if WriteHeaderLine() was called).
+	virtual void WriteRotationHeader(const std::string& previous_file_path);
+
+	// Write a committed line to the default log file only (not to memory,
+	//   not to observers).
+	void OutputLine(const std::string& line, bool encrypt);
+	// Same as OutputLine(..), but without checking the rotation policy.
+	void WriteOutputLine(const std::string& line, bool encrypt);
+
 
 private:
-	std::string AppendNewLineIfNecessary(std::string line);
-	void WriteLineToFile(std::string line);
-	void WriteEncryptedLineToFile(std::string line);
+	// Row being built by LogDataPoint(..): "date,time,value,value " plus the
+	// offset where each value starts.
+	std::string rowBuffer;
+	std::vector<size_t> rowValueStarts;
+	std::vector<std::string_view> rowValues;
+	// Column names handed to observers. Rebuilt when columns change.
+	std::shared_ptr<const LogColumnSchema> observerSchema;
+	bool headerLineWritten = false;
+
+	LogRotationPolicy rotationPolicy;
+	size_t bytesInCurrentFile = 0;
+	std::chrono::steady_clock::time_point currentFileOpenedTime;
+	std::chrono::system_clock::time_point nextDayStartTime;
+	bool rotating = false;
+
+	// Flushes BUFFERED lines once the time threshold has elapsed
+	std::thread flushTimerThread;
+	std::mutex flushTimerMutex;
+	std::condition_variable flushTimerWake;
+	bool flushTimerStopRequested = false;
+
+	LogCompactionPolicy compactionPolicy;
+	// Created when first needed, and again when columns change
+	std::unique_ptr<LogRowCompactor> compactor;
+	std::vector<LogCompactedLine> compactedLines;
+	// Acquisition time of the row being built
+	std::chrono::system_clock::time_point rowTime;
+
+	LOG_API bool BeginRow(size_t value_count);
+	LOG_API bool BeginRowAt(size_t value_count, std::chrono::system_clock::time_point acquisition_time);
+	LOG_API void AppendRowValue(int value);
+	LOG_API void AppendRowValue(unsigned int value);
+	LOG_API void AppendRowValue(long value);
+	LOG_API void AppendRowValue(unsigned long value);
+	LOG_API void AppendRowValue(long long value);
+	LOG_API void AppendRowValue(unsigned long long value);
+	LOG_API void AppendRowValue(float value);
+	LOG_API void AppendRowValue(double value);
+	LOG_API void AppendRowValue(std::string_view value);
+	LOG_API void EndRow();
+
+	std::string BuildHeaderLine() const;
+	LogRowCompactor* GetCompactor();
+	void OutputCompactedLines();
+	ColumnarLogWriter* GetColumnarWriter();
+	void ResetRotationState();
+	void RotateIfNecessary(size_t incoming_bytes);
+	void WriteLineToFile(const std::string& line);
+	void WriteEncryptedLineToFile(const std::string& line);
+	void WriteBufferToFile();
+	void SyncLogFile();
+	void StartFlushTimer();
+	void StopFlushTimer();
+	void RunFlushTimer();
 	void SaveMemoryLogToFileHelper(const std::string& file_path, bool encrypt);
 
 };
 
 
+template <typename... Values>
+void LoggerBase::LogDataPoint(const Values&... values) {
+	if (!BeginRow(sizeof...(Values)))
+		return;
+	(AppendRowValue(values), ...);
+	EndRow();
+}
+
+template <typename... Values>
+void LoggerBase::LogDataPointAt(std::chrono::system_clock::time_point acquisition_time, const Values&... values) {
+	if (!BeginRowAt(sizeof...(Values), acquisition_time))
+		return;
+	(AppendRowValue(values), ...);
+	EndRow();
+}
+
+
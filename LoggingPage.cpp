@@ -1,6 +1,7 @@
 #include "CustomLogDebugOutput.h"
 #include "LoggingPage.h"
 #include "../CommonFunctions_GUI.h"
+#include "Logging/UserActionJournal.h"
 
 
 using namespace std;
@@ -13,7 +14,7 @@ static wxString CUSTOM_LOGGING_TOOLTIP = _(
 	"\n"
 	" 1. Select which laser data you want to record.\n"
 	" 2. Select a location to save log data to a new or existing file.\n"
-	" 3. Choose a time interval for each data point.\n"
+	" 3. Choose a time interval in milliseconds for each data point.\n"
 	" 4. Click \"Start\".\n"
 	"\n"
 	"The GUI will now log data continuously until you click \"Stop\" or close the GUI.\n"
@@ -26,7 +27,7 @@ static wxString REAL_TIME_TEMP_LOG_STR = _("Real-Time Temperature Logs:");
 static wxString SELECT_LOG_OUTPUT_FILE_STR = _("Select Log Output File");
 static wxString SELECT_STR = _("Select");
 static wxString TIME_INTERVAL_STR = _("Time Interval");
-static wxString SECONDS_STR = _("seconds");
+static wxString MILLISECONDS_STR = _("ms");
 static wxString STOP_STR = _("Stop");
 static wxString TOTAL_LOG_TIME_STR = _("Total Log Time:");
 static wxString TOTAL_DATA_POINTS_STR = _("Total Data Points:");
@@ -46,14 +47,19 @@ const vector<LaserStateLogCategoryEnum> LASER_STATE_LOG_CATEGORIES_VISIBLE_TO_US
 
 
 LoggingPage::LoggingPage(shared_ptr<MainLaserControllerInterface> _lc, wxWindow* parent) :
-	SettingsPage_Base(_lc, parent) {
+	SettingsPage_Base(_lc, parent),
+	// Rows are stamped with the time the laser state was read
+	logSampler([this](chrono::system_clock::time_point acquired) { logger->LogLaserStateAt(acquired); }) {
 
 	logger = make_shared<CustomLogger>(lc);
-	CustomLogDebugOutput* logDebugOutput = new CustomLogDebugOutput();
-	logger->addObserver(logDebugOutput);
+	logger->EnableAsyncOutput();
+	logger->SetMemoryLogPolicy(MemoryLogPolicy::SPILL_TO_DISK, 16 * 1024 * 1024);
+	logDebugOutput = make_shared<CustomLogDebugOutput>();
+	logDebugOutputSubscription = logger->subscribe(logDebugOutput);
 
 
 	logTimer.Bind(wxEVT_TIMER, &LoggingPage::OnLogTimer, this, logTimer.GetId());
+	sampleTimer.Bind(wxEVT_TIMER, &LoggingPage::OnSampleTimer, this, sampleTimer.GetId());
 
 
 	wxBoxSizer* sizer = new wxBoxSizer(wxVERTICAL);
@@ -130,7 +136,7 @@ LoggingPage::LoggingPage(shared_ptr<MainLaserControllerInterface> _lc, wxWindow*
 	TimeIntervalTextCtrl->SetHelpText(wxT("Choose the amount of time between each log event."));
 	TimeIntervalSizer->Add(TimeIntervalTextCtrl, 0, wxALL | wxALIGN_CENTER_VERTICAL, 0);
 
-	TimeIntervalUnits = new wxStaticText(LogControlsPanel, wxID_ANY, _(SECONDS_STR), wxDefaultPosition, wxDefaultSize, 0);
+	TimeIntervalUnits = new wxStaticText(LogControlsPanel, wxID_ANY, _(MILLISECONDS_STR), wxDefaultPosition, wxDefaultSize, 0);
 	TimeIntervalUnits->SetFont(FONT_VERY_SMALL_SEMIBOLD);
 	TimeIntervalSizer->Add(TimeIntervalUnits, 0, wxALL | wxALIGN_CENTER_VERTICAL, 5);
 
@@ -188,16 +194,8 @@ LoggingPage::LoggingPage(shared_ptr<MainLaserControllerInterface> _lc, wxWindow*
 	// Ensure layout is updated
 	LogControlsSizer->Layout();
 
-	// Other initialization code... 
-	logTimer.Bind(wxEVT_TIMER, &LoggingPage::OnLogTimer, this, logTimer.GetId());
-
-
-	tempObserver = new RealTimeObserver(RealTimeTempLogTextCtrl);
-	logger->addObserver(tempObserver);
-	// Other initialization code... 
-	logTimer.Bind(wxEVT_TIMER,
-		&LoggingPage::OnLogTimer, this,
-		logTimer.GetId());
+	tempObserver = make_shared<RealTimeObserver>(RealTimeTempLogTextCtrl);
+	tempObserverSubscription = logger->subscribe(tempObserver);
 
 
 
@@ -234,6 +232,9 @@ LoggingPage::LoggingPage(shared_ptr<MainLaserControllerInterface> _lc, wxWindow*
 	LogControlsSizer->Fit(LogControlsPanel);
 	CustomLoggingControlsSizer->Add(LogControlsPanel, wxGBPosition(1, 1), wxGBSpan(1, 1), wxEXPAND | wxALL, 5);
 
+	CreateChartPanel();
+	CustomLoggingControlsSizer->Add(ChartPanel, wxGBPosition(2, 0), wxGBSpan(1, 2), wxEXPAND | wxALL, 5);
+
 	CustomLoggingSizer->Add(CustomLoggingControlsSizer, 1, wxEXPAND, 5);
 
 	CustomLoggingPanel->SetSizer(CustomLoggingSizer);
@@ -252,11 +253,18 @@ LoggingPage::LoggingPage(shared_ptr<MainLaserControllerInterface> _lc, wxWindow*
 
 void LoggingPage::Init() {
 	InitCategoryCheckboxes();
-	TimeIntervalTextCtrl->SetLabelText(to_wx_string(logger->GetTimeIntervalInSeconds()));
+	TimeIntervalTextCtrl->SetLabelText(to_wx_string(logSampler.GetInterval().count()));
 	RefreshControlsEnabled();
 }
 
 
+void LoggingPage::CreateChartPanel() {
+	chartBuffer = make_shared<LogChartBuffer>();
+	chartBufferSubscription = logger->subscribe(chartBuffer);
+	ChartPanel = new LogChartPanel(chartBuffer, CustomLoggingPanel);
+}
+
+
 void LoggingPage::InitCategoryCheckboxes() {
 	categoryCheckboxes.clear();
 	for (auto& categoryCheckbox : LogDataCheckboxesSizer->GetChildren())
@@ -282,7 +290,7 @@ void LoggingPage::InitCategoryCheckboxes() {
 
 
 void LoggingPage::OnSelectLogOutputFileButtonClicked(wxCommandEvent& evt) {
-	STAGE_ACTION("Select Log Output File button clicked")
+	JOURNALED_STAGE_ACTION("Select Log Output File button clicked")
 		wxString defaultLogFileName = "LaserStateLog_(" + lc->GetLaserModel() + ")_(Serial#" + lc->GetSerialNumber() + ")_(" + GenerateDateString() + ")";
 
 	wxFileDialog selectOutputFileDialog(this, (_(SELECT_LOG_OUTPUT_FILE_STR)), "", defaultLogFileName, "LOG files (*.log)|*.log", wxFD_SAVE | wxFD_OVERWRITE_PROMPT);
@@ -291,55 +299,67 @@ void LoggingPage::OnSelectLogOutputFileButtonClicked(wxCommandEvent& evt) {
 		return;
 
 	string path = string(selectOutputFileDialog.GetPath());
-	STAGE_ACTION_ARGUMENTS(path)
+	JOURNALED_STAGE_ACTION_ARGUMENTS(path)
 		if (PathIsValid(path)) {
 			logger->SetFilePath(path);
 			logger->Reset();
-			totalLogTimeInS = 0;
+			chartBuffer->Clear();
+			ResetLogTime();
 			LogOutputFileTextCtrl->SetLabelText(path);
 			LogStatusMessage->SetLabelText("");
 		}
 	RefreshControlsEnabled();
-	LOG_ACTION()
+	JOURNALED_LOG_ACTION()
 }
 
 
 void LoggingPage::OnStartButtonClicked(wxCommandEvent& evt) {
-	STAGE_ACTION("Start logging button clicked")
-		if (logger->IsLogging()) {
-			STAGE_ACTION_ARGUMENTS("Stop")
-				logger->Stop();
+	JOURNALED_STAGE_ACTION("Start logging button clicked")
+		if (logSampler.IsRunning()) {
+			JOURNALED_STAGE_ACTION_ARGUMENTS("Stop")
+				logSampler.Stop();
+			sampleTimer.Stop();
 			logTimer.Stop();
+			previousLogTime += chrono::steady_clock::now() - logStartTime;
+			UpdateLogTime();
+
+			string timing = FormatSamplingStatistics(logSampler.GetStatistics());
+			logger->CommitLineMetadata(timing);
+			wxLogStatus(to_wx_string("Stopped custom logging. " + timing));
 			LogStatusMessage->StopCycling();
 			LogStatusMessage->Set(_("Paused"));
 		}
 		else {
-			STAGE_ACTION_ARGUMENTS("Start")
-				logger->SetTimeIntervalInSeconds(stoi(string(TimeIntervalTextCtrl->GetValue())));
-			logger->Start();
+			JOURNALED_STAGE_ACTION_ARGUMENTS("Start")
+				logSampler.SetInterval(chrono::milliseconds(stoi(string(TimeIntervalTextCtrl->GetValue()))));
+			logSampler.ResetStatistics();
+			logSampler.StartOnCallerThread();
+			sampleTimer.StartOnce(1);
+			logStartTime = chrono::steady_clock::now();
 			logTimer.Start(1000);
 			LogStatusMessage->StartCycling();
 			LogStatusMessage->Set(_("Logging"));
 		}
 	RefreshControlsEnabled();
-	LOG_ACTION()
+	JOURNALED_LOG_ACTION()
 }
 
 
 void LoggingPage::OnResetButtonClicked(wxCommandEvent& evt) {
-	STAGE_ACTION("Reset log button clicked")
+	JOURNALED_STAGE_ACTION("Reset log button clicked")
 		logger->Reset();
-	totalLogTimeInS = 0;
-	if (!logger->IsLogging())
+	chartBuffer->Clear();
+	ResetLogTime();
+	if (!logSampler.IsRunning())
 		LogStatusMessage->Set(_("Log reset"));
 	RefreshAll();
 	RefreshControlsEnabled();
-	LOG_ACTION()
+	JOURNALED_LOG_ACTION()
 }
 
 
 void LoggingPage::OnSaveNowButtonClicked(wxCommandEvent& evt) {
-	STAGE_ACTION("Save log now button clicked")
+	JOURNALED_STAGE_ACTION("Save log now button clicked")
 		wxString defaultLogFileName = "LaserStateLog_(" + lc->GetLaserModel() + ")_(Serial#" + lc->GetSerialNumber() + ")_(" + GenerateDateString() + ")";
 
 	wxFileDialog selectOutputFileDialog(this, (_(SELECT_LOG_OUTPUT_FILE_STR)), "", defaultLogFileName, "LOG files (*.log)|*.log", wxFD_SAVE | wxFD_OVERWRITE_PROMPT);
@@ -348,19 +368,43 @@ void LoggingPage::OnSaveNowButtonClicked(wxCommandEvent& evt) {
 		return;
 
 	string path = string(selectOutputFileDialog.GetPath());
-	STAGE_ACTION_ARGUMENTS(path)
+	JOURNALED_STAGE_ACTION_ARGUMENTS(path)
 		if (PathIsValid(path)) {
 			logger->SaveMemoryLogToFile(path);
 			if (!logger->SaveSuccessful())
 				wxMessageBox("Failed to save log file. You may not have permission to save there.");
 		}
 	RefreshControlsEnabled();
-	LOG_ACTION()
+	JOURNALED_LOG_ACTION()
 }
 
 
 void LoggingPage::OnLogTimer(wxTimerEvent& evt) {
-	totalLogTimeInS++;
+	UpdateLogTime();
+}
+
+
+// One-shot, restarted for the next deadline, so rows follow the sampler's
+// schedule instead of drifting with the timer.
+void LoggingPage::OnSampleTimer(wxTimerEvent& evt) {
+	if (logSampler.IsRunning())
+		sampleTimer.StartOnce(max(int(logSampler.SampleIfDue().count()), 1));
+}
+
+
+// Total log time is measured on the steady clock, since timer events can
+// be delayed or dropped while the UI is busy.
+void LoggingPage::UpdateLogTime() {
+	auto totalLogTime = previousLogTime;
+	if (logSampler.IsRunning())
+		totalLogTime += chrono::steady_clock::now() - logStartTime;
+	totalLogTimeInS = (unsigned int)chrono::duration_cast<chrono::seconds>(totalLogTime).count();
+}
+
+void LoggingPage::ResetLogTime() {
+	previousLogTime = chrono::steady_clock::duration::zero();
+	logStartTime = chrono::steady_clock::now();
+	totalLogTimeInS = 0;
 }
 
 
@@ -368,12 +412,12 @@ void LoggingPage::OnLogTimer(wxTimerEvent& evt) {
 // logging and whether it has already logged data points. Only called after
 // certain actions to prevent constant flickering.
 void LoggingPage::RefreshControlsEnabled() {
-	bool isLogging = logger->IsLogging();
+	bool isLogging = logSampler.IsRunning();
 	bool hasLoggedDataPoints = logger->GetTotalLoggedDataPoints() > 0;
 
 	// Category Checkboxes
 	for (auto checkbox : categoryCheckboxes)
-		checkbox->RefreshEnableStatus();
+		checkbox->RefreshEnableStatus(isLogging);
 
 	// Select Log Output
 	RefreshWidgetEnableBasedOnCondition(SelectLogOutputFileButton, !isLogging);
@@ -396,7 +440,7 @@ void LoggingPage::RefreshAll() {
 	TotalDataPointsValue->SetLabelText(to_wx_string(logger->GetTotalLoggedDataPoints()));
 
 	bool hasLoggedDataPoints = logger->GetTotalLoggedDataPoints() > 0;
-	RefreshWidgetEnableBasedOnCondition(TimeIntervalTextCtrl, !logger->IsLogging() and !hasLoggedDataPoints);
+	RefreshWidgetEnableBasedOnCondition(TimeIntervalTextCtrl, !logSampler.IsRunning() and !hasLoggedDataPoints);
 	RefreshWidgetEnableBasedOnCondition(ResetLogButton, hasLoggedDataPoints);
 	RefreshWidgetEnableBasedOnCondition(SaveLogNowButton, hasLoggedDataPoints);
 }
@@ -415,7 +459,7 @@ void LoggingPage::RefreshStrings() {
 	LogOutputFileLabel->SetLabelText(_(SELECT_LOG_OUTPUT_FILE_STR));
 	SelectLogOutputFileButton->SetLabelText(_(SELECT_STR));
 	TimeIntervalLabel->SetLabelText(_(TIME_INTERVAL_STR));
-	TimeIntervalUnits->SetLabelText(_(SECONDS_STR));
+	TimeIntervalUnits->SetLabelText(_(MILLISECONDS_STR));
 	TotalLogTimeLabel->SetLabelText(_(TOTAL_LOG_TIME_STR));
 	TotalDataPointsLabel->SetLabelText(_(TOTAL_DATA_POINTS_STR));
 	ResetLogButton->SetLabelText(_(RESET_STR));
@@ -443,21 +487,21 @@ LogCategoryCheckbox::LogCategoryCheckbox(shared_ptr<MainLaserControllerInterface
 }
 
 void LogCategoryCheckbox::OnLogDataCategoryCheckboxChecked(wxCommandEvent& evt) {
-	STAGE_ACTION("Log data category checkbox clicked")
+	JOURNALED_STAGE_ACTION("Log data category checkbox clicked")
 		if (this->IsChecked()) {
 			logger->IncludeCategory(category);
-			STAGE_ACTION_ARGUMENTS("Included " + categoryName)
+			JOURNALED_STAGE_ACTION_ARGUMENTS("Included " + categoryName)
 		}
 		else {
 			logger->ExcludeCategory(category);
-			STAGE_ACTION_ARGUMENTS("Excluded " + categoryName)
+			JOURNALED_STAGE_ACTION_ARGUMENTS("Excluded " + categoryName)
 		}
-	LOG_ACTION()
+	JOURNALED_LOG_ACTION()
 }
 
-void LogCategoryCheckbox::RefreshEnableStatus() {
+void LogCategoryCheckbox::RefreshEnableStatus(bool is_logging) {
 	// Can only include/exclude log data categories when not logging and no data points have been logged yet.
-	bool canChangeCategoriesIncluded = !logger->IsLogging() and logger->GetTotalLoggedDataPoints() == 0;
+	bool canChangeCategoriesIncluded = !is_logging and logger->GetTotalLoggedDataPoints() == 0;
 	RefreshWidgetEnableBasedOnCondition(this, canChangeCategoriesIncluded);
 }
 
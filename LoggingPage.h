@@ -1,5 +1,6 @@
  #pragma once
 
+#include <chrono>
 #include <map>
 
 #include "wx/wx.h"
@@ -11,7 +12,9 @@
 #include "../CommonGUIComponents/FeatureTitle.h"
 #include "../CommonGUIComponents/DynamicStatusMessage.h"
 #include "../CommonGUIComponents/NumericTextCtrl.h"
+#include "../CommonUtilities/Logging/SamplingScheduler.h"
 #include "../LaserGUI/RealTimeObserver.h"
+#include "../LaserGUI/LogChartPanel.h"
 
 
 
@@ -31,7 +34,7 @@ private:
 
 public:
 	LogCategoryCheckbox(shared_ptr<MainLaserControllerInterface> _lc, wxWindow* parent, shared_ptr<CustomLogger> _logger, LaserStateLogCategoryEnum _category);
-	void RefreshEnableStatus();
+	void RefreshEnableStatus(bool is_logging);
 	void RefreshStrings();
 };
 
@@ -53,9 +56,15 @@ private:
 
 	std::vector<LogCategoryCheckbox*> categoryCheckboxes;
 
+	// Takes the logger's rows on a drift-free, millisecond schedule. Sampled
+	// on the UI thread through sampleTimer, since lc isn't thread-safe.
+	SamplingScheduler logSampler;
+	wxTimer sampleTimer;
 	wxTimer logTimer;
 
 	unsigned int totalLogTimeInS = 0;
+	std::chrono::steady_clock::time_point logStartTime;
+	std::chrono::steady_clock::duration previousLogTime{ 0 };  // Logged before the last pause
 
 	wxPanel* CustomLoggingPanel;
 	FeatureTitle* CustomLoggingTitle;
@@ -83,7 +92,14 @@ private:
 
 	//////////////////////////////////////////////////////////////////////
 	wxTextCtrl* RealTimeTempLogTextCtrl;
-	RealTimeObserver* tempObserver;//Observer for temperature logs
+	std::shared_ptr<RealTimeObserver> tempObserver;//Observer for temperature logs
+	std::shared_ptr<LogRowObserver> logDebugOutput;
+	std::shared_ptr<LogChartBuffer> chartBuffer;
+	LogChartPanel* ChartPanel;
+	// Declared last so they are destroyed first, unsubscribing the observers above
+	LogSubscription tempObserverSubscription;
+	LogSubscription logDebugOutputSubscription;
+	LogSubscription chartBufferSubscription;
 	
 
 	void InitCategoryCheckboxes();
@@ -96,6 +112,9 @@ private:
 	void OnResetButtonClicked(wxCommandEvent& evt);
 	void OnSaveNowButtonClicked(wxCommandEvent& evt);
 	void OnLogTimer(wxTimerEvent& evt);
+	void OnSampleTimer(wxTimerEvent& evt);
+	void UpdateLogTime();
+	void ResetLogTime();
 
 	 
 
@@ -0,0 +1,202 @@
+
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+
+#include "MemoryLog.h"
+#include "LogBlockCipher.h"
+#include "../ErrorMessageStream.h"
+
+using namespace std;
+
+
+const size_t DEFAULT_CHUNK_CAPACITY = 256 * 1024;
+const size_t MIN_CHUNK_CAPACITY = 4 * 1024;
+
+
+// Unique spill file name for each memory log that spills in this process
+static string GenerateSpillFilePath() {
+	static atomic<unsigned int> spillFileCount{ 0 };
+	auto ticks = chrono::steady_clock::now().time_since_epoch().count();
+	string filename = "LogSpill_" + to_string(ticks) + "_" + to_string(spillFileCount++) + ".tmp";
+	return (filesystem::temp_directory_path() / filename).string();
+}
+
+
+MemoryLog::MemoryLog() {
+	chunkCapacity = DEFAULT_CHUNK_CAPACITY;
+}
+
+MemoryLog::~MemoryLog() {
+	RemoveSpillFile();
+}
+
+
+void MemoryLog::SetPolicy(MemoryLogPolicy memory_policy, size_t max_bytes_in_memory) {
+	policy = memory_policy;
+	maxBytesInMemory = max_bytes_in_memory;
+
+	// Keep several chunks within the limit so trimming is gradual
+	chunkCapacity = DEFAULT_CHUNK_CAPACITY;
+	if (policy != MemoryLogPolicy::UNBOUNDED) {
+		chunkCapacity = min(DEFAULT_CHUNK_CAPACITY, maxBytesInMemory / 4);
+		chunkCapacity = max(chunkCapacity, MIN_CHUNK_CAPACITY);
+	}
+}
+
+MemoryLogPolicy MemoryLog::GetPolicy() const {
+	return policy;
+}
+
+
+void MemoryLog::push_back(const string& line) {
+	if (line.empty())
+		return;
+
+	size_t bytesNeeded = line.size() + (line.back() == '\n' ? 0 : 1);
+
+	if (chunks.empty() or chunks.back().text.size() + bytesNeeded > chunkCapacity) {
+		chunks.emplace_back();
+		chunks.back().text.reserve(max(chunkCapacity, bytesNeeded));
+	}
+
+	Chunk& chunk = chunks.back();
+	chunk.text += line;
+	if (line.back() != '\n')
+		chunk.text += '\n';
+	chunk.lineCount++;
+
+	bytesInMemory += bytesNeeded;
+	linesInMemory++;
+
+	EnforceMemoryLimit();
+}
+
+
+void MemoryLog::clear() {
+	chunks.clear();
+	bytesInMemory = 0;
+	linesInMemory = 0;
+	linesSpilled = 0;
+	linesDiscarded = 0;
+	RemoveSpillFile();
+}
+
+
+size_t MemoryLog::size() const {
+	return linesSpilled + linesInMemory;
+}
+
+bool MemoryLog::empty() const {
+	return size() == 0;
+}
+
+size_t MemoryLog::GetBytesInMemory() const {
+	return bytesInMemory;
+}
+
+unsigned long long MemoryLog::GetDiscardedLineCount() const {
+	return linesDiscarded;
+}
+
+
+void MemoryLog::ForEachLine(const function<void(const string&)>& visit) const {
+	string line;
+	auto visitLines = [&](const string& text) {
+		size_t start = 0;
+		while (start < text.size()) {
+			size_t end = text.find('\n', start);
+			line.assign(text, start, end - start);
+			visit(line);
+			start = end + 1;
+		}
+	};
+
+	ForEachSpilledChunk(visitLines);
+	for (const Chunk& chunk : chunks)
+		visitLines(chunk.text);
+}
+
+
+void MemoryLog::WriteTo(ostream& out) const {
+	ForEachSpilledChunk([&](const string& text) { out.write(text.data(), text.size()); });
+	for (const Chunk& chunk : chunks)
+		out.write(chunk.text.data(), chunk.text.size());
+}
+
+
+void MemoryLog::EnforceMemoryLimit() {
+	if (policy == MemoryLogPolicy::UNBOUNDED)
+		return;
+
+	// Never drop the chunk currently being filled
+	while (bytesInMemory > maxBytesInMemory and chunks.size() > 1) {
+		Chunk& oldest = chunks.front();
+
+		if (policy == MemoryLogPolicy::SPILL_TO_DISK and SpillChunk(oldest))
+			linesSpilled += oldest.lineCount;
+		else
+			linesDiscarded += oldest.lineCount;
+
+		bytesInMemory -= oldest.text.size();
+		linesInMemory -= oldest.lineCount;
+		chunks.pop_front();
+	}
+}
+
+
+bool MemoryLog::SpillChunk(const Chunk& chunk) {
+	if (spillFilePath == "")
+		spillFilePath = GenerateSpillFilePath();
+
+	string encrypted = EncryptLogBlock(chunk.text);
+
+	ofstream spillFile(spillFilePath, ios::app | ios::binary);
+	if (spillFile.is_open()) {
+		spillFile.write(encrypted.data(), encrypted.size());
+		if (spillFile.good()) {
+			spilledChunkSizes.push_back(encrypted.size());
+			spillFileBytes += encrypted.size();
+			return true;
+		}
+		spillFile.close();
+	}
+
+	// Cut off a partly written chunk, so the chunks after it still line up
+	error_code ec;
+	filesystem::resize_file(spillFilePath, spillFileBytes, ec);
+	e << "Failed to spill log memory to file \"" << spillFilePath << "\". Discarding oldest lines." << endl;
+	return false;
+}
+
+
+void MemoryLog::ForEachSpilledChunk(const function<void(const string&)>& visit) const {
+	if (spilledChunkSizes.empty())
+		return;
+
+	ifstream spillFile(spillFilePath, ios::binary);
+	string encrypted, text;
+	for (size_t i = 0; i < spilledChunkSizes.size() and spillFile.good(); i++) {
+		encrypted.resize(spilledChunkSizes[i]);
+		spillFile.read(&encrypted[0], encrypted.size());
+		if (size_t(spillFile.gcount()) != encrypted.size())
+			break;
+		if (!DecryptLogBlock(encrypted, text)) {
+			e << "Failed to decrypt log memory spilled to file \"" << spillFilePath << "\"." << endl;
+			break;
+		}
+		visit(text);
+	}
+}
+
+
+void MemoryLog::RemoveSpillFile() {
+	if (spillFilePath == "")
+		return;
+	error_code ec;
+	filesystem::remove(spillFilePath, ec);
+	spillFilePath = "";
+	spilledChunkSizes.clear();
+	spillFileBytes = 0;
+}
@@ -0,0 +1,100 @@
+/**
+* Memory Log - In-memory copy of every line committed by a LoggerBase, used
+*	by SaveMemoryLogToFile(..) to write the log to another file later.
+*
+* - Lines are packed back-to-back (newline-terminated) into large contiguous
+*	chunks instead of one heap string per line, so growing the log never
+*	reallocates or copies what has already been stored.
+* - A memory policy caps how much of the log is kept in RAM:
+*		- UNBOUNDED: Keep everything in memory. (Default)
+*		- RING: Keep only the most recent lines. Whole chunks of the oldest
+*			lines are discarded once the memory limit is exceeded.
+*		- SPILL_TO_DISK: Once the memory limit is exceeded, the oldest chunks
+*			are appended to a temporary spill file and streamed back in
+*			order when the log is read. Nothing is lost. Spilled chunks are
+*			encrypted (LogBlockCipher.h), so a spill file left behind by a
+*			crash can't be read without decryptofy(..).
+* - Empty lines are not stored. A line containing newlines is read back as
+*	several lines.
+*
+* Keeps the push_back()/size()/empty()/clear() interface of the
+*	std::vector<std::string> it replaced.
+*
+* @file MemoryLog.h
+* @created October 2026
+* @version 1.0
+*/
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+
+enum class MemoryLogPolicy {
+	UNBOUNDED,
+	RING,
+	SPILL_TO_DISK,
+};
+
+
+class MemoryLog {
+
+public:
+	MemoryLog();
+	~MemoryLog();
+	MemoryLog(const MemoryLog&) = delete;
+	MemoryLog& operator=(const MemoryLog&) = delete;
+
+	// Choose how much of the log stays in memory. Existing lines are kept
+	//   and trimmed to the new limit on the next push_back(..).
+	void SetPolicy(MemoryLogPolicy memory_policy, size_t max_bytes_in_memory);
+	MemoryLogPolicy GetPolicy() const;
+
+	void push_back(const std::string& line);
+	void clear();
+
+	// Number of lines that can still be read back (memory + spill file).
+	size_t size() const;
+	bool empty() const;
+	size_t GetBytesInMemory() const;
+	// Number of lines discarded by the RING policy.
+	unsigned long long GetDiscardedLineCount() const;
+
+	// Visit every retained line, oldest first, without its newline.
+	void ForEachLine(const std::function<void(const std::string&)>& visit) const;
+	// Write every retained line, oldest first, newline-terminated.
+	void WriteTo(std::ostream& out) const;
+
+
+private:
+	struct Chunk {
+		std::string text;
+		size_t lineCount = 0;
+	};
+
+	MemoryLogPolicy policy = MemoryLogPolicy::UNBOUNDED;
+	size_t maxBytesInMemory = 0;
+	size_t chunkCapacity = 0;
+
+	std::deque<Chunk> chunks;
+	size_t bytesInMemory = 0;
+	size_t linesInMemory = 0;
+
+	std::string spillFilePath;
+	// Size of each spilled chunk, encrypted, in file order
+	std::vector<size_t> spilledChunkSizes;
+	uint64_t spillFileBytes = 0;
+	size_t linesSpilled = 0;
+	unsigned long long linesDiscarded = 0;
+
+	void EnforceMemoryLimit();
+	bool SpillChunk(const Chunk& chunk);
+	// Visit each spilled chunk's text, decrypted, in order
+	void ForEachSpilledChunk(const std::function<void(const std::string&)>& visit) const;
+	void RemoveSpillFile();
+
+};
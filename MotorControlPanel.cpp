@@ -3,6 +3,7 @@
 #include <wx/scrolwin.h>
 
 #include "../CommonFunctions_GUI.h"
+#include "Logging/UserActionJournal.h"
 #include "MotorControlPanel.h"
 #include "ConfigurationManager.h"
 
@@ -528,9 +529,9 @@ void MotorControlPanel::OnTargetIndexEntered(wxCommandEvent& evt) {
 	if (CheckIfCantMoveMotorDueToLDDCurrentLimit(true))
 		return;
 
-	STAGE_ACTION_("Motor target index entered", string(MotorTargetIndexTextCtrl->GetValue()))
+	JOURNALED_STAGE_ACTION_("Motor target index entered", string(MotorTargetIndexTextCtrl->GetValue()))
 	GoToTargetIndex();
-	LOG_ACTION()
+	JOURNALED_LOG_ACTION()
 }
 
 
@@ -538,7 +539,7 @@ void MotorControlPanel::OnGoToTargetIndexButtonClicked(wxCommandEvent& evt) {
 	if (CheckIfCantMoveMotorDueToLDDCurrentLimit(true))
 		return;
 
-	STAGE_ACTION_("Motor go to target index button clicked", string(MotorTargetIndexTextCtrl->GetValue()))
+	JOURNALED_STAGE_ACTION_("Motor go to target index button clicked", string(MotorTargetIndexTextCtrl->GetValue()))
 	// If clicked on while in STOP state (while motor is moving), just stop motor and set slider to current position
 	if (lc->MotorIsMoving(motorId)) {
 		lc->StopMotor(motorId);
@@ -550,7 +551,7 @@ void MotorControlPanel::OnGoToTargetIndexButtonClicked(wxCommandEvent& evt) {
 		GoToTargetIndex();
 	}
 	RefreshGoToTargetButton();
-	LOG_ACTION()
+	JOURNALED_LOG_ACTION()
 }
 
 
@@ -558,15 +559,15 @@ void MotorControlPanel::OnSliderMoved(wxScrollEvent& evt) {
 	if (CheckIfCantMoveMotorDueToLDDCurrentLimit(true))
 		return;
 
-	STAGE_ACTION("Motor index slider moved")
+	JOURNALED_STAGE_ACTION("Motor index slider moved")
 	int targetIndex = MotorSlider->GetValue();
-	STAGE_ACTION_ARGUMENTS(to_string(targetIndex))
+	JOURNALED_STAGE_ACTION_ARGUMENTS(to_string(targetIndex))
 	int targetIndexRounded = roundMotorIndex(targetIndex);
 	MotorSlider->SetValue(targetIndexRounded);
 	lc->MoveMotorToIndex(motorId, targetIndexRounded);
 	MotorTargetIndexTextCtrl->SetLabelText(to_wx_string(targetIndexRounded));
 	RefreshGoToTargetButton();
-	LOG_ACTION()
+	JOURNALED_LOG_ACTION()
 }
 
 
@@ -574,17 +575,17 @@ void MotorControlPanel::OnCCWButtonClicked(wxMouseEvent& evt) {
 	if (CheckIfCantMoveMotorDueToLDDCurrentLimit(true))
 		return;
 
-	STAGE_ACTION_("Motor CCW button clicked", to_string(GetStepSize()))
+	JOURNALED_STAGE_ACTION_("Motor CCW button clicked", to_string(GetStepSize()))
 	MoveCCW();
-	LOG_ACTION()
+	JOURNALED_LOG_ACTION()
 }
 
 
 void MotorControlPanel::OnCCWButtonClickStopped(wxMouseEvent& evt) {
-	STAGE_ACTION_("Motor CCW button click stopped", to_string(GetStepSize()))
+	JOURNALED_STAGE_ACTION_("Motor CCW button click stopped", to_string(GetStepSize()))
 	StopMoving();
 	movingMotor = false;
-	LOG_ACTION()
+	JOURNALED_LOG_ACTION()
 }
 
 
@@ -592,17 +593,17 @@ void MotorControlPanel::OnCWButtonClicked(wxMouseEvent& evt) {
 	if (CheckIfCantMoveMotorDueToLDDCurrentLimit(true))
 		return;
 
-	STAGE_ACTION_("Motor CW button clicked", to_string(GetStepSize()))
+	JOURNALED_STAGE_ACTION_("Motor CW button clicked", to_string(GetStepSize()))
 	MoveCW();
-	LOG_ACTION()
+	JOURNALED_LOG_ACTION()
 }
 
 
 void MotorControlPanel::OnCWButtonClickStopped(wxMouseEvent& evt) {
-	STAGE_ACTION_("Motor CW button click stopped", to_string(GetStepSize()))
+	JOURNALED_STAGE_ACTION_("Motor CW button click stopped", to_string(GetStepSize()))
 	StopMoving();
 	movingMotor = false;
-	LOG_ACTION()
+	JOURNALED_LOG_ACTION()
 }
 
 
@@ -665,7 +666,7 @@ void MotorControlPanel::StopMoving() {
 // Controlled by MotorSettingsPage
 void MotorControlPanel::OnKeyDown(wxKeyEvent& evt) {
 
-	STAGE_ACTION_("Moving motor by key", to_string(motorId));
+	JOURNALED_STAGE_ACTION_("Moving motor by key", to_string(motorId));
 
 	if (AssignKeyboardChoice->GetSelection() == 1) { // Left-Right
 		if (evt.GetKeyCode() == WXK_LEFT)
@@ -692,22 +693,22 @@ void MotorControlPanel::OnKeyDown(wxKeyEvent& evt) {
 			MoveCW();
 	}
 
-	LOG_ACTION();
+	JOURNALED_LOG_ACTION();
 }
 
 // Controlled by MotorSettingsPage
 void MotorControlPanel::OnKeyUp(wxKeyEvent& evt) {
-	STAGE_ACTION_("Moving motor by key stopped", to_string(motorId));
+	JOURNALED_STAGE_ACTION_("Moving motor by key stopped", to_string(motorId));
 	StopMoving();
 	movingMotor = false;
-	LOG_ACTION();
+	JOURNALED_LOG_ACTION();
 }
 
 
 void MotorControlPanel::OnMotorLabelEntered(wxCommandEvent& evt) {
-	STAGE_ACTION("Motor label entered")
+	JOURNALED_STAGE_ACTION("Motor label entered")
 		string newLabel = string(MotorLabelTextCtrl->GetValue());
-	STAGE_ACTION_ARGUMENTS(newLabel)
+	JOURNALED_STAGE_ACTION_ARGUMENTS(newLabel)
 		lc->SetMotorLabel(motorId, newLabel);
 	string newLabelConfirmed = lc->GetMotorLabel(motorId);
 	MotorLabelTextCtrl->SetValue(newLabelConfirmed);
@@ -715,51 +716,51 @@ void MotorControlPanel::OnMotorLabelEntered(wxCommandEvent& evt) {
 	//MotorLabel->SetLabelText(newLabelConfirmed);
 	MotorTitle->SetTitle(newLabelConfirmed);
 
-	LOG_ACTION()
+	JOURNALED_LOG_ACTION()
 }
 
 void MotorControlPanel::OnRedefineCurrentIndexEntered(wxCommandEvent& evt) {
-	STAGE_ACTION("Motor redefine current index extered")
+	JOURNALED_STAGE_ACTION("Motor redefine current index extered")
 		int newCurrentIndex = wxAtoi(MotorRedefineCurrentIndexTextCtrl->GetValue());
-	STAGE_ACTION_ARGUMENTS(to_string(newCurrentIndex))
+	JOURNALED_STAGE_ACTION_ARGUMENTS(to_string(newCurrentIndex))
 		newCurrentIndex = min(max(newCurrentIndex, minIndex), maxIndex);
 	MotorRedefineCurrentIndexTextCtrl->SetValue(to_wx_string(newCurrentIndex));
 	lc->RedefineCurrentMotorIndex(motorId, newCurrentIndex);
 	RefreshCurrentIndexDependentWidgets();
 	MotorSlider->SetValue(newCurrentIndex);
-	LOG_ACTION()
+	JOURNALED_LOG_ACTION()
 }
 
 void MotorControlPanel::OnSetMinIndexEntered(wxCommandEvent& evt) {
-	STAGE_ACTION("Motor set min index extered")
+	JOURNALED_STAGE_ACTION("Motor set min index extered")
 		int newMinIndex = wxAtoi(MotorSetMinIndexTextCtrl->GetValue());
-	STAGE_ACTION_ARGUMENTS(to_string(newMinIndex))
+	JOURNALED_STAGE_ACTION_ARGUMENTS(to_string(newMinIndex))
 		lc->SetMotorMinIndex(motorId, newMinIndex);
 	minIndex = lc->GetMotorMinIndex(motorId);
 	MotorSetMinIndexTextCtrl->SetValue(to_wx_string(minIndex));
 	MotorSlider->SetMin(minIndex);
 	MotorGauge->SetRange(maxIndex - minIndex);
-	LOG_ACTION()
+	JOURNALED_LOG_ACTION()
 }
 
 void MotorControlPanel::OnSetMaxIndexEntered(wxCommandEvent& evt) {
-	STAGE_ACTION("Motor set max index extered")
+	JOURNALED_STAGE_ACTION("Motor set max index extered")
 		int newMaxIndex = wxAtoi(MotorSetMaxIndexTextCtrl->GetValue());
-	STAGE_ACTION_ARGUMENTS(to_string(newMaxIndex))
+	JOURNALED_STAGE_ACTION_ARGUMENTS(to_string(newMaxIndex))
 		lc->SetMotorMaxIndex(motorId, newMaxIndex);
 	maxIndex = lc->GetMotorMaxIndex(motorId);
 	MotorSetMaxIndexTextCtrl->SetValue(to_wx_string(maxIndex));
 	MotorSlider->SetMax(maxIndex);
 	MotorGauge->SetRange(maxIndex - minIndex);
-	LOG_ACTION()
+	JOURNALED_LOG_ACTION()
 }
 
 void MotorControlPanel::OnSetBacklashEntered(wxCommandEvent& evt) {
-	STAGE_ACTION("Motor set backlash extered")
+	JOURNALED_STAGE_ACTION("Motor set backlash extered")
 		int newBacklash = wxAtoi(MotorBacklashTextCtrl->GetValue());
-	STAGE_ACTION_ARGUMENTS(to_string(newBacklash))
+	JOURNALED_STAGE_ACTION_ARGUMENTS(to_string(newBacklash))
 		lc->SetMotorBacklash(motorId, newBacklash);
-	LOG_ACTION()
+	JOURNALED_LOG_ACTION()
 }
 
 
@@ -779,11 +780,11 @@ void MotorControlPanel::OnKeyboardChoiceSelected(wxCommandEvent& evt) {
 
 
 void MotorControlPanel::OnMotorSettingsCollapse(wxCollapsiblePaneEvent& event) {
-	STAGE_ACTION("Motor settings collapse button clicked")
+	JOURNALED_STAGE_ACTION("Motor settings collapse button clicked")
 		this->Layout();
 	MotorControlsSizer->Fit(this);
 	this->GetParent()->Layout();
-	LOG_ACTION()
+	JOURNALED_LOG_ACTION()
 }
 
 void MotorControlPanel::GoToTargetIndex() {
@@ -1,5 +1,6 @@
 #include "MotorSettingsPage.h"
 #include "..\CommonFunctions_GUI.h"
+#include "Logging/UserActionJournal.h"
 #include "../AccessCodeDialog.h"
 
 using namespace std;
@@ -147,13 +148,13 @@ void MotorSettingsPage::RefreshSlidersPosition() {
 
 
 void MotorSettingsPage::OnGetMotorAccessKeyButtonClicked(wxCommandEvent& evt) {
-	STAGE_ACTION("Generate motor access key")
+	JOURNALED_STAGE_ACTION("Generate motor access key")
 
 	wxString code = GenerateOfflinePartialKey(AccessCodeType::MOTOR);
 	AccessCodeDialog accessCodeDialog(this, code, _(MOTOR_ACCESS_KEY_MESSAGE_STR));
 	accessCodeDialog.ShowModal();
 
-	LOG_ACTION()
+	JOURNALED_LOG_ACTION()
 }
 
 
@@ -0,0 +1,108 @@
+#include "ProcedureExecutor.h"
+
+using namespace std;
+
+
+const chrono::milliseconds ProcedureExecutor::IDLE_STEP_WAIT(5);
+const chrono::microseconds ProcedureExecutor::IDLE_STEP_TIME(500);
+
+
+ProcedureExecutor::~ProcedureExecutor() {
+	Cancel();
+	Join();
+}
+
+void ProcedureExecutor::Start(const Procedure& procedure_to_run) {
+	Join();
+	procedure = procedure_to_run;
+	{
+		lock_guard<mutex> lock(wakeMutex);
+		wakeRequested = false;
+	}
+	// Drop a snapshot of the previous procedure the UI thread didn't take
+	sharedProgress.fetch_and(PROGRESS_INDEX_MASK);
+	running = true;
+	worker = thread(&ProcedureExecutor::Run, this);
+}
+
+void ProcedureExecutor::Wake() {
+	{
+		lock_guard<mutex> lock(wakeMutex);
+		wakeRequested = true;
+	}
+	wakeCondition.notify_one();
+}
+
+void ProcedureExecutor::Cancel() {
+	if (running and procedure.cancel)
+		procedure.cancel();
+	Wake();
+}
+
+void ProcedureExecutor::Join() {
+	if (worker.joinable())
+		worker.join();
+}
+
+bool ProcedureExecutor::IsRunning() const {
+	return running;
+}
+
+bool ProcedureExecutor::TakeProgress(ProcedureProgress& progress) {
+	if (!(sharedProgress.load(memory_order_acquire) & NEW_PROGRESS))
+		return false;
+	uiProgress = sharedProgress.exchange(uiProgress, memory_order_acq_rel) & PROGRESS_INDEX_MASK;
+	progress = progressBuffers[uiProgress];
+	return true;
+}
+
+
+//-------------------------------------------------------------------------
+// Worker thread
+
+void ProcedureExecutor::Run() {
+	unsigned long long stepCount = 0;
+	const chrono::milliseconds publishInterval(PROGRESS_FRAME_INTERVAL_MS);
+	chrono::steady_clock::time_point lastPublishTime;
+
+	while (procedure.isRunning()) {
+		auto stepStartTime = chrono::steady_clock::now();
+		procedure.step();
+		stepCount++;
+
+		auto now = chrono::steady_clock::now();
+		// The UI thread shows one snapshot per frame, so don't build more
+		if (now - lastPublishTime >= publishInterval) {
+			PublishProgress(stepCount, true);
+			lastPublishTime = now;
+		}
+
+		chrono::steady_clock::time_point nextStepTime;
+		if (now - stepStartTime < IDLE_STEP_TIME)
+			nextStepTime = now + IDLE_STEP_WAIT;
+		else
+			nextStepTime = now;
+
+		unique_lock<mutex> lock(wakeMutex);
+		if (nextStepTime > now)
+			wakeCondition.wait_until(lock, nextStepTime, [this] { return wakeRequested; });
+		wakeRequested = false;
+	}
+
+	PublishProgress(stepCount, false);
+	running = false;
+}
+
+// Fill the worker's buffer and swap it with the shared one. The UI thread
+// takes whatever is there at its next frame.
+void ProcedureExecutor::PublishProgress(unsigned long long step_count, bool still_running) {
+	ProcedureProgress& progress = progressBuffers[workerProgress];
+	progress.stepCount = step_count;
+	progress.running = still_running;
+	if (procedure.getStepSummary)
+		progress.stepSummary = procedure.getStepSummary();
+	else
+		progress.stepSummary.clear();
+
+	workerProgress = sharedProgress.exchange(workerProgress | NEW_PROGRESS, memory_order_acq_rel) & PROGRESS_INDEX_MASK;
+}
@@ -0,0 +1,134 @@
+/**
+* Procedure Executor - Polls a long-running laser control procedure (e.g.
+*	Autotune-Power, Autotune-Diagnostics, Autotune-Oscillator) on a worker
+*	thread at a paced rate, and hands its progress to the UI thread.
+*
+* - This is a paced poll, not an event-driven scheduler: the autotune
+*	procedures don't report when their next step is due or when a reply
+*	arrives, so the worker can only step them and look at how long the
+*	step took.
+* - The worker calls Step() while the procedure is running. A step that
+*	took longer than IDLE_STEP_TIME (it talked to the laser) is followed by
+*	the next one right away. After a step that returned right away (the
+*	procedure was only checking whether a wait time had passed) the worker
+*	sleeps for IDLE_STEP_WAIT (5 ms) instead of spinning, so a waiting
+*	procedure is polled every 5 ms.
+* - Cancel() ends the current sleep early, so a cancelled procedure is
+*	stepped again straight away.
+* - At most once per PROGRESS_FRAME_INTERVAL_MS, and after the last step,
+*	the worker publishes a progress snapshot. The UI thread picks up the
+*	latest one with TakeProgress(..) at its frame rate - snapshots it
+*	didn't pick up in time are replaced, never queued.
+* - Snapshots go through three reused ProcedureProgress buffers (a triple
+*	buffer swapped with one atomic exchange), so no snapshot is allocated.
+*	Only the procedure's summary text is built, once per published
+*	snapshot.
+* - Nothing on the worker touches wx widgets.
+* - Cancel() asks the procedure to stop (it keeps being stepped until it
+*	is no longer running, so it can clean up); Join() waits for the worker.
+*	Destruction cancels and joins.
+*
+* Example usage (in a panel):
+*
+*	stepExecutor.Start({
+*		[=] { return autotunePower->IsRunning(); },
+*		[=] { autotunePower->Step(); },
+*		[=] { return autotunePower->GetStepSummary(); },
+*		[=] { autotunePower->Cancel(); }
+*	});
+*	progressTimer.Start(PROGRESS_FRAME_INTERVAL_MS);
+*
+*	void OnProgressTimer(wxTimerEvent& evt) {
+*		ProcedureProgress progress;
+*		if (stepExecutor.TakeProgress(progress))
+*			wxLogStatus(to_wx_string(progress.stepSummary));
+*	}
+*
+* @file ProcedureExecutor.h
+* @created October 2026
+* @version 1.0
+*/
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+
+
+// How often a UI thread should take progress snapshots (~30 frames/s)
+const int PROGRESS_FRAME_INTERVAL_MS = 33;
+
+
+// One snapshot of a procedure's progress, published after each step
+struct ProcedureProgress {
+	unsigned long long stepCount = 0;
+	std::string stepSummary;
+	// False in the last snapshot, once the procedure stopped running
+	bool running = true;
+};
+
+
+class ProcedureExecutor {
+
+public:
+	struct Procedure {
+		std::function<bool()> isRunning;
+		std::function<void()> step;
+		// Status text after a step. May be empty.
+		std::function<std::string()> getStepSummary;
+		// Ask the procedure to stop. May be empty.
+		std::function<void()> cancel;
+	};
+
+	// Pause after a step that returned in less than IDLE_STEP_TIME
+	static const std::chrono::milliseconds IDLE_STEP_WAIT;
+	static const std::chrono::microseconds IDLE_STEP_TIME;
+
+	ProcedureExecutor() = default;
+	~ProcedureExecutor();
+	ProcedureExecutor(const ProcedureExecutor&) = delete;
+	ProcedureExecutor& operator=(const ProcedureExecutor&) = delete;
+
+	// Start stepping procedure on the worker thread. Waits for the
+	//   previous procedure's worker to finish first.
+	void Start(const Procedure& procedure);
+	// Ask the procedure to stop, and wake the worker.
+	void Cancel();
+	// Wait until the worker has finished.
+	void Join();
+	// True from Start(..) until the worker has finished.
+	bool IsRunning() const;
+
+	// Take the latest progress snapshot, if one was published since the
+	//   last call. UI thread. Reusing progress keeps its string capacity.
+	bool TakeProgress(ProcedureProgress& progress);
+
+
+private:
+	Procedure procedure;
+	std::thread worker;
+	std::atomic<bool> running{ false };
+
+	std::mutex wakeMutex;
+	std::condition_variable wakeCondition;
+	bool wakeRequested = false;
+
+	// Triple buffer: the worker fills one buffer, the UI thread reads
+	//   another, and the third is swapped between them through
+	//   sharedProgress, with NEW_PROGRESS set until the UI thread takes it.
+	static const int NEW_PROGRESS = 4;
+	static const int PROGRESS_INDEX_MASK = 3;
+	ProcedureProgress progressBuffers[3];
+	std::atomic<int> sharedProgress{ 1 };
+	int workerProgress = 0;
+	int uiProgress = 2;
+
+	void Wake();
+	void Run();
+	void PublishProgress(unsigned long long step_count, bool still_running);
+
+};
@@ -4,6 +4,7 @@
 
 #include "PulseSettingsPage.h"
 #include "../CommonFunctions_GUI.h"
+#include "Logging/UserActionJournal.h"
 #include "../AccessCodeDialog.h"
 
 using namespace std;
@@ -214,17 +215,17 @@ void PulseSettingsPage::InitPulseControlMiniWindow() {
 }
 
 void PulseSettingsPage::OngetPulseAccessKeyButtonClicked(wxCommandEvent& evt) {
-	STAGE_ACTION("Generate pulse access key")
+	JOURNALED_STAGE_ACTION("Generate pulse access key")
 	wxString code = GenerateOfflinePartialKey(AccessCodeType::PULSE);
 	AccessCodeDialog accessCodeDialog(this, code, _(PULSE_ACCESS_KEY_MESSAGE_STR));
 	accessCodeDialog.ShowModal();
-	LOG_ACTION()
+	JOURNALED_LOG_ACTION()
 }
 
 void PulseSettingsPage::OnOpenPulseControlMiniWindow(wxCommandEvent& evt) {
-	STAGE_ACTION("Open pulse control mini window button clicked")
+	JOURNALED_STAGE_ACTION("Open pulse control mini window button clicked")
 	InitPulseControlMiniWindow();
-	LOG_ACTION()
+	JOURNALED_LOG_ACTION()
 }
 
 void PulseSettingsPage::OnPulseControlMiniWindowClosed(wxCommandEvent& evt) {
@@ -1,2 +1,127 @@
+#include <algorithm>
+
 #include "RealTimeObserver.h"
 
+using namespace std;
+
+
+// Shortest time between two updates of the text control (~30 frames/s)
+static const chrono::milliseconds FRAME_INTERVAL(33);
+
+
+RealTimeObserver::RealTimeObserver(wxTextCtrl* textCtrl, size_t maxRetainedRows) :
+    textCtrl_(textCtrl),
+    maxRetainedRows_(max<size_t>(maxRetainedRows, 1)) {
+
+    frameTimer_.Bind(wxEVT_TIMER, [this](wxTimerEvent&) { Render(); });
+}
+
+RealTimeObserver::~RealTimeObserver() {
+    frameTimer_.Stop();
+    PendingRow* row = pendingRows_.exchange(nullptr);
+    while (row) {
+        PendingRow* next = row->next;
+        delete row;
+        row = next;
+    }
+}
+
+
+// Called on the logging thread
+void RealTimeObserver::onRowLogged(const LogRowView& row) {
+    PendingRow* pending = new PendingRow;
+    pending->text = "Received Data:\n";
+    for (size_t col = 0; col < row.size(); col++) {
+        pending->text += row.GetSchema()->GetColumnName(col);
+        pending->text += ": ";
+        pending->text += row.GetValue(col);
+        pending->text += '\n';
+    }
+
+    pending->next = pendingRows_.load(memory_order_relaxed);
+    while (!pendingRows_.compare_exchange_weak(pending->next, pending, memory_order_release, memory_order_relaxed));
+
+    RequestRender();
+}
+
+void RealTimeObserver::RequestRender() {
+    // One request in flight is enough; it will pick up every pending row
+    if (renderRequested_.exchange(true))
+        return;
+
+    weak_ptr<RealTimeObserver> weakSelf = weak_from_this();
+    textCtrl_->CallAfter([weakSelf]() {
+        if (auto self = weakSelf.lock())
+            self->OnRenderRequested();
+    });
+}
+
+
+//-------------------------------------------------------------------------
+// UI thread
+
+void RealTimeObserver::OnRenderRequested() {
+    auto sinceLastRender = chrono::steady_clock::now() - lastRenderTime_;
+    if (sinceLastRender >= FRAME_INTERVAL)
+        Render();
+    else if (!frameTimer_.IsRunning())
+        frameTimer_.StartOnce(int(chrono::duration_cast<chrono::milliseconds>(FRAME_INTERVAL - sinceLastRender).count()) + 1);
+}
+
+void RealTimeObserver::Render() {
+    // Cleared first so a row pushed from here on requests another render
+    renderRequested_ = false;
+    lastRenderTime_ = chrono::steady_clock::now();
+
+    PendingRow* newestRow = pendingRows_.exchange(nullptr, memory_order_acquire);
+    if (!newestRow)
+        return;
+
+    // The queue is newest first; reverse it
+    PendingRow* oldestRow = nullptr;
+    while (newestRow) {
+        PendingRow* next = newestRow->next;
+        newestRow->next = oldestRow;
+        oldestRow = newestRow;
+        newestRow = next;
+    }
+
+    auto renderStartTime = chrono::steady_clock::now();
+    wxString batch;
+    size_t rowCount = 0;
+    for (PendingRow* row = oldestRow; row;) {
+        wxString rowText(row->text);
+        batch += rowText;
+        retainedRows_.push_back(rowText);
+        rowCount++;
+
+        PendingRow* next = row->next;
+        delete row;
+        row = next;
+    }
+    while (retainedRows_.size() > maxRetainedRows_)
+        retainedRows_.pop_front();
+
+    // Trimming means replacing the whole text, so let a quarter of the limit
+    // build up before doing it
+    rowsAppendedSinceTrim_ += rowCount;
+    textCtrl_->Freeze();
+    if (rowsAppendedSinceTrim_ > maxRetainedRows_ / 4 and retainedRows_.size() == maxRetainedRows_) {
+        wxString retainedText;
+        for (const wxString& rowText : retainedRows_)
+            retainedText += rowText;
+        textCtrl_->ChangeValue(retainedText);
+        textCtrl_->SetInsertionPointEnd();
+        textCtrl_->ShowPosition(textCtrl_->GetLastPosition());
+        rowsAppendedSinceTrim_ = 0;
+    }
+    else {
+        textCtrl_->AppendText(batch);
+    }
+    textCtrl_->Thaw();
+
+    renderStatistics_.textUpdates++;
+    renderStatistics_.rowsRendered += rowCount;
+    renderStatistics_.renderSeconds += chrono::duration<double>(chrono::steady_clock::now() - renderStartTime).count();
+}
+
@@ -1,42 +1,62 @@
 #pragma once
-#include "../CommonUtilities/Logging/LogObserver.h"
-#include "wx/wx.h"
-
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <memory>
+#include <string>
 
-class RealTimeObserver : public LogObserver {
-public:
-    RealTimeObserver(wxTextCtrl* textCtrl) : textCtrl_(textCtrl) {}
+#include "../CommonUtilities/Logging/LogRowObserver.h"
+#include "wx/wx.h"
 
-    void onDataPointLogged(std::map<std::string, std::string> data) override {
-        textCtrl_->AppendText("Received Data:\n");
-        for (const auto& entry : data) {
-            std::string logEntry = entry.first + ": " + entry.second + "\n";
-            textCtrl_->AppendText(logEntry);
-        }
-    }
 
-private:
-    wxTextCtrl* textCtrl_;  // Pointer to the wxTextCtrl in the LoggingPage
-};
-/*class RealTimeObserver :public LogObserver {
+// Real-Time Observer - Shows each logged data point in a wxTextCtrl.
+//
+// - onRowLogged(..) may be called from any thread. It only formats the row
+//   and pushes it onto a lock-free queue.
+// - The queue is drained on the UI thread (via CallAfter) at most once per
+//   frame, and all rows that arrived since the last frame are added with
+//   a single AppendText(..).
+// - Only the most recent rows are kept in the text control, so it doesn't
+//   grow (and slow down) for the whole logging session.
+//
+// Must be created with std::make_shared on the UI thread.
+class RealTimeObserver : public LogRowObserver, public std::enable_shared_from_this<RealTimeObserver> {
 public:
-	RealTimeObserver(wxTextCtrl* textCtrl) :textCtrl_(textCtrl) {}
-	void  onDataPointLogged(std::map<std::string, std::string> data)override {
-		//Assume temperature data is under the key "Temperature"
-		std::string temperatureLog = "Temperature: " + data["Temperature"] + "\n";
+    RealTimeObserver(wxTextCtrl* textCtrl, size_t maxRetainedRows = 500);
+    ~RealTimeObserver();
 
-		textCtrl_->AppendText(temperatureLog);
-	}
+    void onRowLogged(const LogRowView& row) override;
 
+    // Work done on the UI thread so far (see RealTimeObserverBenchmark.h).
+    //   UI thread only.
+    struct RenderStatistics {
+        size_t textUpdates = 0;
+        size_t rowsRendered = 0;
+        double renderSeconds = 0;
+    };
+    const RenderStatistics& GetRenderStatistics() const { return renderStatistics_; }
 
 private:
-	wxTextCtrl* textCtrl_;//Pointer to the wxTextCtrl i the LoggingPage 
-
-
+    struct PendingRow {
+        std::string text;
+        PendingRow* next = nullptr;
+    };
 
+    wxTextCtrl* textCtrl_;  // Pointer to the wxTextCtrl in the LoggingPage
+    const size_t maxRetainedRows_;
+
+    // Rows pushed by any thread, newest first
+    std::atomic<PendingRow*> pendingRows_{ nullptr };
+    std::atomic<bool> renderRequested_{ false };
+
+    // UI thread only
+    std::deque<wxString> retainedRows_;
+    size_t rowsAppendedSinceTrim_ = 0;
+    wxTimer frameTimer_;
+    std::chrono::steady_clock::time_point lastRenderTime_;
+    RenderStatistics renderStatistics_;
+
+    void RequestRender();
+    void OnRenderRequested();
+    void Render();
 };
-*/
-
-
-
-
@@ -0,0 +1,151 @@
+#include <algorithm>
+#include <cmath>
+
+#include "SamplingScheduler.h"
+
+using namespace std;
+
+
+SamplingScheduler::SamplingScheduler(SampleFunction sample_function) :
+	sample(sample_function) {
+}
+
+SamplingScheduler::~SamplingScheduler() {
+	Stop();
+}
+
+
+void SamplingScheduler::SetInterval(chrono::milliseconds sample_interval) {
+	lock_guard<mutex> lock(schedulerMutex);
+	interval = max(sample_interval, chrono::milliseconds(1));
+}
+
+chrono::milliseconds SamplingScheduler::GetInterval() const {
+	lock_guard<mutex> lock(schedulerMutex);
+	return interval;
+}
+
+
+void SamplingScheduler::Start() {
+	lock_guard<mutex> lock(schedulerMutex);
+	if (running)
+		return;
+	running = true;
+	stopRequested = false;
+	samplingThread = thread(&SamplingScheduler::Run, this);
+}
+
+void SamplingScheduler::StartOnCallerThread() {
+	lock_guard<mutex> lock(schedulerMutex);
+	if (running)
+		return;
+	running = true;
+	stopRequested = false;
+	deadline = chrono::steady_clock::now();
+}
+
+chrono::milliseconds SamplingScheduler::SampleIfDue() {
+	{
+		lock_guard<mutex> lock(schedulerMutex);
+		if (!running or samplingThread.joinable())
+			return interval;
+		if (chrono::steady_clock::now() < deadline)
+			return chrono::ceil<chrono::milliseconds>(deadline - chrono::steady_clock::now());
+	}
+
+	TakeSample();
+
+	lock_guard<mutex> lock(schedulerMutex);
+	return max(chrono::ceil<chrono::milliseconds>(deadline - chrono::steady_clock::now()), chrono::milliseconds(0));
+}
+
+void SamplingScheduler::Stop() {
+	{
+		lock_guard<mutex> lock(schedulerMutex);
+		if (!running)
+			return;
+		stopRequested = true;
+	}
+	stopRequestedCondition.notify_all();
+	// Not joinable when sampling on the caller's thread
+	if (samplingThread.joinable())
+		samplingThread.join();
+
+	lock_guard<mutex> lock(schedulerMutex);
+	running = false;
+}
+
+bool SamplingScheduler::IsRunning() const {
+	lock_guard<mutex> lock(schedulerMutex);
+	return running;
+}
+
+
+SamplingStatistics SamplingScheduler::GetStatistics() const {
+	lock_guard<mutex> lock(schedulerMutex);
+	SamplingStatistics statistics;
+	statistics.samplesTaken = samplesTaken;
+	statistics.missedDeadlines = missedDeadlines;
+	statistics.maxLatenessMs = maxLatenessMs;
+	if (samplesTaken > 0) {
+		statistics.meanLatenessMs = latenessSumMs / samplesTaken;
+		double variance = latenessSquaredSumMs / samplesTaken - statistics.meanLatenessMs * statistics.meanLatenessMs;
+		statistics.latenessStandardDeviationMs = sqrt(max(variance, 0.0));
+	}
+	return statistics;
+}
+
+void SamplingScheduler::ResetStatistics() {
+	lock_guard<mutex> lock(schedulerMutex);
+	samplesTaken = 0;
+	missedDeadlines = 0;
+	latenessSumMs = 0;
+	latenessSquaredSumMs = 0;
+	maxLatenessMs = 0;
+}
+
+
+void SamplingScheduler::Run() {
+	{
+		lock_guard<mutex> lock(schedulerMutex);
+		deadline = chrono::steady_clock::now();
+	}
+
+	while (true) {
+		{
+			unique_lock<mutex> lock(schedulerMutex);
+			if (stopRequestedCondition.wait_until(lock, deadline, [this] { return stopRequested; }))
+				return;
+		}
+		TakeSample();
+	}
+}
+
+void SamplingScheduler::TakeSample() {
+	// Read both clocks as close to the wake-up as possible
+	auto wokeUp = chrono::steady_clock::now();
+	auto acquisitionTime = chrono::system_clock::now();
+	sample(acquisitionTime);
+
+	lock_guard<mutex> lock(schedulerMutex);
+	double latenessMs = chrono::duration<double, milli>(wokeUp - deadline).count();
+	samplesTaken++;
+	latenessSumMs += latenessMs;
+	latenessSquaredSumMs += latenessMs * latenessMs;
+	maxLatenessMs = max(maxLatenessMs, latenessMs);
+
+	// Next deadline on the original grid. Skip any that already passed.
+	deadline += interval;
+	auto now = chrono::steady_clock::now();
+	if (now > deadline) {
+		auto missed = (now - deadline) / interval + 1;
+		missedDeadlines += missed;
+		deadline += missed * interval;
+	}
+}
+
+
+string FormatSamplingStatistics(const SamplingStatistics& statistics) {
+	return "Samples: " + to_string(statistics.samplesTaken) + ", missed: " + to_string(statistics.missedDeadlines) +
+		", late by " + to_string(int(statistics.meanLatenessMs)) + " ms on average, " + to_string(int(statistics.maxLatenessMs)) + " ms at most";
+}
@@ -0,0 +1,120 @@
+/**
+* Sampling Scheduler - Calls a sampling function at a fixed interval from a
+*	dedicated thread, or from the caller's thread, without drifting.
+*
+* - Deadlines are absolute: sample N is due at start + N * interval on the
+*	steady clock, so time spent sampling or a late wake-up never pushes
+*	later samples back.
+* - Intervals are in milliseconds and may be shorter than a second.
+* - The sampling function receives the wall-clock time at which the sample
+*	was taken, so rows can be stamped with acquisition time rather than the
+*	time they were written (see LoggerBase::LogDataPointAt(..)).
+* - If sampling takes longer than the interval, the deadlines that have
+*	already passed are skipped (not sampled in a burst) and counted as
+*	missed.
+* - GetStatistics() reports how late each sample was taken (jitter).
+* - If the sampling function uses objects that aren't thread-safe (e.g. the
+*	laser controller from the UI thread), StartOnCallerThread() keeps the
+*	same schedule without a thread: the caller calls SampleIfDue() when
+*	the time it returned has passed, e.g. from a one-shot wxTimer.
+*
+* Example usage:
+*
+*	SamplingScheduler scheduler([&](chrono::system_clock::time_point acquired) {
+*		logger.LogDataPointAt(acquired, ReadPower(), ReadTemperature());
+*	});
+*	scheduler.SetInterval(chrono::milliseconds(250));
+*	scheduler.Start();
+*
+*	// Or on the UI thread
+*	scheduler.StartOnCallerThread();
+*	sampleTimer.StartOnce(1);
+*	...
+*	void OnSampleTimer(wxTimerEvent& evt) {
+*		sampleTimer.StartOnce(max(int(scheduler.SampleIfDue().count()), 1));
+*	}
+*
+* @file SamplingScheduler.h
+* @created October 2026
+* @version 1.0
+*/
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+
+
+#define LOG_API __declspec(dllexport)
+
+
+struct SamplingStatistics {
+	unsigned long long samplesTaken = 0;
+	unsigned long long missedDeadlines = 0;
+	// How long after its deadline each sample was taken
+	double meanLatenessMs = 0;
+	double maxLatenessMs = 0;
+	double latenessStandardDeviationMs = 0;
+};
+
+
+class SamplingScheduler {
+
+public:
+	using SampleFunction = std::function<void(std::chrono::system_clock::time_point acquisition_time)>;
+
+	LOG_API SamplingScheduler(SampleFunction sample_function);
+	// Stops the sampling thread
+	LOG_API ~SamplingScheduler();
+
+	// Takes effect from the next sample if already running.
+	LOG_API void SetInterval(std::chrono::milliseconds sample_interval);
+	LOG_API std::chrono::milliseconds GetInterval() const;
+
+	// The first sample is taken immediately.
+	LOG_API void Start();
+	// Sample on the caller's thread instead, through SampleIfDue(). The
+	//   first sample is due immediately.
+	LOG_API void StartOnCallerThread();
+	// Takes the sample if its deadline has passed. Returns how long until
+	//   the next deadline. Only for StartOnCallerThread().
+	LOG_API std::chrono::milliseconds SampleIfDue();
+	// Waits for a sample in progress to finish. Must not be called from
+	//   the sampling function.
+	LOG_API void Stop();
+	LOG_API bool IsRunning() const;
+
+	LOG_API SamplingStatistics GetStatistics() const;
+	LOG_API void ResetStatistics();
+
+
+private:
+	SampleFunction sample;
+
+	mutable std::mutex schedulerMutex;
+	std::condition_variable stopRequestedCondition;
+	std::chrono::milliseconds interval{ 1000 };
+	bool running = false;
+	bool stopRequested = false;
+	std::thread samplingThread;
+	std::chrono::steady_clock::time_point deadline;
+
+	// Statistics, guarded by schedulerMutex
+	unsigned long long samplesTaken = 0;
+	unsigned long long missedDeadlines = 0;
+	double latenessSumMs = 0;
+	double latenessSquaredSumMs = 0;
+	double maxLatenessMs = 0;
+
+	void Run();
+	// Take the sample due at deadline and move on to the next deadline
+	void TakeSample();
+
+};
+
+
+// One line, e.g. "Samples: 120, missed: 2, late by 3 ms on average, 41 ms at most"
+LOG_API std::string FormatSamplingStatistics(const SamplingStatistics& statistics);
@@ -1,6 +1,7 @@
 #include "SensorsPage.h"
 #include "MainDefinitions.h"
 #include "../CommonFunctions_GUI.h"
+#include "Logging/UserActionJournal.h"
 #include "../AccessCodeDialog.h"
 
 using namespace std;
@@ -207,11 +208,11 @@ void SensorsPage::AddHumiditySettingsPanel(int humidity_id) {
 }
 
 void SensorsPage::OnGetSensorsAccessKeyButtonClicked(wxCommandEvent& evt) {
-	STAGE_ACTION("Generate sensors access key")
+	JOURNALED_STAGE_ACTION("Generate sensors access key")
 
 	wxString code = GenerateOfflinePartialKey(AccessCodeType::SENSOR);
 	AccessCodeDialog accessCodeDialog(this, code, _(SENSORS_ACCESS_KEY_MESSAGE_STR));
 	accessCodeDialog.ShowModal();
 
-	LOG_ACTION()
+	JOURNALED_LOG_ACTION()
 }
@@ -0,0 +1,41 @@
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+#include "SimulatedLaser.h"
+
+using namespace std;
+
+
+SimulatedLaser::SimulatedLaser(const SimulatedLaserSettings& settings) : settings(settings), random(settings.seed) {}
+
+string SimulatedLaser::SendCommand(string_view command) {
+	size_t concurrent = ++concurrentCommands;
+	size_t maxConcurrent = maxConcurrentCommands.load();
+	while (concurrent > maxConcurrent and !maxConcurrentCommands.compare_exchange_weak(maxConcurrent, concurrent)) {}
+
+	string error;
+	{
+		// The link carries one command at a time, so callers on other threads wait
+		lock_guard<mutex> lock(linkMutex);
+		uniform_real_distribution<double> unit(0, 1);
+		double milliseconds = settings.commandMilliseconds * (1 + settings.jitterFraction * (2 * unit(random) - 1));
+		bool fails = unit(random) < settings.errorFraction;
+		commandCount++;
+
+		this_thread::sleep_for(chrono::duration<double, milli>(max(milliseconds, 0.0)));
+		if (fails)
+			error = "Simulated laser error on: " + string(command);
+	}
+	concurrentCommands--;
+	return error;
+}
+
+size_t SimulatedLaser::GetCommandCount() {
+	lock_guard<mutex> lock(linkMutex);
+	return commandCount;
+}
+
+size_t SimulatedLaser::GetMaxConcurrentCommands() const {
+	return maxConcurrentCommands.load();
+}
@@ -0,0 +1,66 @@
+/**
+* Simulated Laser - Stands in for the laser's serial link in replays and
+*	benchmarks, so they run without the instrument attached.
+*
+* - SendCommand(..) answers after the round trip of one command, with some
+*	jitter, and fails a configurable fraction of the commands.
+* - The link carries one command at a time, like the laser's RS232 link. A
+*	caller sending while another thread's command is in flight waits, and
+*	is counted: on the real link the two would be mixed up, so
+*	GetMaxConcurrentCommands() above 1 means the callers don't take turns.
+*
+* Used by UserActionReplay and AutotuneLaneBenchmark.
+*
+* Example usage:
+*
+*	SimulatedLaserSettings settings;
+*	settings.commandMilliseconds = 2;
+*	SimulatedLaser laser(settings);
+*	string error = laser.SendCommand("SETTEMP 1 25.0");
+*
+* @file SimulatedLaser.h
+* @created October 2026
+* @version 1.0
+*/
+#pragma once
+
+#include <atomic>
+#include <mutex>
+#include <random>
+#include <string>
+#include <string_view>
+
+
+struct SimulatedLaserSettings {
+	// Round trip of one command
+	double commandMilliseconds = 5;
+	// Each round trip varies by up to this fraction
+	double jitterFraction = 0.2;
+	// Fraction of commands answered with an error
+	double errorFraction = 0;
+	unsigned seed = 1;
+};
+
+
+class SimulatedLaser {
+
+public:
+	explicit SimulatedLaser(const SimulatedLaserSettings& settings);
+
+	// Answer the command after the round trip, one command at a time. Returns
+	//   the error ("" if none).
+	std::string SendCommand(std::string_view command);
+	size_t GetCommandCount();
+	// Most commands that were sent at the same time
+	size_t GetMaxConcurrentCommands() const;
+
+
+private:
+	SimulatedLaserSettings settings;
+	std::mutex linkMutex;
+	std::mt19937 random;
+	size_t commandCount = 0;
+	std::atomic<size_t> concurrentCommands{ 0 };
+	std::atomic<size_t> maxConcurrentCommands{ 0 };
+
+};
@@ -1,4 +1,5 @@
 #include "../CommonFunctions_GUI.h"
+#include "Logging/UserActionJournal.h"
 #include "Security/DataDecryptor.h"
 #include "SystemSettingsPage.h"
 #include <Security/AccessByMACAddress.h>
@@ -85,32 +86,32 @@ void SystemSettingsPage::RefreshAll() {
 
 
 void SystemSettingsPage::OnEnableTamperChecked(wxCommandEvent& evt) {
-	STAGE_ACTION("Enable tamper checkbox");
+	JOURNALED_STAGE_ACTION("Enable tamper checkbox");
 	if (enableTamperCheckbox->IsChecked()) {
 		tm->EnableTamper();
-		STAGE_ACTION_ARGUMENTS("Checked");
+		JOURNALED_STAGE_ACTION_ARGUMENTS("Checked");
 	}
 	else {
 		tm->DisableTamper();
-		STAGE_ACTION_ARGUMENTS("Unchecked");
+		JOURNALED_STAGE_ACTION_ARGUMENTS("Unchecked");
 	}
 	RefreshAll();
-	LOG_ACTION();
+	JOURNALED_LOG_ACTION();
 }
 
 
 void SystemSettingsPage::OnQSWControlChecked(wxCommandEvent& evt) {
-	STAGE_ACTION("Enable QSW control checkbox");
+	JOURNALED_STAGE_ACTION("Enable QSW control checkbox");
 	if (qswControlCheckbox->IsChecked()) {
 		lc->EnableManualQSWControl();
-		STAGE_ACTION_ARGUMENTS("Checked");
+		JOURNALED_STAGE_ACTION_ARGUMENTS("Checked");
 	}
 	else {
 		lc->DisableManualQSWControl();
-		STAGE_ACTION_ARGUMENTS("Unchecked");
+		JOURNALED_STAGE_ACTION_ARGUMENTS("Unchecked");
 	}
 	RefreshAll();
-	LOG_ACTION();
+	JOURNALED_LOG_ACTION();
 }
 
 
@@ -1,6 +1,7 @@
 #include "TemperatureControlPanel.h"
 #include "CommonFunctions.h"
 #include "../CommonFunctions_GUI.h"
+#include "Logging/UserActionJournal.h"
 #include "../Resources.h"
 
 using namespace std;
@@ -361,22 +362,22 @@ void TemperatureControlPanel::RefreshSetTempButton() {
 }
 
 void TemperatureControlPanel::OnEnterSetTemperature(wxCommandEvent& evt) {
-	STAGE_ACTION("Set temperature entered")
+	JOURNALED_STAGE_ACTION("Set temperature entered")
 	string newSetTempString = string(SetTemperatureTextCtrl->GetValue());
-	STAGE_ACTION_ARGUMENTS("ID:" + to_string(temperatureId) + " - " + newSetTempString)
+	JOURNALED_STAGE_ACTION_ARGUMENTS("ID:" + to_string(temperatureId) + " - " + newSetTempString)
 	if (containsSubstr(newSetTempString, "e"))
 		return;
 	float newSetTemp = ToFloatSafely(newSetTempString);
 	lc->SetTemperature(temperatureId, newSetTemp);
 	TemperatureSlider->SetValue(newSetTemp * 100);
-	LOG_ACTION()
+	JOURNALED_LOG_ACTION()
 }
 
 void TemperatureControlPanel::OnSetTempButtonClicked(wxCommandEvent& evt) {
-	STAGE_ACTION("Set temperature button clicked")
+	JOURNALED_STAGE_ACTION("Set temperature button clicked")
 	// If clicked on while in STOP state (while temperature is ramping):
 	if (!lc->TemperatureIsRampedNearSetPoint(temperatureId)) {
-		STAGE_ACTION_ARGUMENTS("ID:" + to_string(temperatureId) + " - " + "Cancel")
+		JOURNALED_STAGE_ACTION_ARGUMENTS("ID:" + to_string(temperatureId) + " - " + "Cancel")
 		CancelChangeTemperature();
 		increaseTemperatureButtonPressed = false;
 		decreaseTemperatureButtonPressed = false;
@@ -384,35 +385,35 @@ void TemperatureControlPanel::OnSetTempButtonClicked(wxCommandEvent& evt) {
 	// If clicked on while in SET state (temperature is stable):
 	else {
 		float targetTemp = wxAtof(SetTemperatureTextCtrl->GetValue());
-		STAGE_ACTION_ARGUMENTS("ID:" + to_string(temperatureId) + " - " + to_string_with_precision(targetTemp, 2))
+		JOURNALED_STAGE_ACTION_ARGUMENTS("ID:" + to_string(temperatureId) + " - " + to_string_with_precision(targetTemp, 2))
 		float constrainedtargetTemp = min(max(targetTemp, minTemp), maxTemp);
 		lc->SetTemperature(temperatureId, constrainedtargetTemp);
 		TemperatureSlider->SetValue(constrainedtargetTemp * 100);
 		SetTemperatureTextCtrl->SetLabelText(to_wx_string(constrainedtargetTemp, 2));
 	}
 	RefreshSetTempButton();
-	LOG_ACTION()
+	JOURNALED_LOG_ACTION()
 }
 
 void TemperatureControlPanel::OnSliderMoved(wxScrollEvent& evt) {
-	STAGE_ACTION("Set temperature slider moved")
+	JOURNALED_STAGE_ACTION("Set temperature slider moved")
 	float targetTemp = TemperatureSlider->GetValue() / static_cast<float>(100);
-	STAGE_ACTION_ARGUMENTS("ID:" + to_string(temperatureId) + " - " + to_string_with_precision(targetTemp, 2))
+	JOURNALED_STAGE_ACTION_ARGUMENTS("ID:" + to_string(temperatureId) + " - " + to_string_with_precision(targetTemp, 2))
 	float targetTempRounded = roundTemperature(targetTemp);
 	TemperatureSlider->SetValue(targetTempRounded * 100);
 	lc->SetTemperature(temperatureId, targetTempRounded);
 	SetTemperatureTextCtrl->SetLabelText(to_wx_string(targetTempRounded, 2));
 	RefreshSetTempButton();
-	LOG_ACTION()
+	JOURNALED_LOG_ACTION()
 }
 
 void TemperatureControlPanel::OnColderButtonClicked(wxMouseEvent& evt) {
-	STAGE_ACTION_("Set temperature colder button clicked", "ID:" + to_string(temperatureId))
+	JOURNALED_STAGE_ACTION_("Set temperature colder button clicked", "ID:" + to_string(temperatureId))
 	TemperatureSlider->SetValue(TemperatureSlider->GetMin());
 	RefreshSetTempButton();
 	moveCausedByButton = true;
 	decreaseTemperatureButtonPressed = true;
-	LOG_ACTION()
+	JOURNALED_LOG_ACTION()
 }
 
 
@@ -428,12 +429,12 @@ void TemperatureControlPanel::OnColderButtonClickStopped(wxMouseEvent& evt) {
 
 
 void TemperatureControlPanel::OnHotterButtonClicked(wxMouseEvent& evt) {
-	STAGE_ACTION_("Set temperature hotter button clicked", "ID:" + to_string(temperatureId))
+	JOURNALED_STAGE_ACTION_("Set temperature hotter button clicked", "ID:" + to_string(temperatureId))
 	TemperatureSlider->SetValue(TemperatureSlider->GetMax());
 	RefreshSetTempButton();
 	moveCausedByButton = true;
 	increaseTemperatureButtonPressed = true;
-	LOG_ACTION()
+	JOURNALED_LOG_ACTION()
 }
 
 
@@ -449,20 +450,20 @@ void TemperatureControlPanel::OnHotterButtonClickStopped(wxMouseEvent& evt) {
 
 
 void TemperatureControlPanel::OnTempLabelEntered(wxCommandEvent& evt) {
-	STAGE_ACTION("Temperature label entered")
+	JOURNALED_STAGE_ACTION("Temperature label entered")
 	string newLabel = string(TemperatureLabelTextCtrl->GetValue());
-	STAGE_ACTION_ARGUMENTS("ID:" + to_string(temperatureId) + " - " + newLabel)
+	JOURNALED_STAGE_ACTION_ARGUMENTS("ID:" + to_string(temperatureId) + " - " + newLabel)
 	lc->SetTemperatureControlLabel(temperatureId, newLabel);
 	string newLabelConfirmed = lc->GetTemperatureControlLabel(temperatureId);
 	TemperatureLabelTextCtrl->SetValue(newLabelConfirmed);
 	TemperatureLabel->SetLabelText(newLabelConfirmed);
-	LOG_ACTION()
+	JOURNALED_LOG_ACTION()
 }
 
 void TemperatureControlPanel::OnSetHighLimitEntered(wxCommandEvent& evt) {
-	STAGE_ACTION("Temperature high limit entered")
+	JOURNALED_STAGE_ACTION("Temperature high limit entered")
 	float newHighLimit = wxAtof(TemperatureHighLimitTextCtrl->GetValue());
-	STAGE_ACTION_ARGUMENTS("ID:" + to_string(temperatureId) + " - " + to_string_with_precision(newHighLimit, 2))
+	JOURNALED_STAGE_ACTION_ARGUMENTS("ID:" + to_string(temperatureId) + " - " + to_string_with_precision(newHighLimit, 2))
 	newHighLimit = min(max(newHighLimit, minTemp), 99.9f);
 	lc->SetMaxSetTemperature(temperatureId, newHighLimit);
 	float newHighLimitConfirmed = lc->GetMaxSetTemperature(temperatureId);
@@ -471,13 +472,13 @@ void TemperatureControlPanel::OnSetHighLimitEntered(wxCommandEvent& evt) {
 	TemperatureSlider->SetMax(maxTemp * 100);
 	TemperatureSliderMax->SetLabelText(to_wx_string(maxTemp, 2));
 	TemperatureGauge->SetRange((maxTemp - minTemp) * 100);
-	LOG_ACTION()
+	JOURNALED_LOG_ACTION()
 }
 
 void TemperatureControlPanel::OnSetLowLimitEntered(wxCommandEvent& evt) {
-	STAGE_ACTION("Temperature low limit entered")
+	JOURNALED_STAGE_ACTION("Temperature low limit entered")
 	float newLowLimit = wxAtof(TemperatureLowLimitTextCtrl->GetValue());
-	STAGE_ACTION_ARGUMENTS("ID:" + to_string(temperatureId) + " - " + to_string_with_precision(newLowLimit, 2))
+	JOURNALED_STAGE_ACTION_ARGUMENTS("ID:" + to_string(temperatureId) + " - " + to_string_with_precision(newLowLimit, 2))
 	newLowLimit = min(max(newLowLimit, 0.0f), maxTemp);
 	lc->SetMinSetTemperature(temperatureId, newLowLimit);
 	float newLowLimitConfirmed = lc->GetMinSetTemperature(temperatureId);
@@ -486,52 +487,52 @@ void TemperatureControlPanel::OnSetLowLimitEntered(wxCommandEvent& evt) {
 	TemperatureSlider->SetMin(minTemp * 100);
 	TemperatureSliderMin->SetLabelText(to_wx_string(minTemp, 2));
 	TemperatureGauge->SetRange((maxTemp - minTemp) * 100);
-	LOG_ACTION()
+	JOURNALED_LOG_ACTION()
 }
 
 
 void TemperatureControlPanel::OnAlarmEnabledChecked(wxCommandEvent& evt) {
 	if (AlarmEnabledCheckbox->IsChecked()) {
-		STAGE_ACTION_("Temperature alarm enabled", "ID:" + to_string(temperatureId))
+		JOURNALED_STAGE_ACTION_("Temperature alarm enabled", "ID:" + to_string(temperatureId))
 		lc->SetAlarm(GetTemperatureAlarmFromComponentID(), true);
 	}
 	else {
-		STAGE_ACTION_("Temperature alarm disabled", "ID:" + to_string(temperatureId))
+		JOURNALED_STAGE_ACTION_("Temperature alarm disabled", "ID:" + to_string(temperatureId))
 		lc->SetAlarm(GetTemperatureAlarmFromComponentID(), false);
 	}
 	AlarmEnabledCheckbox->SetValue(lc->AlarmEnabled(GetTemperatureAlarmFromComponentID()));
-	LOG_ACTION()
+	JOURNALED_LOG_ACTION()
 }
 
 void TemperatureControlPanel::OnAlarmHighLimitEntered(wxCommandEvent& evt) {
-	STAGE_ACTION("Temperature alarm high limit entered")
+	JOURNALED_STAGE_ACTION("Temperature alarm high limit entered")
 	float newHighLimit = wxAtof(AlarmHighLimitTextCtrl->GetValue());
-	STAGE_ACTION_ARGUMENTS("ID:" + to_string(temperatureId) + " - " + to_string_with_precision(newHighLimit, 2))
+	JOURNALED_STAGE_ACTION_ARGUMENTS("ID:" + to_string(temperatureId) + " - " + to_string_with_precision(newHighLimit, 2))
 	newHighLimit = min(max(newHighLimit, 0.0f), 99.9f);
 	lc->SetTemperatureAlarmHighLimit(temperatureId, newHighLimit);
 	float newHighLimitConfirmed = lc->GetTemperatureAlarmHighLimit(temperatureId);
 	AlarmHighLimitTextCtrl->SetValue(to_wx_string(newHighLimitConfirmed, 2));
-	LOG_ACTION()
+	JOURNALED_LOG_ACTION()
 }
 
 void TemperatureControlPanel::OnAlarmLowLimitEntered(wxCommandEvent& evt) {
-	STAGE_ACTION("Temperature alarm low limit entered")
+	JOURNALED_STAGE_ACTION("Temperature alarm low limit entered")
 	float newLowLimit = wxAtof(AlarmLowLimitTextCtrl->GetValue());
-	STAGE_ACTION_ARGUMENTS("ID:" + to_string(temperatureId) + " - " + to_string_with_precision(newLowLimit, 2))
+	JOURNALED_STAGE_ACTION_ARGUMENTS("ID:" + to_string(temperatureId) + " - " + to_string_with_precision(newLowLimit, 2))
 	newLowLimit = max(newLowLimit, 0.0f);
 	lc->SetTemperatureAlarmLowLimit(temperatureId, newLowLimit);
 	float newLowLimitConfirmed = lc->GetTemperatureAlarmLowLimit(temperatureId);
 	AlarmLowLimitTextCtrl->SetValue(to_wx_string(newLowLimitConfirmed, 2));
-	LOG_ACTION()
+	JOURNALED_LOG_ACTION()
 }
 
 
 void TemperatureControlPanel::OnSettingsCollapse(wxCollapsiblePaneEvent& event) {
-	STAGE_ACTION("Temperature settings collapbe button clicked")
+	JOURNALED_STAGE_ACTION("Temperature settings collapbe button clicked")
 	this->Layout();
 	TemperatureControlSizer->Fit(this);
 	this->GetParent()->Layout();
-	LOG_ACTION()
+	JOURNALED_LOG_ACTION()
 }
 
 void TemperatureControlPanel::CancelChangeTemperature() {
@@ -1,5 +1,6 @@
 #include "TemperatureSettingsPage.h"
 #include "../CommonFunctions_GUI.h"
+#include "Logging/UserActionJournal.h"
 #include "../AccessCodeDialog.h"
 
 using namespace std;
@@ -82,12 +83,12 @@ void TemperatureSettingsPage::RefreshControlEnabled() {
 }
 
 void TemperatureSettingsPage::OnGetTemperatureAccessKeyButtonClicked(wxCommandEvent& evt) {
-	STAGE_ACTION("Generate temperature access key")
+	JOURNALED_STAGE_ACTION("Generate temperature access key")
 
 	wxString code = GenerateOfflinePartialKey(AccessCodeType::TEMPERATURE);
 	AccessCodeDialog accessCodeDialog(this, code, _(TEMPERATURE_ACCESS_KEY_MESSAGE_STR));
 	accessCodeDialog.ShowModal();
 
-	LOG_ACTION()
+	JOURNALED_LOG_ACTION()
 }
 
@@ -0,0 +1,137 @@
+/**
+* Background Error Logger Stress Test - Reports errors from many threads at
+*	once and checks that every one reached the error log intact.
+*
+* - Built as its own console program against the logging library, so the
+*	errors never go to the error log of an installed GUI. The logger's
+*	journal and error logs are kept in a temporary folder, which is
+*	deleted afterwards.
+* - 16 threads report 5000 errors each through
+*	BackgroundErrorLogger::LogDataPoint(..), the way "e" does: first into
+*	the journal, then into an error log after Init().
+* - The file is then decoded and every error of the run is checked: none
+*	missing, none split or merged with another, and each thread's errors
+*	in the order it reported them.
+* - Prints one line per run and returns 1 if any run failed.
+*
+* @file BackgroundErrorLoggerStressTest.cpp
+* @created October 2026
+* @version 1.0
+*/
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../BackgroundErrorLogger.h"
+#include "../LogFileDecoder.h"
+#include "../../Security/DataDecryptor.h"
+
+using namespace std;
+
+
+const unsigned int THREAD_COUNT = 16;
+const size_t ERRORS_PER_THREAD = 5000;
+
+
+struct ErrorLoggerStressResult {
+	unsigned long long errorsFound = 0;
+	// Lines of this run that weren't a whole error
+	unsigned long long malformedLines = 0;
+	// Errors found before an earlier error of the same thread
+	unsigned long long outOfOrderErrors = 0;
+	double seconds = 0;
+	bool passed = false;
+};
+
+
+static ErrorLoggerStressResult RunStressTest(BackgroundErrorLogger& errorLogger, const string& run_tag) {
+	ErrorLoggerStressResult result;
+
+	auto startTime = chrono::steady_clock::now();
+	vector<thread> threads;
+	for (unsigned int t = 0; t < THREAD_COUNT; t++) {
+		threads.emplace_back([&, t]() {
+			for (size_t i = 0; i < ERRORS_PER_THREAD; i++) {
+				errorLogger.LogDataPoint({ to_string(t * ERRORS_PER_THREAD + i + 1),
+					run_tag + " thread " + to_string(t) + " error " + to_string(i) });
+			}
+		});
+	}
+	for (thread& writer : threads)
+		writer.join();
+	errorLogger.FlushErrors();
+	result.seconds = chrono::duration<double>(chrono::steady_clock::now() - startTime).count();
+
+	vector<long long> lastErrorOfThread(THREAD_COUNT, -1);
+	LogFileDecoder decoder([](const string& line) { return decryptofy(line); }, 1);
+	bool decoded = decoder.Decode(errorLogger.GetLogFilePath(), [&](const LogDecodedChunk& chunk) {
+		for (const LogDecodedLine& line : chunk.lines) {
+			if (chunk.GetLine(line).find(run_tag) == string_view::npos)
+				continue;
+
+			// Date, Time, Error #, Thread, Monotonic Time (us), Error
+			unsigned int threadNumber;
+			long long errorIndex;
+			string message(line.type == LogLineType::DATA and line.fieldCount == 6 ? chunk.GetField(line, 5) : "");
+			if (sscanf(message.c_str() + min(message.size(), run_tag.size()), " thread %u error %lld", &threadNumber, &errorIndex) != 2
+				or message.compare(0, run_tag.size(), run_tag) != 0 or threadNumber >= THREAD_COUNT) {
+				result.malformedLines++;
+				continue;
+			}
+
+			result.errorsFound++;
+			if (errorIndex <= lastErrorOfThread[threadNumber])
+				result.outOfOrderErrors++;
+			lastErrorOfThread[threadNumber] = errorIndex;
+		}
+		return true;
+	});
+
+	result.passed = decoded and result.errorsFound == (unsigned long long)THREAD_COUNT * ERRORS_PER_THREAD
+		and result.malformedLines == 0 and result.outOfOrderErrors == 0;
+	return result;
+}
+
+
+static void PrintResult(const string& run_name, const ErrorLoggerStressResult& result) {
+	printf("%s: %u threads x %zu errors: %llu found, %llu malformed, %llu out of order, %.2f s, %s\n",
+		run_name.c_str(), THREAD_COUNT, ERRORS_PER_THREAD, result.errorsFound, result.malformedLines,
+		result.outOfOrderErrors, result.seconds, result.passed ? "passed" : "FAILED");
+}
+
+
+int main() {
+	filesystem::path baseDirectory = filesystem::temp_directory_path() /
+		("BackgroundErrorLoggerStressTest_" + to_string(chrono::steady_clock::now().time_since_epoch().count()));
+	filesystem::create_directories(baseDirectory);
+
+	bool passed;
+	{
+		BackgroundErrorLogger& errorLogger = BackgroundErrorLogger::GetInstance();
+		errorLogger.SetBaseDirectory(baseDirectory.string() + "\\");
+		errorLogger.SetSerialNumberAndModel("StressTest", "None");
+
+		ErrorLoggerStressResult journalResult = RunStressTest(errorLogger, "Journal stress test");
+		PrintResult("Journal", journalResult);
+
+		errorLogger.Init();
+		ErrorLoggerStressResult errorLogResult = RunStressTest(errorLogger, "Error log stress test");
+		PrintResult("Error log", errorLogResult);
+
+		if (errorLogger.GetDroppedErrorCount() > 0)
+			printf("%llu errors dropped\n", errorLogger.GetDroppedErrorCount());
+		passed = journalResult.passed and errorLogResult.passed and errorLogger.GetDroppedErrorCount() == 0;
+
+		// Let go of the files before deleting them
+		errorLogger.ResetToTemporaryOutputFile();
+	}
+
+	error_code error;
+	filesystem::remove_all(baseDirectory, error);
+	return passed ? 0 : 1;
+}
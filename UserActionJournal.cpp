@@ -0,0 +1,411 @@
+#include <cstring>
+#include <filesystem>
+#include <functional>
+#ifdef _WIN32
+#include <Windows.h>
+#endif
+
+#include "UserActionJournal.h"
+#include "BackgroundLogger.h"
+#include "LogSessionIndex.h"
+#include "../CommonFunctions.h"
+#include "../ErrorMessageStream.h"
+#include "../WindowsFunctions.h"
+
+using namespace std;
+
+
+const string UserActionJournal::JOURNAL_EXTENSION = ".uaj";
+const string UserActionJournal::FILE_MAGIC = "PIUAJ1\n";
+
+// Events that can wait for the writer thread at once. A burst of slider
+// events is a few hundred.
+const size_t EVENT_QUEUE_CAPACITY = 8192;
+const size_t EVENT_RESERVED_BYTES = 64;
+const chrono::milliseconds EVENT_WRITER_POLL_INTERVAL(100);
+
+
+string GetUserActionJournalDirectory() {
+	return GetLogBaseDirectory() + "UserActionJournals\\";
+}
+
+
+static unsigned long GetCurrentThreadNumber() {
+#ifdef _WIN32
+	return GetCurrentThreadId();
+#else
+	return (unsigned long)hash<thread::id>()(this_thread::get_id());
+#endif
+}
+
+static void AppendVarint(string& bytes, unsigned long long value) {
+	while (value >= 0x80) {
+		bytes += char((value & 0x7F) | 0x80);
+		value >>= 7;
+	}
+	bytes += char(value);
+}
+
+static unsigned long long ZigZag(long long value) {
+	return (static_cast<unsigned long long>(value) << 1) ^ static_cast<unsigned long long>(value >> 63);
+}
+
+static bool ReadVarint(string_view bytes, size_t& position, unsigned long long& value) {
+	value = 0;
+	for (int shift = 0; shift < 64 and position < bytes.size(); shift += 7) {
+		unsigned char byte = static_cast<unsigned char>(bytes[position++]);
+		value |= static_cast<unsigned long long>(byte & 0x7F) << shift;
+		if (!(byte & 0x80))
+			return true;
+	}
+	return false;
+}
+
+// Reused by each thread to encode its events, so recording doesn't allocate
+static string& GetThreadEventBuffer() {
+	thread_local string buffer;
+	buffer.clear();
+	return buffer;
+}
+
+
+// ------ For Singleton implementation ------
+UserActionJournal::UserActionJournal() : eventQueue(EVENT_QUEUE_CAPACITY, EVENT_RESERVED_BYTES) {
+	monotonicStartTime = chrono::steady_clock::now();
+	writerThread = thread(&UserActionJournal::WriteEvents, this);
+}
+
+UserActionJournal::~UserActionJournal() {
+	Stop();
+	{
+		lock_guard<mutex> lock(writerMutex);
+		stopRequested = true;
+	}
+	eventQueuedCondition.notify_all();
+	if (writerThread.joinable())
+		writerThread.join();
+}
+
+UserActionJournal& UserActionJournal::GetInstance() {
+	static UserActionJournal journal;
+	return journal;
+}
+// -----------------------------------------
+
+
+//-------------------------------------------------------------------------
+// Journal file
+
+void UserActionJournal::Start() {
+	started = true;
+	{
+		lock_guard<mutex> lock(writerMutex);
+		startRequested = true;
+	}
+	eventQueuedCondition.notify_one();
+}
+
+// On the writer thread
+void UserActionJournal::StartJournalFile() {
+	DeleteOldJournals();
+
+	bool opened;
+	{
+		lock_guard<mutex> lock(fileMutex);
+		if (!journalFile.is_open())
+			OpenJournalFile();
+		opened = journalFile.is_open();
+	}
+
+	{
+		lock_guard<mutex> lock(writerMutex);
+		startRequested = false;
+		writing = opened;
+	}
+	eventsWrittenCondition.notify_all();
+}
+
+void UserActionJournal::Stop() {
+	// Let a pending start finish, so the file it opens gets closed here
+	Flush();
+
+	unsigned long long written = 0;
+	{
+		lock_guard<mutex> lock(fileMutex);
+		if (!journalFile.is_open())
+			return;
+		written = WritePendingEvents();
+		journalFile.close();
+	}
+
+	{
+		lock_guard<mutex> lock(writerMutex);
+		writing = false;
+		eventsWritten += written;
+	}
+	eventsWrittenCondition.notify_all();
+}
+
+void UserActionJournal::SetMaxAgeDays(int max_age_days) {
+	maxAgeDays = max_age_days;
+}
+
+string UserActionJournal::GetJournalFilePath() {
+	lock_guard<mutex> lock(fileMutex);
+	return journalFilePath;
+}
+
+void UserActionJournal::OpenJournalFile() {
+	string date = GenerateDateString();
+	string directory = GetUserActionJournalDirectory() + date;
+	error_code error;
+	filesystem::create_directories(directory, error);
+
+	// Claim a new file, so two GUI processes never share a journal
+	LogSessionIndex sessionIndex(directory, [&date](int id) {
+		return "UserActions_(" + date + ")_" + to_string(id) + UserActionJournal::JOURNAL_EXTENSION;
+	});
+	int journalID = sessionIndex.ClaimNextLogID();
+	if (journalID == 0) {
+		e << "Failed to create a user action journal in: " << directory << endl;
+		return;
+	}
+	journalFilePath = directory + "\\" + "UserActions_(" + date + ")_" + to_string(journalID) + JOURNAL_EXTENSION;
+	journalFile.open(journalFilePath, ios::binary | ios::app);
+	if (!journalFile.is_open()) {
+		e << "Failed to open user action journal: \"" << journalFilePath << "\"." << endl;
+		return;
+	}
+
+	// Each file names its own actions and has its own start time
+	actionNameWritten.clear();
+	threadNumbers.clear();
+	lastEventMicroseconds = 0;
+
+	auto wallClockAtStart = chrono::system_clock::now() - (chrono::steady_clock::now() - monotonicStartTime);
+	encodedEvents = FILE_MAGIC;
+	encodedEvents += char(UserActionEventType::SESSION);
+	AppendVarint(encodedEvents, ZigZag(0));
+	AppendVarint(encodedEvents, 0);
+	AppendVarint(encodedEvents, static_cast<unsigned long long>(
+		chrono::duration_cast<chrono::microseconds>(wallClockAtStart.time_since_epoch()).count()));
+	journalFile.write(encodedEvents.data(), encodedEvents.size());
+	journalFile.flush();
+}
+
+void UserActionJournal::DeleteOldJournals() {
+	int maxAge = maxAgeDays;
+	if (maxAge <= 0)
+		return;
+	auto oldestKept = filesystem::file_time_type::clock::now() - chrono::hours(24) * maxAge;
+
+	error_code error;
+	for (const auto& dateFolder : filesystem::directory_iterator(GetUserActionJournalDirectory(), error)) {
+		if (!dateFolder.is_directory(error))
+			continue;
+		bool keptAny = false;
+		for (const auto& entry : filesystem::directory_iterator(dateFolder.path(), error)) {
+			if (entry.path().extension() != JOURNAL_EXTENSION)
+				continue;
+			auto lastWriteTime = entry.last_write_time(error);
+			if (!error and lastWriteTime < oldestKept)
+				filesystem::remove(entry.path(), error);
+			else
+				keptAny = true;
+		}
+		if (!keptAny)
+			filesystem::remove_all(dateFolder.path(), error);
+	}
+}
+
+
+//-------------------------------------------------------------------------
+// Recording events from any thread
+
+unsigned int UserActionJournal::InternActionName(string_view name) {
+	lock_guard<mutex> lock(namesMutex);
+	auto action = actionIDs.find(string(name));
+	if (action != actionIDs.end())
+		return action->second;
+	unsigned int actionID = static_cast<unsigned int>(actionNames.size());
+	actionNames.emplace_back(name);
+	actionIDs.emplace(actionNames.back(), actionID);
+	return actionID;
+}
+
+void UserActionJournal::StageAction(unsigned int action_id) {
+	string& payload = GetThreadEventBuffer();
+	AppendVarint(payload, action_id);
+	RecordEvent(UserActionEventType::STAGE, payload);
+}
+
+void UserActionJournal::StageIntegerArgument(long long value) {
+	string& payload = GetThreadEventBuffer();
+	AppendVarint(payload, ZigZag(value));
+	RecordEvent(UserActionEventType::ARGUMENT_INTEGER, payload);
+}
+
+void UserActionJournal::StageNumberArgument(double value) {
+	unsigned long long bits;
+	memcpy(&bits, &value, sizeof(bits));
+	string& payload = GetThreadEventBuffer();
+	for (int i = 0; i < 8; i++)
+		payload += char((bits >> (8 * i)) & 0xFF);
+	RecordEvent(UserActionEventType::ARGUMENT_NUMBER, payload);
+}
+
+void UserActionJournal::StageTextArgument(string_view text) {
+	string& payload = GetThreadEventBuffer();
+	AppendVarint(payload, text.size());
+	payload.append(text.data(), text.size());
+	RecordEvent(UserActionEventType::ARGUMENT_TEXT, payload);
+}
+
+void UserActionJournal::LogAction(string_view result) {
+	string& payload = GetThreadEventBuffer();
+	AppendVarint(payload, result.size());
+	payload.append(result.data(), result.size());
+	RecordEvent(UserActionEventType::LOG, payload);
+}
+
+// The queued message is the type byte followed by the payload as written
+// to the file.
+void UserActionJournal::RecordEvent(UserActionEventType type, string_view payload) {
+	if (!started.load(memory_order_relaxed))
+		Start();
+	long long monotonicMicroseconds = chrono::duration_cast<chrono::microseconds>(
+		chrono::steady_clock::now() - monotonicStartTime).count();
+
+	thread_local string message;
+	message.assign(1, char(type));
+	message.append(payload.data(), payload.size());
+
+	// Never make the GUI wait: drop the event if the writer is behind
+	if (!eventQueue.TryPush(message, GetCurrentThreadNumber(), monotonicMicroseconds)) {
+		eventsDropped++;
+		return;
+	}
+	eventsQueued++;
+	eventQueuedCondition.notify_one();
+}
+
+void UserActionJournal::Flush() {
+	unsigned long long target = eventsQueued.load();
+	if (this_thread::get_id() == writerThread.get_id())
+		return;
+	eventQueuedCondition.notify_one();
+	unique_lock<mutex> lock(writerMutex);
+	eventsWrittenCondition.wait(lock, [&] {
+		return eventsWritten >= target or (!writing and !startRequested) or stopRequested;
+	});
+}
+
+unsigned long long UserActionJournal::GetDroppedEventCount() const {
+	return eventsDropped.load();
+}
+
+
+//-------------------------------------------------------------------------
+// Writer thread
+
+void UserActionJournal::WriteEvents() {
+	while (true) {
+		bool stopping, starting;
+		{
+			unique_lock<mutex> lock(writerMutex);
+			eventQueuedCondition.wait_for(lock, EVENT_WRITER_POLL_INTERVAL,
+				[this] { return stopRequested or startRequested or (writing and !eventQueue.IsEmpty()); });
+			stopping = stopRequested;
+			starting = startRequested;
+		}
+		if (stopping)
+			return;
+		if (starting)
+			StartJournalFile();
+
+		unsigned long long written = 0;
+		{
+			lock_guard<mutex> lock(fileMutex);
+			if (journalFile.is_open())
+				written = WritePendingEvents();
+		}
+		if (written == 0)
+			continue;
+
+		{
+			lock_guard<mutex> lock(writerMutex);
+			eventsWritten += written;
+		}
+		eventsWrittenCondition.notify_all();
+	}
+}
+
+// Write every queued event to the journal file. fileMutex must be held.
+unsigned long long UserActionJournal::WritePendingEvents() {
+	LogRecord record;
+	record.message.reserve(EVENT_RESERVED_BYTES);
+	encodedEvents.clear();
+	unsigned long long written = 0;
+	while (eventQueue.TryPop(record)) {
+		EncodeEvent(record);
+		written++;
+	}
+	if (!encodedEvents.empty()) {
+		journalFile.write(encodedEvents.data(), encodedEvents.size());
+		journalFile.flush();
+	}
+	return written;
+}
+
+void UserActionJournal::EncodeEvent(const LogRecord& record) {
+	string_view message = record.message;
+	if (message.empty())
+		return;
+	UserActionEventType type = static_cast<UserActionEventType>(message[0]);
+
+	// Thread IDs can be large, so events use a small number instead. 0 is
+	// the session event's.
+	auto thread = threadNumbers.find(record.threadID);
+	if (thread == threadNumbers.end()) {
+		thread = threadNumbers.emplace(record.threadID, static_cast<unsigned int>(threadNumbers.size() + 1)).first;
+		encodedEvents += char(UserActionEventType::THREAD);
+		AppendVarint(encodedEvents, ZigZag(0));
+		AppendVarint(encodedEvents, thread->second);
+		AppendVarint(encodedEvents, record.threadID);
+	}
+	unsigned int threadNumber = thread->second;
+
+	// Name an action the first time it's staged in this file
+	if (type == UserActionEventType::STAGE) {
+		size_t position = 1;
+		unsigned long long actionID;
+		if (ReadVarint(message, position, actionID)) {
+			if (actionID >= actionNameWritten.size())
+				actionNameWritten.resize(size_t(actionID) + 1, false);
+			if (!actionNameWritten[size_t(actionID)]) {
+				string name;
+				{
+					lock_guard<mutex> lock(namesMutex);
+					if (actionID < actionNames.size())
+						name = actionNames[size_t(actionID)];
+				}
+				encodedEvents += char(UserActionEventType::ACTION_NAME);
+				AppendVarint(encodedEvents, ZigZag(record.monotonicMicroseconds - lastEventMicroseconds));
+				AppendVarint(encodedEvents, threadNumber);
+				AppendVarint(encodedEvents, actionID);
+				AppendVarint(encodedEvents, name.size());
+				encodedEvents += name;
+				lastEventMicroseconds = record.monotonicMicroseconds;
+				actionNameWritten[size_t(actionID)] = true;
+			}
+		}
+	}
+
+	// Events from different threads may be slightly out of time order,
+	// hence the signed time change
+	encodedEvents += message[0];
+	AppendVarint(encodedEvents, ZigZag(record.monotonicMicroseconds - lastEventMicroseconds));
+	AppendVarint(encodedEvents, threadNumber);
+	encodedEvents.append(message.data() + 1, message.size() - 1);
+	lastEventMicroseconds = record.monotonicMicroseconds;
+}
@@ -0,0 +1,202 @@
+/**
+* User Action Journal - Compact binary record of what the user did in the
+*	GUI and how long each handler took.
+*
+* - Each GUI session writes one .uaj file in a date folder under
+*	GetUserActionJournalDirectory().
+* - Action names are interned: the name is written once per file, and
+*	after that each action is a small ID. Arguments keep their type
+*	(integer, number or text) instead of being formatted into a string.
+* - Every event has the microseconds since the session started on the
+*	steady clock and the reporting thread (numbered per file), so a handler's duration is
+*	the time from its StageAction(..) to its LogAction(..) on the same
+*	thread.
+* - Recording only encodes the event into a lock-free queue and returns,
+*	so the GUI thread never waits on the file. A writer thread writes the
+*	events. If the queue is ever full, the event is dropped and counted
+*	rather than stalling the GUI.
+* - The journal file is opened by the writer thread, on Start() or on the
+*	first recorded event, whichever comes first. Journals older than the
+*	maximum age are deleted there too, so the GUI never waits on the disk.
+*
+* Read a journal with user_action_journal_report.py, which prints the
+* handler latency distribution of each action, or replay it against a
+* simulated laser with UserActionReplay.
+*
+* GUI handlers use the JOURNALED_* macros below in place of the
+* STAGE_ACTION(..)/STAGE_ACTION_ARGUMENTS(..)/STAGE_ACTION_(..)/LOG_ACTION()
+* macros of CommonFunctions_GUI.h. They do what those do and also record
+* through the JOURNAL_* macros. Code that stages through the laser
+* controller directly (lc->StageUserAction(..)) adds the JOURNAL_* macros
+* itself. The name passed to JOURNAL_STAGE_ACTION(..) must not change
+* between calls, since it's interned once per call site.
+*
+* Example usage:
+*
+*	void TemperatureControlPanel::OnColderButtonClicked(wxMouseEvent& evt) {
+*		JOURNALED_STAGE_ACTION_("Set temperature colder button clicked", "ID:" + to_string(temperatureId))
+*		...
+*		JOURNALED_LOG_ACTION()
+*	}
+*
+*	lc->StageUserAction("FPGA slot choice selected");
+*	JOURNAL_STAGE_ACTION("FPGA slot choice selected")
+*	...
+*	lc->LogUserAction(GetResultingError());
+*	JOURNAL_LOG_ACTION(GetResultingError())
+*
+* File format (all integers are LEB128 varints unless noted):
+*	"PIUAJ1\n", then one event after another:
+*	[type byte][time change since the previous event in us, zigzag]
+*	[thread number][payload], where the payload by type is
+*	- SESSION: wall-clock time of the session start (us since 1970)
+*	- THREAD: the thread's ID (as in the error log), written before the
+*	  thread number's first use
+*	- ACTION_NAME: action ID, name length, name
+*	- STAGE: action ID
+*	- ARGUMENT_INTEGER: value (zigzag)
+*	- ARGUMENT_NUMBER: 8 byte little-endian double
+*	- ARGUMENT_TEXT and LOG: length, text (LOG's text is the resulting
+*	  error, empty on success)
+*
+* @file UserActionJournal.h
+* @created October 2026
+* @version 1.0
+*/
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "LogRecordQueue.h"
+
+
+#define LOG_API __declspec(dllexport)
+
+
+#define JOURNAL_STAGE_ACTION(name) { \
+	static const unsigned int journalActionID = UserActionJournal::GetInstance().InternActionName(name); \
+	UserActionJournal::GetInstance().StageAction(journalActionID); }
+#define JOURNAL_STAGE_ARGUMENTS(arguments) UserActionJournal::GetInstance().StageTextArgument(arguments);
+#define JOURNAL_LOG_ACTION(result) UserActionJournal::GetInstance().LogAction(result);
+
+#define JOURNALED_STAGE_ACTION(name) STAGE_ACTION(name) JOURNAL_STAGE_ACTION(name)
+#define JOURNALED_STAGE_ACTION_ARGUMENTS(arguments) STAGE_ACTION_ARGUMENTS(arguments) JOURNAL_STAGE_ARGUMENTS(arguments)
+#define JOURNALED_STAGE_ACTION_(name, arguments) STAGE_ACTION_(name, arguments) JOURNAL_STAGE_ACTION(name) JOURNAL_STAGE_ARGUMENTS(arguments)
+#define JOURNALED_LOG_ACTION() LOG_ACTION() JOURNAL_LOG_ACTION(GetResultingError())
+
+
+// Folder the journals are kept in (one folder per date inside)
+LOG_API std::string GetUserActionJournalDirectory();
+
+
+enum class UserActionEventType : unsigned char {
+	SESSION = 1,
+	ACTION_NAME = 2,
+	STAGE = 3,
+	ARGUMENT_INTEGER = 4,
+	ARGUMENT_NUMBER = 5,
+	ARGUMENT_TEXT = 6,
+	LOG = 7,
+	THREAD = 8,
+};
+
+
+class UserActionJournal {
+
+private:
+	////////////////////////////
+	// Singleton methods
+	UserActionJournal();
+	~UserActionJournal();
+	UserActionJournal(const UserActionJournal&) = delete;
+	const UserActionJournal& operator=(const UserActionJournal&) = delete;
+	////////////////////////////
+
+	// Encoded events waiting for the writer thread
+	LogRecordQueue eventQueue;
+	std::chrono::steady_clock::time_point monotonicStartTime;
+	std::atomic<unsigned long long> eventsQueued{ 0 };
+	std::atomic<unsigned long long> eventsDropped{ 0 };
+
+	std::mutex namesMutex;
+	std::unordered_map<std::string, unsigned int> actionIDs;
+	std::vector<std::string> actionNames;
+
+	// Held by the writer thread while starting or writing, and by Stop()
+	std::mutex fileMutex;
+	std::ofstream journalFile;
+	std::string journalFilePath;
+	std::string encodedEvents;
+	std::vector<bool> actionNameWritten;
+	std::unordered_map<unsigned long, unsigned int> threadNumbers;
+	long long lastEventMicroseconds = 0;
+	std::atomic<int> maxAgeDays{ 90 };
+
+	std::thread writerThread;
+	std::mutex writerMutex;
+	std::condition_variable eventQueuedCondition;
+	std::condition_variable eventsWrittenCondition;
+	unsigned long long eventsWritten = 0;
+	// Set once Start() has been called, so only the first event starts it
+	std::atomic<bool> started{ false };
+	// The writer thread opens the journal file when this is set
+	bool startRequested = false;
+	// Events are left in the queue until a journal file is open
+	bool writing = false;
+	bool stopRequested = false;
+
+	void RecordEvent(UserActionEventType type, std::string_view payload);
+	void WriteEvents();
+	void StartJournalFile();
+	unsigned long long WritePendingEvents();
+	void EncodeEvent(const LogRecord& record);
+	void OpenJournalFile();
+	void DeleteOldJournals();
+
+public:
+	static const std::string JOURNAL_EXTENSION;
+	static const std::string FILE_MAGIC;
+
+	LOG_API static UserActionJournal& GetInstance();
+
+	// Have the writer thread start a new journal file for this GUI
+	//   session. Called by the first recorded event if not before. Events
+	//   recorded until the file is open wait in the queue (until it is full).
+	LOG_API void Start();
+	// Write everything recorded so far and close the journal file. Events
+	//   recorded after this wait in the queue until Start() is called again.
+	LOG_API void Stop();
+	// Journals not written to for this many days are deleted when the
+	//   journal file is started. Zero keeps them forever. Call before Start().
+	LOG_API void SetMaxAgeDays(int max_age_days);
+
+	// ID for an action name. The same name always gets the same ID.
+	LOG_API unsigned int InternActionName(std::string_view name);
+
+	// Record that a handler for the action started on this thread.
+	LOG_API void StageAction(unsigned int action_id);
+	// Record an argument of the action staged last on this thread.
+	LOG_API void StageIntegerArgument(long long value);
+	LOG_API void StageNumberArgument(double value);
+	LOG_API void StageTextArgument(std::string_view text);
+	// Record that the handler staged last on this thread finished, with
+	//   the error it resulted in ("" if none).
+	LOG_API void LogAction(std::string_view result = "");
+
+	// Wait until every event recorded so far has been written. Returns
+	//   straight away if no journal file is open or being started.
+	LOG_API void Flush();
+	// Events lost because the queue was full
+	LOG_API unsigned long long GetDroppedEventCount() const;
+	LOG_API std::string GetJournalFilePath();
+
+};
@@ -0,0 +1,254 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <thread>
+#include <unordered_map>
+
+#include "UserActionReplay.h"
+#include "UserActionJournal.h"
+
+using namespace std;
+
+
+//-------------------------------------------------------------------------
+// Reading a journal
+
+static bool ReadVarint(const string& bytes, size_t& position, unsigned long long& value) {
+	value = 0;
+	for (int shift = 0; shift < 64 and position < bytes.size(); shift += 7) {
+		unsigned char byte = static_cast<unsigned char>(bytes[position++]);
+		value |= static_cast<unsigned long long>(byte & 0x7F) << shift;
+		if (!(byte & 0x80))
+			return true;
+	}
+	return false;
+}
+
+static long long UnZigZag(unsigned long long value) {
+	return static_cast<long long>(value >> 1) ^ -static_cast<long long>(value & 1);
+}
+
+static bool ReadText(const string& bytes, size_t& position, string& text) {
+	unsigned long long length;
+	if (!ReadVarint(bytes, position, length) or length > bytes.size() - position)
+		return false;
+	text.assign(bytes, position, size_t(length));
+	position += size_t(length);
+	return true;
+}
+
+
+bool ReadUserActionJournal(const string& path, vector<RecordedUserAction>& actions) {
+	actions.clear();
+	ifstream file(path, ios::binary);
+	if (!file.is_open())
+		return false;
+	string bytes((istreambuf_iterator<char>(file)), istreambuf_iterator<char>());
+	if (bytes.compare(0, UserActionJournal::FILE_MAGIC.size(), UserActionJournal::FILE_MAGIC) != 0)
+		return false;
+
+	unordered_map<unsigned long long, string> names;
+	// Action staged last on each thread, until it's logged
+	unordered_map<unsigned int, RecordedUserAction> staged;
+
+	size_t position = UserActionJournal::FILE_MAGIC.size();
+	long long microseconds = 0;
+	while (position < bytes.size()) {
+		UserActionEventType type = static_cast<UserActionEventType>(bytes[position++]);
+		unsigned long long change, thread, value;
+		if (!ReadVarint(bytes, position, change) or !ReadVarint(bytes, position, thread))
+			break;
+		microseconds += UnZigZag(change);
+		unsigned int threadNumber = static_cast<unsigned int>(thread);
+
+		string text;
+		bool complete = true;
+		switch (type) {
+		case UserActionEventType::SESSION:
+		case UserActionEventType::THREAD:
+			complete = ReadVarint(bytes, position, value);
+			break;
+		case UserActionEventType::ACTION_NAME:
+			complete = ReadVarint(bytes, position, value) and ReadText(bytes, position, text);
+			if (complete)
+				names[value] = text;
+			break;
+		case UserActionEventType::STAGE:
+			complete = ReadVarint(bytes, position, value);
+			if (complete) {
+				// A handler that returned early never logs; the next one replaces it
+				RecordedUserAction& action = staged[threadNumber];
+				action = RecordedUserAction();
+				auto name = names.find(value);
+				action.name = name != names.end() ? name->second : "#" + to_string(value);
+				action.thread = threadNumber;
+				action.stageMicroseconds = microseconds;
+			}
+			break;
+		case UserActionEventType::ARGUMENT_INTEGER:
+			complete = ReadVarint(bytes, position, value);
+			text = to_string(UnZigZag(value));
+			break;
+		case UserActionEventType::ARGUMENT_NUMBER: {
+			complete = bytes.size() - position >= 8;
+			if (!complete)
+				break;
+			unsigned long long bits = 0;
+			for (int i = 0; i < 8; i++)
+				bits |= static_cast<unsigned long long>(static_cast<unsigned char>(bytes[position++])) << (8 * i);
+			double number;
+			memcpy(&number, &bits, sizeof(number));
+			text = to_string(number);
+			break;
+		}
+		case UserActionEventType::ARGUMENT_TEXT:
+		case UserActionEventType::LOG:
+			complete = ReadText(bytes, position, text);
+			break;
+		default:
+			// Unknown event: the rest can't be decoded
+			complete = false;
+		}
+		if (!complete)
+			break;
+
+		if (type == UserActionEventType::ARGUMENT_INTEGER or type == UserActionEventType::ARGUMENT_NUMBER or
+			type == UserActionEventType::ARGUMENT_TEXT) {
+			auto action = staged.find(threadNumber);
+			if (action != staged.end())
+				action->second.arguments.push_back(text);
+		}
+		else if (type == UserActionEventType::LOG) {
+			auto action = staged.find(threadNumber);
+			if (action == staged.end())
+				continue;
+			action->second.logMicroseconds = microseconds;
+			action->second.result = text;
+			actions.push_back(move(action->second));
+			staged.erase(action);
+		}
+	}
+
+	stable_sort(actions.begin(), actions.end(), [](const RecordedUserAction& a, const RecordedUserAction& b) {
+		return a.stageMicroseconds < b.stageMicroseconds;
+	});
+	return true;
+}
+
+
+//-------------------------------------------------------------------------
+// UserActionReplay
+
+void UserActionReplay::SetHandler(const string& action_name, UserActionReplayHandler handler) {
+	handlers[action_name] = handler;
+}
+
+string UserActionReplay::Handle(SimulatedLaser& laser, const RecordedUserAction& action) const {
+	auto handler = handlers.find(action.name);
+	if (handler != handlers.end())
+		return handler->second(laser, action);
+
+	string error = laser.SendCommand(action.name);
+	for (const string& argument : action.arguments) {
+		string argumentError = laser.SendCommand(argument);
+		if (error.empty())
+			error = argumentError;
+	}
+	return error;
+}
+
+
+static double GetPercentile(vector<double>& values, double fraction) {
+	sort(values.begin(), values.end());
+	return values[min(values.size() - 1, size_t(double(values.size()) * fraction))];
+}
+
+
+vector<UserActionReplayResult> UserActionReplay::Run(const vector<RecordedUserAction>& actions,
+	const UserActionReplaySettings& settings) const {
+
+	SimulatedLaser laser(settings.laser);
+
+	// Replayed latency, delay and result of each action
+	struct Replayed {
+		double latencyMilliseconds = 0;
+		double delayMilliseconds = 0;
+		string result;
+	};
+	vector<Replayed> replayed(actions.size());
+
+	map<unsigned int, vector<size_t>> actionsByThread;
+	for (size_t i = 0; i < actions.size(); i++)
+		actionsByThread[actions[i].thread].push_back(i);
+
+	long long firstMicroseconds = actions.empty() ? 0 : actions.front().stageMicroseconds;
+	auto startTime = chrono::steady_clock::now();
+	vector<thread> threads;
+	for (const auto& threadActions : actionsByThread) {
+		const vector<size_t>& indexes = threadActions.second;
+		threads.emplace_back([&, indexes] {
+			for (size_t i : indexes) {
+				const RecordedUserAction& action = actions[i];
+				auto dueTime = startTime;
+				if (settings.speed > 0)
+					dueTime += chrono::duration_cast<chrono::steady_clock::duration>(
+						chrono::duration<double, micro>(double(action.stageMicroseconds - firstMicroseconds) / settings.speed));
+				this_thread::sleep_until(dueTime);
+
+				auto handlerStart = chrono::steady_clock::now();
+				replayed[i].result = Handle(laser, action);
+				auto handlerEnd = chrono::steady_clock::now();
+				replayed[i].latencyMilliseconds = chrono::duration<double, milli>(handlerEnd - handlerStart).count();
+				if (settings.speed > 0)
+					replayed[i].delayMilliseconds = max(chrono::duration<double, milli>(handlerStart - dueTime).count(), 0.0);
+			}
+		});
+	}
+	for (thread& replayThread : threads)
+		replayThread.join();
+
+	map<string, vector<size_t>> actionsByName;
+	for (size_t i = 0; i < actions.size(); i++)
+		actionsByName[actions[i].name].push_back(i);
+
+	vector<UserActionReplayResult> results;
+	for (const auto& named : actionsByName) {
+		UserActionReplayResult result;
+		result.action = named.first;
+		result.count = named.second.size();
+
+		vector<double> recordedLatencies, replayedLatencies;
+		for (size_t i : named.second) {
+			recordedLatencies.push_back(double(actions[i].logMicroseconds - actions[i].stageMicroseconds) / 1000);
+			replayedLatencies.push_back(replayed[i].latencyMilliseconds);
+			result.maxDelayMilliseconds = max(result.maxDelayMilliseconds, replayed[i].delayMilliseconds);
+			if (actions[i].result.empty() != replayed[i].result.empty())
+				result.resultMismatches++;
+		}
+		result.recordedP50Milliseconds = GetPercentile(recordedLatencies, 0.5);
+		result.recordedMaxMilliseconds = recordedLatencies.back();
+		result.replayedP50Milliseconds = GetPercentile(replayedLatencies, 0.5);
+		result.replayedP95Milliseconds = GetPercentile(replayedLatencies, 0.95);
+		result.replayedMaxMilliseconds = replayedLatencies.back();
+		results.push_back(result);
+	}
+
+	sort(results.begin(), results.end(), [](const UserActionReplayResult& a, const UserActionReplayResult& b) {
+		return a.replayedMaxMilliseconds > b.replayedMaxMilliseconds;
+	});
+	return results;
+}
+
+
+string FormatUserActionReplay(const UserActionReplayResult& result) {
+	char line[400];
+	snprintf(line, sizeof(line),
+		"%s: %zu actions, recorded p50 %.2f ms max %.2f ms, replayed p50 %.2f ms p95 %.2f ms max %.2f ms, delay max %.1f ms, %zu results differ",
+		result.action.c_str(), result.count, result.recordedP50Milliseconds, result.recordedMaxMilliseconds,
+		result.replayedP50Milliseconds, result.replayedP95Milliseconds, result.replayedMaxMilliseconds,
+		result.maxDelayMilliseconds, result.resultMismatches);
+	return line;
+}
@@ -0,0 +1,107 @@
+/**
+* User Action Replay - Replays a user action journal against a simulated
+*	laser, to see how the GUI's handlers keep up with a recorded session
+*	without the instrument attached.
+*
+* - ReadUserActionJournal(..) pairs each staged action with the LogAction(..)
+*	after it on the same thread, like user_action_journal_report.py. Actions
+*	that were never logged aren't replayed.
+* - Run(..) issues the actions at their recorded times (scaled by speed),
+*	one replay thread per recorded thread, so a slow handler delays the
+*	actions after it the way it would on the GUI thread.
+* - Each action is handled by the handler set for its name, or else sends
+*	one command for the action and one per argument to SimulatedLaser.
+* - Per action the result has the recorded and the replayed handler latency,
+*	the most the replay started it late, and how many replayed results
+*	differ from the recorded ones (error or none).
+*
+* Example usage:
+*
+*	vector<RecordedUserAction> actions;
+*	if (ReadUserActionJournal(journalPath, actions)) {
+*		UserActionReplay replay;
+*		replay.SetHandler("Set temperature entered", [](SimulatedLaser& laser, const RecordedUserAction& action) {
+*			return laser.SendCommand("SETTEMP " + action.arguments[0]);
+*		});
+*		for (const UserActionReplayResult& result : replay.Run(actions, UserActionReplaySettings()))
+*			cout << FormatUserActionReplay(result) << endl;
+*	}
+*
+* @file UserActionReplay.h
+* @created October 2026
+* @version 1.0
+*/
+#pragma once
+
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "SimulatedLaser.h"
+
+
+struct RecordedUserAction {
+	std::string name;
+	// Thread number in the journal
+	unsigned int thread = 0;
+	// Microseconds since the session started
+	long long stageMicroseconds = 0;
+	long long logMicroseconds = 0;
+	// Integers and numbers as text
+	std::vector<std::string> arguments;
+	std::string result;
+};
+
+
+struct UserActionReplaySettings {
+	// 2 replays twice as fast as recorded, 0 as fast as the handlers go
+	double speed = 1;
+	SimulatedLaserSettings laser;
+};
+
+
+struct UserActionReplayResult {
+	std::string action;
+	size_t count = 0;
+	double recordedP50Milliseconds = 0;
+	double recordedMaxMilliseconds = 0;
+	double replayedP50Milliseconds = 0;
+	double replayedP95Milliseconds = 0;
+	double replayedMaxMilliseconds = 0;
+	// How much later than its recorded time the replay started the action
+	double maxDelayMilliseconds = 0;
+	size_t resultMismatches = 0;
+};
+
+
+// Returns the resulting error, "" if none
+using UserActionReplayHandler = std::function<std::string(SimulatedLaser& laser, const RecordedUserAction& action)>;
+
+
+// The handled actions of the journal, in the order they were staged. A
+//   journal cut off by a crash ends at its last complete event. Returns false
+//   if the file can't be read or isn't a user action journal.
+bool ReadUserActionJournal(const std::string& path, std::vector<RecordedUserAction>& actions);
+
+
+class UserActionReplay {
+
+public:
+	void SetHandler(const std::string& action_name, UserActionReplayHandler handler);
+
+	// Slowest replayed action first
+	std::vector<UserActionReplayResult> Run(const std::vector<RecordedUserAction>& actions,
+		const UserActionReplaySettings& settings) const;
+
+
+private:
+	std::map<std::string, UserActionReplayHandler> handlers;
+
+	std::string Handle(SimulatedLaser& laser, const RecordedUserAction& action) const;
+
+};
+
+
+// One line, e.g. "Set temperature entered: 12 actions, recorded p50 3.10 ms max 8.20 ms, replayed p50 10.40 ms p95 12.10 ms max 12.30 ms, delay max 0.2 ms, 0 results differ"
+std::string FormatUserActionReplay(const UserActionReplayResult& result);
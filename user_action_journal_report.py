@@ -0,0 +1,207 @@
+# user_action_journal_report.py
+#
+#   James Butcher
+#   10/17/26
+#
+#   Reads user action journals (.uaj files written by UserActionJournal) and prints,
+#   for each action, how many times it was handled and the distribution of handler
+#   latency: the time from StageAction(..) to LogAction(..) on the same thread.
+#   To replay a journal against a simulated laser, use UserActionReplay (UserActionReplay.h).
+#
+#   Usage:
+#       python user_action_journal_report.py <journal.uaj or folder> [...] [--events] [--csv <file>]
+#
+#   --events    also print every decoded event
+#   --csv       also write one row per handled action (action, start, latency, arguments, result)
+
+
+import datetime
+import struct
+import sys
+from pathlib import Path
+
+
+FILE_MAGIC = b"PIUAJ1\n"
+
+SESSION = 1
+ACTION_NAME = 2
+STAGE = 3
+ARGUMENT_INTEGER = 4
+ARGUMENT_NUMBER = 5
+ARGUMENT_TEXT = 6
+LOG = 7
+THREAD = 8
+
+
+def readVarint(data, position):
+    value = 0
+    shift = 0
+    while True:
+        if position >= len(data):
+            raise EOFError("journal ends inside an event")
+        byte = data[position]
+        position += 1
+        value |= (byte & 0x7F) << shift
+        if not byte & 0x80:
+            return value, position
+        shift += 7
+
+
+def unZigZag(value):
+    return (value >> 1) ^ -(value & 1)
+
+
+def readEvents(path):
+    # Yields (type, microseconds since session start, thread, payload) for each event.
+    # A journal cut off by a crash ends at its last complete event.
+    data = Path(path).read_bytes()
+    if not data.startswith(FILE_MAGIC):
+        raise ValueError(str(path) + " is not a user action journal")
+
+    position = len(FILE_MAGIC)
+    microseconds = 0
+    while position < len(data):
+        try:
+            eventType = data[position]
+            change, position = readVarint(data, position + 1)
+            thread, position = readVarint(data, position)
+            microseconds += unZigZag(change)
+
+            if eventType in (SESSION, THREAD):
+                payload, position = readVarint(data, position)
+            elif eventType == ACTION_NAME:
+                actionId, position = readVarint(data, position)
+                length, position = readVarint(data, position)
+                payload = (actionId, data[position:position + length].decode("utf-8", "replace"))
+                position += length
+            elif eventType == STAGE:
+                payload, position = readVarint(data, position)
+            elif eventType == ARGUMENT_INTEGER:
+                value, position = readVarint(data, position)
+                payload = unZigZag(value)
+            elif eventType == ARGUMENT_NUMBER:
+                if position + 8 > len(data):
+                    raise EOFError("journal ends inside an event")
+                payload = struct.unpack("<d", data[position:position + 8])[0]
+                position += 8
+            elif eventType in (ARGUMENT_TEXT, LOG):
+                length, position = readVarint(data, position)
+                if position + length > len(data):
+                    raise EOFError("journal ends inside an event")
+                payload = data[position:position + length].decode("utf-8", "replace")
+                position += length
+            else:
+                raise ValueError("unknown event type " + str(eventType) + " in " + str(path))
+        except EOFError:
+            return
+        yield eventType, microseconds, thread, payload
+
+
+def readHandledActions(path, printEvents=False):
+    # Pairs each staged action with the next LogAction(..) on its thread.
+    # Returns (handled actions, names of actions staged but never logged).
+    names = {}
+    sessionStart = None
+    staged = {}
+    handled = []
+    notLogged = []
+
+    for eventType, microseconds, thread, payload in readEvents(path):
+        if printEvents:
+            print(f"{microseconds / 1e6:14.6f}  {thread:>20}  {eventType}  {payload}")
+
+        if eventType == SESSION:
+            sessionStart = datetime.datetime.fromtimestamp(payload / 1e6)
+        elif eventType == ACTION_NAME:
+            names[payload[0]] = payload[1]
+        elif eventType == STAGE:
+            # A handler that returned early never logs; the next one replaces it
+            if thread in staged:
+                notLogged.append(staged[thread]["action"])
+            staged[thread] = {"action": names.get(payload, "#" + str(payload)), "start": microseconds, "arguments": []}
+        elif eventType in (ARGUMENT_INTEGER, ARGUMENT_NUMBER, ARGUMENT_TEXT):
+            if thread in staged:
+                staged[thread]["arguments"].append(payload)
+        elif eventType == LOG:
+            action = staged.pop(thread, None)
+            if action is None:
+                continue
+            action["latency"] = microseconds - action["start"]
+            action["result"] = payload
+            if sessionStart is not None:
+                action["time"] = sessionStart + datetime.timedelta(microseconds=action["start"])
+            handled.append(action)
+
+    notLogged.extend(action["action"] for action in staged.values())
+    return handled, notLogged
+
+
+def percentile(sortedValues, fraction):
+    index = min(len(sortedValues) - 1, int(round(fraction * (len(sortedValues) - 1))))
+    return sortedValues[index]
+
+
+def printReport(handled, notLogged):
+    latencies = {}
+    errors = {}
+    for action in handled:
+        latencies.setdefault(action["action"], []).append(action["latency"] / 1000)
+        if action["result"]:
+            errors[action["action"]] = errors.get(action["action"], 0) + 1
+
+    nameWidth = max([len("Action")] + [len(name) for name in latencies])
+    print(f"{'Action':<{nameWidth}}  {'Count':>7}  {'Errors':>6}  {'p50 ms':>9}  {'p90 ms':>9}  {'p99 ms':>9}  {'Max ms':>9}")
+    # Slowest handlers first
+    for name, values in sorted(latencies.items(), key=lambda item: -max(item[1])):
+        values.sort()
+        print(f"{name:<{nameWidth}}  {len(values):>7}  {errors.get(name, 0):>6}  {percentile(values, 0.5):>9.2f}  "
+              f"{percentile(values, 0.9):>9.2f}  {percentile(values, 0.99):>9.2f}  {values[-1]:>9.2f}")
+
+    if notLogged:
+        print()
+        print(f"{len(notLogged)} staged actions were never logged (handler returned early or the GUI closed):")
+        for name in sorted(set(notLogged)):
+            print(f"  {name}: {notLogged.count(name)}")
+
+
+def writeCsv(handled, csvPath):
+    with open(csvPath, "w") as csvFile:
+        csvFile.write("Action,Start,Latency (ms),Arguments,Result\n")
+        for action in handled:
+            arguments = " ".join(str(argument) for argument in action["arguments"]).replace(",", ";")
+            start = action["time"].isoformat() if "time" in action else str(action["start"])
+            csvFile.write(f"{action['action']},{start},{action['latency'] / 1000:.3f},{arguments},{action['result'].replace(',', ';')}\n")
+
+
+if __name__ == "__main__":
+
+    paths = []
+    printEvents = False
+    csvPath = None
+    arguments = iter(sys.argv[1:])
+    for argument in arguments:
+        if argument == "--events":
+            printEvents = True
+        elif argument == "--csv":
+            csvPath = next(arguments)
+        elif Path(argument).is_dir():
+            paths.extend(sorted(Path(argument).rglob("*.uaj")))
+        else:
+            paths.append(Path(argument))
+
+    if not paths:
+        print("Usage: python user_action_journal_report.py <journal.uaj or folder> [...] [--events] [--csv <file>]")
+        sys.exit(1)
+
+    allHandled = []
+    allNotLogged = []
+    for path in paths:
+        handled, notLogged = readHandledActions(path, printEvents)
+        allHandled.extend(handled)
+        allNotLogged.extend(notLogged)
+
+    print(f"{len(allHandled)} handled actions in {len(paths)} journal(s)")
+    print()
+    printReport(allHandled, allNotLogged)
+    if csvPath:
+        writeCsv(allHandled, csvPath)